@@ -0,0 +1,51 @@
+// Atomic operations.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#ifndef _OE_ATOMIC_H_
+#define _OE_ATOMIC_H_
+
+namespace OpenEngine {
+namespace Core {
+
+/**
+ * Atomically add \a delta to \a value.
+ * Implies a full memory barrier.
+ *
+ * @return The new value.
+ */
+template <typename T>
+inline T AtomicAdd(volatile T& value, T delta) {
+    return __sync_add_and_fetch(&value, delta);
+}
+
+/**
+ * Atomically replace \a value with \a replacement if it equals \a
+ * expected.
+ * Implies a full memory barrier.
+ *
+ * @return True if the value was replaced.
+ */
+template <typename T>
+inline bool AtomicCompareAndSwap(volatile T& value, T expected, T replacement) {
+    return __sync_bool_compare_and_swap(&value, expected, replacement);
+}
+
+/**
+ * Full memory barrier.
+ * No loads or stores will be reordered across the barrier by either
+ * the compiler or the processor.
+ */
+inline void MemoryBarrier() {
+    __sync_synchronize();
+}
+
+} // NS Core
+} // NS OpenEngine
+
+#endif // _OE_ATOMIC_H_
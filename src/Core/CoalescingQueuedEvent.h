@@ -0,0 +1,138 @@
+// Coalescing Queued Event.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#ifndef _OE_COALESCING_QUEUED_EVENT_H_
+#define _OE_COALESCING_QUEUED_EVENT_H_
+
+#include <Core/IEvent.h>
+#include <Core/IListener.h>
+#include <Core/ListenerList.h>
+#include <vector>
+#include <map>
+
+namespace OpenEngine {
+namespace Core {
+
+/**
+ * Coalescing Queued Event.
+ * A queued event that merges queued events with the same key into a
+ * single event, so each key is released at most once. This is meant
+ * for change notifications where only the accumulated change matters,
+ * for instance a texture modified several times during a frame
+ * should only be uploaded once.
+ *
+ * The event argument must provide a key and a merge operation:
+ * @code
+ * class ChangedEventArg {
+ * public:
+ *     // events with the same key are merged
+ *     const void* GetKey() const;
+ *     // extend this event to also cover the change in other
+ *     void Merge(const ChangedEventArg& other);
+ * };
+ * @endcode
+ *
+ * Merged events are released in the order of their first
+ * notification. Events notified while releasing are kept for the
+ * next release.
+ *
+ * @class CoalescingQueuedEvent CoalescingQueuedEvent.h Core/CoalescingQueuedEvent.h
+ * @tparam EventArg Argument type of the event.
+ * @see QueuedEvent
+ */
+template <typename EventArg>
+class CoalescingQueuedEvent : public IEvent<EventArg>, public IListener<EventArg> {
+protected:
+    //! list of listeners
+    ListenerList<IListener<EventArg> > ls;
+
+    //! merged event queue
+    std::vector<EventArg> eq;
+
+    //! events being released
+    std::vector<EventArg> released;
+
+    //! queue position of each key
+    std::map<const void*, unsigned int> index;
+
+    //! number of notifications merged into queued events
+    unsigned int merged;
+
+public:
+
+    CoalescingQueuedEvent() : merged(0) {}
+
+    virtual void Attach(IListener<EventArg>& listener) {
+        ls.Add(&listener);
+    }
+
+    virtual void Detach(IListener<EventArg>& listener) {
+        ls.Remove(&listener);
+    }
+
+    /**
+     * Queue the event to be sent on Release.
+     * If an event with the same key is queued the two are merged.
+     */
+    virtual void Notify(EventArg arg) {
+        const void* key = arg.GetKey();
+        typename std::map<const void*, unsigned int>::iterator i = index.find(key);
+        if (i != index.end()) {
+            eq[i->second].Merge(arg);
+            merged++;
+            return;
+        }
+        index.insert(std::make_pair(key, (unsigned int)eq.size()));
+        eq.push_back(arg);
+    }
+
+    /**
+     * Release all queued events to the attached listeners.
+     * This will empty the event queue.
+     */
+    void Release() {
+        released.swap(eq);
+        index.clear();
+        typename ListenerList<IListener<EventArg> >::Dispatch d(ls);
+        for (unsigned int e = 0; e < released.size(); e++)
+            for (unsigned int i = 0; i < d.Size(); i++) {
+                IListener<EventArg>* l = ls[i];
+                if (l != NULL) l->Handle(released[e]);
+            }
+        released.clear();
+    }
+
+    virtual void Handle(EventArg arg) {
+        Notify(arg);
+    }
+
+    virtual unsigned int Size() {
+        return ls.Size();
+    }
+
+    /**
+     * Number of queued (merged) events.
+     */
+    unsigned int QueueSize() const {
+        return eq.size();
+    }
+
+    /**
+     * Number of notifications that were merged into a queued event
+     * since the event was created.
+     */
+    unsigned int GetMergedCount() const {
+        return merged;
+    }
+};
+
+} // NS Core
+} // NS OpenEngine
+
+#endif // _OE_COALESCING_QUEUED_EVENT_H_
@@ -0,0 +1,198 @@
+// Concurrent queue.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#ifndef _OE_CONCURRENT_QUEUE_H_
+#define _OE_CONCURRENT_QUEUE_H_
+
+#include <Core/Atomic.h>
+#include <boost/aligned_storage.hpp>
+#include <boost/type_traits/alignment_of.hpp>
+#include <new>
+
+namespace OpenEngine {
+namespace Core {
+
+/**
+ * Bounded lock-free multi producer, single consumer queue.
+ * Elements are stored in a ring buffer of preallocated cells, so
+ * putting and getting elements never allocates memory. Any number of
+ * threads may Put() concurrently while a single consumer thread
+ * calls Get() or Consume().
+ *
+ * Each cell carries a sequence number telling whether it is free for
+ * the producer at a given position or holds an element for the
+ * consumer (after D. Vyukov's bounded queue).
+ *
+ * @class ConcurrentQueue ConcurrentQueue.h Core/ConcurrentQueue.h
+ * @tparam T Element type, must be copy constructible.
+ * @see ConcurrentQueuedEvent
+ */
+template <typename T>
+class ConcurrentQueue {
+private:
+    struct Cell {
+        volatile unsigned long sequence;
+        typename boost::aligned_storage<sizeof(T),
+            boost::alignment_of<T>::value>::type storage;
+        T* Element() { return static_cast<T*>((void*)&storage); }
+    };
+
+    Cell* cells;
+    unsigned long mask;
+    // keep the producer and consumer positions on separate cache lines
+    char pad0[64];
+    volatile unsigned long enqueuePos;
+    char pad1[64];
+    volatile unsigned long dequeuePos;
+    char pad2[64];
+
+    ConcurrentQueue(const ConcurrentQueue&);
+    ConcurrentQueue& operator=(const ConcurrentQueue&);
+
+    /**
+     * Get the next cell holding an element, or NULL.
+     */
+    Cell* Front() {
+        unsigned long pos = dequeuePos;
+        Cell* cell = &cells[pos & mask];
+        long diff = (long)cell->sequence - (long)(pos + 1);
+        if (diff < 0) return NULL;
+        MemoryBarrier();
+        return cell;
+    }
+
+    /**
+     * Destroy the front element and hand its cell back to producers.
+     */
+    void PopFront(Cell* cell) {
+        unsigned long pos = dequeuePos;
+        cell->Element()->~T();
+        MemoryBarrier();
+        cell->sequence = pos + mask + 1;
+        dequeuePos = pos + 1;
+    }
+
+public:
+
+    /**
+     * Create a queue.
+     *
+     * @param capacity Maximal number of elements, rounded up to the
+     *                 nearest power of two.
+     */
+    ConcurrentQueue(unsigned int capacity = 1024)
+        : enqueuePos(0), dequeuePos(0) {
+        unsigned long size = 2;
+        while (size < capacity) size <<= 1;
+        cells = new Cell[size];
+        mask = size - 1;
+        for (unsigned long i = 0; i < size; i++)
+            cells[i].sequence = i;
+    }
+
+    ~ConcurrentQueue() {
+        Cell* cell;
+        while ((cell = Front()) != NULL)
+            PopFront(cell);
+        delete[] cells;
+    }
+
+    /**
+     * Put an element in the queue.
+     * May be called from any thread.
+     *
+     * @param e Element to copy into the queue.
+     * @return False if the queue is full.
+     */
+    bool Put(const T& e) {
+        unsigned long pos = enqueuePos;
+        Cell* cell;
+        for (;;) {
+            cell = &cells[pos & mask];
+            long diff = (long)cell->sequence - (long)pos;
+            if (diff == 0) {
+                if (AtomicCompareAndSwap(enqueuePos, pos, pos + 1)) break;
+            }
+            else if (diff < 0)
+                return false;
+            pos = enqueuePos;
+        }
+        new (cell->Element()) T(e);
+        MemoryBarrier();
+        cell->sequence = pos + 1;
+        return true;
+    }
+
+    /**
+     * Get an element from the queue.
+     * May only be called from the consumer thread.
+     *
+     * @param e Assigned the element on success.
+     * @return False if the queue is empty.
+     */
+    bool Get(T& e) {
+        Cell* cell = Front();
+        if (cell == NULL) return false;
+        e = *cell->Element();
+        PopFront(cell);
+        return true;
+    }
+
+    /**
+     * Pass the queued elements to a function object in order.
+     * Only elements put before the call are consumed, so elements put
+     * while consuming are left for the next call. Elements are passed
+     * by reference directly from the queue storage.
+     * May only be called from the consumer thread.
+     *
+     * @param f Function object taking a \a T reference.
+     * @return Number of consumed elements.
+     */
+    template <class F>
+    unsigned int Consume(F& f) {
+        unsigned long limit = enqueuePos;
+        unsigned int n = 0;
+        Cell* cell;
+        while ((long)(limit - dequeuePos) > 0 && (cell = Front()) != NULL) {
+            f(*cell->Element());
+            PopFront(cell);
+            n++;
+        }
+        return n;
+    }
+
+    /**
+     * Check if the queue is empty.
+     * From the consumer thread a false result is exact, from other
+     * threads it is a snapshot.
+     */
+    bool IsEmpty() {
+        return Front() == NULL;
+    }
+
+    /**
+     * Approximate number of elements in the queue.
+     */
+    unsigned int Size() const {
+        long s = (long)(enqueuePos - dequeuePos);
+        return s > 0 ? s : 0;
+    }
+
+    /**
+     * Maximal number of elements in the queue.
+     */
+    unsigned int Capacity() const {
+        return mask + 1;
+    }
+};
+
+} // NS Core
+} // NS OpenEngine
+
+#endif // _OE_CONCURRENT_QUEUE_H_
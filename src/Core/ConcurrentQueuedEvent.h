@@ -0,0 +1,150 @@
+// Concurrent Queued Event.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#ifndef _OE_CONCURRENT_QUEUED_EVENT_H_
+#define _OE_CONCURRENT_QUEUED_EVENT_H_
+
+#include <Core/IEvent.h>
+#include <Core/IListener.h>
+#include <Core/IReleaseAble.h>
+#include <Core/ConcurrentQueue.h>
+#include <Core/Atomic.h>
+#include <Core/Mutex.h>
+#include <vector>
+#include <algorithm>
+
+namespace OpenEngine {
+namespace Core {
+
+using std::vector;
+
+/**
+ * Concurrent Queued Event.
+ * A queued event that any number of threads may notify without
+ * locking or allocating, while a single consumer thread releases the
+ * queued events to the listeners. Typical producers are input and
+ * network threads posting to the engine or render thread.
+ *
+ * The queue is bounded. Notifications made while it is full are
+ * dropped and counted, see GetDropped(). TryNotify() lets a producer
+ * detect the condition and apply its own back pressure.
+ *
+ * Release only dispatches the events queued before it was called;
+ * events notified during dispatch are kept for the next release.
+ * Attaching and detaching listeners is locked, but never contends
+ * with notifying threads. Listeners may not attach or detach on the
+ * event they are handling.
+ *
+ * @class ConcurrentQueuedEvent ConcurrentQueuedEvent.h Core/ConcurrentQueuedEvent.h
+ * @tparam EventArg Argument type of the event.
+ * @see ConcurrentQueue
+ * @see QueuedEvent
+ */
+template <typename EventArg>
+class ConcurrentQueuedEvent : public IEvent<EventArg>,
+                              public IListener<EventArg>,
+                              public IReleaseAble {
+private:
+    //! list of listeners
+    vector<IListener<EventArg>*> ls;
+    Mutex lock;
+
+    //! event queue
+    ConcurrentQueue<EventArg> eq;
+    volatile unsigned int dropped;
+
+    class Dispatcher {
+    public:
+        vector<IListener<EventArg>*>& ls;
+        Dispatcher(vector<IListener<EventArg>*>& ls) : ls(ls) {}
+        void operator()(EventArg& arg) {
+            for (unsigned int i = 0; i < ls.size(); i++)
+                ls[i]->Handle(arg);
+        }
+    };
+
+public:
+
+    /**
+     * Create a concurrent queued event.
+     *
+     * @param capacity Maximal number of queued events.
+     */
+    ConcurrentQueuedEvent(unsigned int capacity = 1024)
+        : eq(capacity), dropped(0) {}
+
+    virtual void Attach(IListener<EventArg>& listener) {
+        lock.Lock();
+        ls.push_back(&listener);
+        lock.Unlock();
+    }
+
+    virtual void Detach(IListener<EventArg>& listener) {
+        lock.Lock();
+        ls.erase(std::remove(ls.begin(), ls.end(), &listener), ls.end());
+        lock.Unlock();
+    }
+
+    /**
+     * Queue the event to be sent on Release.
+     * Drops the event if the queue is full.
+     */
+    virtual void Notify(EventArg arg) {
+        if (!eq.Put(arg)) AtomicAdd(dropped, 1u);
+    }
+
+    /**
+     * Queue the event to be sent on Release.
+     * A full queue is left to the caller and not counted as a drop.
+     *
+     * @return False if the queue was full.
+     */
+    bool TryNotify(const EventArg& arg) {
+        return eq.Put(arg);
+    }
+
+    /**
+     * Release the queued events to the attached listeners.
+     * May only be called from one thread at a time.
+     */
+    void Release() {
+        lock.Lock();
+        Dispatcher d(ls);
+        eq.Consume(d);
+        lock.Unlock();
+    }
+
+    //! Forwards to Notify
+    virtual void Handle(EventArg arg) {
+        Notify(arg);
+    }
+
+    virtual unsigned int Size() {
+        return ls.size();
+    }
+
+    /**
+     * Number of events dropped because the queue was full.
+     */
+    unsigned int GetDropped() const {
+        return dropped;
+    }
+
+    /**
+     * Check if there are events waiting to be released.
+     */
+    bool IsEmpty() {
+        return eq.IsEmpty();
+    }
+};
+
+} // NS Core
+} // NS OpenEngine
+
+#endif // _OE_CONCURRENT_QUEUED_EVENT_H_
@@ -8,14 +8,14 @@
 //--------------------------------------------------------------------
 
 #include <Core/Engine.h>
+#include <Core/Thread.h>
 #include <Logging/Logger.h>
-#include <Utils/Timer.h>
+#include <Utils/Profiler.h>
 
 namespace OpenEngine {
 namespace Core {
 
-using OpenEngine::Utils::Time;
-using OpenEngine::Utils::Timer;
+using Utils::Profiler;
 
 /**
  * Engine constructor.
@@ -26,56 +26,72 @@ Engine::Engine() : running(false) {
 
 /**
  * Main engine loop.
+ * Process events are paced according to the loop policy. Profiler
+ * zones are collected at the end of each frame.
+ *
+ * @see SetLoopPolicy()
  */
 void Engine::StartMainLoop() {
-    Time time, _time;
-    unsigned int approx;
-    const unsigned int count = 10;
-    unsigned int index = 0;
-    unsigned int loops[count];
-
-    // we initialize the approximate frame time to 50 milliseconds
-    for (unsigned int i=0; i<count; i++) loops[i] = 50;
-
-    // set the initial time
-    time = Timer::GetTime();
+    clock.Reset();
 
     // run the engine loop
     running = true;
     while (running) {
+        unsigned int steps = clock.Advance();
+        {
+            Profiler::Zone frame("Engine::Frame");
+            for (unsigned int i = 0; i < steps && running; i++) {
+                Profiler::Zone zone("Engine::Process");
+                process.Notify(clock.GetProcessEventArg(i));
+            }
+        }
+        Profiler::Collect();
+    }
+}
 
-        // calculate the approximate frame time
-        // Note: we assume that the sum of the loops do not overflow
-        // fps of 20 => (frame ~= 50 msec = 50.000 usec) x 10 = 500.000
-        approx = 0;
-        for (unsigned int i=0; i<count; i++)
-            approx += loops[i];
-        approx = approx / count;
-
-        // process listeners
-        process.Notify(ProcessEventArg(time, approx));
-
-        // save frame time to perform the next approximation
-        _time = Timer::GetTime();
-        loops[index] = (_time - time).AsInt();
-        time = _time;
+/**
+ * Set the policy used to pace the main loop.
+ * The default policy is free running, processing events as fast as
+ * possible.
+ *
+ * @see LoopPolicy
+ */
+void Engine::SetLoopPolicy(const LoopPolicy& policy) {
+    clock.SetLoopPolicy(policy);
+}
 
-        // update the loop index
-        index = (index + 1) % count;
-    }
+/**
+ * Get the policy used to pace the main loop.
+ */
+const LoopPolicy& Engine::GetLoopPolicy() const {
+    return clock.GetLoopPolicy();
 }
 
 /**
+ * Runs the engine on the calling thread until stopped. After the
+ * deinitialize event the threads that join on shutdown are asked to
+ * stop and joined.
+ *
  * @see IEngine::Start()
+ * @see Thread::JoinAll()
  */
 void Engine::Start() {
     if (running) {
         logger.warning << "Ignoring start request - engine already running." << logger.end;
         return;
     }
-    initialize.Notify(InitializeEventArg());
+    Thread::SetCurrentName("oe-engine");
+    {
+        Profiler::Zone zone("Engine::Initialize");
+        initialize.Notify(InitializeEventArg());
+    }
     StartMainLoop();
-    deinitialize.Notify(DeinitializeEventArg());
+    {
+        Profiler::Zone zone("Engine::Deinitialize");
+        deinitialize.Notify(DeinitializeEventArg());
+    }
+    Thread::JoinAll();
+    Profiler::Collect();
 }
 
 /**
@@ -93,9 +109,14 @@ IEvent<InitializeEventArg>& Engine::InitializeEvent() {
 }
 
 /**
+ * The process event is a task graph event, so modules may declare
+ * dependencies and be processed in parallel when a task scheduler is
+ * set on it.
+ *
  * @see IEngine::ProcessEvent()
+ * @see TaskGraphEvent
  */
-IEvent<ProcessEventArg>& Engine::ProcessEvent() {
+TaskGraphEvent<ProcessEventArg>& Engine::ProcessEvent() {
     return process;
 }
 
@@ -13,6 +13,8 @@
 #include <Core/IEngine.h>
 #include <Core/IEvent.h>
 #include <Core/Event.h>
+#include <Core/TaskGraphEvent.h>
+#include <Core/FrameClock.h>
 
 namespace OpenEngine {
 namespace Core {
@@ -21,15 +23,18 @@ class Engine : public IEngine {
 private:
     bool running;
     Event<InitializeEventArg>   initialize;
-    Event<ProcessEventArg>      process;
+    TaskGraphEvent<ProcessEventArg> process;
     Event<DeinitializeEventArg> deinitialize;
+    FrameClock clock;
 public:
     Engine();
     virtual void Start();
     virtual void Stop();
     void StartMainLoop();
+    void SetLoopPolicy(const LoopPolicy& policy);
+    const LoopPolicy& GetLoopPolicy() const;
     virtual IEvent<InitializeEventArg>&   InitializeEvent();
-    virtual IEvent<ProcessEventArg>&      ProcessEvent();
+    virtual TaskGraphEvent<ProcessEventArg>& ProcessEvent();
     virtual IEvent<DeinitializeEventArg>& DeinitializeEvent();
 };
 
@@ -29,13 +29,24 @@ class DeinitializeEventArg { };
 
 /**
  * Engine process event argument.
+ * The delta time \a dt is the real duration of the previous loop, or
+ * the fixed step when the engine runs with a fixed time step. The \a
+ * alpha is the interpolation factor between the previous and the
+ * current simulation state, which is one unless a fixed time step
+ * leaves a remainder.
+ *
+ * @see LoopPolicy
  */
 class ProcessEventArg {
 public:
     Time start;                 //!< time of engine loop start.
     unsigned int approx;        //!< approximate engine loop time.
+    Time dt;                    //!< time step of this event.
+    float alpha;                //!< interpolation factor in [0,1].
     ProcessEventArg(Time start, unsigned long approx)
-        : start(start), approx(approx) {}
+        : start(start), approx(approx), dt(approx), alpha(1.0f) {}
+    ProcessEventArg(Time start, unsigned long approx, Time dt, float alpha)
+        : start(start), approx(approx), dt(dt), alpha(alpha) {}
 };
 
 } // NS Core
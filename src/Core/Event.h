@@ -12,37 +12,41 @@
 
 #include <Core/IEvent.h>
 #include <Core/IListener.h>
-#include <list>
+#include <Core/ListenerList.h>
 
 namespace OpenEngine {
 namespace Core {
 
-using std::list;
-
 /**
  * Basic Event.
  * This is a basic implementation of a event list. It maintains a list
  * of attached listeners and invokes their handlers immediately on
  * event notification.
+ *
+ * Listeners are stored contiguously and may attach or detach
+ * listeners, including themselves, while handling the event. When
+ * the listener type is known at compile time a TypedEvent avoids the
+ * virtual handler call and the argument copy per listener.
  * 
  * @class Event Event.h Core/Event.h
  * @tparam EventArg Argument type of the event.
  * @see Listener
+ * @see TypedEvent
  */
 template <typename EventArg>
 class Event : public IEvent<EventArg> {
 protected:
     //! list of listeners
-    list<IListener<EventArg>*> ls;
+    ListenerList<IListener<EventArg> > ls;
 
 public:
 
     virtual void Attach(IListener<EventArg>& listener) {
-        ls.push_back(&listener);
+        ls.Add(&listener);
     }
 
     virtual void Detach(IListener<EventArg>& listener) {
-        ls.remove(&listener);
+        ls.Remove(&listener);
     }
     
     /**
@@ -51,13 +55,15 @@ public:
      * attached listener.
      */
     virtual void Notify(EventArg arg) {
-        typename list<IListener<EventArg>*>::iterator itr;
-        for (itr=ls.begin(); itr != ls.end(); itr++)
-            (*itr)->Handle(arg);
+        typename ListenerList<IListener<EventArg> >::Dispatch d(ls);
+        for (unsigned int i = 0; i < d.Size(); i++) {
+            IListener<EventArg>* l = ls[i];
+            if (l != NULL) l->Handle(arg);
+        }
     }
 
     unsigned int Size() {
-        return ls.size();
+        return ls.Size();
     }
 
 };
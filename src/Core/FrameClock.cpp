@@ -0,0 +1,160 @@
+// Engine frame clock.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#include <Core/FrameClock.h>
+#include <Core/Thread.h>
+#include <Utils/Timer.h>
+#include <Utils/Clock.h>
+
+namespace OpenEngine {
+namespace Core {
+
+using OpenEngine::Utils::Timer;
+using OpenEngine::Utils::Clock;
+
+/**
+ * Create a free running frame clock.
+ */
+FrameClock::FrameClock() {
+    Reset();
+}
+
+/**
+ * Set the loop policy.
+ * Resets the clock.
+ */
+void FrameClock::SetLoopPolicy(const LoopPolicy& policy) {
+    this->policy = policy;
+    Reset();
+}
+
+/**
+ * Get the loop policy.
+ */
+const LoopPolicy& FrameClock::GetLoopPolicy() const {
+    return policy;
+}
+
+/**
+ * Restart the time accounting from now.
+ */
+void FrameClock::Reset() {
+    last = next = Now();
+    accumulator = 0;
+    elapsed = 0;
+    steps = 0;
+    start = Timer::GetTime();
+    // we initialize the approximate frame time to 50 milliseconds
+    index = 0;
+    for (unsigned int i = 0; i < count; i++) loops[i] = 50;
+}
+
+/**
+ * Advance the clock to the next frame.
+ * When \a wait is set the calling thread sleeps until the policy
+ * allows the next frame. An externally driven engine should not wait
+ * and must accept that no events are due on a given tick.
+ *
+ * @param wait Wait for the next frame.
+ * @return Number of process events to notify for this frame.
+ */
+unsigned int FrameClock::Advance(bool wait) {
+    uint64_t period = policy.period.AsInt64();
+    uint64_t now = Now();
+
+    if (wait && period > 0) {
+        if (policy.mode == LoopPolicy::TARGET_RATE)
+            now = WaitUntil(next);
+        else if (policy.mode == LoopPolicy::FIXED_TIMESTEP &&
+                 accumulator + (now - last) < period)
+            now = WaitUntil(last + period - accumulator);
+    }
+
+    elapsed = now - last;
+    last = now;
+    start = Timer::GetTime();
+    loops[index] = elapsed;
+    index = (index + 1) % count;
+
+    if (period == 0 || policy.mode == LoopPolicy::FREE_RUNNING) {
+        steps = 1;
+    }
+    else if (policy.mode == LoopPolicy::TARGET_RATE) {
+        if (now < next) {
+            steps = 0;
+        } else {
+            // keep the cadence unless we are too far behind
+            if (now - next > period * policy.maxCatchUp) next = now;
+            next += period;
+            steps = 1;
+        }
+    }
+    else {
+        accumulator += elapsed;
+        uint64_t max = period * (policy.maxCatchUp > 0 ? policy.maxCatchUp : 1);
+        if (accumulator > max) accumulator = max;
+        steps = accumulator / period;
+        accumulator -= steps * period;
+    }
+    return steps;
+}
+
+/**
+ * Get the process event argument for a step of the current frame.
+ * The delta time is the fixed step in fixed time step mode and the
+ * real frame time otherwise. The alpha is the fraction of a step
+ * left in the accumulator after the step and is clamped to one, so it
+ * is one on all but the last step of a catch up burst and always one
+ * when not in fixed time step mode.
+ *
+ * @param step Step index in [0, Advance()).
+ */
+ProcessEventArg FrameClock::GetProcessEventArg(unsigned int step) const {
+    unsigned int approx = 0;
+    for (unsigned int i = 0; i < count; i++)
+        approx += loops[i];
+    approx = approx / count;
+
+    if (policy.mode != LoopPolicy::FIXED_TIMESTEP || policy.period.IsZero())
+        return ProcessEventArg(start, approx,
+                               Time(elapsed / 1000000, elapsed % 1000000),
+                               1.0f);
+
+    uint64_t period = policy.period.AsInt64();
+    uint64_t left = accumulator + (steps - step - 1) * period;
+    float alpha = left >= period ? 1.0f : (float)left / (float)period;
+    return ProcessEventArg(start, approx, policy.period, alpha);
+}
+
+/**
+ * Sleep until the deadline, yielding for the last part to wake up
+ * close to it.
+ */
+uint64_t FrameClock::WaitUntil(uint64_t deadline) const {
+    uint64_t spin = policy.spin.AsInt64();
+    for (;;) {
+        uint64_t now = Now();
+        if (now >= deadline) return now;
+        uint64_t remaining = deadline - now;
+        if (remaining > spin)
+            Thread::Sleep(remaining - spin);
+        else
+            Thread::Yield();
+    }
+}
+
+/**
+ * Read the monotonic clock in microseconds.
+ */
+uint64_t FrameClock::Now() {
+    return Clock::Now().AsMicroseconds();
+}
+
+} // NS Core
+} // NS OpenEngine
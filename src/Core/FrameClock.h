@@ -0,0 +1,63 @@
+// Engine frame clock.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#ifndef _OE_FRAME_CLOCK_H_
+#define _OE_FRAME_CLOCK_H_
+
+#include <Core/LoopPolicy.h>
+#include <Core/EngineEvents.h>
+#include <Meta/Types.h>
+
+namespace OpenEngine {
+namespace Core {
+
+/**
+ * Engine frame clock.
+ * Keeps the time accounting of an engine loop according to a
+ * LoopPolicy. Each loop iteration calls Advance(), which waits as
+ * the policy requires and returns the number of process events to
+ * notify, and then obtains the event arguments with
+ * GetProcessEventArg().
+ *
+ * @class FrameClock FrameClock.h Core/FrameClock.h
+ * @see LoopPolicy
+ */
+class FrameClock {
+private:
+    LoopPolicy policy;
+    uint64_t last;          //!< start of the previous frame
+    uint64_t next;          //!< deadline of the next paced frame
+    uint64_t accumulator;   //!< unprocessed fixed step time
+    uint64_t elapsed;       //!< real duration of the previous frame
+    Time start;
+    unsigned int steps;
+
+    // rolling average for ProcessEventArg::approx
+    static const unsigned int count = 10;
+    unsigned int loops[count];
+    unsigned int index;
+
+    uint64_t WaitUntil(uint64_t deadline) const;
+    static uint64_t Now();
+
+public:
+    FrameClock();
+
+    void SetLoopPolicy(const LoopPolicy& policy);
+    const LoopPolicy& GetLoopPolicy() const;
+
+    void Reset();
+    unsigned int Advance(bool wait = true);
+    ProcessEventArg GetProcessEventArg(unsigned int step) const;
+};
+
+} // NS Core
+} // NS OpenEngine
+
+#endif // _OE_FRAME_CLOCK_H_
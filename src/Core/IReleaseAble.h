@@ -0,0 +1,37 @@
+// Releasable event interface.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#ifndef _OE_INTERFACE_RELEASE_ABLE_H_
+#define _OE_INTERFACE_RELEASE_ABLE_H_
+
+namespace OpenEngine {
+namespace Core {
+
+/**
+ * Releasable event interface.
+ * Implemented by events that hold back notifications until they are
+ * released, allowing a consumer to release a set of queued events of
+ * different argument types.
+ *
+ * @class IReleaseAble IReleaseAble.h Core/IReleaseAble.h
+ */
+class IReleaseAble {
+public:
+    virtual ~IReleaseAble() {}
+
+    /**
+     * Release all held back notifications to the listeners.
+     */
+    virtual void Release() = 0;
+};
+
+} // NS Core
+} // NS OpenEngine
+
+#endif // _OE_INTERFACE_RELEASE_ABLE_H_
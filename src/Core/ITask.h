@@ -0,0 +1,40 @@
+// Task interface.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#ifndef _OE_INTERFACE_TASK_H_
+#define _OE_INTERFACE_TASK_H_
+
+namespace OpenEngine {
+namespace Core {
+
+/**
+ * Task interface.
+ * A task is a unit of work that can be executed by a TaskScheduler
+ * on any of its worker threads. The task object is not owned by the
+ * scheduler and must outlive its execution.
+ *
+ * @class ITask ITask.h Core/ITask.h
+ * @see TaskScheduler
+ */
+class ITask {
+public:
+    virtual ~ITask() {};
+
+    /**
+     * Execute the task.
+     * Invoked exactly once per spawn, possibly on another thread than
+     * the one that spawned the task.
+     */
+    virtual void Run() = 0;
+};
+
+} // NS Core
+} // NS OpenEngine
+
+#endif // _OE_INTERFACE_TASK_H_
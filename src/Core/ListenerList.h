@@ -0,0 +1,118 @@
+// Listener list.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#ifndef _OE_LISTENER_LIST_H_
+#define _OE_LISTENER_LIST_H_
+
+#include <vector>
+#include <cstddef>
+
+namespace OpenEngine {
+namespace Core {
+
+/**
+ * Listener list.
+ * Contiguous storage of listener pointers for event implementations.
+ * Listeners may be added and removed while the list is being
+ * dispatched: a listener removed during dispatch leaves an empty
+ * (NULL) slot that is compacted away when the outermost dispatch
+ * ends, and a listener added during dispatch is not visited until
+ * the next dispatch.
+ *
+ * @code
+ * ListenerList<IListener<EventArg> > ls;
+ * ListenerList<IListener<EventArg> >::Dispatch d(ls);
+ * for (unsigned int i = 0; i < d.Size(); i++)
+ *     if (ls[i]) ls[i]->Handle(arg);
+ * @endcode
+ *
+ * @class ListenerList ListenerList.h Core/ListenerList.h
+ * @tparam Listener Listener type.
+ * @see Event
+ * @see TypedEvent
+ */
+template <typename Listener>
+class ListenerList {
+private:
+    std::vector<Listener*> ls;
+    unsigned int count;     //!< number of non empty slots
+    unsigned int depth;     //!< nesting of ongoing dispatches
+    bool holes;             //!< removed during dispatch
+
+    void Compact() {
+        unsigned int j = 0;
+        for (unsigned int i = 0; i < ls.size(); i++)
+            if (ls[i] != NULL) ls[j++] = ls[i];
+        ls.resize(j);
+        holes = false;
+    }
+
+public:
+
+    /**
+     * Scoped dispatch of a listener list.
+     * Defers compaction of the list until the dispatch is destroyed,
+     * also when a listener throws.
+     */
+    class Dispatch {
+    private:
+        ListenerList& list;
+        unsigned int size;
+    public:
+        Dispatch(ListenerList& list) : list(list), size(list.ls.size()) {
+            list.depth++;
+        }
+        ~Dispatch() {
+            if (--list.depth == 0 && list.holes) list.Compact();
+        }
+        //! number of slots to visit
+        unsigned int Size() const { return size; }
+    };
+
+    ListenerList() : count(0), depth(0), holes(false) {}
+
+    void Add(Listener* listener) {
+        ls.push_back(listener);
+        count++;
+    }
+
+    /**
+     * Remove all occurrences of \a listener.
+     */
+    void Remove(Listener* listener) {
+        unsigned int j = 0;
+        for (unsigned int i = 0; i < ls.size(); i++) {
+            if (ls[i] == listener) {
+                count--;
+                if (depth > 0) {
+                    ls[i] = NULL;
+                    holes = true;
+                }
+                continue;
+            }
+            if (depth == 0) ls[j++] = ls[i];
+        }
+        if (depth == 0) ls.resize(j);
+    }
+
+    //! Listener in slot \a i, may be NULL during dispatch.
+    Listener* operator[](unsigned int i) const {
+        return ls[i];
+    }
+
+    //! Number of listeners in the list.
+    unsigned int Size() const {
+        return count;
+    }
+};
+
+} // NS Core
+} // NS OpenEngine
+
+#endif // _OE_LISTENER_LIST_H_
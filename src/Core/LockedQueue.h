@@ -6,6 +6,11 @@
 
 using OpenEngine::Core::Mutex;
 
+/**
+ * Mutex protected unbounded queue.
+ * For a bounded allocation-free alternative with a single consumer
+ * see OpenEngine::Core::ConcurrentQueue.
+ */
 template <class T> class LockedQueue {
 
 
@@ -24,7 +29,10 @@ public:
     }    
 
     bool IsEmpty() {
-        return _queue.empty(); // hopefully atomic.
+        m.Lock();
+        bool empty = _queue.empty();
+        m.Unlock();
+        return empty;
     }
     
     T Get() {
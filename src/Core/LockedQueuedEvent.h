@@ -13,6 +13,7 @@
 #include <Core/IEvent.h>
 #include <Core/IListener.h>
 #include <Core/Mutex.h>
+#include <Core/IReleaseAble.h>
 #include <list>
 
 namespace OpenEngine {
@@ -21,24 +22,18 @@ namespace Core {
 using std::list;
 
 /**
- * Queued Event.
- * A queued event maintains a list of attached listeners and queued
- * events that have been sent. On release the queued events are sent
- * to the listener handlers. Sending of events happens in order and
- * all listeners will have received the first event before the next is
- * processed. Queued event implements the IListener interface in order
- * to chain event together.
+ * Locked Queued Event.
+ * A queued event that may be notified from several threads. Every
+ * notification takes a lock and allocates a list entry; prefer the
+ * lock-free ConcurrentQueuedEvent unless the queue must be unbounded.
+ * The queued events are swapped out under the lock before they are
+ * released, so notifying threads are not blocked during dispatch.
  *
- * @class QueuedEvent QueuedEvent.h Core/QueuedEvent.h
+ * @class LockedQueuedEvent LockedQueuedEvent.h Core/LockedQueuedEvent.h
  * @tparam EventArg Argument type of the event.
- * @see IListener
+ * @see QueuedEvent
+ * @see ConcurrentQueuedEvent
  */
-    
-    class IReleaseAble {
-    public:
-        virtual void Release() =0;
-    };
-
 template <typename EventArg>
 class LockedQueuedEvent : public IEvent<EventArg>, public IListener<EventArg>, public IReleaseAble {
 protected:
@@ -80,14 +75,16 @@ public:
      * This will empty the event queue.
      */
     void Release() {
+        list<EventArg> events;
         lock.Lock();
+        events.swap(eq);
+        list<IListener<EventArg>*> listeners(ls);
+        lock.Unlock();
         typename list<EventArg>::iterator e;
         typename list<IListener<EventArg>*>::iterator l;
-        for (e = eq.begin(); e != eq.end(); e++)
-            for (l = ls.begin(); l != ls.end(); l++)
+        for (e = events.begin(); e != events.end(); e++)
+            for (l = listeners.begin(); l != listeners.end(); l++)
                 (*l)->Handle(*e);
-        eq.clear();
-        lock.Unlock();
     }
 
     virtual void Handle(EventArg arg) {
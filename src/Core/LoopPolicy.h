@@ -0,0 +1,97 @@
+// Engine loop policy.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#ifndef _OE_LOOP_POLICY_H_
+#define _OE_LOOP_POLICY_H_
+
+#include <Core/Exceptions.h>
+#include <Utils/Timer.h>
+
+namespace OpenEngine {
+namespace Core {
+
+using OpenEngine::Utils::Time;
+
+/**
+ * Engine loop policy.
+ * Describes how an engine paces its process events.
+ *
+ * - \a FREE_RUNNING processes one event per loop as fast as
+ *   possible. This is the default and matches the original engine.
+ * - \a TARGET_RATE processes one event per period and sleeps until
+ *   the next period starts instead of spinning.
+ * - \a FIXED_TIMESTEP accumulates the real elapsed time and processes
+ *   one event per whole step in the accumulator, each with a delta
+ *   time of exactly one step. The remainder is reported as the
+ *   interpolation alpha.
+ *
+ * In both paced modes the engine falls at most \a maxCatchUp periods
+ * behind; any further lag is dropped instead of processed in a burst.
+ *
+ * @code
+ * engine.SetLoopPolicy(LoopPolicy::FixedTimestep(Time(16667)));
+ * @endcode
+ *
+ * @class LoopPolicy LoopPolicy.h Core/LoopPolicy.h
+ * @see FrameClock
+ */
+class LoopPolicy {
+public:
+    enum Mode { FREE_RUNNING, TARGET_RATE, FIXED_TIMESTEP };
+
+    Mode mode;                  //!< pacing mode.
+    Time period;                //!< frame period or fixed step.
+    unsigned int maxCatchUp;    //!< max number of periods to catch up.
+    Time spin;                  //!< time to yield rather than sleep.
+
+    /**
+     * Free running policy.
+     */
+    LoopPolicy()
+        : mode(FREE_RUNNING)
+        , period(0, 0)
+        , maxCatchUp(0)
+        , spin(1000) {}
+
+    /**
+     * Paced policy.
+     *
+     * @param mode Pacing mode.
+     * @param period Frame period or fixed step length.
+     * @param maxCatchUp Maximal number of periods to catch up.
+     */
+    LoopPolicy(Mode mode, Time period, unsigned int maxCatchUp)
+        : mode(mode)
+        , period(period)
+        , maxCatchUp(maxCatchUp)
+        , spin(1000) {}
+
+    /**
+     * Policy processing at most \a hz events per second.
+     *
+     * @throws InvalidArgument if \a hz is zero.
+     */
+    static LoopPolicy TargetRate(unsigned int hz, unsigned int maxCatchUp = 1) {
+        if (hz == 0)
+            throw InvalidArgument("Target rate must be positive");
+        return LoopPolicy(TARGET_RATE, Time(1000000 / hz), maxCatchUp);
+    }
+
+    /**
+     * Policy processing events with a fixed delta time of \a step.
+     */
+    static LoopPolicy FixedTimestep(Time step, unsigned int maxCatchUp = 5) {
+        return LoopPolicy(FIXED_TIMESTEP, step, maxCatchUp);
+    }
+};
+
+} // NS Core
+} // NS OpenEngine
+
+#endif // _OE_LOOP_POLICY_H_
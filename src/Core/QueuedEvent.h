@@ -12,12 +12,13 @@
 
 #include <Core/IEvent.h>
 #include <Core/IListener.h>
-#include <list>
+#include <Core/ListenerList.h>
+#include <vector>
 
 namespace OpenEngine {
 namespace Core {
 
-using std::list;
+using std::vector;
 
 /**
  * Queued Event.
@@ -27,6 +28,10 @@ using std::list;
  * all listeners will have received the first event before the next is
  * processed. Queued event implements the IListener interface in order
  * to chain event together.
+ *
+ * The queue storage is reused between releases, so a queued event
+ * does not allocate once it has grown to its working size. Events
+ * notified while releasing are kept for the next release.
  * 
  * @class QueuedEvent QueuedEvent.h Core/QueuedEvent.h
  * @tparam EventArg Argument type of the event.
@@ -36,19 +41,22 @@ template <typename EventArg>
 class QueuedEvent : public IEvent<EventArg>, public IListener<EventArg> {
 protected:
     //! list of listeners
-    list<IListener<EventArg>*> ls;
+    ListenerList<IListener<EventArg> > ls;
 
     //! event queue
-    list<EventArg> eq;
+    vector<EventArg> eq;
+
+    //! events being released
+    vector<EventArg> released;
 
 public:
 
     virtual void Attach(IListener<EventArg>& listener) {
-        ls.push_back(&listener);
+        ls.Add(&listener);
     }
 
     virtual void Detach(IListener<EventArg>& listener) {
-        ls.remove(&listener);
+        ls.Remove(&listener);
     }
     
     /**
@@ -64,12 +72,14 @@ public:
      * This will empty the event queue.
      */
     void Release() {
-        typename list<EventArg>::iterator e;
-        typename list<IListener<EventArg>*>::iterator l;
-        for (e = eq.begin(); e != eq.end(); e++)
-            for (l = ls.begin(); l != ls.end(); l++)
-                (*l)->Handle(*e);
-        eq.clear();
+        released.swap(eq);
+        typename ListenerList<IListener<EventArg> >::Dispatch d(ls);
+        for (unsigned int e = 0; e < released.size(); e++)
+            for (unsigned int i = 0; i < d.Size(); i++) {
+                IListener<EventArg>* l = ls[i];
+                if (l != NULL) l->Handle(released[e]);
+            }
+        released.clear();
     }
 
     virtual void Handle(EventArg arg) {
@@ -77,7 +87,7 @@ public:
     }
 
     virtual unsigned int Size() {
-        return ls.size();
+        return ls.Size();
     }
 
 };
@@ -0,0 +1,329 @@
+// Task graph event.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#ifndef _OE_TASK_GRAPH_EVENT_H_
+#define _OE_TASK_GRAPH_EVENT_H_
+
+#include <Core/IEvent.h>
+#include <Core/IListener.h>
+#include <Core/ITask.h>
+#include <Core/Atomic.h>
+#include <Core/Mutex.h>
+#include <Core/TaskScheduler.h>
+#include <Core/Exceptions.h>
+
+#include <vector>
+#include <string>
+
+namespace OpenEngine {
+namespace Core {
+
+using std::vector;
+
+/**
+ * Task graph event.
+ * An event where the attached listeners form a dependency graph.
+ * On notification each listener is handled as a task on a
+ * TaskScheduler as soon as all the listeners it depends on have
+ * completed, so independent listeners are handled in parallel.
+ *
+ * Listeners attached with Attach() depend on the listener attached
+ * immediately before them, which gives the same sequential order as
+ * the basic Event. Listeners attached with AttachParallel() have no
+ * implicit dependencies and must declare their ordering constraints
+ * with AddDependency().
+ *
+ * Without a scheduler, or with a scheduler without workers, the
+ * listeners are handled on the notifying thread in a topological
+ * order of the graph.
+ *
+ * Listeners may not attach or detach listeners on the event they are
+ * handling. If a listener throws during a parallel notification, the
+ * remaining graph still completes and a Core::Exception with the
+ * first error message is thrown from Notify.
+ *
+ * @code
+ * TaskGraphEvent<ProcessEventArg>& e = engine.ProcessEvent();
+ * e.AttachParallel(physics);
+ * e.AttachParallel(audio);
+ * e.AttachParallel(renderer);
+ * e.AddDependency(renderer, physics); // physics before renderer
+ * e.SetTaskScheduler(&scheduler);
+ * @endcode
+ *
+ * @class TaskGraphEvent TaskGraphEvent.h Core/TaskGraphEvent.h
+ * @tparam EventArg Argument type of the event.
+ * @see TaskScheduler
+ */
+template <typename EventArg>
+class TaskGraphEvent : public IEvent<EventArg> {
+private:
+    struct Node {
+        IListener<EventArg>* listener;
+        vector<unsigned int> successors;
+        unsigned int dependencies;
+        volatile int pending;
+    };
+
+    class NodeTask : public ITask {
+    public:
+        TaskGraphEvent* event;
+        unsigned int node;
+        void Run() { event->RunNode(node); }
+    };
+
+    vector<Node> nodes;
+    vector<NodeTask> tasks;
+    vector<unsigned int> order;     //!< cached topological order
+    bool ordered;
+    TaskScheduler* scheduler;
+
+    // state of the current notification
+    EventArg* arg;
+    TaskGroup* group;
+    bool failed;
+    std::string error;
+    Mutex errorLock;
+
+    int Find(IListener<EventArg>& listener) {
+        for (unsigned int i = 0; i < nodes.size(); i++)
+            if (nodes[i].listener == &listener) return i;
+        return -1;
+    }
+
+    void AddEdge(unsigned int from, unsigned int to) {
+        vector<unsigned int>& s = nodes[from].successors;
+        for (unsigned int i = 0; i < s.size(); i++)
+            if (s[i] == to) return;
+        s.push_back(to);
+        nodes[to].dependencies++;
+        ordered = false;
+    }
+
+    void RemoveEdge(unsigned int from, unsigned int to) {
+        vector<unsigned int>& s = nodes[from].successors;
+        for (unsigned int i = 0; i < s.size(); i++)
+            if (s[i] == to) {
+                s.erase(s.begin() + i);
+                nodes[to].dependencies--;
+                ordered = false;
+                return;
+            }
+    }
+
+    /**
+     * Compute a topological order, preferring attachment order.
+     * @return False if the graph contains a cycle.
+     */
+    bool Order() {
+        if (ordered) return true;
+        unsigned int n = nodes.size();
+        vector<unsigned int> deps(n);
+        order.clear();
+        for (unsigned int i = 0; i < n; i++)
+            deps[i] = nodes[i].dependencies;
+        vector<bool> done(n, false);
+        while (order.size() < n) {
+            unsigned int i = 0;
+            while (i < n && (done[i] || deps[i] > 0)) i++;
+            if (i == n) return false;
+            done[i] = true;
+            order.push_back(i);
+            for (unsigned int j = 0; j < nodes[i].successors.size(); j++)
+                deps[nodes[i].successors[j]]--;
+        }
+        ordered = true;
+        return true;
+    }
+
+    void Handle(unsigned int node) {
+        try {
+            nodes[node].listener->Handle(*arg);
+        } catch (std::exception& e) {
+            Fail(e.what());
+        } catch (...) {
+            Fail("Unknown exception in task graph listener.");
+        }
+    }
+
+    void Fail(std::string msg) {
+        errorLock.Lock();
+        if (!failed) {
+            failed = true;
+            error = msg;
+        }
+        errorLock.Unlock();
+    }
+
+    void RunNode(unsigned int node) {
+        Handle(node);
+        vector<unsigned int>& s = nodes[node].successors;
+        for (unsigned int i = 0; i < s.size(); i++)
+            if (AtomicAdd(nodes[s[i]].pending, -1) == 0)
+                scheduler->Spawn(tasks[s[i]], *group);
+    }
+
+    void NotifySequential() {
+        for (unsigned int i = 0; i < order.size(); i++)
+            nodes[order[i]].listener->Handle(*arg);
+    }
+
+    void NotifyParallel() {
+        TaskGroup g;
+        group = &g;
+        unsigned int n = nodes.size();
+        tasks.resize(n);
+        for (unsigned int i = 0; i < n; i++) {
+            nodes[i].pending = nodes[i].dependencies;
+            tasks[i].event = this;
+            tasks[i].node = i;
+        }
+        MemoryBarrier();
+        for (unsigned int i = 0; i < n; i++)
+            if (nodes[i].dependencies == 0)
+                scheduler->Spawn(tasks[i], g);
+        scheduler->Wait(g);
+        group = NULL;
+    }
+
+public:
+
+    TaskGraphEvent()
+        : ordered(true), scheduler(NULL), arg(NULL), group(NULL), failed(false) {}
+
+    /**
+     * Attach a listener after the most recently attached listener.
+     * Preserves the sequential semantics of the basic Event.
+     */
+    virtual void Attach(IListener<EventArg>& listener) {
+        unsigned int prev = nodes.size();
+        AttachParallel(listener);
+        if (prev > 0) AddEdge(prev - 1, prev);
+    }
+
+    /**
+     * Attach a listener without any dependencies.
+     * Ordering constraints must be declared with AddDependency().
+     */
+    void AttachParallel(IListener<EventArg>& listener) {
+        Node node;
+        node.listener = &listener;
+        node.dependencies = 0;
+        node.pending = 0;
+        nodes.push_back(node);
+        ordered = false;
+    }
+
+    /**
+     * Detach a listener.
+     * The ordering constraints through the listener are kept, so
+     * listeners it depended on still precede its dependents.
+     */
+    virtual void Detach(IListener<EventArg>& listener) {
+        int idx = Find(listener);
+        if (idx < 0) return;
+        unsigned int n = idx;
+        vector<unsigned int> preds;
+        for (unsigned int i = 0; i < nodes.size(); i++)
+            for (unsigned int j = 0; j < nodes[i].successors.size(); j++)
+                if (nodes[i].successors[j] == n) preds.push_back(i);
+        vector<unsigned int> succs = nodes[n].successors;
+        for (unsigned int i = 0; i < preds.size(); i++) {
+            RemoveEdge(preds[i], n);
+            for (unsigned int j = 0; j < succs.size(); j++)
+                AddEdge(preds[i], succs[j]);
+        }
+        for (unsigned int j = 0; j < succs.size(); j++)
+            RemoveEdge(n, succs[j]);
+        // remove the node and renumber the edges
+        nodes.erase(nodes.begin() + n);
+        for (unsigned int i = 0; i < nodes.size(); i++)
+            for (unsigned int j = 0; j < nodes[i].successors.size(); j++)
+                if (nodes[i].successors[j] > n) nodes[i].successors[j]--;
+        ordered = false;
+    }
+
+    /**
+     * Declare that \a listener must be handled after \a dependency.
+     * Both listeners must be attached.
+     *
+     * @throws InvalidArgument if a listener is not attached or the
+     *         dependency would create a cycle.
+     */
+    void AddDependency(IListener<EventArg>& listener,
+                       IListener<EventArg>& dependency) {
+        int to = Find(listener), from = Find(dependency);
+        if (to < 0 || from < 0)
+            throw InvalidArgument("Dependency between unattached listeners.");
+        if (to == from)
+            throw InvalidArgument("Listener can not depend on itself.");
+        bool existed = false;
+        for (unsigned int i = 0; i < nodes[from].successors.size(); i++)
+            if (nodes[from].successors[i] == (unsigned int)to) existed = true;
+        if (existed) return;
+        AddEdge(from, to);
+        if (!Order()) {
+            RemoveEdge(from, to);
+            throw InvalidArgument("Dependency creates a cycle.");
+        }
+    }
+
+    /**
+     * Remove a declared dependency.
+     */
+    void RemoveDependency(IListener<EventArg>& listener,
+                          IListener<EventArg>& dependency) {
+        int to = Find(listener), from = Find(dependency);
+        if (to < 0 || from < 0) return;
+        RemoveEdge(from, to);
+    }
+
+    /**
+     * Set the scheduler used to handle listeners in parallel.
+     *
+     * @param s Scheduler or NULL for sequential notification.
+     */
+    void SetTaskScheduler(TaskScheduler* s) {
+        scheduler = s;
+    }
+
+    TaskScheduler* GetTaskScheduler() {
+        return scheduler;
+    }
+
+    /**
+     * Notify all listeners.
+     * Returns when every listener has handled the event.
+     *
+     * @throws Exception if a listener threw an exception.
+     */
+    virtual void Notify(EventArg a) {
+        if (nodes.empty()) return;
+        Order();
+        arg = &a;
+        failed = false;
+        if (scheduler == NULL || nodes.size() == 1 ||
+            (scheduler->GetWorkerCount() == 0 || !scheduler->IsRunning()))
+            NotifySequential();
+        else
+            NotifyParallel();
+        arg = NULL;
+        if (failed) throw Exception(error);
+    }
+
+    virtual unsigned int Size() {
+        return nodes.size();
+    }
+
+};
+
+} // NS Core
+} // NS OpenEngine
+
+#endif // _OE_TASK_GRAPH_EVENT_H_
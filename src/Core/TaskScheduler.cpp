@@ -0,0 +1,253 @@
+// Work stealing task scheduler.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#include <Core/TaskScheduler.h>
+#include <Core/Atomic.h>
+
+#include <sched.h>
+#include <unistd.h>
+#include <sstream>
+
+namespace OpenEngine {
+namespace Core {
+
+// number of failed job searches before an idle worker blocks
+static const unsigned int spinLimit = 64;
+
+/**
+ * Create a task scheduler.
+ * The worker threads are not started until Start() is called.
+ *
+ * @param workers Number of worker threads. The default is one less
+ *                than the number of processors, leaving a processor
+ *                for the thread that waits on tasks.
+ */
+TaskScheduler::TaskScheduler(unsigned int workers)
+    : count(workers)
+    , running(false)
+    , injectedCount(0)
+    , queued(0)
+    , sleepers(0) {
+    pthread_mutex_init(&sleepLock, NULL);
+    pthread_cond_init(&sleepCond, NULL);
+    pthread_key_create(&current, NULL);
+}
+
+/**
+ * Stops the workers before destruction.
+ */
+TaskScheduler::~TaskScheduler() {
+    Stop();
+    pthread_key_delete(current);
+    pthread_cond_destroy(&sleepCond);
+    pthread_mutex_destroy(&sleepLock);
+}
+
+TaskScheduler::Worker::Worker(TaskScheduler& scheduler, unsigned int index)
+    : scheduler(scheduler), index(index) {
+    std::ostringstream name;
+    name << "oe-worker-" << index;
+    SetName(name.str());
+    SetJoinOnShutdown(true);
+}
+
+/**
+ * Start the worker threads.
+ * Calls to Start() on a running scheduler are ignored.
+ */
+void TaskScheduler::Start() {
+    if (running) return;
+    // reclaim workers stopped by Thread::JoinAll
+    Stop();
+    running = true;
+    for (unsigned int i = 0; i < count; i++)
+        workers.push_back(new Worker(*this, i));
+    for (unsigned int i = 0; i < count; i++)
+        workers[i]->Start();
+}
+
+/**
+ * Stop and join the worker threads.
+ * Tasks that are still queued will be executed by threads waiting
+ * for their group.
+ */
+void TaskScheduler::Stop() {
+    Shutdown();
+    for (unsigned int i = 0; i < workers.size(); i++) {
+        workers[i]->Wait();
+        // move left over jobs to the injection queue
+        Job job;
+        while (workers[i]->queue.Pop(job)) {
+            injectedLock.Lock();
+            injected.push_back(job);
+            injectedCount++;
+            injectedLock.Unlock();
+        }
+        delete workers[i];
+    }
+    workers.clear();
+}
+
+/**
+ * Spawn a task.
+ * The task is queued for execution on some worker and accounted in
+ * \a group until it has completed.
+ *
+ * @param task Task to execute.
+ * @param group Group the task belongs to.
+ */
+void TaskScheduler::Spawn(ITask& task, TaskGroup& group) {
+    Job job;
+    job.task = &task;
+    job.group = &group;
+    AtomicAdd(group.pending, 1);
+    // count the job before it becomes visible so queued never drops
+    // below zero
+    AtomicAdd(queued, 1);
+    Worker* self = (Worker*)pthread_getspecific(current);
+    if (self == NULL) {
+        injectedLock.Lock();
+        injected.push_back(job);
+        injectedCount++;
+        injectedLock.Unlock();
+    } else if (!self->queue.Push(job)) {
+        // our own queue is full, run it right away
+        AtomicAdd(queued, -1);
+        Execute(job);
+        return;
+    }
+    if (sleepers > 0) Wake();
+}
+
+/**
+ * Wait for all tasks in a group to complete.
+ * The calling thread executes queued tasks while waiting.
+ *
+ * @param group Group to wait for.
+ */
+void TaskScheduler::Wait(TaskGroup& group) {
+    Worker* self = (Worker*)pthread_getspecific(current);
+    Job job;
+    while (group.pending > 0) {
+        if (FindJob(self, job))
+            Execute(job);
+        else
+            sched_yield();
+    }
+    MemoryBarrier();
+}
+
+/**
+ * Get the number of worker threads.
+ */
+unsigned int TaskScheduler::GetWorkerCount() const {
+    return count;
+}
+
+/**
+ * Check if the worker threads are running.
+ */
+bool TaskScheduler::IsRunning() const {
+    return running;
+}
+
+/**
+ * Number of processors available to the process.
+ * Always at least one.
+ */
+unsigned int TaskScheduler::HardwareConcurrency() {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? n : 1;
+}
+
+void TaskScheduler::WorkerLoop(Worker& self) {
+    pthread_setspecific(current, &self);
+    unsigned int spins = 0;
+    Job job;
+    while (running) {
+        if (FindJob(&self, job)) {
+            Execute(job);
+            spins = 0;
+            continue;
+        }
+        if (++spins < spinLimit) {
+            sched_yield();
+            continue;
+        }
+        // block until a job is spawned or we are stopped
+        pthread_mutex_lock(&sleepLock);
+        AtomicAdd(sleepers, 1);
+        while (running && queued == 0)
+            pthread_cond_wait(&sleepCond, &sleepLock);
+        AtomicAdd(sleepers, -1);
+        pthread_mutex_unlock(&sleepLock);
+        spins = 0;
+    }
+    pthread_setspecific(current, NULL);
+}
+
+bool TaskScheduler::FindJob(Worker* self, Job& job) {
+    // own queue first (most recently spawned, likely in cache)
+    if (self != NULL && self->queue.Pop(job)) {
+        AtomicAdd(queued, -1);
+        return true;
+    }
+    // then jobs from outside the pool
+    if (injectedCount > 0) {
+        bool found = false;
+        injectedLock.Lock();
+        if (!injected.empty()) {
+            job = injected.front();
+            injected.pop_front();
+            injectedCount--;
+            found = true;
+        }
+        injectedLock.Unlock();
+        if (found) {
+            AtomicAdd(queued, -1);
+            return true;
+        }
+    }
+    // finally steal from the other workers, starting at our neighbour
+    unsigned int n = workers.size();
+    unsigned int start = self != NULL ? self->index + 1 : 0;
+    for (unsigned int i = 0; i < n; i++) {
+        Worker* victim = workers[(start + i) % n];
+        if (victim == self) continue;
+        if (victim->queue.Steal(job)) {
+            AtomicAdd(queued, -1);
+            return true;
+        }
+    }
+    return false;
+}
+
+void TaskScheduler::Execute(Job& job) {
+    TaskGroup* group = job.group;
+    job.task->Run();
+    // the group may be released by its waiter once this hits zero
+    AtomicAdd(group->pending, -1);
+}
+
+void TaskScheduler::Wake() {
+    pthread_mutex_lock(&sleepLock);
+    pthread_cond_signal(&sleepCond);
+    pthread_mutex_unlock(&sleepLock);
+}
+
+// Make the workers leave their loop without joining them.
+void TaskScheduler::Shutdown() {
+    pthread_mutex_lock(&sleepLock);
+    running = false;
+    pthread_cond_broadcast(&sleepCond);
+    pthread_mutex_unlock(&sleepLock);
+}
+
+} // NS Core
+} // NS OpenEngine
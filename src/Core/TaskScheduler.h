@@ -0,0 +1,139 @@
+// Work stealing task scheduler.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#ifndef _OE_TASK_SCHEDULER_H_
+#define _OE_TASK_SCHEDULER_H_
+
+#include <Core/ITask.h>
+#include <Core/Thread.h>
+#include <Core/Mutex.h>
+#include <Core/WorkStealingQueue.h>
+
+#include <pthread.h>
+#include <deque>
+#include <vector>
+
+namespace OpenEngine {
+namespace Core {
+
+/**
+ * Task group.
+ * Counts the tasks spawned into it that have not yet completed.
+ * A thread can wait for the group with TaskScheduler::Wait.
+ *
+ * @class TaskGroup TaskScheduler.h Core/TaskScheduler.h
+ */
+class TaskGroup {
+private:
+    friend class TaskScheduler;
+    volatile int pending;
+    TaskGroup(const TaskGroup&);
+    TaskGroup& operator=(const TaskGroup&);
+public:
+    TaskGroup() : pending(0) {}
+
+    /**
+     * Check if all tasks spawned into the group have completed.
+     */
+    bool IsDone() const { return pending == 0; }
+};
+
+/**
+ * Work stealing task scheduler.
+ * The scheduler owns a pool of worker threads each with its own
+ * WorkStealingQueue. Tasks spawned from a worker are pushed onto its
+ * own queue and idle workers steal from the others. Tasks spawned
+ * from any other thread are placed in a shared injection queue.
+ *
+ * A thread waiting for a TaskGroup helps executing tasks until the
+ * group completes, so a scheduler with zero workers is valid and
+ * simply executes all tasks on the waiting thread.
+ *
+ * Idle workers spin briefly and then block until new tasks arrive,
+ * so an idle scheduler does not consume processor time.
+ *
+ * @code
+ * TaskScheduler scheduler;   // one worker per additional core
+ * scheduler.Start();
+ * TaskGroup group;
+ * scheduler.Spawn(task1, group);
+ * scheduler.Spawn(task2, group);
+ * scheduler.Wait(group);     // task1 and task2 have now completed
+ * @endcode
+ *
+ * @class TaskScheduler TaskScheduler.h Core/TaskScheduler.h
+ * @see ITask
+ * @see TaskGraphEvent
+ */
+class TaskScheduler {
+private:
+    struct Job {
+        ITask* task;
+        TaskGroup* group;
+    };
+
+    class Worker : public Thread {
+    public:
+        TaskScheduler& scheduler;
+        unsigned int index;
+        WorkStealingQueue<Job> queue;
+        Worker(TaskScheduler& scheduler, unsigned int index);
+        void Run() { scheduler.WorkerLoop(*this); }
+        void RequestStop() { scheduler.Shutdown(); }
+    };
+
+    std::vector<Worker*> workers;
+    unsigned int count;
+    volatile bool running;
+
+    //! tasks spawned from threads outside the pool
+    std::deque<Job> injected;
+    volatile int injectedCount;
+    Mutex injectedLock;
+
+    //! number of queued tasks not yet picked up
+    volatile int queued;
+
+    //! idle worker synchronization
+    volatile int sleepers;
+    pthread_mutex_t sleepLock;
+    pthread_cond_t sleepCond;
+
+    //! maps a worker thread to its Worker object
+    pthread_key_t current;
+
+    TaskScheduler(const TaskScheduler&);
+    TaskScheduler& operator=(const TaskScheduler&);
+
+    void WorkerLoop(Worker& self);
+    bool FindJob(Worker* self, Job& job);
+    void Execute(Job& job);
+    void Wake();
+    void Shutdown();
+
+public:
+    TaskScheduler(unsigned int workers = HardwareConcurrency() - 1);
+    ~TaskScheduler();
+
+    void Start();
+    void Stop();
+
+    void Spawn(ITask& task, TaskGroup& group);
+    void Wait(TaskGroup& group);
+
+    unsigned int GetWorkerCount() const;
+    bool IsRunning() const;
+
+    static unsigned int HardwareConcurrency();
+};
+
+} // NS Core
+} // NS OpenEngine
+
+#endif // _OE_TASK_SCHEDULER_H_
@@ -8,27 +8,300 @@
  */
 
 #include "Thread.h"
+#include <Core/Mutex.h>
+#include <Core/ThreadStorage.h>
 #include <unistd.h>
+#include <sched.h>
+#if defined(__linux__)
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#endif
 
 namespace OpenEngine {
 namespace Core {
 
+// threads started and not yet joined
+static std::vector<Thread*> registry;
+static Mutex registryLock;
 
-int Thread::Start() {
-    
-    return pthread_create(&thread, NULL, Thread::thread_func, (void*)this);
+// nice values of the priority hints
+static const int niceness[] = { 10, 0, -5 };
+
+Thread::Thread()
+    : priority(PRIORITY_NORMAL), state(CREATED), stopRequested(false)
+    , joinOnShutdown(false) {}
+
+Thread::Thread(const std::string& name)
+    : name(name), priority(PRIORITY_NORMAL), state(CREATED), stopRequested(false)
+    , joinOnShutdown(false) {}
+
+/**
+ * A thread must be joined before it is destroyed. The destructor only
+ * removes a thread that was never joined from the registry, after
+ * waiting for JoinAll() to finish joining it.
+ */
+Thread::~Thread() {
+    registryLock.Lock();
+    while (state == JOINING) {
+        registryLock.Unlock();
+        Yield();
+        registryLock.Lock();
+    }
+    for (unsigned int i = 0; i < registry.size(); i++)
+        if (registry[i] == this) {
+            registry.erase(registry.begin() + i);
+            break;
+        }
+    registryLock.Unlock();
+}
+
+void* Thread::thread_func(void *d) {
+    Thread* t = (Thread*)d;
+    t->ApplyName();
+    t->ApplyAffinity();
+    t->ApplyPriority();
+    t->Run();
+    return 0;
+}
 
+/**
+ * Start the thread and add it to the registry.
+ *
+ * @return Zero on success, otherwise a pthread error code.
+ */
+int Thread::Start() {
+    registryLock.Lock();
+    state = RUNNING;
+    stopRequested = false;
+    registry.push_back(this);
+    registryLock.Unlock();
+    int err = pthread_create(&thread, NULL, Thread::thread_func, (void*)this);
+    if (err != 0) {
+        registryLock.Lock();
+        state = CREATED;
+        registry.pop_back();
+        registryLock.Unlock();
+    }
+    return err;
 }
 
+/**
+ * Wait for the thread to finish and remove it from the registry.
+ * Waiting on a thread that is not running, or that has already been
+ * joined, returns immediately.
+ *
+ * @return Zero on success, otherwise a pthread error code.
+ */
 int Thread::Wait() {
-    return pthread_join(thread, NULL);
-    
+    registryLock.Lock();
+    while (state == JOINING) {
+        registryLock.Unlock();
+        Yield();
+        registryLock.Lock();
+    }
+    if (state != RUNNING) {
+        registryLock.Unlock();
+        return 0;
+    }
+    state = JOINING;
+    registryLock.Unlock();
+
+    int err = pthread_join(thread, NULL);
+
+    registryLock.Lock();
+    state = JOINED;
+    for (unsigned int i = 0; i < registry.size(); i++)
+        if (registry[i] == this) {
+            registry.erase(registry.begin() + i);
+            break;
+        }
+    registryLock.Unlock();
+    return err;
+}
+
+/**
+ * Set the thread name.
+ * Operating systems may truncate the name, Linux keeps 15 characters.
+ */
+void Thread::SetName(const std::string& name) {
+    this->name = name;
+}
+
+const std::string& Thread::GetName() const {
+    return name;
+}
+
+/**
+ * Hint that the thread should run on a single processor.
+ *
+ * @param cpu Processor index.
+ */
+void Thread::SetAffinity(unsigned int cpu) {
+    SetAffinity(std::vector<unsigned int>(1, cpu));
 }
 
+/**
+ * Hint that the thread should run on a set of processors. An empty
+ * set allows all processors. Takes effect immediately when the thread
+ * is running. Ignored on platforms without affinity support.
+ *
+ * @param cpus Processor indices.
+ */
+void Thread::SetAffinity(const std::vector<unsigned int>& cpus) {
+    affinity = cpus;
+#if defined(__linux__)
+    if (state != RUNNING) return;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (unsigned int i = 0; i < affinity.size(); i++)
+        CPU_SET(affinity[i], &set);
+    if (affinity.empty())
+        for (long i = 0; i < sysconf(_SC_NPROCESSORS_ONLN); i++)
+            CPU_SET(i, &set);
+    pthread_setaffinity_np(thread, sizeof(set), &set);
+#endif
+}
+
+/**
+ * Hint the scheduling priority of the thread. Applied when the thread
+ * starts.
+ */
+void Thread::SetPriority(Priority priority) {
+    this->priority = priority;
+}
+
+Thread::Priority Thread::GetPriority() const {
+    return priority;
+}
+
+/**
+ * Let JoinAll() stop and join the thread. Off by default, since
+ * JoinAll() waits for the thread to return from Run().
+ */
+void Thread::SetJoinOnShutdown(bool join) {
+    registryLock.Lock();
+    joinOnShutdown = join;
+    registryLock.Unlock();
+}
+
+bool Thread::GetJoinOnShutdown() const {
+    return joinOnShutdown;
+}
+
+/**
+ * Ask the thread to stop. Run() implementations should poll
+ * IsStopRequested() and return when it is set. Subclasses blocking on
+ * other conditions should override this to wake up the thread.
+ */
+void Thread::RequestStop() {
+    stopRequested = true;
+}
+
+bool Thread::IsStopRequested() const {
+    return stopRequested;
+}
+
+/**
+ * Check if the thread has been started and not yet joined.
+ */
+bool Thread::IsRunning() const {
+    return state == RUNNING;
+}
+
+void Thread::ApplyName() {
+    if (!name.empty()) SetCurrentName(name);
+}
+
+void Thread::ApplyAffinity() {
+#if defined(__linux__)
+    if (affinity.empty()) return;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (unsigned int i = 0; i < affinity.size(); i++)
+        CPU_SET(affinity[i], &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#endif
+}
+
+void Thread::ApplyPriority() {
+#if defined(__linux__)
+    // linux schedules threads as processes, so the nice value is per
+    // thread
+    if (priority == PRIORITY_NORMAL) return;
+    setpriority(PRIO_PROCESS, syscall(SYS_gettid), niceness[priority]);
+#endif
+}
 
 void Thread::Sleep(long usec) {
     usleep(usec);
 }
 
+void Thread::Yield() {
+    sched_yield();
+}
+
+/**
+ * Request the running threads that join on shutdown to stop and wait
+ * for them. The calling thread is skipped if it is in the registry.
+ * Threads started while joining are joined as well. A thread being
+ * joined is not destroyed before it has been joined.
+ *
+ * @see SetJoinOnShutdown()
+ */
+void Thread::JoinAll() {
+    for (;;) {
+        std::vector<Thread*> threads;
+        registryLock.Lock();
+        for (unsigned int i = 0; i < registry.size(); i++) {
+            Thread* t = registry[i];
+            if (t->joinOnShutdown && t->state == RUNNING &&
+                !pthread_equal(t->thread, pthread_self())) {
+                // pins the thread, see Wait() and the destructor
+                t->state = JOINING;
+                threads.push_back(t);
+            }
+        }
+        registryLock.Unlock();
+        if (threads.empty()) return;
+        for (unsigned int i = 0; i < threads.size(); i++)
+            threads[i]->RequestStop();
+        for (unsigned int i = 0; i < threads.size(); i++) {
+            Thread* t = threads[i];
+            pthread_join(t->thread, NULL);
+            registryLock.Lock();
+            t->state = JOINED;
+            for (unsigned int j = 0; j < registry.size(); j++)
+                if (registry[j] == t) {
+                    registry.erase(registry.begin() + j);
+                    break;
+                }
+            registryLock.Unlock();
+        }
+    }
+}
+
+/**
+ * Number of threads started and not yet joined.
+ */
+unsigned int Thread::GetRunningCount() {
+    registryLock.Lock();
+    unsigned int n = registry.size();
+    registryLock.Unlock();
+    return n;
+}
+
+/**
+ * Name the calling thread, which need not be started as a Thread.
+ * The name is kept in its ThreadStorage.
+ */
+void Thread::SetCurrentName(const std::string& name) {
+    ThreadStorage::Current().SetThreadName(name);
+#if defined(__linux__)
+    pthread_setname_np(pthread_self(), name.substr(0, 15).c_str());
+#elif defined(__APPLE__)
+    pthread_setname_np(name.c_str());
+#endif
+}
+
 }
 }
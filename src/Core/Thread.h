@@ -11,28 +11,89 @@
 #define _THREAD_H_
 
 #include <pthread.h>
+#include <string>
+#include <vector>
 
 namespace OpenEngine {
 namespace Core {
 
+/**
+ * Thread.
+ * Subclasses implement Run(). A thread can be given a name, which is
+ * shown by debuggers, perf and the profiler, and hints for the
+ * processors it should run on and its scheduling priority. Hints set
+ * before Start() are applied when the thread starts.
+ *
+ * Started threads are kept in a registry until joined. Threads that
+ * opt in with SetJoinOnShutdown() are stopped and joined by the engine
+ * on shutdown, see JoinAll(). Such threads must poll
+ * IsStopRequested(), or override RequestStop() to wake up.
+ *
+ * @class Thread Thread.h Core/Thread.h
+ * @see ThreadStorage
+ */
 class Thread {
-
+public:
+    /**
+     * Scheduling priority hints.
+     * Raising the priority may require privileges and is silently
+     * ignored without them.
+     */
+    enum Priority {
+        PRIORITY_LOW,
+        PRIORITY_NORMAL,
+        PRIORITY_HIGH
+    };
 
 private:
+    enum State { CREATED, RUNNING, JOINING, JOINED };
+
     pthread_t thread;
-    static void* thread_func(void *d){((Thread *)d)->Run(); return 0;}
+    std::string name;
+    std::vector<unsigned int> affinity;
+    Priority priority;
+    volatile State state;
+    volatile bool stopRequested;
+    bool joinOnShutdown;
+
+    static void* thread_func(void *d);
+
+    void ApplyName();
+    void ApplyAffinity();
+    void ApplyPriority();
+
+    Thread(const Thread&);
+    Thread& operator=(const Thread&);
 
-    
 public:
-    virtual ~Thread() {};
+    Thread();
+    Thread(const std::string& name);
+    virtual ~Thread();
     
     virtual void Run() =0;
     
     int Start();
     int Wait();
 
+    void SetName(const std::string& name);
+    const std::string& GetName() const;
+    void SetAffinity(unsigned int cpu);
+    void SetAffinity(const std::vector<unsigned int>& cpus);
+    void SetPriority(Priority priority);
+    Priority GetPriority() const;
+    void SetJoinOnShutdown(bool join);
+    bool GetJoinOnShutdown() const;
+
+    virtual void RequestStop();
+    bool IsStopRequested() const;
+    bool IsRunning() const;
+
     static void Sleep(long mills);
-    
+    static void Yield();
+
+    static void JoinAll();
+    static unsigned int GetRunningCount();
+    static void SetCurrentName(const std::string& name);
 };
 
 }
@@ -0,0 +1,160 @@
+// Per thread storage.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#include <Core/ThreadStorage.h>
+#include <Core/Exceptions.h>
+#include <Core/Atomic.h>
+
+#include <pthread.h>
+
+namespace OpenEngine {
+namespace Core {
+
+// size of the first scratch chunk
+static const size_t firstChunk = 64 * 1024;
+
+static pthread_key_t key;
+static pthread_once_t keyOnce = PTHREAD_ONCE_INIT;
+static volatile unsigned int slotCount = 0;
+static ThreadStorage::Cleanup cleanups[ThreadStorage::SLOTS];
+
+const unsigned int ThreadStorage::SLOTS;
+
+static void DeleteStorage(void* storage) {
+    delete static_cast<ThreadStorage*>(storage);
+}
+
+static void CreateKey() {
+    pthread_key_create(&key, DeleteStorage);
+}
+
+ThreadStorage::ThreadStorage() {
+    for (unsigned int i = 0; i < SLOTS; i++)
+        slots[i] = NULL;
+}
+
+ThreadStorage::~ThreadStorage() {
+    for (unsigned int i = 0; i < SLOTS; i++)
+        if (slots[i] != NULL && cleanups[i] != NULL)
+            cleanups[i](slots[i]);
+    for (unsigned int i = 0; i < chunks.size(); i++)
+        delete[] chunks[i].data;
+}
+
+/**
+ * Get the storage of the calling thread.
+ */
+ThreadStorage& ThreadStorage::Current() {
+    pthread_once(&keyOnce, CreateKey);
+    ThreadStorage* s = static_cast<ThreadStorage*>(pthread_getspecific(key));
+    if (s == NULL) {
+        s = new ThreadStorage();
+        pthread_setspecific(key, s);
+    }
+    return *s;
+}
+
+/**
+ * Allocate a slot index. Slots are never freed, so a subsystem
+ * should allocate its slot once.
+ *
+ * @param cleanup Called with the value of the slot when a thread
+ *        exits, if set.
+ * @throws Exception if all slots are in use.
+ */
+unsigned int ThreadStorage::AllocateSlot(Cleanup cleanup) {
+    unsigned int slot = AtomicAdd(slotCount, 1u) - 1;
+    if (slot >= SLOTS)
+        throw Exception("No more thread storage slots.");
+    cleanups[slot] = cleanup;
+    return slot;
+}
+
+/**
+ * Get the name of the thread, empty if it has not been named.
+ *
+ * @see Thread::SetName
+ */
+const std::string& ThreadStorage::GetThreadName() const {
+    return name;
+}
+
+void ThreadStorage::SetThreadName(const std::string& name) {
+    this->name = name;
+}
+
+/**
+ * Get the value of a slot, NULL if it has not been set.
+ */
+void* ThreadStorage::Get(unsigned int slot) const {
+    return slots[slot];
+}
+
+void ThreadStorage::Set(unsigned int slot, void* value) {
+    slots[slot] = value;
+}
+
+/**
+ * Allocate scratch memory.
+ * The memory stays valid until released to a marker taken before the
+ * allocation, see Scope.
+ *
+ * @param size Size in bytes.
+ * @param align Alignment, must be a power of two.
+ */
+void* ThreadStorage::Allocate(size_t size, size_t align) {
+    for (; top.chunk < chunks.size(); top.chunk++, top.offset = 0) {
+        Chunk& c = chunks[top.chunk];
+        size_t base = (size_t)c.data;
+        size_t start = ((base + top.offset + align - 1) & ~(align - 1)) - base;
+        if (start + size <= c.size) {
+            top.offset = start + size;
+            return c.data + start;
+        }
+    }
+    // no room in the existing chunks, double the capacity
+    Chunk c;
+    c.size = chunks.empty() ? firstChunk : chunks.back().size * 2;
+    if (c.size < size + align) c.size = size + align;
+    c.data = new char[c.size];
+    chunks.push_back(c);
+    size_t base = (size_t)c.data;
+    size_t start = ((base + align - 1) & ~(align - 1)) - base;
+    top.chunk = chunks.size() - 1;
+    top.offset = start + size;
+    return c.data + start;
+}
+
+/**
+ * Get the current position in the scratch memory.
+ */
+ThreadStorage::Marker ThreadStorage::GetMarker() const {
+    return top;
+}
+
+/**
+ * Release all scratch memory allocated after the marker was taken.
+ * The memory is kept for reuse.
+ */
+void ThreadStorage::Release(Marker mark) {
+    top = mark;
+}
+
+/**
+ * Total size of the scratch memory owned by the thread.
+ */
+size_t ThreadStorage::GetScratchCapacity() const {
+    size_t n = 0;
+    for (unsigned int i = 0; i < chunks.size(); i++)
+        n += chunks[i].size;
+    return n;
+}
+
+} // NS Core
+} // NS OpenEngine
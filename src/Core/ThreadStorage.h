@@ -0,0 +1,122 @@
+// Per thread storage.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#ifndef _OE_THREAD_STORAGE_H_
+#define _OE_THREAD_STORAGE_H_
+
+#include <vector>
+#include <string>
+#include <cstddef>
+
+namespace OpenEngine {
+namespace Core {
+
+/**
+ * Per thread storage.
+ * Every thread, whether started as a Thread or not, has a storage
+ * object created on first use and destroyed when the thread exits.
+ * It offers:
+ *
+ * - The thread name, as set by Thread.
+ * - Slots: pointer sized values that subsystems such as the profiler
+ *   or allocators hang their per thread state off. A subsystem
+ *   allocates a slot index once and uses it on every thread.
+ * - Scratch memory: a stack allocator for short lived temporaries
+ *   that would otherwise be allocated on the heap every frame.
+ *
+ * @code
+ * static const unsigned int slot = ThreadStorage::AllocateSlot();
+ * ThreadStorage& ts = ThreadStorage::Current();
+ * State* s = (State*)ts.Get(slot);
+ * if (s == NULL) ts.Set(slot, s = new State());
+ *
+ * {
+ *     ThreadStorage::Scope scope(ts);
+ *     float* tmp = (float*)ts.Allocate(n * sizeof(float));
+ *     ...
+ * } // tmp is released
+ * @endcode
+ *
+ * When the thread exits, the cleanup function given for a slot is
+ * called with the value of the slot if it is set. Values of slots
+ * without a cleanup function are not deleted.
+ *
+ * @class ThreadStorage ThreadStorage.h Core/ThreadStorage.h
+ * @see Thread
+ */
+class ThreadStorage {
+public:
+    static const unsigned int SLOTS = 16;
+
+    /**
+     * Function releasing the value of a slot when a thread exits.
+     */
+    typedef void (*Cleanup)(void* value);
+
+    /**
+     * Position in the scratch memory.
+     */
+    class Marker {
+    public:
+        unsigned int chunk;
+        size_t offset;
+        Marker() : chunk(0), offset(0) {}
+    };
+
+    /**
+     * Scoped scratch allocation.
+     * Releases everything allocated in the scope when destroyed.
+     */
+    class Scope {
+    private:
+        ThreadStorage& storage;
+        Marker mark;
+    public:
+        Scope(ThreadStorage& storage)
+            : storage(storage), mark(storage.GetMarker()) {}
+        ~Scope() { storage.Release(mark); }
+    };
+
+    static ThreadStorage& Current();
+    static unsigned int AllocateSlot(Cleanup cleanup = NULL);
+
+    const std::string& GetThreadName() const;
+    void SetThreadName(const std::string& name);
+
+    void* Get(unsigned int slot) const;
+    void Set(unsigned int slot, void* value);
+
+    void* Allocate(size_t size, size_t align = 16);
+    Marker GetMarker() const;
+    void Release(Marker mark);
+    size_t GetScratchCapacity() const;
+
+    ~ThreadStorage();
+
+private:
+    class Chunk {
+    public:
+        char* data;
+        size_t size;
+    };
+
+    std::string name;
+    void* slots[SLOTS];
+    std::vector<Chunk> chunks;
+    Marker top;
+
+    ThreadStorage();
+    ThreadStorage(const ThreadStorage&);
+    ThreadStorage& operator=(const ThreadStorage&);
+};
+
+} // NS Core
+} // NS OpenEngine
+
+#endif // _OE_THREAD_STORAGE_H_
@@ -8,16 +8,14 @@
 //--------------------------------------------------------------------
 
 #include <Core/TickEngine.h>
+#include <Core/Thread.h>
 #include <Logging/Logger.h>
-#include <Utils/Timer.h>
+#include <Utils/Profiler.h>
 #include <cstdlib>
 
 namespace OpenEngine {
 namespace Core {
 
-using OpenEngine::Utils::Time;
-using OpenEngine::Utils::Timer;
-
 
 
 TickEngine::TickEngine() {
@@ -25,40 +23,42 @@ TickEngine::TickEngine() {
 }
 
 void TickEngine::Tick() {
-    
-    Time _time;
-
-    unsigned int approx = 0;
-    for (int i=0;i<10;i++) 
-        approx += loops[i];
-    approx = approx / 10;
-
-    process.Notify(ProcessEventArg(time,approx));
-    
-    _time = Timer::GetTime();
-    loops[index] = (_time - time).AsInt();
-    time = _time;
-
-    index = (index + 1) % 10;
-    
+    unsigned int steps = clock.Advance(false);
+    {
+        Utils::Profiler::Zone frame("Engine::Frame");
+        for (unsigned int i = 0; i < steps; i++) {
+            Utils::Profiler::Zone zone("Engine::Process");
+            process.Notify(clock.GetProcessEventArg(i));
+        }
+    }
+    Utils::Profiler::Collect();
 }
 
 void TickEngine::Start() {
     initialize.Notify(InitializeEventArg());
+    clock.Reset();
+}
 
-           
-    // Ready the approx calculation
-    index = 0;
-    for (int i=0;i<10;i++) 
-        loops[i] = 50;
+/**
+ * Set the policy used to pace the ticks.
+ *
+ * @see LoopPolicy
+ */
+void TickEngine::SetLoopPolicy(const LoopPolicy& policy) {
+    clock.SetLoopPolicy(policy);
+}
 
-    time = Timer::GetTime();
-    
+/**
+ * Get the policy used to pace the ticks.
+ */
+const LoopPolicy& TickEngine::GetLoopPolicy() const {
+    return clock.GetLoopPolicy();
 }
 
 void TickEngine::Stop() {
     // only way to end the glutMainLoop
     deinitialize.Notify(DeinitializeEventArg());
+    Thread::JoinAll();
 
     exit(0);
 }
@@ -72,9 +72,9 @@ IEvent<InitializeEventArg>& TickEngine::InitializeEvent() {
 }
 
 /**
- * @see IEngine::ProcessEvent()
+ * @see Engine::ProcessEvent()
  */
-IEvent<ProcessEventArg>& TickEngine::ProcessEvent() {
+TaskGraphEvent<ProcessEventArg>& TickEngine::ProcessEvent() {
     return process;
 }
 
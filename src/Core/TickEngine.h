@@ -14,34 +14,38 @@
 #include <Core/IEngine.h>
 #include <Core/IEvent.h>
 #include <Core/Event.h>
+#include <Core/TaskGraphEvent.h>
+#include <Core/FrameClock.h>
 
 namespace OpenEngine {
 namespace Core {
 /**
- * Short description.
+ * Externally driven engine.
+ * The process event is notified from Tick(), typically called by a
+ * windowing toolkit main loop. A paced loop policy makes ticks that
+ * arrive early skip processing rather than wait.
  *
  * @class TickEngine TickEngine.h re/TickEngine.h
  */
 class TickEngine : public IEngine {
 private:
     Event<InitializeEventArg>   initialize;
-    Event<ProcessEventArg>      process;
+    TaskGraphEvent<ProcessEventArg> process;
     Event<DeinitializeEventArg> deinitialize;
 
-    Time time;
-
-    unsigned int index;
-    unsigned int loops[10];
+    FrameClock clock;
 
 public:
     TickEngine();
     virtual void Start();
     virtual void Stop();
     virtual IEvent<InitializeEventArg>&   InitializeEvent();
-    virtual IEvent<ProcessEventArg>&      ProcessEvent();
+    virtual TaskGraphEvent<ProcessEventArg>& ProcessEvent();
     virtual IEvent<DeinitializeEventArg>& DeinitializeEvent();
 
     void Tick();
+    void SetLoopPolicy(const LoopPolicy& policy);
+    const LoopPolicy& GetLoopPolicy() const;
 };
 
 } // NS Core
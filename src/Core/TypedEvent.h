@@ -0,0 +1,85 @@
+// Typed Event.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#ifndef _OE_TYPED_EVENT_H_
+#define _OE_TYPED_EVENT_H_
+
+#include <Core/ListenerList.h>
+
+namespace OpenEngine {
+namespace Core {
+
+/**
+ * Typed Event.
+ * An event for listeners of a type known at compile time. The event
+ * argument is passed by const reference and the handler is invoked
+ * through the concrete listener type, so when \a Listener declares a
+ * non virtual Handle method no virtual call and no argument copy is
+ * made per listener.
+ *
+ * As the listener type is fixed a typed event is not an IEvent. It
+ * is meant for high frequency notifications inside a module where
+ * the receivers are known, such as resource change notifications to
+ * a renderer.
+ *
+ * @code
+ * class Binder {
+ * public:
+ *     void Handle(const IDataBlockChangedEventArg& arg) { ... }
+ * };
+ * TypedEvent<IDataBlockChangedEventArg, Binder> changed;
+ * changed.Attach(binder);
+ * changed.Notify(arg);
+ * @endcode
+ *
+ * Listeners may be attached and detached while the event notifies,
+ * see ListenerList.
+ *
+ * @class TypedEvent TypedEvent.h Core/TypedEvent.h
+ * @tparam EventArg Argument type of the event.
+ * @tparam Listener Listener type with a Handle(const EventArg&) method.
+ * @see Event
+ */
+template <typename EventArg, typename Listener>
+class TypedEvent {
+private:
+    ListenerList<Listener> ls;
+
+public:
+
+    void Attach(Listener& listener) {
+        ls.Add(&listener);
+    }
+
+    void Detach(Listener& listener) {
+        ls.Remove(&listener);
+    }
+
+    /**
+     * Notify all listeners.
+     * This will immediately invoke Listener::Handle on each attached
+     * listener.
+     */
+    void Notify(const EventArg& arg) {
+        typename ListenerList<Listener>::Dispatch d(ls);
+        for (unsigned int i = 0; i < d.Size(); i++) {
+            Listener* l = ls[i];
+            if (l != NULL) l->Handle(arg);
+        }
+    }
+
+    unsigned int Size() {
+        return ls.Size();
+    }
+};
+
+} // NS Core
+} // NS OpenEngine
+
+#endif // _OE_TYPED_EVENT_H_
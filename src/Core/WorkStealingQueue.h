@@ -0,0 +1,133 @@
+// Work stealing queue.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#ifndef _OE_WORK_STEALING_QUEUE_H_
+#define _OE_WORK_STEALING_QUEUE_H_
+
+#include <Core/Atomic.h>
+
+namespace OpenEngine {
+namespace Core {
+
+/**
+ * Work stealing queue.
+ * A bounded lock-free double ended queue in the style of Chase and
+ * Lev. A single owner thread pushes and pops elements at the bottom
+ * (LIFO) while any number of thief threads steal elements from the
+ * top (FIFO).
+ *
+ * The element type must be copyable by plain assignment and should be
+ * small, typically a pointer or a pair of pointers.
+ *
+ * @class WorkStealingQueue WorkStealingQueue.h Core/WorkStealingQueue.h
+ * @tparam T Element type.
+ * @see TaskScheduler
+ */
+template <typename T>
+class WorkStealingQueue {
+private:
+    T* elements;
+    long mask;
+    volatile long top;
+    volatile long bottom;
+
+    // not copyable
+    WorkStealingQueue(const WorkStealingQueue&);
+    WorkStealingQueue& operator=(const WorkStealingQueue&);
+
+public:
+
+    /**
+     * Create a queue.
+     *
+     * @param capacity Maximal number of elements, rounded up to the
+     *                 nearest power of two.
+     */
+    WorkStealingQueue(unsigned int capacity = 1024)
+        : top(0), bottom(0) {
+        long size = 1;
+        while (size < (long)capacity) size <<= 1;
+        elements = new T[size];
+        mask = size - 1;
+    }
+
+    ~WorkStealingQueue() {
+        delete[] elements;
+    }
+
+    /**
+     * Push an element at the bottom.
+     * May only be called by the owner thread.
+     *
+     * @return False if the queue is full.
+     */
+    bool Push(const T& e) {
+        long b = bottom;
+        long t = top;
+        if (b - t > mask) return false;
+        elements[b & mask] = e;
+        MemoryBarrier();
+        bottom = b + 1;
+        return true;
+    }
+
+    /**
+     * Pop an element from the bottom.
+     * May only be called by the owner thread.
+     *
+     * @param e Assigned the popped element on success.
+     * @return False if the queue was empty.
+     */
+    bool Pop(T& e) {
+        long b = bottom - 1;
+        bottom = b;
+        MemoryBarrier();
+        long t = top;
+        if (t > b) {
+            bottom = t;
+            return false;
+        }
+        e = elements[b & mask];
+        if (t != b) return true;
+        // last element, race against thieves for it
+        bool won = AtomicCompareAndSwap(top, t, t + 1);
+        bottom = t + 1;
+        return won;
+    }
+
+    /**
+     * Steal an element from the top.
+     * May be called by any thread.
+     *
+     * @param e Assigned the stolen element on success.
+     * @return False if the queue was empty or the steal was lost to
+     *         another thread.
+     */
+    bool Steal(T& e) {
+        long t = top;
+        MemoryBarrier();
+        long b = bottom;
+        if (t >= b) return false;
+        e = elements[t & mask];
+        return AtomicCompareAndSwap(top, t, t + 1);
+    }
+
+    /**
+     * Approximate number of queued elements.
+     */
+    unsigned int Size() const {
+        long s = bottom - top;
+        return s > 0 ? s : 0;
+    }
+};
+
+} // NS Core
+} // NS OpenEngine
+
+#endif // _OE_WORK_STEALING_QUEUE_H_
@@ -0,0 +1,105 @@
+#include <Testing/Testing.h>
+
+#include <Core/ConcurrentQueue.h>
+#include <Core/ConcurrentQueuedEvent.h>
+#include <Core/Thread.h>
+
+#include <vector>
+
+using namespace OpenEngine::Core;
+
+static const int producers = 4;
+static const int events = 20000;
+
+struct Message {
+    int producer;
+    int sequence;
+};
+
+// Producer posting a sequence of messages, retrying when full
+class Producer : public Thread {
+public:
+    ConcurrentQueuedEvent<Message>* event;
+    int id;
+    void Run() {
+        for (int i = 0; i < events; i++) {
+            Message m;
+            m.producer = id;
+            m.sequence = i;
+            while (!event->TryNotify(m)) Thread::Yield();
+        }
+    }
+};
+
+// Listener checking the per producer order
+class Checker : public IListener<Message> {
+public:
+    int next[producers];
+    int received;
+    bool ordered;
+    Checker() : received(0), ordered(true) {
+        for (int i = 0; i < producers; i++) next[i] = 0;
+    }
+    void Handle(Message m) {
+        if (m.sequence != next[m.producer]) ordered = false;
+        next[m.producer] = m.sequence + 1;
+        received++;
+    }
+};
+
+int test_main(int argc, char* argv[]) {
+
+    // single threaded semantics
+    {
+        ConcurrentQueue<int> q(4);
+        OE_CHECK(q.Capacity() == 4);
+        OE_CHECK(q.IsEmpty());
+        for (int i = 0; i < 4; i++) OE_CHECK(q.Put(i));
+        OE_CHECK(!q.Put(4));
+        int e;
+        for (int i = 0; i < 4; i++) OE_CHECK(q.Get(e) && e == i);
+        OE_CHECK(!q.Get(e));
+        // wrap around
+        for (int i = 0; i < 10; i++) {
+            OE_CHECK(q.Put(i));
+            OE_CHECK(q.Get(e) && e == i);
+        }
+    }
+
+    // dropped notifications are counted
+    {
+        ConcurrentQueuedEvent<Message> event(2);
+        Checker checker;
+        event.Attach(checker);
+        Message m = { 0, 0 };
+        event.Notify(m); m.sequence++;
+        event.Notify(m); m.sequence++;
+        event.Notify(m);
+        OE_CHECK(event.GetDropped() == 1);
+        event.Release();
+        OE_CHECK(checker.received == 2);
+        OE_CHECK(event.IsEmpty());
+    }
+
+    // concurrent producers with a releasing consumer
+    {
+        ConcurrentQueuedEvent<Message> event(256);
+        Checker checker;
+        event.Attach(checker);
+        std::vector<Producer> threads(producers);
+        for (int i = 0; i < producers; i++) {
+            threads[i].event = &event;
+            threads[i].id = i;
+            threads[i].Start();
+        }
+        while (checker.received < producers * events)
+            event.Release();
+        for (int i = 0; i < producers; i++)
+            threads[i].Wait();
+        OE_CHECK(checker.ordered);
+        OE_CHECK(checker.received == producers * events);
+        OE_CHECK(event.GetDropped() == 0);
+    }
+
+    return 0;
+}
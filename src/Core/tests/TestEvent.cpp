@@ -0,0 +1,146 @@
+#include <Testing/Testing.h>
+
+#include <Core/Event.h>
+#include <Core/QueuedEvent.h>
+#include <Core/CoalescingQueuedEvent.h>
+#include <Core/TypedEvent.h>
+
+using namespace OpenEngine::Core;
+
+// Listener counting events and optionally detaching a peer
+class Counter : public IListener<int> {
+public:
+    IEvent<int>* event;
+    IListener<int>* detach;
+    int count;
+    Counter() : event(NULL), detach(NULL), count(0) {}
+    void Handle(int arg) {
+        count++;
+        if (detach) {
+            event->Detach(*detach);
+            detach = NULL;
+        }
+    }
+};
+
+// Listener used through a typed event
+class Sum {
+public:
+    int sum;
+    Sum() : sum(0) {}
+    void Handle(const int& arg) { sum += arg; }
+};
+
+// Range change of an object, merged by object
+class RangeArg {
+public:
+    int* object;
+    unsigned int start, end;
+    RangeArg(int* o, unsigned int s, unsigned int e)
+        : object(o), start(s), end(e) {}
+    const void* GetKey() const { return object; }
+    void Merge(const RangeArg& other) {
+        start = std::min(start, other.start);
+        end = std::max(end, other.end);
+    }
+};
+
+class RangeListener : public IListener<RangeArg> {
+public:
+    std::vector<RangeArg> args;
+    void Handle(RangeArg arg) { args.push_back(arg); }
+};
+
+int test_main(int argc, char* argv[]) {
+
+    // detaching self and others while notifying
+    {
+        Event<int> e;
+        Counter a, b, c;
+        e.Attach(a);
+        e.Attach(b);
+        e.Attach(c);
+        a.event = &e; a.detach = &c;
+        b.event = &e; b.detach = &b;
+        e.Notify(0);
+        OE_CHECK(a.count == 1 && b.count == 1 && c.count == 0);
+        OE_CHECK(e.Size() == 1);
+        e.Notify(0);
+        OE_CHECK(a.count == 2 && b.count == 1 && c.count == 0);
+    }
+
+    // detaching removes every attachment of a listener
+    {
+        Event<int> e;
+        Counter a, b;
+        e.Attach(a);
+        e.Attach(b);
+        e.Attach(a);
+        e.Notify(0);
+        OE_CHECK(a.count == 2 && b.count == 1);
+        e.Detach(a);
+        OE_CHECK(e.Size() == 1);
+        e.Notify(0);
+        OE_CHECK(a.count == 2 && b.count == 2);
+
+        // also while notifying
+        e.Attach(a);
+        e.Attach(a);
+        b.event = &e; b.detach = &a;
+        e.Notify(0);
+        OE_CHECK(a.count == 2 && b.count == 3);
+        OE_CHECK(e.Size() == 1);
+    }
+
+    // queued events notified while releasing wait for the next release
+    {
+        QueuedEvent<int> q;
+        Counter a;
+        q.Attach(a);
+        q.Notify(1);
+        q.Notify(2);
+        OE_CHECK(a.count == 0);
+        q.Release();
+        OE_CHECK(a.count == 2);
+        q.Release();
+        OE_CHECK(a.count == 2);
+    }
+
+    // typed event
+    {
+        TypedEvent<int, Sum> t;
+        Sum s1, s2;
+        t.Attach(s1);
+        t.Attach(s2);
+        t.Notify(2);
+        t.Detach(s1);
+        t.Notify(3);
+        OE_CHECK(s1.sum == 2 && s2.sum == 5);
+        OE_CHECK(t.Size() == 1);
+    }
+
+    // coalescing events merge by key in first notification order
+    {
+        CoalescingQueuedEvent<RangeArg> q;
+        RangeListener l;
+        int x, y;
+        q.Attach(l);
+        q.Notify(RangeArg(&y, 4, 6));
+        q.Notify(RangeArg(&x, 10, 20));
+        q.Notify(RangeArg(&y, 0, 2));
+        q.Notify(RangeArg(&x, 15, 30));
+        OE_CHECK(q.QueueSize() == 2);
+        OE_CHECK(q.GetMergedCount() == 2);
+        q.Release();
+        OE_CHECK(l.args.size() == 2);
+        OE_CHECK(l.args[0].object == &y);
+        OE_CHECK(l.args[0].start == 0 && l.args[0].end == 6);
+        OE_CHECK(l.args[1].object == &x);
+        OE_CHECK(l.args[1].start == 10 && l.args[1].end == 30);
+        q.Notify(RangeArg(&x, 1, 2));
+        q.Release();
+        OE_CHECK(l.args.size() == 3 && l.args[2].start == 1);
+    }
+
+    return 0;
+}
@@ -0,0 +1,53 @@
+#include <Testing/Testing.h>
+
+#include <Core/FrameClock.h>
+#include <Core/Exceptions.h>
+#include <Core/Thread.h>
+
+using namespace OpenEngine::Core;
+using OpenEngine::Utils::Time;
+
+// periods are long compared to the scheduling noise of a loaded machine
+static const unsigned int STEP = 50000;
+
+int test_main(int argc, char* argv[]) {
+    bool threw = false;
+    try { LoopPolicy::TargetRate(0); } catch (InvalidArgument&) { threw = true; }
+    OE_CHECK(threw);
+    OE_CHECK(LoopPolicy::TargetRate(20).period == Time(STEP));
+
+    // fixed time step catches up at most maxCatchUp steps
+    {
+        FrameClock clock;
+        clock.SetLoopPolicy(LoopPolicy::FixedTimestep(Time(STEP), 2));
+        Thread::Sleep(4 * STEP);
+        OE_CHECK(clock.Advance(false) == 2);
+        ProcessEventArg first = clock.GetProcessEventArg(0);
+        ProcessEventArg last = clock.GetProcessEventArg(1);
+        OE_CHECK(first.dt == Time(STEP) && last.dt == Time(STEP));
+        OE_CHECK(first.alpha == 1.0f);
+        OE_CHECK(last.alpha >= 0.0f && last.alpha < 1.0f);
+
+        // the dropped lag is not processed later
+        OE_CHECK(clock.Advance(false) == 0);
+
+        // waiting processes exactly one step
+        OE_CHECK(clock.Advance(true) == 1);
+        OE_CHECK(clock.GetProcessEventArg(0).dt == Time(STEP));
+    }
+
+    // target rate drops lag beyond maxCatchUp and keeps the period
+    {
+        FrameClock clock;
+        clock.SetLoopPolicy(LoopPolicy::TargetRate(20, 1));
+        OE_CHECK(clock.Advance(false) == 1);
+        OE_CHECK(clock.Advance(false) == 0);
+        Thread::Sleep(4 * STEP);
+        OE_CHECK(clock.Advance(false) == 1);
+        OE_CHECK(clock.Advance(false) == 0);
+        OE_CHECK(clock.Advance(true) == 1);
+        OE_CHECK(clock.GetProcessEventArg(0).dt >= Time(STEP - 10000));
+        OE_CHECK(clock.GetProcessEventArg(0).alpha == 1.0f);
+    }
+    return 0;
+}
@@ -0,0 +1,127 @@
+#include <Testing/Testing.h>
+
+#include <Core/TaskScheduler.h>
+#include <Core/TaskGraphEvent.h>
+#include <Core/Atomic.h>
+
+#include <vector>
+
+using namespace OpenEngine::Core;
+
+// Task incrementing a shared counter
+class CountTask : public ITask {
+public:
+    volatile int* counter;
+    void Run() { AtomicAdd(*counter, 1); }
+};
+
+// Task spawning a number of child tasks into its own group
+class ForkTask : public ITask {
+public:
+    TaskScheduler* scheduler;
+    std::vector<CountTask> children;
+    void Run() {
+        TaskGroup group;
+        for (unsigned int i = 0; i < children.size(); i++)
+            scheduler->Spawn(children[i], group);
+        scheduler->Wait(group);
+    }
+};
+
+// Listener recording the order in which it was handled
+class OrderListener : public IListener<int> {
+public:
+    volatile int* clock;
+    int stamp;
+    OrderListener() : clock(NULL), stamp(-1) {}
+    void Handle(int arg) { stamp = AtomicAdd(*clock, 1); }
+};
+
+int test_main(int argc, char* argv[]) {
+
+    // tasks complete without any workers
+    {
+        TaskScheduler scheduler(0);
+        volatile int counter = 0;
+        std::vector<CountTask> tasks(100);
+        TaskGroup group;
+        for (unsigned int i = 0; i < tasks.size(); i++) {
+            tasks[i].counter = &counter;
+            scheduler.Spawn(tasks[i], group);
+        }
+        scheduler.Wait(group);
+        OE_CHECK(counter == 100);
+        OE_CHECK(group.IsDone());
+    }
+
+    // nested spawning on a running pool
+    {
+        TaskScheduler scheduler(4);
+        scheduler.Start();
+        volatile int counter = 0;
+        std::vector<ForkTask> forks(50);
+        TaskGroup group;
+        for (unsigned int i = 0; i < forks.size(); i++) {
+            forks[i].scheduler = &scheduler;
+            forks[i].children.resize(20);
+            for (unsigned int j = 0; j < 20; j++)
+                forks[i].children[j].counter = &counter;
+            scheduler.Spawn(forks[i], group);
+        }
+        scheduler.Wait(group);
+        OE_CHECK(counter == 50 * 20);
+        scheduler.Stop();
+    }
+
+    // task graph ordering, sequential and parallel
+    for (unsigned int workers = 0; workers < 4; workers += 3) {
+        TaskScheduler scheduler(workers);
+        scheduler.Start();
+        volatile int clock = 0;
+        OrderListener a, b, c, d;
+        a.clock = b.clock = c.clock = d.clock = &clock;
+
+        TaskGraphEvent<int> e;
+        e.SetTaskScheduler(&scheduler);
+        e.AttachParallel(d);
+        e.AttachParallel(c);
+        e.AttachParallel(b);
+        e.AttachParallel(a);
+        e.AddDependency(b, a);
+        e.AddDependency(c, a);
+        e.AddDependency(d, b);
+        e.AddDependency(d, c);
+        OE_CHECK_THROW(e.AddDependency(a, d), InvalidArgument);
+
+        for (int i = 0; i < 10; i++) {
+            clock = 0;
+            e.Notify(i);
+            OE_CHECK(a.stamp < b.stamp && a.stamp < c.stamp);
+            OE_CHECK(b.stamp < d.stamp && c.stamp < d.stamp);
+        }
+
+        // detaching keeps the transitive ordering a < d
+        e.Detach(b);
+        e.Detach(c);
+        OE_CHECK(e.Size() == 2);
+        clock = 0;
+        e.Notify(0);
+        OE_CHECK(a.stamp == 1 && d.stamp == 2);
+        scheduler.Stop();
+    }
+
+    // plain attach keeps the sequential event order
+    {
+        volatile int clock = 0;
+        OrderListener a, b, c;
+        a.clock = b.clock = c.clock = &clock;
+        TaskGraphEvent<int> e;
+        e.Attach(a);
+        e.Attach(b);
+        e.Attach(c);
+        e.Notify(0);
+        OE_CHECK(a.stamp == 1 && b.stamp == 2 && c.stamp == 3);
+    }
+
+    return 0;
+}
@@ -0,0 +1,71 @@
+#include <Testing/Testing.h>
+
+#include <Core/Thread.h>
+#include <Core/ThreadStorage.h>
+
+using namespace OpenEngine::Core;
+
+// Runs until asked to stop
+class Looper : public Thread {
+public:
+    std::string name;
+    volatile bool scratchOk;
+    Looper(const std::string& n) : Thread(n), scratchOk(false) {}
+    void Run() {
+        ThreadStorage& ts = ThreadStorage::Current();
+        name = ts.GetThreadName();
+        {
+            ThreadStorage::Scope scope(ts);
+            char* a = (char*)ts.Allocate(100);
+            char* b = (char*)ts.Allocate(100000, 64);
+            scratchOk = a != NULL && b != NULL && ((size_t)b % 64) == 0;
+        }
+        while (!IsStopRequested())
+            Sleep(1000);
+    }
+};
+
+int test_main(int argc, char* argv[]) {
+
+    // slots are per thread
+    unsigned int slot = ThreadStorage::AllocateSlot();
+    int value;
+    ThreadStorage::Current().Set(slot, &value);
+    OE_CHECK(ThreadStorage::Current().Get(slot) == &value);
+
+    // scratch memory is reused after release
+    ThreadStorage& ts = ThreadStorage::Current();
+    ThreadStorage::Marker m = ts.GetMarker();
+    void* p = ts.Allocate(32);
+    ts.Release(m);
+    OE_CHECK(ts.Allocate(32) == p);
+    ts.Release(m);
+
+    // registry joins the threads that opted in
+    Looper a("looper-a"), b("looper-b"), c("looper-c");
+    a.SetAffinity(0);
+    b.SetPriority(Thread::PRIORITY_LOW);
+    a.SetJoinOnShutdown(true);
+    b.SetJoinOnShutdown(true);
+    OE_CHECK(a.Start() == 0);
+    OE_CHECK(b.Start() == 0);
+    OE_CHECK(c.Start() == 0);
+    OE_CHECK(Thread::GetRunningCount() == 3);
+    Thread::JoinAll();
+    OE_CHECK(Thread::GetRunningCount() == 1);
+    OE_CHECK(!a.IsRunning() && !b.IsRunning());
+    OE_CHECK(c.IsRunning() && !c.IsStopRequested());
+    c.RequestStop();
+    OE_CHECK(c.Wait() == 0);
+    OE_CHECK(Thread::GetRunningCount() == 0);
+    OE_CHECK(a.name == "looper-a" && b.name == "looper-b");
+    OE_CHECK(a.scratchOk && b.scratchOk);
+    OE_CHECK(a.Wait() == 0);
+
+    // a stopped thread can be started again
+    OE_CHECK(a.Start() == 0);
+    a.RequestStop();
+    OE_CHECK(a.Wait() == 0);
+    OE_CHECK(Thread::GetRunningCount() == 0);
+    return 0;
+}
@@ -111,6 +111,35 @@ void Frustum::VisualizeClipping(const bool visualize) {
     visualizeClipping = visualize;
 }
 
+/**
+ * Test if bounds are visible in the frustum.
+ *
+ * @param bounds World space bounds to test for visibility.
+ * @return True if the bounds are not empty and visible.
+ */
+bool Frustum::IsVisible(const Bounds& bounds) {
+    if (bounds.IsEmpty()) return false;
+    return IsVisible(bounds.GetBox());
+}
+
+/**
+ * Test if any part of a scene node sub tree is visible in the
+ * frustum. Visitors can skip the sub nodes of invisible nodes.
+ *
+ * @code
+ * void VisitTransformationNode(TransformationNode* node) {
+ *     if (!frustum.IsVisible(*node)) return;
+ *     ...
+ * }
+ * @endcode
+ *
+ * @param node Scene node to test for visibility.
+ * @return True if the node bounds are visible.
+ */
+bool Frustum::IsVisible(ISceneNode& node) {
+    return IsVisible(node.GetWorldBounds());
+}
+
 /**
  * Test if a box is visible in the frustum.
  *
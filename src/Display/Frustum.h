@@ -12,6 +12,7 @@
 
 #include <Display/IViewingVolumeDecorator.h>
 #include <Geometry/Plane.h>
+#include <Geometry/Bounds.h>
 #include <Scene/RenderNode.h>
 #include <list>
 
@@ -79,6 +80,8 @@ public:
 
     // viewing volume clipping methods
     virtual bool IsVisible(const Box& box);
+    virtual bool IsVisible(const Bounds& bounds);
+    virtual bool IsVisible(ISceneNode& node);
 };
 
 } // NS Display
@@ -53,10 +53,21 @@ public:
     ICanvas& canvas;
     Time start;                 //!< time of engine loop start.
     unsigned int approx;        //!< approximate engine loop time.
+    Time dt;                    //!< time step of this event.
+    float alpha;                //!< interpolation factor in [0,1].
     ProcessEventArg(ICanvas& canvas, Time start, unsigned int approx)
         : canvas(canvas)
         , start(start)
-        , approx(approx) {}
+        , approx(approx)
+        , dt(approx)
+        , alpha(1.0f) {}
+    ProcessEventArg(ICanvas& canvas, Time start, unsigned int approx,
+                    Time dt, float alpha)
+        : canvas(canvas)
+        , start(start)
+        , approx(approx)
+        , dt(dt)
+        , alpha(alpha) {}
     virtual ~ProcessEventArg() {}
 };
 
@@ -11,6 +11,7 @@
 #include <Display/IViewingVolume.h>
 #include <Renderers/IRenderer.h>
 #include <Core/Exceptions.h>
+#include <Utils/Profiler.h>
 
 namespace OpenEngine {
 namespace Display {
@@ -52,9 +53,11 @@ void RenderCanvas::Handle(Display::ProcessEventArg arg) {
     if (!init) throw new Exception("RenderCanvas not initialized.");
     if (renderer == NULL) throw new Exception("NULL renderer in RenderCanvas.");
 #endif
+    Utils::Profiler::Zone zone("RenderCanvas::Process");
     backend->Pre();
     ((IListener<Renderers::ProcessEventArg>*)renderer)
-        ->Handle(Renderers::ProcessEventArg(*this, arg.start, arg.approx));
+        ->Handle(Renderers::ProcessEventArg(*this, arg.start, arg.approx,
+                                            arg.dt, arg.alpha));
     backend->Post();
 }
 
@@ -0,0 +1,225 @@
+// Axis aligned bounds.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS) 
+// 
+// This program is free software; It is covered by the GNU General 
+// Public License version 2 or any later version. 
+// See the GNU General Public License for more details (see LICENSE). 
+//--------------------------------------------------------------------
+
+#include <Geometry/Bounds.h>
+#include <Geometry/Box.h>
+#include <Geometry/Sphere.h>
+#include <Geometry/Ray.h>
+#include <Geometry/Plane.h>
+
+#include <limits>
+#include <algorithm>
+
+namespace OpenEngine {
+namespace Geometry {
+
+/**
+ * Create empty bounds.
+ */
+Bounds::Bounds() : empty(true) {}
+
+/**
+ * Create bounds from the minimum and maximum corners.
+ */
+Bounds::Bounds(Vector<3,float> min, Vector<3,float> max)
+    : min(min), max(max), empty(false) {}
+
+bool Bounds::IsEmpty() const {
+    return empty;
+}
+
+Vector<3,float> Bounds::GetMin() const {
+    return min;
+}
+
+Vector<3,float> Bounds::GetMax() const {
+    return max;
+}
+
+Vector<3,float> Bounds::GetCenter() const {
+    return (min + max) * 0.5f;
+}
+
+/**
+ * Get the half size of the bounds.
+ */
+Vector<3,float> Bounds::GetExtent() const {
+    return (max - min) * 0.5f;
+}
+
+/**
+ * Get the radius of the bounding sphere around the center.
+ */
+float Bounds::GetRadius() const {
+    return GetExtent().GetLength();
+}
+
+/**
+ * Grow the bounds to include a point.
+ */
+void Bounds::Add(Vector<3,float> point) {
+    if (empty) {
+        min = max = point;
+        empty = false;
+        return;
+    }
+    for (int i = 0; i < 3; i++) {
+        if (point[i] < min[i]) min[i] = point[i];
+        if (point[i] > max[i]) max[i] = point[i];
+    }
+}
+
+/**
+ * Grow the bounds to include other bounds.
+ */
+void Bounds::Add(const Bounds& bounds) {
+    if (bounds.empty) return;
+    Add(bounds.min);
+    Add(bounds.max);
+}
+
+/**
+ * Get the bounds of the transformed corners.
+ * The corners are scaled, rotated and then translated, as by
+ * TransformationNode::GetTransformationMatrix().
+ *
+ * @param position Translation.
+ * @param rotation Rotation.
+ * @param scale Scale along the axes.
+ * @return Transformed bounds.
+ */
+Bounds Bounds::Transform(Vector<3,float> position,
+                         Quaternion<float> rotation,
+                         Vector<3,float> scale) const {
+    Bounds b;
+    if (empty) return b;
+    Vector<3,float> lo = min, hi = max;
+    for (int i = 0; i < 8; i++) {
+        Vector<3,float> c((i & 1 ? hi : lo)[0] * scale[0],
+                          (i & 2 ? hi : lo)[1] * scale[1],
+                          (i & 4 ? hi : lo)[2] * scale[2]);
+        b.Add(rotation.RotateVector(c) + position);
+    }
+    return b;
+}
+
+/**
+ * Test if the bounds overlap.
+ */
+bool Bounds::Intersects(const Bounds& bounds) const {
+    if (empty || bounds.empty) return false;
+    Vector<3,float> lo = min, hi = max, olo = bounds.min, ohi = bounds.max;
+    for (int i = 0; i < 3; i++)
+        if (hi[i] < olo[i] || ohi[i] < lo[i]) return false;
+    return true;
+}
+
+/**
+ * Test if the bounds overlap a sphere.
+ */
+bool Bounds::Intersects(const Sphere& sphere) const {
+    if (empty) return false;
+    float r = sphere.GetRadius();
+    return GetSquaredDistance(sphere.GetCenter()) <= r * r;
+}
+
+/**
+ * Test if a ray hits the bounds.
+ *
+ * @param ray Ray to test.
+ * @param distance Set to the distance along the ray to the first hit,
+ * in lengths of the ray direction, 0 if the ray starts inside.
+ * @return True if the ray hits the bounds.
+ */
+bool Bounds::Intersects(const Ray& ray, float* distance) const {
+    if (empty) return false;
+    Vector<3,float> lo = min, hi = max;
+    Vector<3,float> p = ray.GetPoint(), d = ray.GetDirection();
+    float tmin = 0, tmax = std::numeric_limits<float>::max();
+    for (int i = 0; i < 3; i++) {
+        if (d[i] == 0) {
+            if (p[i] < lo[i] || hi[i] < p[i]) return false;
+            continue;
+        }
+        float t1 = (lo[i] - p[i]) / d[i];
+        float t2 = (hi[i] - p[i]) / d[i];
+        if (t1 > t2) std::swap(t1, t2);
+        if (t1 > tmin) tmin = t1;
+        if (t2 < tmax) tmax = t2;
+        if (tmin > tmax) return false;
+    }
+    if (distance) *distance = tmin;
+    return true;
+}
+
+bool Bounds::Contains(Vector<3,float> point) const {
+    if (empty) return false;
+    Vector<3,float> lo = min, hi = max;
+    for (int i = 0; i < 3; i++)
+        if (point[i] < lo[i] || hi[i] < point[i]) return false;
+    return true;
+}
+
+/**
+ * Test if the bounds are entirely behind a plane, that is on the
+ * side opposite of the normal, as the clipping planes of a Frustum.
+ */
+bool Bounds::IsBehind(const Plane& plane) const {
+    if (empty) return true;
+    Vector<3,float> lo = min, hi = max, n = plane.GetNormal();
+    // the corner furthest along the normal
+    Vector<3,float> c(n[0] > 0 ? hi[0] : lo[0],
+                      n[1] > 0 ? hi[1] : lo[1],
+                      n[2] > 0 ? hi[2] : lo[2]);
+    return c * n + plane.GetDistance() < 0;
+}
+
+/**
+ * Get the squared distance from a point to the bounds, 0 if the point
+ * is inside.
+ */
+float Bounds::GetSquaredDistance(Vector<3,float> point) const {
+    if (empty) return std::numeric_limits<float>::max();
+    Vector<3,float> lo = min, hi = max;
+    float d = 0;
+    for (int i = 0; i < 3; i++) {
+        float v = 0;
+        if (point[i] < lo[i]) v = lo[i] - point[i];
+        else if (point[i] > hi[i]) v = point[i] - hi[i];
+        d += v * v;
+    }
+    return d;
+}
+
+/**
+ * Get the bounds as a box.
+ */
+Box Bounds::GetBox() const {
+    return Box(GetCenter(), GetExtent());
+}
+
+/**
+ * Get the bounding sphere of the bounds.
+ */
+Sphere Bounds::GetSphere() const {
+    return Sphere(GetCenter(), 2 * GetRadius());
+}
+
+bool Bounds::operator==(const Bounds& bounds) const {
+    if (empty || bounds.empty) return empty == bounds.empty;
+    Vector<3,float> lo = min, hi = max;
+    return lo == bounds.min && hi == bounds.max;
+}
+
+bool Bounds::operator!=(const Bounds& bounds) const {
+    return !(*this == bounds);
+}
+
+} // NS Geometry
+} // NS OpenEngine
@@ -0,0 +1,78 @@
+// Axis aligned bounds.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS) 
+// 
+// This program is free software; It is covered by the GNU General 
+// Public License version 2 or any later version. 
+// See the GNU General Public License for more details (see LICENSE). 
+//--------------------------------------------------------------------
+
+#ifndef _GEOMETRY_BOUNDS_H_
+#define _GEOMETRY_BOUNDS_H_
+
+#include <Math/Vector.h>
+#include <Math/Quaternion.h>
+
+#include <cstddef>
+
+namespace OpenEngine {
+namespace Geometry {
+
+class Box;
+class Sphere;
+class Ray;
+class Plane;
+
+using OpenEngine::Math::Vector;
+using OpenEngine::Math::Quaternion;
+
+/**
+ * Axis aligned bounds.
+ * A light weight minimum and maximum corner pair used for bounding
+ * volume hierarchies. Bounds start out empty and grow as points and
+ * other bounds are added. For visibility tests they convert to a Box
+ * or a bounding Sphere.
+ *
+ * @class Bounds Bounds.h Geometry/Bounds.h
+ */
+class Bounds {
+private:
+    Vector<3,float> min, max;
+    bool empty;
+
+public:
+    Bounds();
+    Bounds(Vector<3,float> min, Vector<3,float> max);
+
+    bool IsEmpty() const;
+    Vector<3,float> GetMin() const;
+    Vector<3,float> GetMax() const;
+    Vector<3,float> GetCenter() const;
+    Vector<3,float> GetExtent() const;
+    float GetRadius() const;
+
+    void Add(Vector<3,float> point);
+    void Add(const Bounds& bounds);
+
+    Bounds Transform(Vector<3,float> position,
+                     Quaternion<float> rotation,
+                     Vector<3,float> scale) const;
+
+    bool Intersects(const Bounds& bounds) const;
+    bool Intersects(const Sphere& sphere) const;
+    bool Intersects(const Ray& ray, float* distance = NULL) const;
+    bool Contains(Vector<3,float> point) const;
+    bool IsBehind(const Plane& plane) const;
+    float GetSquaredDistance(Vector<3,float> point) const;
+
+    Box GetBox() const;
+    Sphere GetSphere() const;
+
+    bool operator==(const Bounds& bounds) const;
+    bool operator!=(const Bounds& bounds) const;
+};
+
+} // NS Geometry
+} // NS OpenEngine
+
+#endif // _GEOMETRY_BOUNDS_H_
@@ -45,6 +45,8 @@ Box::Box(FaceSet& faces) {
  * the corner will be [0,0,0].
  *
  * @TODO Make sure that transformation nodes are accounted for!
+ * @deprecated Use ISceneNode::GetBounds().GetBox(), which accounts
+ *             for transformation nodes.
  * @param node root node to create a box from.
  */
 Box::Box(ISceneNode& node) {
@@ -123,8 +123,9 @@ Face::~Face() {
  */
 int Face::ComparePointPlane(const Vector<3,float>& point, const float epsilon) {
 	if (hardNorm.GetLength() == 0.0f) {
-		logger.warning << "hardNorm is 0.0f: " << vert[0] << ","
-                       << vert[1] << "," << vert[2] << logger.end;
+		OE_LOG_RATE_LIMITED(warning, 1000000)
+            << "hardNorm is 0.0f: " << vert[0] << ","
+            << vert[1] << "," << vert[2] << logger.end;
     }
 
     // Calculate the distance from constraint p1 to plane.
@@ -284,7 +285,7 @@ void Face::CalcHardNorm() {
 
     // check if the normal is valid
     if (h.IsZero()) {
-        logger.warning << "Normal is zero due to invalid face." << logger.end;
+        OE_LOG_RATE_LIMITED(warning, 1000000) << "Normal is zero due to invalid face." << logger.end;
         return;
     }
 
@@ -75,11 +75,11 @@ Line* Line::ShortestLineBetweenRays(Vector<3,float> direction1, Vector<3,float>
     Vector<3,float> p3 = pointOnLine2;
 
     if( fabs(p21[0]) < EPS && fabs(p21[1]) < EPS && fabs(p21[2]) < EPS){
-        logger.warning << "p21 < EPS" << logger.end;
+        OE_LOG_RATE_LIMITED(warning, 1000000) << "p21 < EPS" << logger.end;
         return NULL;
     }
     if( fabs(p43[0]) < EPS && fabs(p43[1]) < EPS && fabs(p43[2]) < EPS){
-        logger.warning << "p43 < EPS" << logger.end;
+        OE_LOG_RATE_LIMITED(warning, 1000000) << "p43 < EPS" << logger.end;
         return NULL;
     }
 
@@ -88,7 +88,7 @@ Line* Line::ShortestLineBetweenRays(Vector<3,float> direction1, Vector<3,float>
     double d4343 = p43 * p43;
     double denom = d2121 * d4343 - d4321 * d4321;
     if( fabs(denom) < EPS ){
-        logger.warning << "fabs(denom) < EPS" << logger.end;
+        OE_LOG_RATE_LIMITED(warning, 1000000) << "fabs(denom) < EPS" << logger.end;
         return NULL;
     }
     Vector<3,float> p13 = p1 - p3;
@@ -39,11 +39,11 @@ void Ray::SetDirection(Vector<3,float> direction) {
     this->dir = direction;
 }
 
-Vector<3,float> Ray::GetPoint() {
+Vector<3,float> Ray::GetPoint() const {
     return point;
 }
 
-Vector<3,float> Ray::GetDirection() {
+Vector<3,float> Ray::GetDirection() const {
     return dir;
 }
 
@@ -39,8 +39,8 @@ public:
     Ray(Vector<3,float> point, Vector<3,float> direction);
     ~Ray();
 
-    Vector<3,float> GetPoint();
-    Vector<3,float> GetDirection();
+    Vector<3,float> GetPoint() const;
+    Vector<3,float> GetDirection() const;
 
     void SetPoint(Vector<3,float> point);
     void SetDirection(Vector<3,float> direction);
@@ -0,0 +1,215 @@
+// Asynchronous logging backend.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+// --------------------------------------------------------------------
+
+#include <Logging/AsyncLogBackend.h>
+#include <Core/Atomic.h>
+
+#include <algorithm>
+#include <sys/time.h>
+
+namespace OpenEngine {
+namespace Logging {
+
+using Core::AtomicAdd;
+using Core::MemoryBarrier;
+using Core::Thread;
+
+// distinguishes backends so threads drop buffers of stopped ones
+static volatile unsigned int generations = 0;
+
+static bool BySequence(const LogRecord& a, const LogRecord& b) {
+    return a.sequence < b.sequence;
+}
+
+/**
+ * Create a backend and start its flusher thread.
+ */
+AsyncLogBackend::AsyncLogBackend(const AsyncLogConfig& config)
+    : config(config)
+    , generation(AtomicAdd(generations, 1u))
+    , flusher(*this)
+    , accepting(true)
+    , inflight(0)
+    , dropped(0)
+    , posted(0)
+    , written(0)
+    , wake(false) {
+    pthread_mutex_init(&wakeLock, NULL);
+    pthread_cond_init(&wakeCond, NULL);
+    flusher.Start();
+}
+
+/**
+ * Stops the flusher and frees the buffers.
+ */
+AsyncLogBackend::~AsyncLogBackend() {
+    Stop();
+    for (unsigned int i = 0; i < buffers.size(); i++)
+        delete buffers[i];
+    pthread_cond_destroy(&wakeCond);
+    pthread_mutex_destroy(&wakeLock);
+}
+
+/**
+ * Post a record from the calling thread.
+ *
+ * @param record Record to log.
+ * @param buffer Buffer of the calling thread, registered if NULL.
+ * @return False if the backend no longer accepts records and the
+ *         record must be written by the caller.
+ */
+bool AsyncLogBackend::Post(const LogRecord& record, Buffer*& buffer) {
+    AtomicAdd(inflight, 1u);
+    if (!accepting) {
+        AtomicAdd(inflight, -1u);
+        return false;
+    }
+    if (buffer == NULL) buffer = Register();
+    bool put = buffer->Put(record);
+    if (!put && config.overflow == AsyncLogConfig::BLOCK) {
+        // back pressure, wait for the flusher to make room
+        while (!put) {
+            Wake();
+            Thread::Yield();
+            put = buffer->Put(record);
+        }
+    }
+    if (put) AtomicAdd(posted, (uint64_t)1);
+    else AtomicAdd(dropped, 1u);
+    AtomicAdd(inflight, -1u);
+    if (record.type == Error || buffer->Size() > buffer->Capacity() / 2)
+        Wake();
+    return true;
+}
+
+/**
+ * Wait until all records posted before the call are written.
+ */
+void AsyncLogBackend::Flush() {
+    uint64_t target = posted;
+    while (written < target && flusher.IsRunning()) {
+        Wake();
+        Thread::Sleep(100);
+    }
+}
+
+/**
+ * Write the buffered records and join the flusher.
+ */
+void AsyncLogBackend::Stop() {
+    flusher.RequestStop();
+    flusher.Wait();
+}
+
+bool AsyncLogBackend::IsAccepting() const {
+    return accepting;
+}
+
+/**
+ * Number of records dropped because a thread buffer was full.
+ */
+unsigned int AsyncLogBackend::GetDropped() const {
+    return dropped;
+}
+
+unsigned int AsyncLogBackend::GetGeneration() const {
+    return generation;
+}
+
+/**
+ * Retire the buffer of an exiting thread. The buffer is freed by the
+ * flusher once it has been drained.
+ */
+void AsyncLogBackend::Retire(Buffer* buffer) {
+    buffersLock.Lock();
+    retired.push_back(buffer);
+    buffersLock.Unlock();
+    Wake();
+}
+
+/**
+ * Number of thread buffers, including retired buffers not yet freed.
+ */
+unsigned int AsyncLogBackend::GetBufferCount() {
+    buffersLock.Lock();
+    unsigned int n = buffers.size();
+    buffersLock.Unlock();
+    return n;
+}
+
+AsyncLogBackend::Buffer* AsyncLogBackend::Register() {
+    Buffer* b = new Buffer(config.capacity);
+    buffersLock.Lock();
+    buffers.push_back(b);
+    buffersLock.Unlock();
+    return b;
+}
+
+void AsyncLogBackend::Wake() {
+    pthread_mutex_lock(&wakeLock);
+    wake = true;
+    pthread_cond_signal(&wakeCond);
+    pthread_mutex_unlock(&wakeLock);
+}
+
+void AsyncLogBackend::FlusherLoop() {
+    for (;;) {
+        pthread_mutex_lock(&wakeLock);
+        if (!wake && !flusher.IsStopRequested()) {
+            struct timeval now;
+            gettimeofday(&now, NULL);
+            uint64_t usec = now.tv_usec + config.interval;
+            struct timespec deadline;
+            deadline.tv_sec = now.tv_sec + usec / 1000000;
+            deadline.tv_nsec = (usec % 1000000) * 1000;
+            pthread_cond_timedwait(&wakeCond, &wakeLock, &deadline);
+        }
+        wake = false;
+        pthread_mutex_unlock(&wakeLock);
+
+        if (flusher.IsStopRequested()) {
+            accepting = false;
+            MemoryBarrier();
+            // blocked producers need us to make room
+            while (inflight > 0) {
+                Drain();
+                Thread::Yield();
+            }
+            Drain();
+            return;
+        }
+        Drain();
+    }
+}
+
+// Move the buffered records of all threads to the loggers, ordered
+// by when they were logged, and free the buffers retired before.
+void AsyncLogBackend::Drain() {
+    buffersLock.Lock();
+    std::vector<Buffer*> dead;
+    dead.swap(retired);
+    LogRecord r;
+    for (unsigned int i = 0; i < buffers.size(); i++)
+        while (buffers[i]->Get(r))
+            batch.push_back(r);
+    for (unsigned int i = 0; i < dead.size(); i++) {
+        buffers.erase(std::find(buffers.begin(), buffers.end(), dead[i]));
+        delete dead[i];
+    }
+    buffersLock.Unlock();
+    if (batch.empty()) return;
+    std::stable_sort(batch.begin(), batch.end(), BySequence);
+    for (unsigned int i = 0; i < batch.size(); i++)
+        Logger::WriteRecord(batch[i]);
+    AtomicAdd(written, (uint64_t)batch.size());
+    batch.clear();
+}
+
+} //NS Logging
+} //NS OpenEngine
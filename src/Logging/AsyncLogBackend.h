@@ -0,0 +1,107 @@
+// Asynchronous logging backend.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+// --------------------------------------------------------------------
+
+#ifndef _ASYNC_LOG_BACKEND_H_
+#define _ASYNC_LOG_BACKEND_H_
+
+#include <Logging/Logger.h>
+#include <Logging/LogRecord.h>
+#include <Core/ConcurrentQueue.h>
+#include <Core/Thread.h>
+#include <Core/Mutex.h>
+
+#include <pthread.h>
+#include <vector>
+
+namespace OpenEngine {
+namespace Logging {
+
+/**
+ * Asynchronous logging backend.
+ * Each logging thread puts its records in its own lock free buffer.
+ * A flusher thread periodically moves the records of all buffers to
+ * the loggers, so the loggers only run on the flusher thread. The
+ * records of a thread are written in order, and records flushed
+ * together are ordered by when they were logged. Error records are
+ * flushed right away. The buffer of a thread is freed after the
+ * thread exits and its records have been written.
+ *
+ * When the flusher is asked to stop, for instance by
+ * Core::Thread::JoinAll, it stops accepting records, writes what is
+ * buffered and exits. Records logged after that are written
+ * synchronously.
+ *
+ * Used through Logger::StartAsync.
+ *
+ * @class AsyncLogBackend AsyncLogBackend.h Logging/AsyncLogBackend.h
+ */
+class AsyncLogBackend {
+public:
+    typedef Core::ConcurrentQueue<LogRecord> Buffer;
+
+    AsyncLogBackend(const AsyncLogConfig& config);
+    ~AsyncLogBackend();
+
+    bool Post(const LogRecord& record, Buffer*& buffer);
+    void Flush();
+    void Stop();
+    bool IsAccepting() const;
+    unsigned int GetDropped() const;
+    unsigned int GetGeneration() const;
+    void Retire(Buffer* buffer);
+    unsigned int GetBufferCount();
+
+private:
+    class Flusher : public Core::Thread {
+    public:
+        AsyncLogBackend& backend;
+        Flusher(AsyncLogBackend& backend)
+            : Thread("oe-log"), backend(backend) {
+            SetJoinOnShutdown(true);
+        }
+        void Run() { backend.FlusherLoop(); }
+        void RequestStop() {
+            Thread::RequestStop();
+            backend.Wake();
+        }
+    };
+
+    AsyncLogConfig config;
+    unsigned int generation;
+    Flusher flusher;
+
+    std::vector<Buffer*> buffers;
+    std::vector<Buffer*> retired;       //!< buffers of exited threads
+    Core::Mutex buffersLock;
+
+    volatile bool accepting;
+    volatile unsigned int inflight;     //!< threads posting right now
+    volatile unsigned int dropped;
+    volatile uint64_t posted;
+    volatile uint64_t written;
+
+    pthread_mutex_t wakeLock;
+    pthread_cond_t wakeCond;
+    bool wake;
+
+    std::vector<LogRecord> batch;
+
+    AsyncLogBackend(const AsyncLogBackend&);
+    AsyncLogBackend& operator=(const AsyncLogBackend&);
+
+    Buffer* Register();
+    void Wake();
+    void FlusherLoop();
+    void Drain();
+};
+
+} //NS Logging
+} //NS OpenEngine
+
+#endif // _ASYNC_LOG_BACKEND_H_
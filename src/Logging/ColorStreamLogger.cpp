@@ -62,6 +62,22 @@ void ColorStreamLogger::Write(LoggerType type, string msg) {
     *stream << std::endl;
 }
 
+/**
+ * Write a log record, stamped with its time and thread.
+ *
+ * @param record Record to log.
+ */
+void ColorStreamLogger::Write(const LogRecord& record) {
+    if (colorsEnabled)
+        *stream << "\033[" << ColorForType(record.type) << 'm';
+    *stream << TypeToString(record.type) << " ";
+    record.WriteStamp(*stream);
+    *stream << ": " << record.message;
+    if (colorsEnabled)
+        *stream << "\033[" << 'm';
+    *stream << std::endl;
+}
+
 /**
  * Get string representation for a log message type.
  *
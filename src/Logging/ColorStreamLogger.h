@@ -38,6 +38,7 @@ public:
     ColorStreamLogger(ostream* stream);
     virtual ~ColorStreamLogger();
     void Write(LoggerType, string);
+    void Write(const LogRecord& record);
     std::string TypeToString(LoggerType);
 };
 
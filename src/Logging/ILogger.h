@@ -12,6 +12,7 @@
 
 #include <string>
 #include <Logging/LoggerType.h>
+#include <Logging/LogRecord.h>
 
 namespace OpenEngine {
 namespace Logging {
@@ -37,6 +38,17 @@ public:
      */
     virtual void Write(LoggerType type, string msg) = 0;
 
+    /**
+     * Write a log record.
+     * Loggers that show the time or thread of a message should
+     * override this. The default writes the message only.
+     *
+     * @param record Record to log.
+     */
+    virtual void Write(const LogRecord& record) {
+        Write(record.type, record.message);
+    }
+
 };
 
 } //NS Logging
@@ -0,0 +1,35 @@
+// Log record.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+// --------------------------------------------------------------------
+
+#include <Logging/LogRecord.h>
+#include <Utils/DateTime.h>
+
+#include <iomanip>
+
+namespace OpenEngine {
+namespace Logging {
+
+/**
+ * Write the time and thread of the record.
+ * Ex. 2009/07/13 14:02:11.042 [3 loader]
+ *
+ * @param out Stream to write to.
+ */
+void LogRecord::WriteStamp(std::ostream& out) const {
+    out << Utils::DateTime::FromTime(time) << ".";
+    char fc = out.fill('0');
+    out << std::setw(3) << usec / 1000;
+    out.fill(fc);
+    out << " [" << thread;
+    if (!threadName.empty()) out << " " << threadName;
+    out << "]";
+}
+
+} //NS Logging
+} //NS OpenEngine
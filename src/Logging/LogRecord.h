@@ -0,0 +1,53 @@
+// Log record.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+// --------------------------------------------------------------------
+
+#ifndef _LOG_RECORD_H_
+#define _LOG_RECORD_H_
+
+#include <Logging/LoggerType.h>
+#include <Meta/Types.h>
+#include <Meta/Time.h>
+
+#include <string>
+#include <ostream>
+
+namespace OpenEngine {
+namespace Logging {
+
+/**
+ * Log record.
+ * A log message with the time and thread it was logged from. With
+ * asynchronous logging the record is written by another thread, so
+ * loggers should use the record time and not the current time.
+ *
+ * @class LogRecord LogRecord.h Logging/LogRecord.h
+ */
+class LogRecord {
+public:
+    LoggerType type;
+    std::string message;
+    time_t time;                //!< wall clock seconds
+    unsigned int usec;          //!< microseconds of the second
+    unsigned int thread;        //!< logging thread number
+    std::string threadName;     //!< empty if the thread is unnamed
+    uint64_t sequence;          //!< order the record was logged in
+
+    LogRecord()
+        : type(Info), time(0), usec(0), thread(0), sequence(0) {}
+    LogRecord(LoggerType type, const std::string& message)
+        : type(type), message(message), time(0), usec(0)
+        , thread(0), sequence(0) {}
+
+    void WriteStamp(std::ostream& out) const;
+};
+
+} //NS Logging
+} //NS OpenEngine
+
+#endif // _LOG_RECORD_H_
@@ -9,14 +9,97 @@
 
 #include <Logging/Logger.h>
 #include <Logging/ILogger.h>
+#include <Logging/AsyncLogBackend.h>
+#include <Core/ThreadStorage.h>
+#include <Core/Atomic.h>
+#include <Core/Mutex.h>
+#include <Utils/Clock.h>
+
+#include <sys/time.h>
 
 namespace OpenEngine {
 namespace Logging {
 
+using Core::ThreadStorage;
+using Core::Mutex;
+using Core::AtomicAdd;
+using Core::AtomicCompareAndSwap;
+using Utils::Clock;
+
 // initialization of static members
 list<ILogger*> Logger::loggerList;
+AsyncLogBackend* Logger::backend = NULL;
+LoggerType Logger::level = Info;
+
+// guards the logger list and serializes writes to the loggers
+static Mutex loggersLock;
+static volatile unsigned int threads = 0;
+static volatile uint64_t sequence = 0;
+
+// Logging state of a thread.
+class Logger::LogThread {
+public:
+    unsigned int id;
+    unsigned int generation;
+    AsyncLogBackend::Buffer* buffer;
+    ostringstream* messages[3];     // message buffers by logger type
+    LogThread() : id(AtomicAdd(threads, 1u)), generation(0), buffer(NULL) {
+        for (unsigned int i = 0; i < 3; i++) messages[i] = NULL;
+    }
+    ~LogThread() {
+        for (unsigned int i = 0; i < 3; i++) delete messages[i];
+    }
+};
+
+// Hand the buffer of an exiting thread back to its backend, which
+// frees it once it has been drained.
+void Logger::ReleaseThread(void* value) {
+    LogThread* t = static_cast<LogThread*>(value);
+    AsyncLogBackend* b = backend;
+    if (t->buffer != NULL && b != NULL && t->generation == b->GetGeneration())
+        b->Retire(t->buffer);
+    delete t;
+}
+
+Logger::LogThread& Logger::CurrentThread() {
+    static const unsigned int slot = ThreadStorage::AllocateSlot(ReleaseThread);
+    ThreadStorage& ts = ThreadStorage::Current();
+    LogThread* t = static_cast<LogThread*>(ts.Get(slot));
+    if (t == NULL) ts.Set(slot, t = new LogThread());
+    return *t;
+}
 
 Logger::Logger() : info(Info), warning(Warning), error(Error), end() {}
+
+/**
+ * Set the runtime log threshold.
+ * Messages of a lower type are discarded without being formatted.
+ *
+ * @param level Lowest type to log, Info logs everything.
+ */
+void Logger::SetLevel(LoggerType level) {
+    Logger::level = level;
+}
+
+/**
+ * Get the runtime log threshold.
+ */
+LoggerType Logger::GetLevel() {
+    return level;
+}
+
+/**
+ * Check if a message may be logged now.
+ * Counts the message as suppressed if not.
+ */
+bool LogRateLimiter::Allow() {
+    uint64_t now = Clock::Now().AsNanoseconds();
+    uint64_t n = next;
+    if (now >= n && AtomicCompareAndSwap(next, n, now + interval))
+        return true;
+    AtomicAdd(suppressed, 1u);
+    return false;
+}
  
 /**
  * Add a new logger instance to list of active loggers.
@@ -24,7 +107,9 @@ Logger::Logger() : info(Info), warning(Warning), error(Error), end() {}
  * @param logger Logger to add.
  */
 void Logger::AddLogger(ILogger* logger){
+    loggersLock.Lock();
     loggerList.push_back(logger);
+    loggersLock.Unlock();
 }
 
 /**
@@ -33,21 +118,119 @@ void Logger::AddLogger(ILogger* logger){
  * @param logger Logger to remove.
  */
 void Logger::RemoveLogger(ILogger* logger){
+    loggersLock.Lock();
     loggerList.remove(logger);
+    loggersLock.Unlock();
 }
 
 /**
  * Write a message to the log.
+ * The message is stamped with the time and the logging thread. In
+ * asynchronous mode it is handed to the flusher thread, otherwise it
+ * is written to the loggers right away.
  *
  * @param type Logging type.
  * @param str Message to log.
  */
 void Logger::WriteToLog(LoggerType type, string msg){
+    LogRecord record(type, msg);
+    struct timeval now;
+    gettimeofday(&now, NULL);
+    record.time = now.tv_sec;
+    record.usec = now.tv_usec;
+    LogThread& t = CurrentThread();
+    record.thread = t.id;
+    record.threadName = ThreadStorage::Current().GetThreadName();
+    record.sequence = AtomicAdd(sequence, (uint64_t)1);
+
+    AsyncLogBackend* b = backend;
+    if (b != NULL) {
+        if (t.generation != b->GetGeneration()) {
+            t.generation = b->GetGeneration();
+            t.buffer = NULL;
+        }
+        if (b->Post(record, t.buffer)) return;
+    }
+    WriteRecord(record);
+}
+
+/**
+ * Write a record to all loggers.
+ */
+void Logger::WriteRecord(const LogRecord& record) {
+    loggersLock.Lock();
     list<ILogger*>::const_iterator itr = loggerList.begin();
     while( itr != loggerList.end() ){
-        (*itr)->Write(type, msg);
+        (*itr)->Write(record);
         itr++;
     }
+    loggersLock.Unlock();
+}
+
+/**
+ * Start asynchronous logging.
+ * Messages are buffered per thread and written by a flusher thread,
+ * so logging never waits for the loggers. Restarts the flusher if
+ * already asynchronous.
+ *
+ * @param config Buffer size, overflow policy and flush interval.
+ */
+void Logger::StartAsync(const AsyncLogConfig& config) {
+    StopAsync();
+    backend = new AsyncLogBackend(config);
+}
+
+/**
+ * Write all buffered messages and return to synchronous logging.
+ * Must not be called while other threads are logging.
+ */
+void Logger::StopAsync() {
+    if (backend == NULL) return;
+    AsyncLogBackend* b = backend;
+    b->Stop();
+    backend = NULL;
+    delete b;
+}
+
+/**
+ * Wait until all messages logged before the call have been written.
+ */
+void Logger::Flush() {
+    if (backend != NULL) backend->Flush();
+}
+
+/**
+ * Check if messages are written asynchronously.
+ */
+bool Logger::IsAsync() {
+    return backend != NULL && backend->IsAccepting();
+}
+
+/**
+ * Number of messages dropped because a thread buffer was full.
+ */
+unsigned int Logger::GetDropped() {
+    return backend != NULL ? backend->GetDropped() : 0;
+}
+
+/**
+ * Number of thread buffers held by the asynchronous backend. Buffers
+ * of exited threads are freed once they have been drained.
+ */
+unsigned int Logger::GetBufferCount() {
+    return backend != NULL ? backend->GetBufferCount() : 0;
+}
+
+/**
+ * Get the message buffer of the calling thread.
+ * Each thread formats its messages in its own buffers, so threads
+ * logging at the same time do not mix their messages.
+ */
+ostringstream& Logger::LoggerTypeObj::Buffer() {
+    LogThread& t = CurrentThread();
+    unsigned int i = type == Error ? 2 : (type == Warning ? 1 : 0);
+    if (t.messages[i] == NULL) t.messages[i] = new ostringstream();
+    return *t.messages[i];
 }
 
 /**
@@ -56,9 +239,9 @@ void Logger::WriteToLog(LoggerType type, string msg){
  * @param e Log end type
  */
 Logger::LoggerTypeObj& Logger::LoggerTypeObj::operator<<(LogEnd e){
-    if(logger.end==e){
+    if(IsEnabled() && logger.end==e){
+        ostringstream& buffer = Buffer();
         Logger::WriteToLog(type, buffer.str());
-        buffer.flush();
         buffer.str("");
         buffer.clear();
     }
@@ -69,6 +252,8 @@ Logger::LoggerTypeObj& Logger::LoggerTypeObj::operator<<(LogEnd e){
  * Deinitialize the logger.
  */
 void Logger::Deinitialize() {
+    StopAsync();
+    loggersLock.Lock();
     list<ILogger*>::const_iterator itr = loggerList.begin();
     while (itr != loggerList.end()) {
         ILogger* logger = (*itr);
@@ -76,6 +261,7 @@ void Logger::Deinitialize() {
         itr++;
     }
     loggerList.clear();
+    loggersLock.Unlock();
 }
 
 } //NS Logging
@@ -15,6 +15,18 @@
 #include <iostream>
 #include <list>
 #include <Logging/LoggerType.h>
+#include <Logging/LogRecord.h>
+#include <Core/Atomic.h>
+#include <Meta/Types.h>
+
+/**
+ * Compile time log threshold.
+ * Messages logged with OE_LOG and friends below this level are
+ * compiled out. Defaults to logging everything.
+ */
+#ifndef OE_LOG_LEVEL
+#define OE_LOG_LEVEL 0
+#endif
 
 namespace OpenEngine {
 namespace Logging {
@@ -23,15 +35,103 @@ using namespace std;
 
 //forward declarations
 class ILogger;
+class AsyncLogBackend;
+
+/**
+ * Asynchronous logging settings.
+ *
+ * @class AsyncLogConfig Logger.h Logging/Logger.h
+ * @see Logger::StartAsync
+ */
+class AsyncLogConfig {
+public:
+    /**
+     * What a thread does when its log buffer is full.
+     * DROP discards the record and counts it, BLOCK waits for the
+     * flusher to make room.
+     */
+    enum OverflowPolicy { DROP, BLOCK };
+
+    unsigned int capacity;      //!< buffered records per thread
+    OverflowPolicy overflow;    //!< full buffer policy
+    unsigned int interval;      //!< flush interval in microseconds
+
+    AsyncLogConfig()
+        : capacity(1024), overflow(DROP), interval(10000) {}
+};
+
+/**
+ * Log rate limiter.
+ * Lets a message through at most once per interval. Used by
+ * OE_LOG_RATE_LIMITED for messages on hot paths that would otherwise
+ * be logged every frame.
+ *
+ * @class LogRateLimiter Logger.h Logging/Logger.h
+ */
+class LogRateLimiter {
+private:
+    uint64_t interval;
+    volatile uint64_t next;
+    volatile unsigned int suppressed;
+public:
+    /**
+     * @param usec Minimal time between messages in microseconds.
+     */
+    LogRateLimiter(uint64_t usec)
+        : interval(usec * 1000), next(0), suppressed(0) {}
+    bool Allow();
+    unsigned int GetSuppressed() const { return suppressed; }
+};
+
+namespace {
+
+/**
+ * State of a call site of the rate limited logging macros. Sites are
+ * numbered within a translation unit, see OE_LOG_SITE, and the
+ * anonymous namespace keeps the sites of different translation units
+ * apart.
+ */
+template <int Site>
+class LogSite {
+public:
+    static bool Allow(uint64_t usec) {
+        static LogRateLimiter limiter(usec);
+        return limiter.Allow();
+    }
+    static bool Every(unsigned int n) {
+        static volatile unsigned int count = 0;
+        return (Core::AtomicAdd(count, 1u) - 1) % n == 0;
+    }
+};
+
+}
 
 /**
  * Log facility.
+ * Messages are written with a stream syntax:
+ * @code
+ * logger.warning << "Texture " << name << " not found." << logger.end;
+ * @endcode
+ * Messages below the runtime threshold, see SetLevel(), are not
+ * formatted. The OE_LOG macros also skip evaluating the message
+ * arguments and compile out messages below OE_LOG_LEVEL:
+ * @code
+ * OE_LOG(info) << "Loaded " << Describe(mesh) << logger.end;
+ * OE_LOG_RATE_LIMITED(warning, 1000000) << "Invalid face." << logger.end;
+ * @endcode
  *
  * @class Logger Logger.h Logging/Logger.h
  */
 class Logger {
+    friend class AsyncLogBackend;
 private:
     static list<ILogger*> loggerList;
+    static AsyncLogBackend* backend;
+    static LoggerType level;
+
+    class LogThread;
+    static LogThread& CurrentThread();
+    static void ReleaseThread(void* value);
 
     class LogEnd {
     public:
@@ -41,36 +141,42 @@ private:
     };
     class LoggerTypeObj {
     private:
-        ostringstream buffer;
         LoggerType type;
         LoggerTypeObj(){}
+        // message buffer of the calling thread
+        ostringstream& Buffer();
     public:
         LoggerTypeObj(LoggerType t) : type(t) {}
+        //! Check if messages of this type pass the runtime threshold.
+        bool IsEnabled() const {
+            return type >= Logger::level;
+        }
         LoggerTypeObj& operator<<(LogEnd);
         template <class T>
         LoggerTypeObj& operator<<(T input) {
-            buffer << input;
+            if (IsEnabled()) Buffer() << input;
             return *this;
         }
         LoggerTypeObj& operator<<(int input) {
-            buffer << input;
+            if (IsEnabled()) Buffer() << input;
             return *this;
         }
         LoggerTypeObj& operator<<(float input) {
-            buffer << input;
+            if (IsEnabled()) Buffer() << input;
             return *this;
         }
         LoggerTypeObj& operator<<(char input) {
-            buffer << input;
+            if (IsEnabled()) Buffer() << input;
             return *this;
         }
         LoggerTypeObj& operator<<(char* input) {
-            buffer << input;
+            if (IsEnabled()) Buffer() << input;
             return *this;
         }
         ~LoggerTypeObj(){}
     };
     static void WriteToLog(LoggerType type, string str);
+    static void WriteRecord(const LogRecord& record);
 public:
 
     LoggerTypeObj info;         //!< Info log.
@@ -81,6 +187,17 @@ public:
     static void AddLogger(ILogger* logger);
     static void RemoveLogger(ILogger* logger);
     static void Deinitialize();
+
+    static void SetLevel(LoggerType level);
+    static LoggerType GetLevel();
+
+    static void StartAsync(const AsyncLogConfig& config = AsyncLogConfig());
+    static void StopAsync();
+    static void Flush();
+    static bool IsAsync();
+    static unsigned int GetDropped();
+    static unsigned int GetBufferCount();
+
     Logger();
 };
 
@@ -89,4 +206,53 @@ public:
 
 static OpenEngine::Logging::Logger logger;
 
+// severity of the logger streams for the compile time threshold
+#define OE_LOG_LEVEL_info    0
+#define OE_LOG_LEVEL_warning 10
+#define OE_LOG_LEVEL_error   20
+
+/**
+ * Check if a logger stream (info, warning or error) is enabled both
+ * at compile time and at runtime.
+ */
+#define OE_LOG_ENABLED(level)                                   \
+    (OE_LOG_LEVEL_##level >= OE_LOG_LEVEL && logger.level.IsEnabled())
+
+/**
+ * Log to a stream if enabled. The message is not evaluated otherwise.
+ */
+#define OE_LOG(level)                                           \
+    if (!OE_LOG_ENABLED(level)) ; else logger.level
+
+// number of the current logging call site. The macros expand to an
+// expression, where a function local static can not be declared, so
+// the site is a template argument. GCC, Clang and MSVC number sites
+// with __COUNTER__. Other compilers fall back to the line number, in
+// which case rate limited sites on the same line share their state.
+#ifdef __COUNTER__
+#define OE_LOG_SITE __COUNTER__
+#else
+#define OE_LOG_SITE __LINE__
+#endif
+
+/**
+ * Log to a stream at most once per \a usec microseconds from this
+ * call site. Without __COUNTER__ the sites on one line share a
+ * limit, so put each on its own line.
+ */
+#define OE_LOG_RATE_LIMITED(level, usec)                        \
+    if (!OE_LOG_ENABLED(level) ||                               \
+        !OpenEngine::Logging::LogSite<OE_LOG_SITE>::Allow(usec)) ; \
+    else logger.level
+
+/**
+ * Log to a stream on the first and then every \a n'th time this call
+ * site is reached. Without __COUNTER__ the sites on one line share a
+ * count, so put each on its own line.
+ */
+#define OE_LOG_EVERY_N(level, n)                                \
+    if (!OE_LOG_ENABLED(level) ||                               \
+        !OpenEngine::Logging::LogSite<OE_LOG_SITE>::Every(n)) ; \
+    else logger.level
+
 #endif // _LOG_H_
@@ -48,6 +48,17 @@ void StreamLogger::Write(LoggerType type, string msg) {
     *stream << msg << std::endl;
 }
 
+/**
+ * Write a log record, stamped with its time and thread.
+ *
+ * @param record Record to log.
+ */
+void StreamLogger::Write(const LogRecord& record) {
+    *stream << TypeToString(record.type) << " ";
+    record.WriteStamp(*stream);
+    *stream << ": " << record.message << std::endl;
+}
+
 /**
  * Get string representation for a log message type.
  *
@@ -34,6 +34,7 @@ public:
     StreamLogger(ostream* stream);
     virtual ~StreamLogger();
     void Write(LoggerType, string);
+    void Write(const LogRecord& record);
     std::string TypeToString(LoggerType);
 };
 
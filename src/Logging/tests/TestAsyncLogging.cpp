@@ -0,0 +1,96 @@
+#include <Testing/Testing.h>
+
+#include <Logging/Logger.h>
+#include <Logging/ILogger.h>
+#include <Core/Thread.h>
+
+#include <vector>
+#include <map>
+
+using namespace OpenEngine::Logging;
+using OpenEngine::Core::Thread;
+
+// Logger keeping the records it is given
+class RecordLogger : public ILogger {
+public:
+    std::vector<LogRecord> records;
+    pthread_t writer;
+    void Write(LoggerType type, string msg) {
+        Write(LogRecord(type, msg));
+    }
+    void Write(const LogRecord& record) {
+        writer = pthread_self();
+        records.push_back(record);
+    }
+};
+
+class Producer : public Thread {
+public:
+    Producer() : Thread("producer") {}
+    void Run() {
+        for (int i = 0; i < 100; i++)
+            logger.info << "message " << i << logger.end;
+    }
+};
+
+int test_main(int argc, char* argv[]) {
+    RecordLogger* sink = new RecordLogger();
+    Logger::AddLogger(sink);
+
+    // synchronous logging writes on the calling thread
+    logger.info << "sync" << logger.end;
+    OE_CHECK(sink->records.size() == 1);
+    OE_CHECK(pthread_equal(sink->writer, pthread_self()));
+    OE_CHECK(sink->records[0].time != 0);
+
+    // asynchronous logging writes on the flusher in logging order
+    AsyncLogConfig config;
+    config.capacity = 4;
+    config.overflow = AsyncLogConfig::BLOCK;
+    Logger::StartAsync(config);
+    OE_CHECK(Logger::IsAsync());
+    Producer p1, p2;
+    p1.Start();
+    p2.Start();
+    logger.warning << "main" << logger.end;
+    p1.Wait();
+    p2.Wait();
+    Logger::Flush();
+    OE_CHECK(sink->records.size() == 202);
+    OE_CHECK(!pthread_equal(sink->writer, pthread_self()));
+    OE_CHECK(Logger::GetDropped() == 0);
+    // records of each thread keep their order
+    bool ordered = true;
+    unsigned int named = 0;
+    std::map<unsigned int, uint64_t> last;
+    for (unsigned int i = 1; i < sink->records.size(); i++) {
+        const LogRecord& r = sink->records[i];
+        ordered &= last[r.thread] < r.sequence;
+        last[r.thread] = r.sequence;
+        if (r.threadName == "producer") named++;
+    }
+    OE_CHECK(ordered);
+    OE_CHECK(named == 200);
+
+    // buffers of exited threads are freed
+    for (int i = 0; i < 50; i++) {
+        Producer p;
+        p.Start();
+        p.Wait();
+    }
+    logger.info << "main" << logger.end;
+    Logger::Flush();
+    OE_CHECK(sink->records.size() == 5203);
+    OE_CHECK(Logger::GetBufferCount() == 1);
+
+    // stopping the flusher returns to synchronous logging
+    Thread::JoinAll();
+    OE_CHECK(!Logger::IsAsync());
+    logger.info << "after" << logger.end;
+    OE_CHECK(sink->records.size() == 5204);
+
+    Logger::StopAsync();
+    Logger::RemoveLogger(sink);
+    delete sink;
+    return 0;
+}
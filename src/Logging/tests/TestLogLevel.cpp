@@ -0,0 +1,75 @@
+#include <Testing/Testing.h>
+
+#include <Logging/Logger.h>
+#include <Logging/ILogger.h>
+
+#include <vector>
+#include <unistd.h>
+
+using namespace OpenEngine::Logging;
+
+// Logger keeping the messages it is given
+class MessageLogger : public ILogger {
+public:
+    std::vector<string> messages;
+    void Write(LoggerType type, string msg) {
+        messages.push_back(msg);
+    }
+};
+
+static int evaluated = 0;
+
+static int Evaluate() {
+    return ++evaluated;
+}
+
+int test_main(int argc, char* argv[]) {
+    MessageLogger* sink = new MessageLogger();
+    Logger::AddLogger(sink);
+
+    // runtime threshold
+    OE_CHECK(Logger::GetLevel() == Info);
+    logger.info << "info " << 1 << logger.end;
+    OE_CHECK(sink->messages.size() == 1);
+    OE_CHECK(sink->messages[0] == "info 1");
+
+    Logger::SetLevel(Warning);
+    OE_CHECK(!logger.info.IsEnabled());
+    OE_CHECK(logger.warning.IsEnabled());
+    logger.info << "dropped" << logger.end;
+    logger.warning << "warning" << logger.end;
+    OE_CHECK(sink->messages.size() == 2);
+    OE_CHECK(sink->messages[1] == "warning");
+
+    // the macros do not evaluate disabled messages
+    OE_LOG(info) << Evaluate() << logger.end;
+    OE_CHECK(evaluated == 0);
+    OE_LOG(error) << Evaluate() << logger.end;
+    OE_CHECK(evaluated == 1);
+    OE_CHECK(sink->messages.size() == 3);
+    OE_CHECK(sink->messages[2] == "1");
+    Logger::SetLevel(Info);
+
+    // every n'th message
+    for (int i = 0; i < 10; i++)
+        OE_LOG_EVERY_N(info, 4) << "every " << i << logger.end;
+    OE_CHECK(sink->messages.size() == 6);
+    OE_CHECK(sink->messages[3] == "every 0");
+    OE_CHECK(sink->messages[5] == "every 8");
+
+    // at most one message per interval
+    for (int j = 0; j < 2; j++) {
+        for (int i = 0; i < 100; i++)
+            OE_LOG_RATE_LIMITED(warning, 50000) << "limited" << logger.end;
+        usleep(60000);
+    }
+    OE_CHECK(sink->messages.size() == 8);
+
+    LogRateLimiter limiter(1000000);
+    OE_CHECK(limiter.Allow());
+    OE_CHECK(!limiter.Allow());
+    OE_CHECK(limiter.GetSuppressed() == 1);
+
+    Logger::Deinitialize();
+    return 0;
+}
@@ -14,6 +14,11 @@
 //  #include <time.h>
 //#else
   #include <sys/time.h>
+  #include <time.h>
 //#endif
 
+#if defined(__APPLE__)
+  #include <mach/mach_time.h>
+#endif
+
 #endif // _OE_META_TIME_H_
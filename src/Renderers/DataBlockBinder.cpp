@@ -9,7 +9,7 @@
 
 #include <Renderers/DataBlockBinder.h>
 
-#include <Core/QueuedEvent.h>
+#include <Core/CoalescingQueuedEvent.h>
 #include <Scene/MeshNode.h>
 #include <Geometry/Mesh.h>
 #include <Geometry/GeometrySet.h>
@@ -17,9 +17,10 @@
 #include <Renderers/IRenderer.h>
 #include <Core/IListener.h>
 #include <Logging/Logger.h>
+#include <Utils/Profiler.h>
 
 namespace OpenEngine {
-    using Core::QueuedEvent;
+    using Core::CoalescingQueuedEvent;
     using Geometry::MeshPtr;
     using Geometry::GeometrySetPtr;
     using Resources::IDataBlockPtr;
@@ -27,6 +28,7 @@ namespace OpenEngine {
     using Resources::IDataBlockList;
     using Scene::MeshNode;
     using Core::IListener;
+    using Utils::Profiler;
 
 namespace Renderers {
 
@@ -36,7 +38,7 @@ namespace Renderers {
      */
     class DataBlockBinder::Reloader : public IListener<IDataBlockChangedEventArg> {
         IRenderer& renderer;
-        QueuedEvent<IDataBlockChangedEventArg> queue;
+        CoalescingQueuedEvent<IDataBlockChangedEventArg> queue;
     public:
         Reloader(IRenderer& renderer)
             : renderer(renderer) {
@@ -44,8 +46,10 @@ namespace Renderers {
         }
         /**
          * Dispatch the changed events in the queue.
+         * Changes to the same block are merged into one rebind.
          */
         void ReloadQueue() {
+            Profiler::Zone zone("DataBlockBinder::ReloadQueue");
             queue.Release();
         }
         /**
@@ -115,6 +119,7 @@ namespace Renderers {
     }
 
     void DataBlockBinder::Bind(ISceneNode& node, ReloadPolicy policy){
+        Profiler::Zone zone("DataBlockBinder::Bind");
         node.Accept(*this);
     }
 
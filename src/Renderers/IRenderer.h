@@ -16,6 +16,7 @@
 #include <Geometry/Face.h>
 #include <Math/Vector.h>
 #include <Utils/Timer.h>
+#include <Utils/Profiler.h>
 
 #include <Display/IRenderCanvas.h>
 #include <Core/IListener.h>
@@ -98,10 +99,21 @@ public:
     IRenderCanvas& canvas;
     Time start;                 //!< time of engine loop start.
     unsigned int approx;        //!< approximate engine loop time.
+    Time dt;                    //!< time step of this event.
+    float alpha;                //!< interpolation factor in [0,1].
     ProcessEventArg(IRenderCanvas& canvas, Time start, unsigned int approx)
         : canvas(canvas)
         , start(start)
-        , approx(approx) {}
+        , approx(approx)
+        , dt(approx)
+        , alpha(1.0f) {}
+    ProcessEventArg(IRenderCanvas& canvas, Time start, unsigned int approx,
+                    Time dt, float alpha)
+        : canvas(canvas)
+        , start(start)
+        , approx(approx)
+        , dt(dt)
+        , alpha(alpha) {}
     virtual ~ProcessEventArg() {}
 };
 
@@ -290,6 +302,28 @@ public:
 protected:
     RendererStage stage;
 
+    /**
+     * Enter a rendering stage and notify its event.
+     * Renderer implementations should use this to notify the stage
+     * events, so each stage is measured as a profiler zone.
+     *
+     * @param s Stage to enter.
+     * @param event Event of the stage.
+     * @param arg Event argument.
+     * @see Utils::Profiler
+     */
+    void NotifyStage(RendererStage s, IEvent<RenderingEventArg>& event,
+                     RenderingEventArg arg) {
+        static const char* names[] = {
+            "Renderer::Uninitialize", "Renderer::Initialize",
+            "Renderer::PreProcess", "Renderer::Process",
+            "Renderer::PostProcess", "Renderer::Deinitialize"
+        };
+        stage = s;
+        Utils::Profiler::Zone zone(names[s]);
+        event.Notify(arg);
+    }
+
 };
 
 } // NS Renderers
@@ -0,0 +1,167 @@
+// Sorted queue of draw items.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#include <Renderers/RenderQueue.h>
+#include <Geometry/Mesh.h>
+
+#include <cstring>
+
+namespace OpenEngine {
+namespace Renderers {
+
+using std::map;
+using std::vector;
+
+// key layout, from the most significant bit:
+//   opaque:  0 | 12 bit enabled options | 12 bit disabled options |
+//            19 bit material | 20 bit depth
+//   blended: 1 | 32 bit inverted depth | 11 bit blending | 20 bit material
+// the opaque depth keeps the sign, exponent and 11 mantissa bits,
+// which is plenty for front to back ordering within a group
+static const uint64_t BLENDED = (uint64_t)1 << 63;
+static const unsigned int OPTION_BITS = 12;
+static const unsigned int OPAQUE_MATERIAL_BITS = 19;
+static const unsigned int OPAQUE_DEPTH_BITS = 20;
+static const unsigned int BLENDED_MATERIAL_BITS = 20;
+
+// map a float to an unsigned integer with the same order
+static uint32_t DepthBits(float depth) {
+    uint32_t u;
+    memcpy(&u, &depth, sizeof(u));
+    return (u & 0x80000000) ? ~u : u | 0x80000000;
+}
+
+static uint64_t Bits(uint64_t value, unsigned int bits) {
+    return value & (((uint64_t)1 << bits) - 1);
+}
+
+DrawItem::DrawItem()
+    : material(0)
+    , enabled(RenderStateNode::NONE)
+    , disabled(RenderStateNode::NONE)
+    , blending(false)
+    , source(BlendingNode::SRC_ALPHA)
+    , destination(BlendingNode::ONE_MINUS_SRC_ALPHA)
+    , equation(BlendingNode::ADD)
+    , depth(0)
+    , key(0) {}
+
+RenderQueue::RenderQueue() {}
+
+RenderQueue::~RenderQueue() {}
+
+/**
+ * Pack the sort key of an item.
+ */
+uint64_t RenderQueue::MakeKey(const DrawItem& item) {
+    uint64_t depth = DepthBits(item.depth);
+    if (!item.blending)
+        return Bits(item.enabled, OPTION_BITS) << 51
+            | Bits(item.disabled, OPTION_BITS) << 39
+            | Bits(item.material, OPAQUE_MATERIAL_BITS) << OPAQUE_DEPTH_BITS
+            | depth >> (32 - OPAQUE_DEPTH_BITS);
+    uint64_t blend = Bits(item.source, 4) << 7
+        | Bits(item.destination, 4) << 3
+        | Bits(item.equation, 3);
+    return BLENDED
+        | Bits(~depth, 32) << 31
+        | blend << BLENDED_MATERIAL_BITS
+        | Bits(item.material, BLENDED_MATERIAL_BITS);
+}
+
+/**
+ * Add an item to the queue and compute its sort key.
+ * The item is not in order until the queue is sorted.
+ */
+void RenderQueue::Add(const DrawItem& item) {
+    items.push_back(item);
+    items.back().key = MakeKey(item);
+}
+
+/**
+ * Sort the items on their keys.
+ * The sort is a stable least significant byte radix sort on the
+ * keys and item indices. Passes over bytes that are the same for all
+ * items are skipped, and the items are moved only once at the end.
+ */
+void RenderQueue::Sort() {
+    const unsigned int size = items.size();
+    if (size < 2) return;
+    keys.resize(size);
+    keysTemp.resize(size);
+    order.resize(size);
+    orderTemp.resize(size);
+    for (unsigned int i = 0; i < size; i++) {
+        keys[i] = items[i].key;
+        order[i] = i;
+    }
+
+    unsigned int count[256];
+    for (unsigned int shift = 0; shift < 64; shift += 8) {
+        memset(count, 0, sizeof(count));
+        for (unsigned int i = 0; i < size; i++)
+            count[(keys[i] >> shift) & 0xff]++;
+        if (count[(keys[0] >> shift) & 0xff] == size) continue;
+        unsigned int offset = 0;
+        for (unsigned int b = 0; b < 256; b++) {
+            unsigned int c = count[b];
+            count[b] = offset;
+            offset += c;
+        }
+        for (unsigned int i = 0; i < size; i++) {
+            unsigned int j = count[(keys[i] >> shift) & 0xff]++;
+            keysTemp[j] = keys[i];
+            orderTemp[j] = order[i];
+        }
+        keys.swap(keysTemp);
+        order.swap(orderTemp);
+    }
+
+    sorted.resize(size);
+    for (unsigned int i = 0; i < size; i++)
+        sorted[i] = items[order[i]];
+    items.swap(sorted);
+}
+
+/**
+ * Remove all items and material keys, keeping the memory.
+ */
+void RenderQueue::Clear() {
+    items.clear();
+    materials.clear();
+}
+
+unsigned int RenderQueue::GetSize() const {
+    return items.size();
+}
+
+const DrawItem& RenderQueue::GetItem(unsigned int index) const {
+    return items[index];
+}
+
+const vector<DrawItem>& RenderQueue::GetItems() const {
+    return items;
+}
+
+/**
+ * Get a small key for a material.
+ * Keys are handed out in the order materials are first seen since
+ * the queue was cleared, 0 is used for items without a material.
+ */
+unsigned int RenderQueue::GetMaterialKey(Geometry::Material* material) {
+    if (material == NULL) return 0;
+    map<Geometry::Material*, unsigned int>::iterator m = materials.find(material);
+    if (m != materials.end()) return m->second;
+    unsigned int key = materials.size() + 1;
+    materials[material] = key;
+    return key;
+}
+
+} // NS Renderers
+} // NS OpenEngine
@@ -0,0 +1,102 @@
+// Sorted queue of draw items.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#ifndef _OE_RENDER_QUEUE_H_
+#define _OE_RENDER_QUEUE_H_
+
+#include <Math/Matrix.h>
+#include <Scene/RenderStateNode.h>
+#include <Scene/BlendingNode.h>
+
+#include <boost/shared_ptr.hpp>
+#include <stdint.h>
+#include <vector>
+#include <map>
+
+namespace OpenEngine {
+    namespace Geometry {
+        class Mesh;
+        typedef boost::shared_ptr<Mesh> MeshPtr;
+        class Material;
+    }
+namespace Renderers {
+
+using Math::Matrix;
+using Geometry::MeshPtr;
+using Scene::RenderStateNode;
+using Scene::BlendingNode;
+
+/**
+ * A single draw call extracted from the scene.
+ *
+ * @struct DrawItem RenderQueue.h Renderers/RenderQueue.h
+ */
+struct DrawItem {
+    Matrix<4,4,float> world;    //!< world transformation matrix
+    MeshPtr mesh;               //!< mesh to draw
+    unsigned int material;      //!< material key, see RenderQueue::GetMaterialKey
+    RenderStateNode::RenderStateOption enabled;  //!< enabled options
+    RenderStateNode::RenderStateOption disabled; //!< disabled options
+    bool blending;              //!< true if drawn with blending
+    BlendingNode::BlendingFactor source;         //!< blending source factor
+    BlendingNode::BlendingFactor destination;    //!< blending destination factor
+    BlendingNode::BlendingEquation equation;     //!< blending equation
+    float depth;                //!< view depth of the item
+    uint64_t key;               //!< sort key, set by RenderQueue::Add
+
+    DrawItem();
+};
+
+/**
+ * Sorted queue of draw items.
+ * Holds the draw calls of a frame as a flat array which is sorted on
+ * a packed 64 bit key, so a renderer can draw the queue in order with
+ * few state changes and without traversing the scene graph.
+ *
+ * Opaque items come first, grouped by render state, both the enabled
+ * and the disabled options, then by material and sorted front to back
+ * within a group to benefit from early depth rejection. Blended items come last, sorted back to front so they
+ * blend correctly, then by blending mode and material.
+ *
+ * The queue is sorted with a radix sort on the keys, which is linear
+ * in the number of items. The arrays are kept between frames, so a
+ * cleared queue does not reallocate when it is refilled.
+ *
+ * @class RenderQueue RenderQueue.h Renderers/RenderQueue.h
+ * @see RenderQueueBuilder
+ */
+class RenderQueue {
+public:
+    RenderQueue();
+    virtual ~RenderQueue();
+
+    void Add(const DrawItem& item);
+    void Sort();
+    void Clear();
+
+    unsigned int GetSize() const;
+    const DrawItem& GetItem(unsigned int index) const;
+    const std::vector<DrawItem>& GetItems() const;
+
+    unsigned int GetMaterialKey(Geometry::Material* material);
+
+    static uint64_t MakeKey(const DrawItem& item);
+
+private:
+    std::vector<DrawItem> items;
+    std::vector<DrawItem> sorted;
+    std::vector<uint64_t> keys, keysTemp;
+    std::vector<unsigned int> order, orderTemp;
+    std::map<Geometry::Material*, unsigned int> materials;
+};
+
+} // NS Renderers
+} // NS OpenEngine
+
+#endif // _OE_RENDER_QUEUE_H_
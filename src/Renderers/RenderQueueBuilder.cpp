@@ -0,0 +1,210 @@
+// Render queue extraction from the scene graph.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#include <Renderers/RenderQueueBuilder.h>
+#include <Display/IViewingVolume.h>
+#include <Geometry/Bounds.h>
+#include <Geometry/Mesh.h>
+#include <Scene/TransformationNode.h>
+#include <Scene/RenderStateNode.h>
+#include <Scene/BlendingNode.h>
+#include <Scene/MeshNode.h>
+#include <Scene/InstanceNode.h>
+
+namespace OpenEngine {
+namespace Renderers {
+
+using namespace Scene;
+using Geometry::Bounds;
+using std::vector;
+
+RenderQueueBuilder::RenderQueueBuilder(RenderQueue& queue,
+                                       Display::IViewingVolume* volume)
+    : queue(queue), volume(volume), culling(true) {}
+
+RenderQueueBuilder::~RenderQueueBuilder() {}
+
+/**
+ * Refill the queue from a scene and sort it.
+ * Transformation nodes above the root apply to the scene.
+ *
+ * @param root Root of the scene.
+ */
+void RenderQueueBuilder::Build(ISceneNode& root) {
+    queue.Clear();
+    if (volume) {
+        eye = volume->GetPosition();
+        forward = volume->GetDirection().RotateVector(Vector<3,float>(0,0,-1));
+    }
+
+    state = DrawItem();
+    position = Vector<3,float>();
+    rotation = Quaternion<float>();
+    scale = Vector<3,float>(1.0f);
+    for (ISceneNode* p = root.GetParent(); p != NULL; p = p->GetParent()) {
+        TransformationNode* t = dynamic_cast<TransformationNode*>(p);
+        if (t == NULL) continue;
+        t->GetAccumulatedTransformations(&position, &rotation, &scale);
+        state.world = t->GetWorldTransformationMatrix();
+        break;
+    }
+
+    root.Accept(*this);
+    prototypes.clear();
+    queue.Sort();
+}
+
+void RenderQueueBuilder::SetViewingVolume(Display::IViewingVolume* volume) {
+    this->volume = volume;
+}
+
+Display::IViewingVolume* RenderQueueBuilder::GetViewingVolume() const {
+    return volume;
+}
+
+/**
+ * Enable or disable culling against the viewing volume, enabled by
+ * default.
+ */
+void RenderQueueBuilder::SetCulling(bool culling) {
+    this->culling = culling;
+}
+
+bool RenderQueueBuilder::IsCulling() const {
+    return culling;
+}
+
+/**
+ * Compute the world bounds of a node and test them against the
+ * viewing volume. Empty bounds are unknown rather than nothing to
+ * draw, for instance those of a mesh unloaded before its bounds were
+ * computed, so the node is drawn and placed at its origin.
+ *
+ * @param node Node below the current transformation.
+ * @param bounds World bounds of the node [out]
+ * @return True if the node can be skipped.
+ */
+bool RenderQueueBuilder::IsCulled(ISceneNode* node, Bounds& bounds) {
+    bounds = node->GetBounds().Transform(position, rotation, scale);
+    bool unknown = bounds.IsEmpty();
+    if (unknown) bounds = Bounds(position, position);
+    if (!culling || volume == NULL || unknown) return false;
+    return !volume->IsVisible(bounds.GetBox());
+}
+
+void RenderQueueBuilder::VisitTransformationNode(TransformationNode* node) {
+    Bounds bounds;
+    if (IsCulled(node, bounds)) return;
+    Vector<3,float> p = position, s = scale;
+    Quaternion<float> r = rotation;
+    Matrix<4,4,float> m = state.world;
+    node->GetAccumulatedTransformations(&position, &rotation, &scale);
+    state.world = node->GetWorldTransformationMatrix();
+    node->VisitSubNodes(*this);
+    position = p;
+    rotation = r;
+    scale = s;
+    state.world = m;
+}
+
+void RenderQueueBuilder::VisitRenderStateNode(RenderStateNode* node) {
+    RenderStateNode::RenderStateOption e = state.enabled, d = state.disabled;
+    RenderStateNode::RenderStateOption ne = node->GetEnabled();
+    RenderStateNode::RenderStateOption nd = node->GetDisabled();
+    // options set by the node override those set above it
+    state.enabled = RenderStateNode::RenderStateOption((e & ~nd) | ne);
+    state.disabled = RenderStateNode::RenderStateOption((d & ~ne) | nd);
+    node->VisitSubNodes(*this);
+    state.enabled = e;
+    state.disabled = d;
+}
+
+void RenderQueueBuilder::VisitBlendingNode(BlendingNode* node) {
+    DrawItem s = state;
+    state.blending = true;
+    state.source = node->GetSource();
+    state.destination = node->GetDestination();
+    state.equation = node->GetEquation();
+    node->VisitSubNodes(*this);
+    state.blending = s.blending;
+    state.source = s.source;
+    state.destination = s.destination;
+    state.equation = s.equation;
+}
+
+void RenderQueueBuilder::VisitMeshNode(MeshNode* node) {
+    Bounds bounds;
+    if (IsCulled(node, bounds)) return;
+    MeshPtr mesh = node->GetMesh();
+    if (mesh) {
+        DrawItem item = state;
+        item.mesh = mesh;
+        item.material = queue.GetMaterialKey(mesh->GetMaterial().get());
+        if (volume) item.depth = (bounds.GetCenter() - eye) * forward;
+        queue.Add(item);
+    }
+    node->VisitSubNodes(*this);
+}
+
+void RenderQueueBuilder::VisitInstanceNode(InstanceNode* node) {
+    Bounds bounds;
+    if (IsCulled(node, bounds)) return;
+    DrawItem s = state;
+    Vector<3,float> p = position, sc = scale;
+    Quaternion<float> r = rotation;
+    node->GetAccumulatedTransformations(&position, &rotation, &scale);
+    state.world = node->GetWorldTransformationMatrix();
+    // sub nodes of the instance itself
+    node->ISceneNode::VisitSubNodes(*this);
+
+    ISceneNode* prototype = node->GetPrototype().get();
+    if (prototype) {
+        const vector<DrawItem>& items = Extract(prototype);
+        float depth = volume ? (bounds.GetCenter() - eye) * forward : 0.0f;
+        for (unsigned int i = 0; i < items.size(); i++) {
+            DrawItem item = items[i];
+            item.world = item.world * state.world;
+            item.material = queue.GetMaterialKey(item.mesh->GetMaterial().get());
+            item.enabled = RenderStateNode::RenderStateOption
+                ((state.enabled & ~item.disabled) | item.enabled);
+            item.disabled = RenderStateNode::RenderStateOption
+                ((state.disabled & ~items[i].enabled) | item.disabled);
+            if (!item.blending && state.blending) {
+                item.blending = true;
+                item.source = state.source;
+                item.destination = state.destination;
+                item.equation = state.equation;
+            }
+            item.depth = depth;
+            queue.Add(item);
+        }
+    }
+    state = s;
+    position = p;
+    rotation = r;
+    scale = sc;
+}
+
+/**
+ * Get the items of a prototype relative to its root, extracting them
+ * on the first use in a build.
+ */
+const vector<DrawItem>& RenderQueueBuilder::Extract(ISceneNode* prototype) {
+    std::map<ISceneNode*, vector<DrawItem> >::iterator itr =
+        prototypes.find(prototype);
+    if (itr != prototypes.end()) return itr->second;
+    RenderQueue local;
+    RenderQueueBuilder builder(local);
+    builder.SetCulling(false);
+    builder.Build(*prototype);
+    return prototypes[prototype] = local.GetItems();
+}
+
+} // NS Renderers
+} // NS OpenEngine
@@ -0,0 +1,102 @@
+// Render queue extraction from the scene graph.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#ifndef _OE_RENDER_QUEUE_BUILDER_H_
+#define _OE_RENDER_QUEUE_BUILDER_H_
+
+#include <Scene/ISceneNodeVisitor.h>
+#include <Renderers/RenderQueue.h>
+#include <Math/Vector.h>
+#include <Math/Quaternion.h>
+
+#include <cstddef>
+#include <vector>
+#include <map>
+
+namespace OpenEngine {
+    namespace Display {
+        class IViewingVolume;
+    }
+    namespace Geometry {
+        class Bounds;
+    }
+namespace Renderers {
+
+using Math::Vector;
+using Math::Quaternion;
+
+/**
+ * Render queue extraction from the scene graph.
+ * Flattens the visible part of a scene into a RenderQueue. Each mesh
+ * node becomes a draw item carrying its world matrix, the render
+ * state options and blending mode in effect above it and its depth
+ * along the view direction. Meshes below a blending node are drawn
+ * with blending.
+ *
+ * @code
+ * RenderQueueBuilder builder(queue, &viewingVolume);
+ * builder.Build(*scene);
+ * for (unsigned int i = 0; i < queue.GetSize(); i++)
+ *     Draw(queue.GetItem(i));
+ * @endcode
+ *
+ * With culling enabled sub trees whose bounds are outside the
+ * viewing volume are skipped. Culling and depth need a viewing
+ * volume, without one all items have depth 0.
+ *
+ * The prototype of instance nodes is extracted once per build and
+ * its items are added for every visible instance, all with the
+ * depth of the instance.
+ *
+ * @class RenderQueueBuilder RenderQueueBuilder.h Renderers/RenderQueueBuilder.h
+ * @see RenderQueue
+ */
+class RenderQueueBuilder : public Scene::ISceneNodeVisitor {
+public:
+    RenderQueueBuilder(RenderQueue& queue,
+                       Display::IViewingVolume* volume = NULL);
+    virtual ~RenderQueueBuilder();
+
+    void Build(Scene::ISceneNode& root);
+
+    void SetViewingVolume(Display::IViewingVolume* volume);
+    Display::IViewingVolume* GetViewingVolume() const;
+    void SetCulling(bool culling);
+    bool IsCulling() const;
+
+    void VisitTransformationNode(Scene::TransformationNode* node);
+    void VisitRenderStateNode(Scene::RenderStateNode* node);
+    void VisitBlendingNode(Scene::BlendingNode* node);
+    void VisitMeshNode(Scene::MeshNode* node);
+    void VisitInstanceNode(Scene::InstanceNode* node);
+
+private:
+    RenderQueue& queue;
+    Display::IViewingVolume* volume;
+    bool culling;
+
+    //! camera position and view direction of the current build
+    Vector<3,float> eye, forward;
+
+    //! state in effect at the current node
+    DrawItem state;
+    Vector<3,float> position, scale;
+    Quaternion<float> rotation;
+
+    //! items of the prototypes of the current build
+    std::map<Scene::ISceneNode*, std::vector<DrawItem> > prototypes;
+
+    bool IsCulled(Scene::ISceneNode* node, Geometry::Bounds& bounds);
+    const std::vector<DrawItem>& Extract(Scene::ISceneNode* prototype);
+};
+
+} // NS Renderers
+} // NS OpenEngine
+
+#endif // _OE_RENDER_QUEUE_BUILDER_H_
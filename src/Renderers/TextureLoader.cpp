@@ -10,7 +10,7 @@
 #include <Renderers/TextureLoader.h>
 
 #include <Core/Exceptions.h>
-#include <Core/QueuedEvent.h>
+#include <Core/CoalescingQueuedEvent.h>
 #include <Renderers/IRenderer.h>
 #include <Scene/ISceneNodeVisitor.h>
 #include <Scene/GeometryNode.h>
@@ -28,6 +28,7 @@
 #include <map>
 #include <set>
 #include <Logging/Logger.h>
+#include <Utils/Profiler.h>
 
 namespace OpenEngine {
 namespace Renderers {
@@ -36,7 +37,7 @@ using namespace std;
 
 using Core::Exception;
 using Core::IListener;
-using Core::QueuedEvent;
+using Core::CoalescingQueuedEvent;
 using Geometry::FaceList;
 using Geometry::FaceSet;
 using Geometry::VertexArray;
@@ -133,8 +134,8 @@ class TextureLoader::Reloader
     : public IListener<Texture2DChangedEventArg>,
       public IListener<Texture3DChangedEventArg> {
     IRenderer& renderer;
-    QueuedEvent<Texture2DChangedEventArg> queue2d;
-    QueuedEvent<Texture3DChangedEventArg> queue3d;
+    CoalescingQueuedEvent<Texture2DChangedEventArg> queue2d;
+    CoalescingQueuedEvent<Texture3DChangedEventArg> queue3d;
 public:
     virtual ~Reloader() { }
     Reloader(IRenderer& renderer)
@@ -143,11 +144,10 @@ public:
         queue3d.Attach(*this);
     }
     // Reload the events in the queue.
-    // @todo: This should preferably only send off one change event
-    // per texture. However, care must be taken to make sure the
-    // dimension field reflects the accumulated changes of the
-    // texture.
+    // The queues merge the changes of each texture, so a texture is
+    // rebound once covering the bounding region of its changes.
     void ReloadQueue() {
+        Utils::Profiler::Zone zone("TextureLoader::ReloadQueue");
         queue2d.Release(); // will dispatch to: this->Handle(...)
         queue3d.Release(); // will dispatch to: this->Handle(...)
     }
@@ -344,6 +344,7 @@ void TextureLoader::ReloadQueue() {
  * used (\a RELOAD_NEVER). 
  */
 void TextureLoader::Load(ISceneNode& node, ReloadPolicy policy) {
+    Utils::Profiler::Zone zone("TextureLoader::Load");
     SceneLoader loader(*this, policy);
     node.Accept(loader);
 }
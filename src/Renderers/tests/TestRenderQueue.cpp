@@ -0,0 +1,164 @@
+#include <Testing/Testing.h>
+
+#include <Renderers/RenderQueue.h>
+#include <Renderers/RenderQueueBuilder.h>
+#include <Display/ViewingVolume.h>
+#include <Scene/SceneNode.h>
+#include <Scene/MeshNode.h>
+#include <Scene/RenderStateNode.h>
+#include <Scene/BlendingNode.h>
+#include <Scene/TransformationNode.h>
+#include <Scene/InstanceNode.h>
+#include <Geometry/Mesh.h>
+#include <Geometry/Material.h>
+#include <Geometry/GeometrySet.h>
+#include <Resources/DataBlock.h>
+
+#include <algorithm>
+#include <cstdlib>
+
+using namespace OpenEngine::Renderers;
+using namespace OpenEngine::Scene;
+using namespace OpenEngine::Geometry;
+using namespace OpenEngine::Resources;
+using OpenEngine::Display::ViewingVolume;
+
+// a mesh of a single unit quad centered at p
+static MeshNode* Quad(Vector<3,float> p, MaterialPtr mat) {
+    float v[] = { p[0]-.5f, p[1]-.5f, p[2],  p[0]+.5f, p[1]-.5f, p[2],
+                  p[0]+.5f, p[1]+.5f, p[2],  p[0]-.5f, p[1]+.5f, p[2] };
+    DataBlock<3,float>* vertices = new DataBlock<3,float>(4);
+    std::copy(v, v + 12, vertices->GetData());
+    IndicesPtr indices(new Indices(4));
+    for (unsigned int i = 0; i < 4; i++) indices->GetData()[i] = i;
+    GeometrySetPtr geom(new GeometrySet(IDataBlockPtr(vertices)));
+    return new MeshNode(MeshPtr(new Mesh(indices, QUADS, geom, mat)));
+}
+
+int test_main(int argc, char* argv[]) {
+    MaterialPtr red(new Material()), blue(new Material());
+
+    SceneNode* root = new SceneNode();
+    MeshNode* far = Quad(Vector<3,float>(0,0,-20), red);
+    MeshNode* near = Quad(Vector<3,float>(0,0,-5), red);
+    MeshNode* other = Quad(Vector<3,float>(0,0,-1), blue);
+    root->AddNode(far);
+    root->AddNode(other);
+    TransformationNode* t = new TransformationNode();
+    t->Move(0,0,-4);
+    t->AddNode(near);
+    root->AddNode(t);
+
+    RenderStateNode* wire = new RenderStateNode();
+    wire->EnableOption(RenderStateNode::WIREFRAME);
+    MeshNode* wired = Quad(Vector<3,float>(0,0,-2), red);
+    wire->AddNode(wired);
+    root->AddNode(wire);
+
+    BlendingNode* blend = new BlendingNode();
+    MeshNode* glassNear = Quad(Vector<3,float>(0,0,-3), red);
+    MeshNode* glassFar = Quad(Vector<3,float>(0,0,-30), red);
+    blend->AddNode(glassNear);
+    blend->AddNode(glassFar);
+    root->AddNode(blend);
+
+    ViewingVolume volume;
+    RenderQueue queue;
+    RenderQueueBuilder builder(queue, &volume);
+    builder.Build(*root);
+    OE_CHECK(queue.GetSize() == 6);
+
+    // opaque first, grouped by state and material, front to back
+    OE_CHECK(queue.GetItem(0).mesh == near->GetMesh());
+    OE_CHECK(queue.GetItem(1).mesh == far->GetMesh());
+    OE_CHECK(queue.GetItem(0).depth < queue.GetItem(1).depth);
+    OE_CHECK(queue.GetItem(2).mesh == other->GetMesh());
+    OE_CHECK(queue.GetItem(3).mesh == wired->GetMesh());
+    OE_CHECK(queue.GetItem(3).enabled & RenderStateNode::WIREFRAME);
+    // world matrices follow the transformation nodes
+    OE_CHECK(queue.GetItem(0).world == t->GetWorldTransformationMatrix());
+    OE_CHECK(queue.GetItem(0).depth > 8.9 && queue.GetItem(0).depth < 9.1);
+    // blended last, back to front
+    OE_CHECK(queue.GetItem(4).mesh == glassFar->GetMesh());
+    OE_CHECK(queue.GetItem(5).mesh == glassNear->GetMesh());
+    OE_CHECK(queue.GetItem(5).blending);
+    OE_CHECK(!queue.GetItem(0).blending);
+
+    // rebuilding gives the same queue
+    builder.Build(*root);
+    OE_CHECK(queue.GetSize() == 6);
+    OE_CHECK(queue.GetItem(4).mesh == glassFar->GetMesh());
+
+    // instances add the items of their prototype
+    TransformationNode* lifted = new TransformationNode();
+    lifted->Move(0,1,0);
+    lifted->AddNode(Quad(Vector<3,float>(0,0,0), blue));
+    ScenePrototype prop(lifted);
+    SceneNode* props = new SceneNode();
+    for (unsigned int i = 0; i < 3; i++) {
+        InstanceNode* instance = new InstanceNode(prop);
+        instance->Move(0,0,-10.0f * (i + 1));
+        props->AddNode(instance);
+    }
+    RenderQueue instanced;
+    RenderQueueBuilder instancer(instanced, &volume);
+    instancer.Build(*props);
+    OE_CHECK(instanced.GetSize() == 3);
+    DrawItem nearest = instanced.GetItem(0);
+    DrawItem farthest = instanced.GetItem(2);
+    OE_CHECK(nearest.depth > 9.9 && nearest.depth < 10.1);
+    OE_CHECK(nearest.world(3,1) == 1.0f && nearest.world(3,2) == -10.0f);
+    OE_CHECK(farthest.world(3,2) == -30.0f);
+    delete props;
+
+    // nodes with unknown bounds are drawn, with and without culling
+    MeshNode* unloaded = Quad(Vector<3,float>(0,0,-5), red);
+    unloaded->GetMesh()->GetGeometrySet()->GetVertices()->Unload();
+    OE_CHECK(unloaded->GetBounds().IsEmpty());
+    RenderQueue unknown;
+    RenderQueueBuilder unknownBuilder(unknown, &volume);
+    unknownBuilder.Build(*unloaded);
+    OE_CHECK(unknown.GetSize() == 1);
+    unknownBuilder.SetCulling(false);
+    unknownBuilder.Build(*unloaded);
+    OE_CHECK(unknown.GetSize() == 1);
+    unknownBuilder.SetViewingVolume(NULL);
+    unknownBuilder.Build(*unloaded);
+    OE_CHECK(unknown.GetSize() == 1);
+    delete unloaded;
+
+    // the radix sort orders any set of keys
+    RenderQueue random;
+    std::vector<uint64_t> keys;
+    srand(42);
+    for (unsigned int i = 0; i < 1000; i++) {
+        DrawItem item;
+        item.depth = float(rand() % 2000) - 1000.0f;
+        item.material = rand() % 5;
+        item.blending = (rand() % 3) == 0;
+        item.enabled = RenderStateNode::RenderStateOption(rand() % 4);
+        item.disabled = RenderStateNode::RenderStateOption(rand() % 4 << 2);
+        random.Add(item);
+        keys.push_back(RenderQueue::MakeKey(item));
+    }
+    random.Sort();
+    std::sort(keys.begin(), keys.end());
+    bool ordered = true;
+    for (unsigned int i = 0; i < keys.size(); i++)
+        ordered = ordered && random.GetItem(i).key == keys[i];
+    OE_CHECK(ordered);
+    // negative depths sort before positive ones
+    DrawItem behind, ahead;
+    behind.depth = -1.0f;
+    ahead.depth = 1.0f;
+    OE_CHECK(RenderQueue::MakeKey(behind) < RenderQueue::MakeKey(ahead));
+    // items with different disabled options are in different groups
+    DrawItem lit, unlit;
+    unlit.disabled = RenderStateNode::LIGHTING;
+    unlit.depth = -100.0f;
+    lit.depth = 100.0f;
+    OE_CHECK(RenderQueue::MakeKey(lit) < RenderQueue::MakeKey(unlit));
+
+    delete root;
+    return 0;
+}
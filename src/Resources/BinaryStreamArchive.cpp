@@ -17,6 +17,7 @@
 #include <Scene/SceneNodes.h>
 
 #include <string>
+#include <algorithm>
 
 using namespace std;
 
@@ -35,6 +36,10 @@ namespace Resources {
 
     using namespace Scene;
 
+// tags raw arrays with the byte order of the writing machine
+static const int BYTE_ORDER_MARK = 0x01020304;
+static const int SWAPPED_BYTE_ORDER_MARK = 0x04030201;
+
 BinaryStreamArchiveReader::BinaryStreamArchiveReader(istream& input) : input(input) {
 
 }
@@ -96,6 +101,38 @@ ISceneNode* BinaryStreamArchiveReader::ReadScene(string key) {
     return ReadNode();
 }
 
+static void SwapBytes(void* data, size_t len, unsigned int size) {
+    char* d = (char*)data;
+    for (size_t i = 0; i < len; i++, d += size)
+        reverse(d, d + size);
+}
+
+/**
+ * Read a raw array at once. The elements, and the length and type of
+ * the array, are swapped if the array was written with the opposite
+ * byte order.
+ */
+void BinaryStreamArchiveReader::ReadRaw(string key, void* data, size_t len, Types::Type type) {
+    size_t s = Begin(key);
+    int t = ReadInt(TAG_KEY);
+    int order = ReadInt(TAG_KEY);
+    bool swap = order == SWAPPED_BYTE_ORDER_MARK;
+    if (swap) {
+        SwapBytes(&s, 1, sizeof(s));
+        SwapBytes(&t, 1, sizeof(t));
+    }
+    else if (order != BYTE_ORDER_MARK)
+        throw Core::Exception("Invalid byte order in ReadRawArray [" + key + "]");
+    if (s != len || t != type)
+        throw Core::Exception("Deserialization mismatch in ReadRawArray [" + key + "]");
+    unsigned int size = Types::GetSize(type);
+    input.read((char*)data, len * size);
+    if (input.fail() || size_t(input.gcount()) != len * size)
+        throw Core::Exception("Unexpected end of stream in ReadRawArray [" + key + "]");
+    if (swap) SwapBytes(data, len, size);
+    End(key);
+}
+
 unsigned int BinaryStreamArchiveReader::ReadIndex() {
     return ReadInt(IDX_KEY);
 }
@@ -172,6 +209,20 @@ void BinaryStreamArchiveWriter::WriteScene(string key, ISceneNode* node) {
     node->Accept(*(new SceneWriter(*this)));
 }
 
+/**
+ * Write a raw array at once, tagged with the element type and the
+ * byte order.
+ */
+void BinaryStreamArchiveWriter::WriteRaw(string key, const void* data, size_t len, Types::Type type) {
+    if (Types::GetSize(type) == 0)
+        throw Core::Exception("Unsupported type in WriteRawArray [" + key + "]");
+    Begin(key, len);
+    WriteInt(TAG_KEY, type);
+    WriteInt(TAG_KEY, BYTE_ORDER_MARK);
+    output.write((const char*)data, len * Types::GetSize(type));
+    End(key);
+}
+
 void BinaryStreamArchiveWriter::WriteIndex(unsigned int idx) {
     WriteInt(IDX_KEY,idx);
 }
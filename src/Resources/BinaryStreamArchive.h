@@ -36,6 +36,7 @@ protected:
     size_t Begin(std::string key);
     void End(std::string key);    
     unsigned int ReadIndex();
+    void ReadRaw(std::string key, void* data, size_t len, Types::Type type);
     
 
 public:
@@ -62,6 +63,7 @@ protected:
     void Begin(std::string key, size_t size);
     void End(std::string key);    
     void WriteIndex(unsigned int idx);
+    void WriteRaw(std::string key, const void* data, size_t len, Types::Type type);
 
 public:
     BinaryStreamArchiveWriter(std::ostream& output);
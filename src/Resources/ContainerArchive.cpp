@@ -0,0 +1,730 @@
+// Container archive.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#include <Resources/ContainerArchive.h>
+#include <Resources/Exceptions.h>
+#include <Resources/DataBlock.h>
+#include <Resources/Texture2D.h>
+#include <Utils/Convert.h>
+
+#include <Scene/SceneNode.h>
+#include <Scene/ISceneNodeVisitor.h>
+#include <Scene/SceneNodes.h>
+
+#include <stdint.h>
+#include <cstring>
+
+using namespace std;
+
+namespace OpenEngine {
+namespace Resources {
+
+    enum SceneNodeTags {
+#define SCENE_NODE(node) \
+        NODE_##node,
+#include <Scene/SceneNodes.def>
+#undef SCENE_NODE
+        NODE_NULL,
+        NODE_END
+    };
+
+    using namespace Scene;
+    using Utils::Convert;
+
+static const char MAGIC[4] = {'O', 'E', 'A', 'C'};
+static const uint32_t VERSION = 1;
+static const uint32_t BYTE_ORDER_MARK = 0x01020304;
+// chunk reference of a NULL scene, data block or texture
+static const uint32_t NO_CHUNK = 0xFFFFFFFF;
+static const size_t HEADER_SIZE = 32;
+static const size_t ENTRY_SIZE = 32;
+static const size_t PAYLOAD_HEADER_SIZE = 32;
+static const size_t ALIGNMENT = 16;
+
+static uint32_t Adler32(uint32_t adler, const char* data, size_t size) {
+    uint32_t a = adler & 0xFFFF, b = adler >> 16;
+    const unsigned char* p = (const unsigned char*)data;
+    while (size) {
+        // largest run before the sums may overflow
+        size_t n = size < 5552 ? size : 5552;
+        size -= n;
+        while (n--) {
+            a += *p++;
+            b += a;
+        }
+        a %= 65521;
+        b %= 65521;
+    }
+    return (b << 16) | a;
+}
+
+static uint64_t Align(uint64_t offset) {
+    return (offset + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+}
+
+// the element types data blocks support
+#define CONTAINER_BLOCKS                        \
+    CONTAINER_BLOCK(1, unsigned char)           \
+    CONTAINER_BLOCK(1, unsigned short)          \
+    CONTAINER_BLOCK(1, unsigned int)            \
+    CONTAINER_BLOCK(4, unsigned char)           \
+    CONTAINER_BLOCK(2, float)                   \
+    CONTAINER_BLOCK(3, float)                   \
+    CONTAINER_BLOCK(4, float)                   \
+    CONTAINER_BLOCK(2, double)                  \
+    CONTAINER_BLOCK(3, double)                  \
+    CONTAINER_BLOCK(4, double)
+
+static bool IsSupportedBlock(unsigned int dimension, Types::Type type) {
+#define CONTAINER_BLOCK(n, t)                                           \
+    if (dimension == n && type == Types::GetResourceType<t>())          \
+        return true;
+    CONTAINER_BLOCKS
+#undef CONTAINER_BLOCK
+    return false;
+}
+
+template <class T>
+static void Put(string& out, T value) {
+    out.append((const char*)&value, sizeof(T));
+}
+
+template <class T>
+static T Get(const char* data) {
+    T value;
+    memcpy(&value, data, sizeof(T));
+    return value;
+}
+
+// Reader
+
+/**
+ * Open an archive.
+ *
+ * @param file Mapped archive file, mapped copy on write if data
+ *        blocks or textures read from it are changed.
+ * @param verify Verify the checksum of each chunk when it is used.
+ * @throws ResourceException if the file is not a valid archive.
+ */
+ContainerArchiveReader::ContainerArchiveReader(MappedFilePtr file, bool verify)
+    : file(file), verify(verify), strings(NULL), numberOfStrings(0) {
+    const char* data = file->GetData();
+    size_t size = file->GetSize();
+    if (size < HEADER_SIZE || memcmp(data, MAGIC, 4) != 0)
+        Corrupt("not a container archive");
+    if (Get<uint32_t>(data + 4) != VERSION)
+        Corrupt("unsupported version " + Convert::ToString(Get<uint32_t>(data + 4)));
+    if (Get<uint32_t>(data + 8) != BYTE_ORDER_MARK)
+        Corrupt("written with another byte order");
+    uint32_t count = Get<uint32_t>(data + 12);
+    uint64_t tocOffset = Get<uint64_t>(data + 16);
+    if (tocOffset > size || count > (size - tocOffset) / ENTRY_SIZE)
+        Corrupt("table of contents outside of the file");
+    const char* toc = data + tocOffset;
+    if (Adler32(1, toc, count * ENTRY_SIZE) != Get<uint32_t>(data + 24))
+        Corrupt("checksum mismatch in the table of contents");
+
+    vector<uint32_t> names;
+    for (unsigned int i = 0; i < count; i++) {
+        const char* entry = toc + i * ENTRY_SIZE;
+        Chunk c;
+        c.type = ContainerChunkType(Get<uint32_t>(entry));
+        uint64_t offset = Get<uint64_t>(entry + 8);
+        uint64_t length = Get<uint64_t>(entry + 16);
+        c.checksum = Get<uint32_t>(entry + 24);
+        if (c.type < CHUNK_STREAM || c.type > CHUNK_STRINGS)
+            Corrupt("unknown chunk type");
+        if (offset % ALIGNMENT != 0 || offset > size || length > size - offset)
+            Corrupt("chunk outside of the file");
+        c.offset = offset;
+        c.size = length;
+        chunks.push_back(c);
+        names.push_back(Get<uint32_t>(entry + 4));
+    }
+    verified.resize(count, false);
+
+    // the stream chunk is first and the string table last
+    if (count < 2 || chunks[0].type != CHUNK_STREAM || chunks[count-1].type != CHUNK_STRINGS)
+        Corrupt("missing stream or string table");
+    strings = Open(count - 1, CHUNK_STRINGS);
+    if (chunks[count-1].size < 4) Corrupt("invalid string table");
+    numberOfStrings = Get<uint32_t>(strings);
+    if (((uint64_t)numberOfStrings + 2) * 4 > chunks[count-1].size)
+        Corrupt("invalid string table");
+    for (unsigned int i = 0; i < count; i++)
+        chunks[i].name = GetString(names[i]);
+
+    const char* stream = Open(0, CHUNK_STREAM);
+    Cursor root = {stream, stream + chunks[0].size};
+    cursors.push_back(root);
+}
+
+void ContainerArchiveReader::Corrupt(const string& reason) {
+    throw ResourceException("Corrupt archive " + file->GetPath() + ": " + reason);
+}
+
+void ContainerArchiveReader::Read(void* out, size_t size) {
+    Cursor& c = cursors.back();
+    if ((size_t)(c.end - c.pos) < size)
+        Corrupt("unexpected end of chunk");
+    memcpy(out, c.pos, size);
+    c.pos += size;
+}
+
+unsigned int ContainerArchiveReader::ReadUInt() {
+    uint32_t r;
+    Read(&r, sizeof(r));
+    return r;
+}
+
+// get a chunk, verifying it the first time it is used
+const char* ContainerArchiveReader::Open(unsigned int chunk, ContainerChunkType type) {
+    if (chunk >= chunks.size() || chunks[chunk].type != type)
+        Corrupt("invalid reference to chunk " + Convert::ToString(chunk));
+    const Chunk& c = chunks[chunk];
+    const char* data = file->GetData() + c.offset;
+    if (verify && !verified[chunk]) {
+        if (Adler32(1, data, c.size) != c.checksum)
+            Corrupt("checksum mismatch in chunk " + Convert::ToString(chunk));
+        verified[chunk] = true;
+    }
+    return data;
+}
+
+string ContainerArchiveReader::GetString(unsigned int id) {
+    if (id >= numberOfStrings) Corrupt("invalid string reference");
+    const char* offsets = strings + 4;
+    const char* bytes = offsets + (numberOfStrings + 1) * 4;
+    size_t size = chunks.back().size - (bytes - strings);
+    uint32_t begin = Get<uint32_t>(offsets + id * 4);
+    uint32_t end = Get<uint32_t>(offsets + (id + 1) * 4);
+    if (begin > end || end > size) Corrupt("invalid string table");
+    // strings are made directly from the mapping
+    return string(bytes + begin, end - begin);
+}
+
+size_t ContainerArchiveReader::Begin(string key) {
+    return ReadUInt();
+}
+
+void ContainerArchiveReader::End(string key) {
+    // nop
+}
+
+/**
+ * Read a raw array with a single copy from the mapping.
+ */
+void ContainerArchiveReader::ReadRaw(string key, void* data, size_t len, Types::Type type) {
+    uint32_t s = ReadUInt();
+    uint32_t t = ReadUInt();
+    if (s != len || t != uint32_t(type))
+        throw ResourceException("Deserialization mismatch in ReadRawArray [" + key + "]");
+    Read(data, (size_t)len * Types::GetSize(type));
+}
+
+unsigned int ContainerArchiveReader::ReadIndex() {
+    return ReadInt(IDX_KEY);
+}
+
+int ContainerArchiveReader::ReadInt(string key) {
+    int32_t r;
+    Read(&r, sizeof(r));
+    return r;
+}
+
+float ContainerArchiveReader::ReadFloat(string key) {
+    float r;
+    Read(&r, sizeof(r));
+    return r;
+}
+
+double ContainerArchiveReader::ReadDouble(string key) {
+    double r;
+    Read(&r, sizeof(r));
+    return r;
+}
+
+string ContainerArchiveReader::ReadString(string key) {
+    return GetString(ReadUInt());
+}
+
+ISceneNode* ContainerArchiveReader::ReadNode() {
+    SceneNodeTags tag = SceneNodeTags(ReadInt(TAG_KEY));
+    ISceneNode *node = NULL;
+
+    switch (tag) {
+#define SCENE_NODE(type)                            \
+        case NODE_##type :                          \
+            node = new type();                      \
+            break;
+#include <Scene/SceneNodes.def>
+#undef SCENE_NODE
+    case NODE_NULL:
+        return NULL;
+    default:
+        Corrupt("unknown node tag");
+    }
+
+    // a corrupt subtree must not leak the nodes read so far
+    try {
+        unsigned int size = Begin(CHILD_KEY);
+        for (unsigned int i=0; i<size; i++) {
+            node->AddNode(ReadNode());
+        }
+        End(CHILD_KEY);
+
+        node->Deserialize(*this);
+    } catch (...) {
+        delete node;
+        throw;
+    }
+    return node;
+}
+
+/**
+ * Read the next scene. The scene is read from its own chunk.
+ */
+ISceneNode* ContainerArchiveReader::ReadScene(string key) {
+    uint32_t chunk = ReadUInt();
+    if (chunk == NO_CHUNK) return NULL;
+    return LoadScene(chunk);
+}
+
+/**
+ * Read the next data block. The elements of the data block are in
+ * the mapped file, and a data block written more than once is read
+ * as the same data block.
+ */
+IDataBlockPtr ContainerArchiveReader::ReadDataBlock(string key) {
+    uint32_t chunk = ReadUInt();
+    if (chunk == NO_CHUNK) return IDataBlockPtr();
+    return LoadDataBlock(chunk);
+}
+
+/**
+ * Read the next texture. The pixels of the texture are in the mapped
+ * file, and a texture written more than once is read as the same
+ * texture.
+ */
+ITexture2DPtr ContainerArchiveReader::ReadTexture(string key) {
+    uint32_t chunk = ReadUInt();
+    if (chunk == NO_CHUNK) return ITexture2DPtr();
+    return LoadTexture(chunk);
+}
+
+unsigned int ContainerArchiveReader::GetNumberOfChunks() const {
+    return chunks.size();
+}
+
+/**
+ * Get an entry of the table of contents.
+ *
+ * @throws ResourceException if there is no such chunk.
+ */
+const ContainerArchiveReader::Chunk& ContainerArchiveReader::GetChunk(unsigned int chunk) const {
+    if (chunk >= chunks.size())
+        throw ResourceException("No chunk " + Convert::ToString(chunk) + " in " + file->GetPath());
+    return chunks[chunk];
+}
+
+/**
+ * Find the first chunk with a name and type.
+ *
+ * @return Index of the chunk, or -1 if there is none.
+ */
+int ContainerArchiveReader::FindChunk(const string& name, ContainerChunkType type) const {
+    for (unsigned int i = 0; i < chunks.size(); i++)
+        if (chunks[i].type == type && chunks[i].name == name)
+            return i;
+    return -1;
+}
+
+/**
+ * Load a scene chunk. Each call creates a new scene.
+ *
+ * @param chunk Index of the chunk.
+ * @throws ResourceException if the chunk is not a valid scene or
+ *         refers to a scene chunk that is being loaded.
+ */
+ISceneNode* ContainerArchiveReader::LoadScene(int chunk) {
+    const char* data = Open(chunk, CHUNK_SCENE);
+    if (loading.find(chunk) != loading.end())
+        Corrupt("scene chunk " + Convert::ToString(chunk) + " refers to itself");
+    Cursor c = {data, data + chunks[chunk].size};
+    cursors.push_back(c);
+    loading.insert(chunk);
+    ISceneNode* node;
+    try {
+        node = ReadNode();
+    } catch (...) {
+        loading.erase(chunk);
+        cursors.pop_back();
+        throw;
+    }
+    loading.erase(chunk);
+    cursors.pop_back();
+    return node;
+}
+
+/**
+ * Load a data block chunk.
+ *
+ * @param chunk Index of the chunk.
+ * @throws ResourceException if the chunk is not a valid data block.
+ */
+IDataBlockPtr ContainerArchiveReader::LoadDataBlock(int chunk) {
+    map<unsigned int, IDataBlockPtr>::iterator cached = blocks.find(chunk);
+    if (cached != blocks.end()) return cached->second;
+    const char* data = Open(chunk, CHUNK_DATA_BLOCK);
+    const Chunk& c = chunks[chunk];
+    if (c.size < PAYLOAD_HEADER_SIZE) Corrupt("invalid data block");
+    uint32_t h[8];
+    memcpy(h, data, sizeof(h));
+    if ((uint64_t)h[1] * h[2] * Types::GetSize(Types::Type(h[0])) != c.size - PAYLOAD_HEADER_SIZE)
+        Corrupt("data block size mismatch");
+    size_t offset = c.offset + PAYLOAD_HEADER_SIZE;
+
+    IDataBlockPtr block;
+#define CONTAINER_BLOCK(n, t)                                           \
+    if (h[1] == n && h[0] == (uint32_t)Types::GetResourceType<t>())     \
+        block = IDataBlockPtr(new DataBlock<n, t>(h[2], file, offset,   \
+                                                  BlockType(h[3]),      \
+                                                  UpdateMode(h[4])));
+    CONTAINER_BLOCKS
+#undef CONTAINER_BLOCK
+    if (!block) Corrupt("unsupported data block type");
+    block->SetUnloadPolicy(UnloadPolicy(h[5]));
+    blocks[chunk] = block;
+    return block;
+}
+
+/**
+ * Load a texture chunk.
+ *
+ * @param chunk Index of the chunk.
+ * @throws ResourceException if the chunk is not a valid texture.
+ */
+ITexture2DPtr ContainerArchiveReader::LoadTexture(int chunk) {
+    map<unsigned int, ITexture2DPtr>::iterator cached = textures.find(chunk);
+    if (cached != textures.end()) return cached->second;
+    const char* data = Open(chunk, CHUNK_TEXTURE);
+    const Chunk& c = chunks[chunk];
+    if (c.size < PAYLOAD_HEADER_SIZE) Corrupt("invalid texture");
+    uint32_t h[8];
+    memcpy(h, data, sizeof(h));
+    if ((uint64_t)h[1] * h[3] * h[4] * Types::GetSize(Types::Type(h[0])) != c.size - PAYLOAD_HEADER_SIZE)
+        Corrupt("texture size mismatch");
+    size_t offset = c.offset + PAYLOAD_HEADER_SIZE;
+
+    ITexture2DPtr texture;
+#define CONTAINER_TEXTURE(t)                                            \
+    if (h[0] == (uint32_t)Types::GetResourceType<t>())                  \
+        texture = ITexture2DPtr(new Texture2D<t>(h[3], h[4], h[1], file, offset));
+    CONTAINER_TEXTURE(unsigned char)
+    CONTAINER_TEXTURE(char)
+    CONTAINER_TEXTURE(unsigned int)
+    CONTAINER_TEXTURE(int)
+    CONTAINER_TEXTURE(float)
+#undef CONTAINER_TEXTURE
+    if (!texture) Corrupt("unsupported texture type");
+    texture->SetColorFormat(ColorFormat(h[2]));
+    texture->SetWrapping(Wrapping(h[5]));
+    texture->SetFiltering(Filtering(h[6]));
+    texture->SetMipmapping(h[7] & 1);
+    texture->SetCompression(h[7] & 2);
+    textures[chunk] = texture;
+    return texture;
+}
+
+// Writer
+
+class ContainerArchiveWriter::SceneWriter : public ISceneNodeVisitor {
+    ContainerArchiveWriter& w;
+
+public:
+    SceneWriter(ContainerArchiveWriter& w) : w(w) {}
+
+#define SCENE_NODE(type)                                \
+    void Visit##type(type* node) {                      \
+        w.WriteInt(TAG_KEY,NODE_##type);                \
+        w.Begin(CHILD_KEY,node->GetNumberOfNodes());    \
+        std::list<ISceneNode*>::iterator itr;           \
+        for(itr = node->subNodes.begin();               \
+            itr != node->subNodes.end();                \
+            itr++) {                                    \
+            (*itr)->Accept(*this);                      \
+        }                                               \
+        w.End(CHILD_KEY);                               \
+        node->Serialize(w);                             \
+    }
+#include <Scene/SceneNodes.def>
+#undef SCENE_NODE
+};
+
+ContainerArchiveWriter::ContainerArchiveWriter(ostream& output)
+    : output(output), closed(false) {
+    Intern("");
+    open.push_back(AddChunk(CHUNK_STREAM, ""));
+}
+
+/**
+ * Closes the archive if it has not been closed.
+ */
+ContainerArchiveWriter::~ContainerArchiveWriter() {
+    if (!closed) {
+        try {
+            Close();
+        } catch (...) {}
+    }
+}
+
+void ContainerArchiveWriter::Append(const void* data, size_t size) {
+    if (closed) throw ResourceException("Write to closed archive");
+    chunks[open.back()].stream.append((const char*)data, size);
+}
+
+unsigned int ContainerArchiveWriter::Intern(const string& str) {
+    map<string, unsigned int>::iterator itr = ids.find(str);
+    if (itr != ids.end()) return itr->second;
+    unsigned int id = strings.size();
+    ids[str] = id;
+    strings.push_back(str);
+    return id;
+}
+
+unsigned int ContainerArchiveWriter::AddChunk(ContainerChunkType type, const string& name) {
+    Chunk c;
+    c.type = type;
+    c.name = Intern(name);
+    chunks.push_back(c);
+    return chunks.size() - 1;
+}
+
+// the header and payload of a data block or texture chunk
+void ContainerArchiveWriter::Payload(Chunk& chunk, unsigned int header[8],
+                                     const char*& data, size_t& size) {
+    memset(header, 0, 8 * sizeof(unsigned int));
+    if (chunk.block) {
+        IDataBlock* b = chunk.block.get();
+        header[0] = b->GetType();
+        header[1] = b->GetDimension();
+        header[2] = b->GetSize();
+        header[3] = b->GetBlockType();
+        header[4] = b->GetUpdateMode();
+        header[5] = b->GetUnloadPolicy();
+        data = (const char*)b->GetVoidData();
+        size = (size_t)header[1] * header[2] * Types::GetSize(Types::Type(header[0]));
+    } else {
+        ITexture2D* t = chunk.texture.get();
+        header[0] = t->GetType();
+        header[1] = t->GetChannels();
+        header[2] = t->GetColorFormat();
+        header[3] = t->GetWidth();
+        header[4] = t->GetHeight();
+        header[5] = t->GetWrapping();
+        header[6] = t->GetFiltering();
+        header[7] = (t->UseMipmapping() ? 1 : 0) | (t->UseCompression() ? 2 : 0);
+        data = (const char*)t->GetVoidDataPtr();
+        size = (size_t)header[1] * header[3] * header[4] * Types::GetSize(Types::Type(header[0]));
+    }
+}
+
+void ContainerArchiveWriter::Begin(string key, size_t size) {
+    uint32_t s = size;
+    Append(&s, sizeof(s));
+}
+
+void ContainerArchiveWriter::End(string key) {
+    // nop
+}
+
+/**
+ * Write a raw array as its length, its element type and the elements.
+ */
+void ContainerArchiveWriter::WriteRaw(string key, const void* data, size_t len, Types::Type type) {
+    if (Types::GetSize(type) == 0)
+        throw ResourceException("Unsupported type in WriteRawArray [" + key + "]");
+    uint32_t header[2] = { uint32_t(len), uint32_t(type) };
+    Append(header, sizeof(header));
+    Append(data, (size_t)len * Types::GetSize(type));
+}
+
+void ContainerArchiveWriter::WriteIndex(unsigned int idx) {
+    WriteInt(IDX_KEY, idx);
+}
+
+void ContainerArchiveWriter::WriteInt(string key, int in) {
+    int32_t v = in;
+    Append(&v, sizeof(v));
+}
+
+void ContainerArchiveWriter::WriteFloat(string key, float in) {
+    Append(&in, sizeof(in));
+}
+
+void ContainerArchiveWriter::WriteDouble(string key, double in) {
+    Append(&in, sizeof(in));
+}
+
+/**
+ * Write a string. Equal strings are stored once in the string table.
+ */
+void ContainerArchiveWriter::WriteString(string key, string in) {
+    uint32_t id = Intern(in);
+    Append(&id, sizeof(id));
+}
+
+/**
+ * Write a scene to a scene chunk named by the key.
+ */
+void ContainerArchiveWriter::WriteScene(string key, ISceneNode* node) {
+    uint32_t chunk = node ? AddChunk(CHUNK_SCENE, key) : NO_CHUNK;
+    Append(&chunk, sizeof(chunk));
+    if (node == NULL) return;
+    open.push_back(chunk);
+    SceneWriter w(*this);
+    node->Accept(w);
+    open.pop_back();
+}
+
+/**
+ * Write a data block to a data block chunk named by the key. A data
+ * block written more than once is stored once.
+ *
+ * @throws ResourceException if the data block is not loaded or of an
+ *         unsupported type.
+ */
+void ContainerArchiveWriter::WriteDataBlock(string key, IDataBlockPtr block) {
+    uint32_t chunk = NO_CHUNK;
+    if (block) {
+        if (block->GetVoidData() == NULL ||
+            !IsSupportedBlock(block->GetDimension(), block->GetType()))
+            throw ResourceException("Can not write data block " + key);
+        map<void*, unsigned int>::iterator itr = payloads.find(block.get());
+        if (itr != payloads.end()) chunk = itr->second;
+        else {
+            chunk = payloads[block.get()] = AddChunk(CHUNK_DATA_BLOCK, key);
+            chunks[chunk].block = block;
+        }
+    }
+    Append(&chunk, sizeof(chunk));
+}
+
+/**
+ * Write a texture to a texture chunk named by the key. A texture
+ * written more than once is stored once.
+ *
+ * @throws ResourceException if the texture is not loaded or of an
+ *         unsupported type.
+ */
+void ContainerArchiveWriter::WriteTexture(string key, ITexture2DPtr texture) {
+    uint32_t chunk = NO_CHUNK;
+    if (texture) {
+        if (texture->GetVoidDataPtr() == NULL || Types::GetSize(texture->GetType()) == 0)
+            throw ResourceException("Can not write texture " + key);
+        map<void*, unsigned int>::iterator itr = payloads.find(texture.get());
+        if (itr != payloads.end()) chunk = itr->second;
+        else {
+            chunk = payloads[texture.get()] = AddChunk(CHUNK_TEXTURE, key);
+            chunks[chunk].texture = texture;
+        }
+    }
+    Append(&chunk, sizeof(chunk));
+}
+
+/**
+ * Write the archive to the output stream. Nothing can be written to
+ * the archive afterwards.
+ *
+ * @throws ResourceException if the output stream fails.
+ */
+void ContainerArchiveWriter::Close() {
+    if (closed) return;
+
+    // the string table, offsets of each string followed by the strings
+    unsigned int table = AddChunk(CHUNK_STRINGS, "");
+    closed = true;
+    string& s = chunks[table].stream;
+    Put<uint32_t>(s, strings.size());
+    uint32_t offset = 0;
+    for (unsigned int i = 0; i < strings.size(); i++) {
+        Put<uint32_t>(s, offset);
+        offset += strings[i].size();
+    }
+    Put<uint32_t>(s, offset);
+    for (unsigned int i = 0; i < strings.size(); i++)
+        s.append(strings[i]);
+
+    // lay out the chunks and write the table of contents
+    uint64_t pos = HEADER_SIZE;
+    vector<uint64_t> offsets(chunks.size());
+    string toc;
+    for (unsigned int i = 0; i < chunks.size(); i++) {
+        Chunk& c = chunks[i];
+        size_t size;
+        uint32_t checksum;
+        if (c.block || c.texture) {
+            unsigned int header[8];
+            const char* data;
+            size_t length;
+            Payload(c, header, data, length);
+            size = PAYLOAD_HEADER_SIZE + length;
+            checksum = Adler32(Adler32(1, (const char*)header, sizeof(header)), data, length);
+        } else {
+            size = c.stream.size();
+            checksum = Adler32(1, c.stream.data(), size);
+        }
+        pos = offsets[i] = Align(pos);
+        pos += size;
+        Put<uint32_t>(toc, c.type);
+        Put<uint32_t>(toc, c.name);
+        Put<uint64_t>(toc, offsets[i]);
+        Put<uint64_t>(toc, size);
+        Put<uint32_t>(toc, checksum);
+        Put<uint32_t>(toc, 0);
+    }
+    uint64_t tocOffset = Align(pos);
+
+    string header(MAGIC, 4);
+    Put<uint32_t>(header, VERSION);
+    Put<uint32_t>(header, BYTE_ORDER_MARK);
+    Put<uint32_t>(header, chunks.size());
+    Put<uint64_t>(header, tocOffset);
+    Put<uint32_t>(header, Adler32(1, toc.data(), toc.size()));
+    Put<uint32_t>(header, 0);
+    output.write(header.data(), header.size());
+
+    const char padding[ALIGNMENT] = {0};
+    pos = HEADER_SIZE;
+    for (unsigned int i = 0; i < chunks.size(); i++) {
+        Chunk& c = chunks[i];
+        output.write(padding, offsets[i] - pos);
+        pos = offsets[i];
+        if (c.block || c.texture) {
+            unsigned int header[8];
+            const char* data;
+            size_t length;
+            Payload(c, header, data, length);
+            output.write((const char*)header, sizeof(header));
+            output.write(data, length);
+            pos += PAYLOAD_HEADER_SIZE + length;
+        } else {
+            output.write(c.stream.data(), c.stream.size());
+            pos += c.stream.size();
+        }
+    }
+    output.write(padding, tocOffset - pos);
+    output.write(toc.data(), toc.size());
+    output.flush();
+    if (!output)
+        throw ResourceException("Could not write archive");
+}
+
+} // NS Resources
+} // NS OpenEngine
@@ -0,0 +1,204 @@
+// Container archive.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#ifndef _OE_CONTAINER_ARCHIVE_H_
+#define _OE_CONTAINER_ARCHIVE_H_
+
+#include <Resources/IArchiveReader.h>
+#include <Resources/IArchiveWriter.h>
+#include <Resources/IDataBlock.h>
+#include <Resources/ITexture2D.h>
+#include <Resources/MappedFile.h>
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+
+namespace OpenEngine {
+namespace Scene {
+class ISceneNode;
+}
+namespace Resources {
+
+/**
+ * Chunk types of a container archive.
+ */
+enum ContainerChunkType {
+    CHUNK_STREAM = 1,  //!< values written outside of scenes
+    CHUNK_SCENE,       //!< a scene graph
+    CHUNK_DATA_BLOCK,  //!< a data block header and its elements
+    CHUNK_TEXTURE,     //!< a texture header and its pixels
+    CHUNK_STRINGS      //!< the interned strings
+};
+
+/**
+ * Container archive reader.
+ * Reads archives written by ContainerArchiveWriter from a mapped
+ * file. Values, objects and scenes are read in the order they were
+ * written like with the other archives, while data blocks and
+ * textures use the mapping in place. Every chunk can also be loaded
+ * on its own through the table of contents, so a scene or texture is
+ * only parsed and paged in when it is needed.
+ *
+ * The checksum of a chunk is verified the first time the chunk is
+ * used, unless verification is disabled.
+ *
+ * @code
+ * ContainerArchiveReader r(MappedFile::Open("level.oec"));
+ * ISceneNode* scene = r.LoadScene(r.FindChunk("scene", CHUNK_SCENE));
+ * @endcode
+ *
+ * @class ContainerArchiveReader ContainerArchive.h Resources/ContainerArchive.h
+ * @see ContainerArchiveWriter
+ */
+class ContainerArchiveReader : public IArchiveReader {
+public:
+    /**
+     * Table of contents entry.
+     */
+    struct Chunk {
+        ContainerChunkType type;
+        std::string name;
+        size_t offset, size;
+        unsigned int checksum;
+    };
+
+private:
+    struct Cursor {
+        const char* pos;
+        const char* end;
+    };
+
+    MappedFilePtr file;
+    bool verify;
+    std::vector<Chunk> chunks;
+    std::vector<bool> verified;
+    std::vector<Cursor> cursors;
+    const char* strings;
+    unsigned int numberOfStrings;
+    std::map<unsigned int, IDataBlockPtr> blocks;
+    std::map<unsigned int, ITexture2DPtr> textures;
+    std::set<unsigned int> loading;
+
+    void Read(void* out, size_t size);
+    unsigned int ReadUInt();
+    const char* Open(unsigned int chunk, ContainerChunkType type);
+    std::string GetString(unsigned int id);
+    Scene::ISceneNode* ReadNode();
+    void Corrupt(const std::string& reason);
+
+protected:
+    size_t Begin(std::string key);
+    void End(std::string key);
+    unsigned int ReadIndex();
+    void ReadRaw(std::string key, void* data, size_t len, Types::Type type);
+
+public:
+    ContainerArchiveReader(MappedFilePtr file, bool verify = true);
+
+    int ReadInt(std::string key);
+    float ReadFloat(std::string key);
+    double ReadDouble(std::string key);
+    std::string ReadString(std::string key);
+
+    Scene::ISceneNode* ReadScene(std::string key);
+    IDataBlockPtr ReadDataBlock(std::string key);
+    ITexture2DPtr ReadTexture(std::string key);
+
+    unsigned int GetNumberOfChunks() const;
+    const Chunk& GetChunk(unsigned int chunk) const;
+    int FindChunk(const std::string& name, ContainerChunkType type) const;
+
+    Scene::ISceneNode* LoadScene(int chunk);
+    IDataBlockPtr LoadDataBlock(int chunk);
+    ITexture2DPtr LoadTexture(int chunk);
+};
+
+/**
+ * Container archive writer.
+ * Writes a versioned binary container with a table of contents. The
+ * values written outside of scenes form the stream chunk, and every
+ * scene, data block and texture is written to a chunk of its own,
+ * named by the key it is written with. Strings and chunk names are
+ * interned in a string table. Chunks are aligned to 16 bytes, so the
+ * elements of data blocks and the pixels of textures can be used in
+ * place from a mapping of the file, and every chunk has a checksum.
+ *
+ * File layout, in the byte order of the writing machine:
+ * @code
+ * header   magic "OEAC", version, byte order mark, number of chunks,
+ *          offset and checksum of the table of contents  (32 bytes)
+ * chunks   16 byte aligned, the stream chunk first and the string
+ *          table last
+ * toc      type, name, offset, size and checksum per chunk (32 bytes)
+ * @endcode
+ *
+ * Data block and texture chunks start with a 32 byte header followed
+ * by the elements or pixels. The archive is written by Close(), and
+ * data blocks and textures must stay loaded until then, as their
+ * data is written directly from the resources.
+ *
+ * @class ContainerArchiveWriter ContainerArchive.h Resources/ContainerArchive.h
+ * @see ContainerArchiveReader
+ */
+class ContainerArchiveWriter : public IArchiveWriter {
+private:
+    struct Chunk {
+        ContainerChunkType type;
+        unsigned int name;
+        std::string stream;
+        IDataBlockPtr block;
+        ITexture2DPtr texture;
+    };
+
+    std::ostream& output;
+    std::vector<Chunk> chunks;
+    std::vector<unsigned int> open;
+    std::map<std::string, unsigned int> ids;
+    std::vector<std::string> strings;
+    std::map<void*, unsigned int> payloads;
+    bool closed;
+
+    class SceneWriter;
+    friend class SceneWriter;
+
+    void Append(const void* data, size_t size);
+    unsigned int Intern(const std::string& str);
+    unsigned int AddChunk(ContainerChunkType type, const std::string& name);
+    void Payload(Chunk& chunk, unsigned int header[8], const char*& data,
+                 size_t& size);
+
+protected:
+    void Begin(std::string key, size_t size);
+    void End(std::string key);
+    void WriteIndex(unsigned int idx);
+    void WriteRaw(std::string key, const void* data, size_t len, Types::Type type);
+
+public:
+    ContainerArchiveWriter(std::ostream& output);
+    virtual ~ContainerArchiveWriter();
+
+    void WriteInt(std::string key, int in);
+    void WriteFloat(std::string key, float in);
+    void WriteDouble(std::string key, double in);
+    void WriteString(std::string key, std::string in);
+
+    void WriteScene(std::string key, Scene::ISceneNode* node);
+    void WriteDataBlock(std::string key, IDataBlockPtr block);
+    void WriteTexture(std::string key, ITexture2DPtr texture);
+
+    void Close();
+};
+
+} // NS Resources
+} // NS OpenEngine
+
+#endif // _OE_CONTAINER_ARCHIVE_H_
@@ -11,6 +11,10 @@
 #define _DATA_BLOCK_H_
 
 #include <Resources/IDataBlock.h>
+#include <Resources/MappedFile.h>
+#include <Resources/Exceptions.h>
+#include <Resources/IArchiveWriter.h>
+#include <Resources/IArchiveReader.h>
 #include <string.h>
 
 namespace OpenEngine {
@@ -40,6 +44,32 @@ namespace OpenEngine {
                 }
             }
 
+            /**
+             * Create a data block using a region of a mapped file as
+             * its data without copying it. The block keeps the file
+             * mapped until it is unloaded. Blocks on read only
+             * mappings must not be written.
+             *
+             * @param s is the number of elements in the data block.
+             * @param file is the mapped file.
+             * @param offset is the byte offset of the elements in the file.
+             * @param b is the type of the data block.
+             * @param u is the blocks update mode.
+             * @throws ResourceException if the elements are not
+             *         within the file or not aligned.
+             */
+            DataBlock(unsigned int s, MappedFilePtr file, size_t offset,
+                      BlockType b = ARRAY, UpdateMode u = STATIC)
+                : IDataBlock(s, NULL, b, u), mapping(file) {
+                if (!file->Contains(offset, N * s * sizeof(T)))
+                    throw ResourceException("Data block outside of mapped file: " + file->GetPath());
+                if (offset % sizeof(T) != 0)
+                    throw ResourceException("Unaligned data block in mapped file: " + file->GetPath());
+                this->data = file->GetData() + offset;
+                this->dimension = N;
+                this->type = Types::GetResourceType<T>();
+            }
+
             DataBlock(IDataBlock* block) 
                 : IDataBlock(block->GetSize(), NULL, 
                              block->GetBlockType(), block->GetUpdateMode()){
@@ -58,7 +88,7 @@ namespace OpenEngine {
             }
 
             ~DataBlock(){
-                if (this->data)
+                if (this->data && !mapping)
                     delete [] (T*) this->data;
             }
 
@@ -73,15 +103,28 @@ namespace OpenEngine {
             }
 
             /**
-             * Unloads the data array.
+             * Unloads the data array, or releases the mapped file.
              */
             void Unload() {
-                if (this->data){
+                if (mapping) {
+                    mapping.reset();
+                    this->data = NULL;
+                }
+                else if (this->data){
                     delete [] (T*) this->data;
                     this->data = NULL;
                 }
             }
 
+            /**
+             * Get the mapped file holding the data.
+             *
+             * @return The mapped file, empty if the data is not mapped.
+             */
+            inline MappedFilePtr GetMapping() const {
+                return mapping;
+            }
+
             /**
              * Get pointer to loaded data.
              *
@@ -182,6 +225,29 @@ namespace OpenEngine {
                 }                                                       
             }
 
+            /**
+             * @throws ResourceException if the data block is unloaded.
+             */
+            void Serialize(IArchiveWriter& w) {
+                if (this->data == NULL && this->size != 0)
+                    throw ResourceException("Can not serialize unloaded data block");
+                w.WriteInt("size", this->size);
+                w.WriteInt("blocktype", this->blockType);
+                w.WriteInt("updatemode", this->updateMode);
+                w.WriteInt("policy", this->policy);
+                w.WriteRawArray("data", (const T*)this->data, N * this->size);
+            }
+
+            void Deserialize(IArchiveReader& r) {
+                Unload();
+                this->size = r.ReadInt("size");
+                this->blockType = BlockType(r.ReadInt("blocktype"));
+                this->updateMode = UpdateMode(r.ReadInt("updatemode"));
+                this->policy = UnloadPolicy(r.ReadInt("policy"));
+                this->data = new T[N * this->size];
+                r.ReadRawArray("data", (T*)this->data, N * this->size);
+            }
+
             std::string ToString(){
                 std::ostringstream out;
                 out << "[";
@@ -191,6 +257,9 @@ namespace OpenEngine {
                 out << GetElement(size-1) << "]";
                 return out.str();
             }
+
+        private:
+            MappedFilePtr mapping;
         };
 
         /**
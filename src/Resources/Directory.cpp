@@ -6,6 +6,7 @@
 #include <sys/stat.h> //includes mkdir
 //#include <sys/types.h>
 #include <dirent.h>
+#include <unistd.h> //includes getcwd, chdir
 #include <iostream>
 #include <sstream>
 #include <Logging/Logger.h>
@@ -4,6 +4,12 @@
 
 #include <sys/stat.h>
 #include <errno.h>
+#include <limits.h>
+#include <stdlib.h>
+
+#if defined(_WIN32)
+    #include <windows.h>
+#endif
 
 namespace OpenEngine {
 namespace Resources {
@@ -62,6 +68,21 @@ int File::GetSize(string filename) {
     return size;
 }
 
+/**
+ * Get the size in bytes of a file from the file system, without
+ * reading the file.
+ *
+ * @param filename File name.
+ * @return File size in bytes.
+ * @throws ResourceException if the file can not be found.
+ */
+unsigned long File::GetLength(string filename) {
+    struct stat sb;
+    if (stat(filename.c_str(), &sb) != 0)
+        throw ResourceException("Error reading size of: " + filename);
+    return sb.st_size;
+}
+
 bool File::Exists(string filename) {
     struct stat sb;
     int error = stat (filename.c_str(), &sb);
@@ -129,5 +150,31 @@ string File::Parent(string filename) {
     return filename.substr(0, i+1);
 }
 
+/**
+ * Get the canonical path of a file, the absolute path without
+ * symbolic links, "." and ".." parts. Different paths to the same
+ * file have the same canonical path.
+ * If the file does not exist the file name is returned unchanged.
+ * On Windows symbolic links are not resolved and the case of the
+ * path is kept.
+ *
+ * @param filename File path.
+ * @return Canonical file path.
+ */
+string File::Canonical(string filename) {
+#if defined(_WIN32)
+    if (GetFileAttributesA(filename.c_str()) == INVALID_FILE_ATTRIBUTES)
+        return filename;
+    char path[MAX_PATH];
+    DWORD length = GetFullPathNameA(filename.c_str(), MAX_PATH, path, NULL);
+    if (length == 0 || length >= MAX_PATH) return filename;
+    return string(path, length);
+#else
+    char path[PATH_MAX];
+    if (realpath(filename.c_str(), path) == NULL) return filename;
+    return path;
+#endif
+}
+
 } //NS Resources
 } //NS OpenEngine
@@ -4,6 +4,7 @@
 #include <Resources/SerializableObjects.h>
 #include <Resources/SerializableObjectTags.h>
 #include <Math/Vector.h>
+#include <Scene/ISceneNode.h>
 #include <boost/shared_ptr.hpp>
 
 namespace OpenEngine {
@@ -45,6 +46,32 @@ using namespace boost;
 #undef S_TYPE
 
 
+/**
+ * Read a raw array. The default reads the elements one by one,
+ * archives override it to read the array at once.
+ */
+void IArchiveReader::ReadRaw(string key, void* data, size_t len, Types::Type type) {
+    size_t s = Begin(key);
+    if (s != len) {
+        std::ostringstream os;
+        os << "Deserialization size mismatch in ReadRawArray ["
+           << key << "] should be: " << len << ", was: " << s;
+        throw Exception(os.str());
+    }
+    switch (type) {
+#define RAW_TYPE(t, type, name, ptype)                  \
+    case Types::t:                                      \
+        for (size_t i = 0; i < len; i++)                \
+            ((type*)data)[i] = (type)Read##name(ELM_KEY); \
+        break;
+#include <Resources/RawArrayTypes.def>
+#undef RAW_TYPE
+    default:
+        throw Exception("Unsupported type in ReadRawArray [" + key + "]");
+    }
+    End(key);
+}
+
 ISerializable* IArchiveReader::ReadObject_(string key) {
     size_t s = Begin(key);
     if (s != 0)
@@ -103,7 +130,24 @@ shared_ptr<ISerializable> IArchiveReader::ReadObjectPtr_(string key) {
     return obj;
 }
 
-
+/**
+ * Read a scene written with IArchiveWriter::WriteScenePtr. Every
+ * read of the same scene returns the same node.
+ */
+shared_ptr<Scene::ISceneNode> IArchiveReader::ReadScenePtr(string key) {
+    size_t s = Begin(key);
+    if (s != 0)
+        throw Exception("Invalid size in ReadScenePtr");
+    unsigned int idx = ReadIndex();
+    shared_ptr<Scene::ISceneNode> node;
+    std::map<unsigned int, shared_ptr<Scene::ISceneNode> >::iterator itr = scenes.find(idx);
+    if (itr != scenes.end())
+        node = itr->second;
+    else
+        node = scenes[idx] = shared_ptr<Scene::ISceneNode>(ReadScene(key));
+    End(key);
+    return node;
+}
 
 
 } // NS Resources
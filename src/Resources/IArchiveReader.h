@@ -21,6 +21,7 @@
 #include <map>
 
 #include <Resources/Serialization.h>
+#include <Resources/Types/ResourceTypes.h>
 #include <boost/shared_ptr.hpp>
 
 
@@ -45,6 +46,7 @@ protected:
     virtual size_t Begin(std::string key) = 0;
     virtual void End(std::string key) = 0;
     virtual unsigned int ReadIndex() = 0;
+    virtual void ReadRaw(std::string key, void* data, size_t len, Types::Type type);
 public:
     virtual ~IArchiveReader() {}
     virtual int ReadInt(std::string key) = 0;
@@ -65,6 +67,7 @@ public:
         return boost::static_pointer_cast<T>(ReadObjectPtr_(key));
     }
     boost::shared_ptr<ISerializable> ReadObjectPtr_(std::string key);
+    boost::shared_ptr<Scene::ISceneNode> ReadScenePtr(std::string key);
     // 
 
     template <class T>
@@ -148,6 +151,20 @@ public:
         
     }
 
+    /**
+     * Read an array written by IArchiveWriter::WriteRawArray.
+     *
+     * @param key Array key.
+     * @param arr Array to read into, of the element type written.
+     * @param len Number of elements.
+     * @throws Core::Exception if the length or element type differs
+     *         from what was written.
+     */
+    template <class T>
+    void ReadRawArray(std::string key, T* arr, size_t len) {
+        ReadRaw(key, arr, len, Types::GetResourceType<T>());
+    }
+
     std::map<unsigned int, ISerializable*> objects;
 
     // template <class T>
@@ -166,6 +183,7 @@ public:
 
 
     std::map<unsigned int, boost::shared_ptr<ISerializable> > objectsPtr;
+    std::map<unsigned int, boost::shared_ptr<Scene::ISceneNode> > scenes;
 
     // template <class T>
     // boost::shared_ptr<T> ReadObjectPtr(std::string key) {
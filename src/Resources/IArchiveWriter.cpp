@@ -2,6 +2,7 @@
 #include <Resources/IArchiveWriter.h>
 #include <Math/Vector.h>
 #include <Resources/ISerializable.h>
+#include <Core/Exceptions.h>
 
 namespace OpenEngine {
 namespace Resources {
@@ -43,6 +44,26 @@ namespace Resources {
 
 
 
+/**
+ * Write a raw array. The default writes the elements one by one,
+ * archives override it to write the array at once.
+ */
+void IArchiveWriter::WriteRaw(std::string key, const void* data, size_t len, Types::Type type) {
+    Begin(key, len);
+    switch (type) {
+#define RAW_TYPE(t, type, name, ptype)                          \
+    case Types::t:                                              \
+        for (size_t i = 0; i < len; i++)                        \
+            Write##name(ELM_KEY, (ptype)((const type*)data)[i]); \
+        break;
+#include <Resources/RawArrayTypes.def>
+#undef RAW_TYPE
+    default:
+        throw Core::Exception("Unsupported type in WriteRawArray [" + key + "]");
+    }
+    End(key);
+}
+
 void IArchiveWriter::WriteObject(std::string key, ISerializable* obj) {
     Begin(key,0);
     unsigned int idx = objects[obj];
@@ -73,6 +94,24 @@ void IArchiveWriter::WriteObjectPtr(std::string key, boost::shared_ptr<ISerializ
     End(key);
 }
 
+/**
+ * Write a shared scene. A scene written more than once is stored the
+ * first time and referenced by its index afterwards, so it is shared
+ * again when read back with IArchiveReader::ReadScenePtr.
+ */
+void IArchiveWriter::WriteScenePtr(std::string key, boost::shared_ptr<Scene::ISceneNode> node) {
+    Begin(key,0);
+    std::map<Scene::ISceneNode*, unsigned int>::iterator itr = scenes.find(node.get());
+    if (itr != scenes.end())
+        WriteIndex(itr->second);
+    else {
+        unsigned int idx = scenes.size() + 1;
+        scenes[node.get()] = idx;
+        WriteIndex(idx);
+        WriteScene(key, node.get());
+    }
+    End(key);
+}
 
 } // NS Resources
 } // NS OpenEngine
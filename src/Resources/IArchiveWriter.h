@@ -12,6 +12,7 @@
 #define _OE_I_ARCHIVE_WRITER_H_
 
 #include <Resources/Serialization.h>
+#include <Resources/Types/ResourceTypes.h>
 #include <Math/Vector.h>
 #include <Math/Matrix.h>
 #include <Math/Quaternion.h>
@@ -44,6 +45,7 @@ protected:
     virtual void Begin(std::string key, size_t len) = 0;
     virtual void End(std::string key) = 0;
     virtual void WriteIndex(unsigned int idx) = 0;
+    virtual void WriteRaw(std::string key, const void* data, size_t len, Types::Type type);
 public:
     virtual ~IArchiveWriter() {}
     virtual void WriteInt(std::string key, int in) = 0;
@@ -54,6 +56,7 @@ public:
     virtual void WriteScene(std::string key, Scene::ISceneNode* node) = 0;
     void WriteObject(std::string key, ISerializable* obj);
     void WriteObjectPtr(std::string key, boost::shared_ptr<ISerializable> obj);
+    void WriteScenePtr(std::string key, boost::shared_ptr<Scene::ISceneNode> node);
 
     template <class T>
     void WriteQuaternion(std::string key, Math::Quaternion<T> q) {
@@ -112,8 +115,25 @@ public:
         End(key);
     }
     
+    /**
+     * Write an array of plain values in bulk. Archives write the
+     * whole array at once, tagged with its element type, instead of
+     * element by element. Read it back with
+     * IArchiveReader::ReadRawArray using the same element type.
+     *
+     * @param key Array key.
+     * @param arr Array of unsigned char, char, unsigned short, short,
+     *        unsigned int, int, float or double.
+     * @param len Number of elements.
+     */
+    template <class T>
+    void WriteRawArray(std::string key, const T* arr, size_t len) {
+        WriteRaw(key, arr, len, Types::GetResourceType<T>());
+    }
+
     std::map<ISerializable*, unsigned int> objects;
     std::map<ISerializable*, unsigned int> objectsPtr;
+    std::map<Scene::ISceneNode*, unsigned int> scenes;
 
     /*
     template <class T>
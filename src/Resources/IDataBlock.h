@@ -16,6 +16,7 @@
 #include <Resources/IResource.h>
 
 #include <list>
+#include <algorithm>
 #include <string>
 
 namespace OpenEngine {
@@ -25,6 +26,8 @@ namespace OpenEngine {
          */
         class IDataBlockChangedEventArg;
         class IDataBlock;
+        class IArchiveWriter;
+        class IArchiveReader;
         /**
          * Data Block interface smart pointer.
          */
@@ -249,6 +252,21 @@ namespace OpenEngine {
              */
             virtual std::string ToString() = 0;
 
+            /**
+             * Write the properties and the elements of the data block.
+             *
+             * @param w The archive to write to.
+             */
+            virtual void Serialize(IArchiveWriter& w) { throw Core::NotImplemented(); }
+
+            /**
+             * Read the properties and the elements of the data block,
+             * replacing the current data.
+             *
+             * @param r The archive to read from.
+             */
+            virtual void Deserialize(IArchiveReader& r) { throw Core::NotImplemented(); }
+
             // *** Math ***
 
             /**
@@ -350,6 +368,22 @@ namespace OpenEngine {
             }
             IDataBlockChangedEventArg(IDataBlockPtr r, unsigned int s, unsigned int e)
                 : resource(r), start(s), end(e) {}
+
+            /**
+             * Key used to coalesce change events of the same block.
+             *
+             * @see Core::CoalescingQueuedEvent
+             */
+            const void* GetKey() const { return resource.get(); }
+
+            /**
+             * Extend the changed range to cover this and another
+             * change to the same block.
+             */
+            void Merge(const IDataBlockChangedEventArg& other) {
+                start = std::min(start, other.start);
+                end = std::max(end, other.end);
+            }
         };
 
     }
@@ -12,6 +12,7 @@
 
 #include <Resources/IResource.h>
 #include <Resources/ITexture.h>
+#include <algorithm>
 
 namespace OpenEngine {
     namespace Resources {
@@ -102,6 +103,29 @@ namespace OpenEngine {
             }
             Texture2DChangedEventArg(ITexture2DPtr resource, unsigned int x, unsigned int y, unsigned int w, unsigned int h, VoidPtr dr = VoidPtr()) 
                 : resource(resource), xOffset(x), yOffset(y), width(w), height(h), dataRect(dr) {}
+
+            /**
+             * Key used to coalesce change events of the same texture.
+             *
+             * @see Core::CoalescingQueuedEvent
+             */
+            const void* GetKey() const { return resource.get(); }
+
+            /**
+             * Extend the changed rectangle to the bounding rectangle
+             * of this and another change to the same texture. The
+             * rectangle data no longer covers the change and is
+             * dropped, so the texture data is read instead.
+             */
+            void Merge(const Texture2DChangedEventArg& other) {
+                unsigned int x1 = std::max(xOffset + width, other.xOffset + other.width);
+                unsigned int y1 = std::max(yOffset + height, other.yOffset + other.height);
+                xOffset = std::min(xOffset, other.xOffset);
+                yOffset = std::min(yOffset, other.yOffset);
+                width = x1 - xOffset;
+                height = y1 - yOffset;
+                dataRect.reset();
+            }
         };
 
     } // NS Resources
@@ -12,6 +12,7 @@
 
 #include <Resources/IResource.h>
 #include <Resources/ITexture.h>
+#include <algorithm>
 
 namespace OpenEngine {
     namespace Resources {
@@ -117,6 +118,31 @@ namespace OpenEngine {
             }
             Texture3DChangedEventArg(ITexture3DPtr resource, unsigned int x, unsigned int y, unsigned int z, unsigned int w, unsigned int h, unsigned int d, VoidPtr dr = VoidPtr()) 
                 : resource(resource), xOffset(x), yOffset(y), zOffset(z), width(w), height(h), depth(d), dataRect(dr) {}
+
+            /**
+             * Key used to coalesce change events of the same texture.
+             *
+             * @see Core::CoalescingQueuedEvent
+             */
+            const void* GetKey() const { return resource.get(); }
+
+            /**
+             * Extend the changed box to the bounding box of this and
+             * another change to the same texture. The box data is
+             * dropped as it no longer covers the change.
+             */
+            void Merge(const Texture3DChangedEventArg& other) {
+                unsigned int x1 = std::max(xOffset + width, other.xOffset + other.width);
+                unsigned int y1 = std::max(yOffset + height, other.yOffset + other.height);
+                unsigned int z1 = std::max(zOffset + depth, other.zOffset + other.depth);
+                xOffset = std::min(xOffset, other.xOffset);
+                yOffset = std::min(yOffset, other.yOffset);
+                zOffset = std::min(zOffset, other.zOffset);
+                width = x1 - xOffset;
+                height = y1 - yOffset;
+                depth = z1 - zOffset;
+                dataRect.reset();
+            }
         };
 
     } // NS Resources
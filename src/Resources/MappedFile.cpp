@@ -0,0 +1,161 @@
+// Memory mapped file.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#include <Resources/MappedFile.h>
+#include <Resources/Exceptions.h>
+
+#include <stdint.h>
+
+#if defined(_WIN32)
+    #include <windows.h>
+#else
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+namespace OpenEngine {
+namespace Resources {
+
+using std::string;
+
+// largest file that fits in the address space
+static const uint64_t maxSize = (size_t)-1;
+
+/**
+ * Map a file.
+ *
+ * @param filename File name.
+ * @param mode Mapping mode.
+ * @return Mapped file pointer.
+ * @throws ResourceException if the file can not be mapped.
+ */
+MappedFilePtr MappedFile::Open(const string& filename, Mode mode) {
+    return MappedFilePtr(new MappedFile(filename, mode));
+}
+
+/**
+ * Map a file.
+ *
+ * @param filename File name.
+ * @param mode Mapping mode.
+ * @throws ResourceException if the file can not be mapped, also if it
+ *         is larger than the address space.
+ */
+MappedFile::MappedFile(const string& filename, Mode mode)
+    : path(filename), mode(mode), size(0), data(NULL) {
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                              NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+        throw ResourceException("Could not open file: " + filename);
+    LARGE_INTEGER length;
+    if (!GetFileSizeEx(file, &length)) {
+        CloseHandle(file);
+        throw ResourceException("Could not read size of: " + filename);
+    }
+    if ((uint64_t)length.QuadPart > maxSize) {
+        CloseHandle(file);
+        throw ResourceException("File too large to map: " + filename);
+    }
+    size = (size_t)length.QuadPart;
+    // an empty file has no mapping
+    if (size > 0) {
+        void* d = NULL;
+        HANDLE mapping = CreateFileMappingA(file, NULL,
+            mode == READ_ONLY ? PAGE_READONLY : PAGE_WRITECOPY, 0, 0, NULL);
+        if (mapping != NULL) {
+            d = MapViewOfFile(mapping,
+                mode == READ_ONLY ? FILE_MAP_READ : FILE_MAP_COPY, 0, 0, 0);
+            // the view keeps the mapping object alive
+            CloseHandle(mapping);
+        }
+        if (d == NULL) {
+            CloseHandle(file);
+            throw ResourceException("Could not map file: " + filename);
+        }
+        data = (char*)d;
+    }
+    // the view stays valid after the file is closed
+    CloseHandle(file);
+#else
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw ResourceException("Could not open file: " + filename);
+    struct stat sb;
+    if (fstat(fd, &sb) != 0) {
+        close(fd);
+        throw ResourceException("Could not read size of: " + filename);
+    }
+    if ((uint64_t)sb.st_size > maxSize) {
+        close(fd);
+        throw ResourceException("File too large to map: " + filename);
+    }
+    size = (size_t)sb.st_size;
+    // an empty file has no mapping
+    if (size > 0) {
+        void* d;
+        if (mode == READ_ONLY)
+            d = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+        else
+            d = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        if (d == MAP_FAILED) {
+            close(fd);
+            throw ResourceException("Could not map file: " + filename);
+        }
+        data = (char*)d;
+    }
+    // the mapping stays valid after the descriptor is closed
+    close(fd);
+#endif
+}
+
+MappedFile::~MappedFile() {
+#if defined(_WIN32)
+    if (data) UnmapViewOfFile(data);
+#else
+    if (data) munmap(data, size);
+#endif
+}
+
+const string& MappedFile::GetPath() const {
+    return path;
+}
+
+MappedFile::Mode MappedFile::GetMode() const {
+    return mode;
+}
+
+/**
+ * Get the size of the mapping in bytes.
+ */
+size_t MappedFile::GetSize() const {
+    return size;
+}
+
+/**
+ * Get the mapped data, NULL for an empty file.
+ */
+char* MappedFile::GetData() const {
+    return data;
+}
+
+/**
+ * Check if a region lies within the mapping.
+ *
+ * @param offset Offset of the region in bytes.
+ * @param length Length of the region in bytes.
+ */
+bool MappedFile::Contains(size_t offset, size_t length) const {
+    return offset <= size && length <= size - offset;
+}
+
+} // NS Resources
+} // NS OpenEngine
@@ -0,0 +1,79 @@
+// Memory mapped file.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#ifndef _OE_MAPPED_FILE_H_
+#define _OE_MAPPED_FILE_H_
+
+#include <boost/shared_ptr.hpp>
+#include <cstddef>
+#include <string>
+
+namespace OpenEngine {
+namespace Resources {
+
+class MappedFile;
+
+/**
+ * Mapped file smart pointer.
+ */
+typedef boost::shared_ptr<MappedFile> MappedFilePtr;
+
+/**
+ * Memory mapped file.
+ * Maps a whole file into memory, so its contents are paged in from
+ * the page cache on demand instead of being read through a heap
+ * buffer. Data blocks and textures can use regions of the mapping as
+ * their data, keeping the mapping alive through a MappedFilePtr until
+ * the last of them is unloaded.
+ *
+ * A read only mapping is shared with every other process mapping
+ * the file and must not be written. A copy on write mapping may be
+ * written, the written pages are copied and the file is not changed.
+ *
+ * @code
+ * MappedFilePtr file = MappedFile::Open("terrain.bin");
+ * DataBlock<3,float>* vertices =
+ *     new DataBlock<3,float>(count, file, offset);
+ * @endcode
+ *
+ * @class MappedFile MappedFile.h Resources/MappedFile.h
+ */
+class MappedFile {
+public:
+    //! Mapping modes.
+    enum Mode {
+        READ_ONLY,     //!< shared, read only pages
+        COPY_ON_WRITE  //!< private pages copied when written
+    };
+
+    static MappedFilePtr Open(const std::string& filename, Mode mode = READ_ONLY);
+
+    MappedFile(const std::string& filename, Mode mode = READ_ONLY);
+    virtual ~MappedFile();
+
+    const std::string& GetPath() const;
+    Mode GetMode() const;
+    size_t GetSize() const;
+    char* GetData() const;
+    bool Contains(size_t offset, size_t length) const;
+
+private:
+    std::string path;
+    Mode mode;
+    size_t size;
+    char* data;
+
+    MappedFile(const MappedFile&);
+    MappedFile& operator=(const MappedFile&);
+};
+
+} // NS Resources
+} // NS OpenEngine
+
+#endif // _OE_MAPPED_FILE_H_
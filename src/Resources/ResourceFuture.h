@@ -0,0 +1,127 @@
+// Future of an asynchronously loaded resource.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#ifndef _OE_RESOURCE_FUTURE_H_
+#define _OE_RESOURCE_FUTURE_H_
+
+#include <Resources/ResourceLoader.h>
+#include <Resources/IResourcePlugin.h>
+#include <Resources/Exceptions.h>
+#include <Core/Event.h>
+
+#include <boost/shared_ptr.hpp>
+#include <string>
+
+namespace OpenEngine {
+namespace Resources {
+
+/**
+ * Resource future event argument, sent when the future is delivered.
+ * The resource is empty unless the state is LOADED.
+ */
+template <class T>
+struct ResourceFutureEventArg {
+    boost::shared_ptr<T> resource;
+    ResourceLoad::State state;
+    ResourceFutureEventArg(boost::shared_ptr<T> resource, ResourceLoad::State state)
+        : resource(resource), state(state) {}
+};
+
+/**
+ * Future of a resource loaded by a ResourceLoader.
+ * The resource is created by a resource plug-in and loaded on a
+ * loader thread. Get() returns the resource once it is loaded, and
+ * the loaded event is sent on the engine thread when the result is
+ * delivered.
+ *
+ * @code
+ * ResourceFuture<ITexture2D>::Ptr tex =
+ *     ResourceManager<ITexture2D>::Load("grass.png", *loader);
+ * tex->LoadedEvent().Attach(*this);
+ * ...
+ * ITexture2DPtr t = tex->Get(); // empty until loaded
+ * @endcode
+ *
+ * @class ResourceFuture ResourceFuture.h Resources/ResourceFuture.h
+ * @see ResourceLoader
+ */
+template <class T>
+class ResourceFuture : public ResourceLoad {
+public:
+    typedef boost::shared_ptr<ResourceFuture<T> > Ptr;
+
+    /**
+     * Create a future.
+     *
+     * @param plugin Plug-in creating the resource.
+     * @param path Full path of the resource file.
+     * @param priority Loads with higher priority are loaded first.
+     */
+    ResourceFuture(IResourcePlugin<T>* plugin, const std::string& path, int priority = 0)
+        : ResourceLoad(path, priority), plugin(plugin) {}
+
+    /**
+     * Get the resource.
+     *
+     * @return The loaded resource, empty if the load is not done or
+     *         did not succeed.
+     */
+    boost::shared_ptr<T> Get() {
+        if (GetState() != LOADED) return boost::shared_ptr<T>();
+        return resource;
+    }
+
+    /**
+     * Wait for the resource, loading it on the calling thread if no
+     * loader thread has taken it yet.
+     *
+     * @return The loaded resource.
+     * @throws ResourceException if the load failed or was cancelled.
+     */
+    boost::shared_ptr<T> WaitFor() {
+        Wait();
+        if (GetState() == FAILED)
+            throw ResourceException("Failed to load " + GetPath() + ": " + GetError());
+        if (GetState() == CANCELLED)
+            throw ResourceException("The load was cancelled: " + GetPath());
+        return resource;
+    }
+
+    /**
+     * Event sent on the engine thread when the result is delivered.
+     */
+    IEvent<ResourceFutureEventArg<T> >& LoadedEvent() {
+        return loadedEvent;
+    }
+
+protected:
+    void Load() {
+        boost::shared_ptr<T> r = plugin->CreateResource(GetPath());
+        r->Load();
+        resource = r;
+    }
+
+    void Deliver() {
+        loadedEvent.Notify(ResourceFutureEventArg<T>(Get(), GetState()));
+    }
+
+    void Discard() {
+        resource.reset();
+    }
+
+private:
+    IResourcePlugin<T>* plugin;
+    boost::shared_ptr<T> resource;
+    Core::Event<ResourceFutureEventArg<T> > loadedEvent;
+};
+
+} // NS Resources
+} // NS OpenEngine
+
+#endif // _OE_RESOURCE_FUTURE_H_
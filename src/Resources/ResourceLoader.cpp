@@ -0,0 +1,340 @@
+// Asynchronous resource loader.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#include <Resources/ResourceLoader.h>
+#include <Resources/Exceptions.h>
+
+#include <exception>
+
+namespace OpenEngine {
+namespace Resources {
+
+using std::list;
+using std::string;
+
+/**
+ * Create a load.
+ *
+ * @param path Path of the resource.
+ * @param priority Loads with higher priority are loaded first.
+ */
+ResourceLoad::ResourceLoad(const string& path, int priority)
+    : path(path), state(QUEUED), cancelled(false), delivered(false)
+    , priority(priority), sequence(0), loader(NULL) {}
+
+ResourceLoad::~ResourceLoad() {}
+
+const string& ResourceLoad::GetPath() const {
+    return path;
+}
+
+ResourceLoad::State ResourceLoad::GetState() const {
+    return state;
+}
+
+/**
+ * Check if the load has completed, failed or been cancelled. The
+ * result may not have been delivered yet.
+ */
+bool ResourceLoad::IsDone() const {
+    return state == LOADED || state == FAILED || state == CANCELLED;
+}
+
+/**
+ * Check if the result has been delivered on the dispatching thread.
+ */
+bool ResourceLoad::IsDelivered() const {
+    return delivered;
+}
+
+/**
+ * Get the message of the exception that failed the load.
+ */
+string ResourceLoad::GetError() const {
+    return state == FAILED ? error : string();
+}
+
+int ResourceLoad::GetPriority() const {
+    return priority;
+}
+
+/**
+ * Change the priority of the load. Only affects queued loads.
+ */
+void ResourceLoad::SetPriority(int priority) {
+    if (loader) loader->Reprioritize(*this, priority);
+    else this->priority = priority;
+}
+
+/**
+ * Cancel the load.
+ * A queued load is never loaded. A load in progress completes, but
+ * its resource is dropped and it is delivered as cancelled.
+ *
+ * @return False if the load was already done.
+ */
+bool ResourceLoad::Cancel() {
+    if (loader) return loader->Cancel(*this);
+    if (IsDone()) return false;
+    state = CANCELLED;
+    return true;
+}
+
+/**
+ * Wait until the load is done. A queued load is loaded on the
+ * calling thread.
+ * The result is still delivered when the loader is dispatched.
+ *
+ * @throws ResourceException if the load has not been submitted.
+ */
+void ResourceLoad::Wait() {
+    if (IsDone()) return;
+    if (loader == NULL)
+        throw ResourceException("The load has not been submitted: " + path);
+    loader->Wait(*this);
+}
+
+ResourceLoader::Worker::Worker(ResourceLoader& loader)
+    : Thread("oe-loader"), loader(loader) {
+    SetJoinOnShutdown(true);
+}
+
+/**
+ * Create a loader.
+ * The loader threads are not started until Start() is called.
+ *
+ * @param threads Number of loader threads.
+ */
+ResourceLoader::ResourceLoader(unsigned int threads)
+    : count(threads), running(false), sequence(0), loading(0) {
+    pthread_mutex_init(&lock, NULL);
+    pthread_cond_init(&changed, NULL);
+}
+
+/**
+ * Stops the loader threads. Loads that are still queued or not yet
+ * delivered are cancelled without being delivered.
+ */
+ResourceLoader::~ResourceLoader() {
+    Stop();
+    std::set<ResourceLoadPtr, Order>::iterator q;
+    for (q = queue.begin(); q != queue.end(); q++) {
+        (*q)->state = ResourceLoad::CANCELLED;
+        (*q)->loader = NULL;
+    }
+    list<ResourceLoadPtr>::iterator d;
+    for (d = done.begin(); d != done.end(); d++)
+        (*d)->loader = NULL;
+    pthread_cond_destroy(&changed);
+    pthread_mutex_destroy(&lock);
+}
+
+/**
+ * Start the loader threads.
+ * Calls to Start() on a running loader are ignored.
+ */
+void ResourceLoader::Start() {
+    if (running) return;
+    // reclaim threads stopped by Thread::JoinAll
+    Stop();
+    running = true;
+    for (unsigned int i = 0; i < count; i++)
+        workers.push_back(new Worker(*this));
+    for (unsigned int i = 0; i < count; i++)
+        workers[i]->Start();
+}
+
+/**
+ * Stop and join the loader threads after their current loads.
+ * Queued loads stay queued until the loader is started again.
+ */
+void ResourceLoader::Stop() {
+    Shutdown();
+    for (unsigned int i = 0; i < workers.size(); i++) {
+        workers[i]->Wait();
+        delete workers[i];
+    }
+    workers.clear();
+}
+
+bool ResourceLoader::IsRunning() const {
+    return running;
+}
+
+unsigned int ResourceLoader::GetThreadCount() const {
+    return count;
+}
+
+/**
+ * Queue a load.
+ *
+ * @param load Load to queue.
+ * @throws ResourceException if the load has been submitted before.
+ */
+void ResourceLoader::Submit(ResourceLoadPtr load) {
+    pthread_mutex_lock(&lock);
+    if (load->loader != NULL || load->state != ResourceLoad::QUEUED) {
+        pthread_mutex_unlock(&lock);
+        throw ResourceException("The load has been submitted before: " + load->path);
+    }
+    load->loader = this;
+    load->sequence = sequence++;
+    queue.insert(load);
+    pthread_cond_signal(&changed);
+    pthread_mutex_unlock(&lock);
+}
+
+/**
+ * Deliver the done loads and send the load event for each of them.
+ * Call on the engine thread, which is done by attaching the loader
+ * to the process event.
+ */
+void ResourceLoader::Dispatch() {
+    list<ResourceLoadPtr> loads;
+    pthread_mutex_lock(&lock);
+    loads.swap(done);
+    pthread_mutex_unlock(&lock);
+    list<ResourceLoadPtr>::iterator itr;
+    for (itr = loads.begin(); itr != loads.end(); itr++) {
+        ResourceLoadPtr load = *itr;
+        load->loader = NULL;
+        if (load->state == ResourceLoad::CANCELLED) load->Discard();
+        load->delivered = true;
+        load->Deliver();
+        loadEvent.Notify(ResourceLoadEventArg(load));
+    }
+}
+
+void ResourceLoader::Handle(ProcessEventArg arg) {
+    Dispatch();
+}
+
+/**
+ * Number of loads waiting for a loader thread.
+ */
+unsigned int ResourceLoader::GetQueued() {
+    pthread_mutex_lock(&lock);
+    unsigned int n = queue.size();
+    pthread_mutex_unlock(&lock);
+    return n;
+}
+
+/**
+ * Number of submitted loads not yet delivered.
+ */
+unsigned int ResourceLoader::GetPending() {
+    pthread_mutex_lock(&lock);
+    unsigned int n = queue.size() + loading + done.size();
+    pthread_mutex_unlock(&lock);
+    return n;
+}
+
+/**
+ * Event sent on the dispatching thread for every delivered load.
+ */
+IEvent<ResourceLoadEventArg>& ResourceLoader::LoadEvent() {
+    return loadEvent;
+}
+
+void ResourceLoader::WorkerLoop() {
+    pthread_mutex_lock(&lock);
+    for (;;) {
+        while (running && queue.empty())
+            pthread_cond_wait(&changed, &lock);
+        if (!running) break;
+        ResourceLoadPtr load = *queue.begin();
+        queue.erase(queue.begin());
+        load->state = ResourceLoad::LOADING;
+        loading++;
+        pthread_mutex_unlock(&lock);
+        Run(load);
+        pthread_mutex_lock(&lock);
+    }
+    pthread_mutex_unlock(&lock);
+}
+
+void ResourceLoader::Shutdown() {
+    pthread_mutex_lock(&lock);
+    running = false;
+    pthread_cond_broadcast(&changed);
+    pthread_mutex_unlock(&lock);
+}
+
+// load without holding the lock, then complete the load
+void ResourceLoader::Run(ResourceLoadPtr load) {
+    bool failed = false;
+    string error;
+    try {
+        load->Load();
+    }
+    catch (std::exception& e) {
+        failed = true;
+        error = e.what();
+    }
+    catch (...) {
+        failed = true;
+        error = "Unknown error";
+    }
+    pthread_mutex_lock(&lock);
+    load->error = error;
+    if (load->cancelled) load->state = ResourceLoad::CANCELLED;
+    else load->state = failed ? ResourceLoad::FAILED : ResourceLoad::LOADED;
+    loading--;
+    done.push_back(load);
+    pthread_cond_broadcast(&changed);
+    pthread_mutex_unlock(&lock);
+}
+
+bool ResourceLoader::Cancel(ResourceLoad& load) {
+    bool cancelled = true;
+    pthread_mutex_lock(&lock);
+    if (load.state == ResourceLoad::QUEUED) {
+        queue.erase(load.shared_from_this());
+        load.state = ResourceLoad::CANCELLED;
+        done.push_back(load.shared_from_this());
+        pthread_cond_broadcast(&changed);
+    }
+    else if (load.state == ResourceLoad::LOADING) load.cancelled = true;
+    else cancelled = false;
+    pthread_mutex_unlock(&lock);
+    return cancelled;
+}
+
+void ResourceLoader::Reprioritize(ResourceLoad& load, int priority) {
+    pthread_mutex_lock(&lock);
+    if (load.state == ResourceLoad::QUEUED) {
+        ResourceLoadPtr l = load.shared_from_this();
+        queue.erase(l);
+        load.priority = priority;
+        queue.insert(l);
+    }
+    else load.priority = priority;
+    pthread_mutex_unlock(&lock);
+}
+
+// wait for a load, loading it on this thread if it is still queued
+void ResourceLoader::Wait(ResourceLoad& load) {
+    pthread_mutex_lock(&lock);
+    while (!load.IsDone()) {
+        if (load.state == ResourceLoad::QUEUED) {
+            ResourceLoadPtr l = load.shared_from_this();
+            queue.erase(l);
+            load.state = ResourceLoad::LOADING;
+            loading++;
+            pthread_mutex_unlock(&lock);
+            Run(l);
+            pthread_mutex_lock(&lock);
+        }
+        else pthread_cond_wait(&changed, &lock);
+    }
+    pthread_mutex_unlock(&lock);
+}
+
+} // NS Resources
+} // NS OpenEngine
@@ -0,0 +1,207 @@
+// Asynchronous resource loader.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#ifndef _OE_RESOURCE_LOADER_H_
+#define _OE_RESOURCE_LOADER_H_
+
+#include <Core/IListener.h>
+#include <Core/EngineEvents.h>
+#include <Core/Event.h>
+#include <Core/Thread.h>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/enable_shared_from_this.hpp>
+#include <pthread.h>
+#include <string>
+#include <vector>
+#include <list>
+#include <set>
+
+namespace OpenEngine {
+namespace Resources {
+
+using Core::IListener;
+using Core::IEvent;
+using Core::ProcessEventArg;
+
+class ResourceLoader;
+
+/**
+ * Load of a resource on a ResourceLoader.
+ * Sub classes load the resource on a loader thread and deliver the
+ * result on the thread dispatching the loader, see ResourceFuture.
+ *
+ * @class ResourceLoad ResourceLoader.h Resources/ResourceLoader.h
+ */
+class ResourceLoad : public boost::enable_shared_from_this<ResourceLoad> {
+public:
+    //! States of a load.
+    enum State {
+        QUEUED,    //!< waiting for a loader thread
+        LOADING,   //!< being loaded
+        LOADED,    //!< loaded successfully
+        FAILED,    //!< loading threw an exception, see GetError()
+        CANCELLED  //!< cancelled before it was delivered
+    };
+
+    ResourceLoad(const std::string& path, int priority);
+    virtual ~ResourceLoad();
+
+    const std::string& GetPath() const;
+    State GetState() const;
+    bool IsDone() const;
+    bool IsDelivered() const;
+    std::string GetError() const;
+    int GetPriority() const;
+    void SetPriority(int priority);
+    bool Cancel();
+    void Wait();
+
+protected:
+    /**
+     * Load the resource.
+     * Called on a loader thread, or on a thread waiting for the load.
+     * Exceptions mark the load failed.
+     */
+    virtual void Load() = 0;
+
+    /**
+     * Deliver the result.
+     * Called on the thread dispatching the loader once the load is
+     * done, also for failed and cancelled loads.
+     */
+    virtual void Deliver() = 0;
+
+    /**
+     * Drop the resource of a load cancelled while it was loading.
+     * Called on the thread dispatching the loader before Deliver().
+     */
+    virtual void Discard() = 0;
+
+private:
+    friend class ResourceLoader;
+
+    std::string path;
+    volatile State state;
+    volatile bool cancelled;
+    volatile bool delivered;
+    int priority;
+    unsigned long sequence;
+    std::string error;
+    ResourceLoader* loader;
+
+    ResourceLoad(const ResourceLoad&);
+    ResourceLoad& operator=(const ResourceLoad&);
+};
+
+typedef boost::shared_ptr<ResourceLoad> ResourceLoadPtr;
+
+/**
+ * Resource load event argument, sent when a load is delivered.
+ */
+struct ResourceLoadEventArg {
+    ResourceLoadPtr load;
+    ResourceLoadEventArg(ResourceLoadPtr load) : load(load) {}
+};
+
+/**
+ * Asynchronous resource loader.
+ * A pool of loader threads reading and decoding resources, so the
+ * disk access and decoding of a level runs across cores while the
+ * engine keeps running frames. Loads are taken highest priority
+ * first, in the order they were submitted within a priority, and
+ * queued loads can be cancelled or have their priority changed.
+ *
+ * Results are delivered on the engine thread: attach the loader to
+ * the process event of the engine, or call Dispatch(), and each done
+ * load is delivered and the load event sent.
+ *
+ * @code
+ * ResourceLoader* loader = new ResourceLoader(2);
+ * loader->Start();
+ * engine.ProcessEvent().Attach(*loader);
+ * ResourceFuture<ITexture2D>::Ptr tex =
+ *     ResourceManager<ITexture2D>::Load("grass.png", *loader);
+ * @endcode
+ *
+ * A loader without threads, or one that has not been started, loads
+ * on the threads waiting for loads and otherwise never.
+ *
+ * @class ResourceLoader ResourceLoader.h Resources/ResourceLoader.h
+ * @see ResourceFuture
+ * @see ResourceManager
+ */
+class ResourceLoader : public IListener<ProcessEventArg> {
+public:
+    ResourceLoader(unsigned int threads = 2);
+    virtual ~ResourceLoader();
+
+    void Start();
+    void Stop();
+    bool IsRunning() const;
+    unsigned int GetThreadCount() const;
+
+    void Submit(ResourceLoadPtr load);
+    void Dispatch();
+    void Handle(ProcessEventArg arg);
+
+    unsigned int GetQueued();
+    unsigned int GetPending();
+
+    IEvent<ResourceLoadEventArg>& LoadEvent();
+
+private:
+    friend class ResourceLoad;
+
+    class Worker : public Core::Thread {
+    public:
+        ResourceLoader& loader;
+        Worker(ResourceLoader& loader);
+        void Run() { loader.WorkerLoop(); }
+        void RequestStop() { loader.Shutdown(); }
+    };
+
+    //! queue order, highest priority and then earliest first
+    struct Order {
+        bool operator()(const ResourceLoadPtr& a, const ResourceLoadPtr& b) const {
+            if (a->priority != b->priority) return a->priority > b->priority;
+            return a->sequence < b->sequence;
+        }
+    };
+
+    unsigned int count;
+    std::vector<Worker*> workers;
+    volatile bool running;
+    unsigned long sequence;
+    unsigned int loading;
+
+    std::set<ResourceLoadPtr, Order> queue;
+    std::list<ResourceLoadPtr> done;
+    Core::Event<ResourceLoadEventArg> loadEvent;
+
+    //! guards the queue, the done list and the states of the loads
+    pthread_mutex_t lock;
+    //! signalled when a load is queued or completes
+    pthread_cond_t changed;
+
+    void WorkerLoop();
+    void Shutdown();
+    void Run(ResourceLoadPtr load);
+    bool Cancel(ResourceLoad& load);
+    void Reprioritize(ResourceLoad& load, int priority);
+    void Wait(ResourceLoad& load);
+
+    ResourceLoader(const ResourceLoader&);
+    ResourceLoader& operator=(const ResourceLoader&);
+};
+
+} // NS Resources
+} // NS OpenEngine
+
+#endif // _OE_RESOURCE_LOADER_H_
@@ -16,9 +16,11 @@
 #include <Resources/File.h>
 #include <Utils/Convert.h>
 #include <Resources/IResourcePlugin.h>
+#include <Resources/ResourceFuture.h>
 #include <Logging/Logger.h>
 #include <string>
 #include <map>
+#include <list>
 #include <vector>
 #include <boost/shared_ptr.hpp>
 
@@ -28,16 +30,93 @@ namespace Resources {
 using OpenEngine::Utils::Convert;
 using namespace std;
 
+/**
+ * Resource cache statistics.
+ *
+ * @see ResourceManager
+ */
+struct ResourceCacheStats {
+    unsigned long hits;      //!< creates returning a cached resource
+    unsigned long misses;    //!< creates creating a new resource
+    unsigned long evictions; //!< resources evicted from the cache
+    unsigned long entries;   //!< resources in the cache
+    unsigned long bytes;     //!< size of the resources in the cache
+    ResourceCacheStats()
+        : hits(0), misses(0), evictions(0), entries(0), bytes(0) {}
+};
+
 /**
  * Resource manager.
  *
+ * Setting a memory budget for a resource type enables a cache of its
+ * resources. Created resources are then cached by the canonical path
+ * of their file, so every request for the same file gets the same
+ * resource instead of decoding and storing it again. Users share the
+ * cached resources, so only enable the cache for types whose
+ * resources are not changed by their users, e.g. textures, but not
+ * models that hand out their scene nodes.
+ *
+ * The budget caps the total size of the cached resources, those in
+ * use included. When it is exceeded the least recently used resources
+ * that are not referenced outside the cache are evicted. Resources in
+ * use are never evicted, so the cache may stay above the budget while
+ * they are used, and each new resource then walks the whole cache
+ * and evicts every unused one. Set the budget above the size of the
+ * resources expected to be in use at once. The default budget is
+ * zero, which disables the cache, so every request creates a new
+ * resource.
+ *
+ * The size of a resource is by default the size of its file, set a
+ * size function to measure resources more precisely.
+ *
  * @class ResourceManager ResourceManager.h Resources/ResourceManager.h
  */
 template<class T>
 class ResourceManager {
+public:
+    /**
+     * Function measuring the size in bytes of a resource.
+     */
+    typedef unsigned long (*SizeFunction)(boost::shared_ptr<T> resource, const string& file);
+
 private:
+    struct CacheEntry {
+        boost::shared_ptr<T> resource;
+        unsigned long size;
+        typename list<string>::iterator lru;
+    };
+
     static vector<IResourcePlugin<T>*> plugins;
-    static map<string,  boost::shared_ptr<T> > resources;
+    static map<string, CacheEntry> cache;
+    // cache keys, most recently used first
+    static list<string> lru;
+    static unsigned long budget;
+    static SizeFunction sizeFunction;
+    static ResourceCacheStats stats;
+
+    static unsigned long FileSize(boost::shared_ptr<T> resource, const string& file) {
+        try {
+            return File::GetLength(file);
+        } catch (const ResourceException&) {
+            return 0;
+        }
+    }
+
+    // evict unused resources, least recently used first, until the
+    // total size of the cache is within the limit
+    static void Evict(unsigned long limit) {
+        typename list<string>::iterator itr = lru.end();
+        while (stats.bytes > limit && itr != lru.begin()) {
+            itr--;
+            typename map<string, CacheEntry>::iterator entry = cache.find(*itr);
+            if (!entry->second.resource.unique()) continue;
+            stats.bytes -= entry->second.size;
+            stats.entries--;
+            stats.evictions++;
+            cache.erase(entry);
+            itr = lru.erase(itr);
+        }
+    }
 
 public:
 
@@ -52,7 +131,8 @@ static void AddPlugin(IResourcePlugin<T>* plugin) {
   
 
 /**
- * Create a resource object.
+ * Create a resource object, or get it from the cache if the cache is
+ * enabled by a budget.
  *
  * @param filename name of the file to be loaded
  * @return pointer to a resource
@@ -72,7 +152,24 @@ static void AddPlugin(IResourcePlugin<T>* plugin) {
   // load the resource
   if (plugin != plugins.end()) {
     string fullname = DirectoryManager::FindFileInPath(filename);
+    if (budget == 0)
+      return (*plugin)->CreateResource(fullname);
+    string key = File::Canonical(fullname);
+    typename map<string, CacheEntry>::iterator cached = cache.find(key);
+    if (cached != cache.end()) {
+      stats.hits++;
+      lru.splice(lru.begin(), lru, cached->second.lru);
+      return cached->second.resource;
+    }
+    stats.misses++;
     boost::shared_ptr<T> resource = (*plugin)->CreateResource(fullname);
+    CacheEntry& entry = cache[key];
+    entry.resource = resource;
+    entry.size = sizeFunction(resource, fullname);
+    entry.lru = lru.insert(lru.begin(), key);
+    stats.entries++;
+    stats.bytes += entry.size;
+    Evict(budget);
     return resource;
   } else
     logger.warning << "Plugin for ." << ext << " not found." << logger.end;
@@ -80,10 +177,113 @@ static void AddPlugin(IResourcePlugin<T>* plugin) {
   throw ResourceException("Unsupported file format: " + filename);
 }
 
+/**
+ * Set the memory budget of the cache and evict unused resources to
+ * fit it. A budget of zero disables and empties the cache.
+ *
+ * @param bytes total size of the cached resources, in use or not
+ */
+static void SetBudget(unsigned long bytes) {
+  budget = bytes;
+  if (budget == 0) Clear();
+  else Evict(budget);
+}
+
+/**
+ * Get the memory budget of the cache.
+ */
+static unsigned long GetBudget() {
+  return budget;
+}
+
+/**
+ * Set the function measuring the size of created resources.
+ *
+ * @param function size function, NULL measures the resource file
+ */
+static void SetSizeFunction(SizeFunction function) {
+  sizeFunction = function ? function : FileSize;
+}
+
+/**
+ * Evict every cached resource that is not in use.
+ */
+static void Purge() {
+  Evict(0);
+}
+
+/**
+ * Empty the cache. Resources in use are kept by their users, but are
+ * created again by the next request.
+ */
+static void Clear() {
+  cache.clear();
+  lru.clear();
+  stats.entries = stats.bytes = 0;
+}
+
+/**
+ * Get the cache statistics.
+ */
+static ResourceCacheStats GetStats() {
+  return stats;
+}
+
+/**
+ * Reset the hit, miss and eviction counters of the statistics.
+ */
+static void ResetStats() {
+  stats.hits = stats.misses = stats.evictions = 0;
+}
+
+/**
+ * Load a resource object asynchronously.
+ * The file is found in the path on the calling thread, while the
+ * resource is created and loaded on a thread of the loader, so the
+ * plug-in must allow resources to be created concurrently.
+ * Asynchronously loaded resources are not cached.
+ *
+ * @param filename name of the file to be loaded
+ * @param loader loader to load the resource on
+ * @param priority loads with higher priority are loaded first
+ * @return future of the resource
+ * @throws ResourceException if the file format is unsupported or the file does not exist
+ */
+  static typename ResourceFuture<T>::Ptr Load(const string filename, ResourceLoader& loader, int priority = 0) {
+  string ext = Convert::ToLower(File::Extension(filename));
+
+  typename vector< IResourcePlugin<T>* >::iterator plugin;
+  for (plugin = plugins.begin(); plugin != plugins.end() ; plugin++) {
+    if ((*plugin)->AcceptsExtension(ext)) {
+      break;
+    }
+  }
+
+  if (plugin != plugins.end()) {
+    string fullname = DirectoryManager::FindFileInPath(filename);
+    typename ResourceFuture<T>::Ptr future(new ResourceFuture<T>(*plugin, fullname, priority));
+    loader.Submit(future);
+    return future;
+  } else
+    logger.warning << "Plugin for ." << ext << " not found." << logger.end;
+
+  throw ResourceException("Unsupported file format: " + filename);
+}
+
 };
 
   template<class T>
   vector<IResourcePlugin<T>*> ResourceManager<T>::plugins = vector<IResourcePlugin<T>*>();
+  template<class T>
+  map<string, typename ResourceManager<T>::CacheEntry> ResourceManager<T>::cache;
+  template<class T>
+  list<string> ResourceManager<T>::lru;
+  template<class T>
+  unsigned long ResourceManager<T>::budget = 0;
+  template<class T>
+  typename ResourceManager<T>::SizeFunction ResourceManager<T>::sizeFunction = ResourceManager<T>::FileSize;
+  template<class T>
+  ResourceCacheStats ResourceManager<T>::stats;
 
 } // NS Resources
 } // NS OpenEngine
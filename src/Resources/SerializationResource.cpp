@@ -11,6 +11,8 @@
 #include <Resources/SerializationResource.h>
 #include <Resources/File.h>
 #include <Resources/StreamArchive.h>
+#include <Resources/ContainerArchive.h>
+#include <Utils/Convert.h>
 
 
 
@@ -22,6 +24,7 @@ using namespace Resources;
 
 SerializationPlugin::SerializationPlugin() {
     this->AddExtension("oes");
+    this->AddExtension("oec");
 }
 
 IModelResourcePtr SerializationPlugin::CreateResource(string file) {
@@ -37,6 +40,11 @@ SerializationResource::SerializationResource(string file)
 }
 
 void SerializationResource::Load() {
+    if (Utils::Convert::ToLower(File::Extension(file)) == "oec") {
+        ContainerArchiveReader r(MappedFile::Open(file));
+        node = r.ReadScene("scene");
+        return;
+    }
     ifstream* in = File::Open(file);
 
     StreamArchiveReader r(*in);
@@ -117,6 +117,33 @@ ISceneNode* StreamArchiveReader::ReadScene(string key) {
     return ReadNode();
 }
 
+void StreamArchiveReader::ReadRaw(string key, void* data, size_t len, Types::Type type) {
+    size_t s = Begin(key);
+    if (s != len) {
+        ostringstream os;
+        os << "Size mismatch in ReadRawArray [" << key << "] is "
+           << s << " should be " << len;
+        throw Core::Exception(os.str());
+    }
+    switch (type) {
+#define RAW_TYPE(t, type, name, ptype)                               \
+    case Types::t:                                                   \
+        for (size_t i = 0; i < len; i++) {                           \
+            ptype v;                                                 \
+            input >> v;                                              \
+            ((type*)data)[i] = (type)v;                              \
+        }                                                            \
+        break;
+#include <Resources/RawArrayTypes.def>
+#undef RAW_TYPE
+    default:
+        throw Core::Exception("Unsupported type in ReadRawArray [" + key + "]");
+    }
+    if (input.fail())
+        throw Core::Exception("Malformed values in ReadRawArray [" + key + "]");
+    End(key);
+}
+
 unsigned int StreamArchiveReader::ReadIndex() {
     return ReadInt(IDX_KEY);
 }
@@ -197,6 +224,27 @@ void StreamArchiveWriter::End(string key) {
 #include <Resources/SerializationTypes.def>
 #undef S_TYPE
 
+/**
+ * Write all the elements of a raw array on a single line.
+ */
+void StreamArchiveWriter::WriteRaw(string key, const void* data, size_t len, Types::Type type) {
+    ostringstream os;
+    switch (type) {
+#define RAW_TYPE(t, type, name, ptype)                               \
+    case Types::t:                                                   \
+        for (size_t i = 0; i < len; i++)                             \
+            os << (i ? " " : "") << (ptype)((const type*)data)[i];   \
+        break;
+#include <Resources/RawArrayTypes.def>
+#undef RAW_TYPE
+    default:
+        throw Core::Exception("Unsupported type in WriteRawArray [" + key + "]");
+    }
+    Begin(key, len);
+    _Write(os.str());
+    End(key);
+}
+
 void StreamArchiveWriter::WriteScene(string key, ISceneNode* node) {
     _Write(key);
     //output << key << " ";
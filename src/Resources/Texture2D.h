@@ -11,6 +11,7 @@
 #define _TEXTURE_2D_RESOURCE_H_
 
 #include <Resources/ITexture2D.h>
+#include <Resources/MappedFile.h>
 #include <Math/Exceptions.h>
 #include <Resources/Exceptions.h>
 #include <Math/Vector.h>
@@ -79,8 +80,37 @@ namespace OpenEngine {
                 this->data = d;
             }
 
+            /**
+             * Create a texture using a region of a mapped file as its
+             * pixels without copying them. The texture keeps the file
+             * mapped until it is unloaded. Textures on read only
+             * mappings must not be written.
+             *
+             * @param w Width in pixels.
+             * @param h Height in pixels.
+             * @param c Number of channels.
+             * @param file Mapped file.
+             * @param offset Byte offset of the pixels in the file.
+             * @throws ResourceException if the pixels are not within
+             *         the file or not aligned.
+             */
+            Texture2D(unsigned int w, unsigned int h, unsigned int c,
+                      MappedFilePtr file, size_t offset)
+                : ITexture2D(), mapping(file) {
+                if (!file->Contains(offset, (size_t)w * h * c * sizeof(T)))
+                    throw ResourceException("Texture outside of mapped file: " + file->GetPath());
+                if (offset % sizeof(T) != 0)
+                    throw ResourceException("Unaligned texture in mapped file: " + file->GetPath());
+                SetupType<T>();
+                this->width = w;
+                this->height = h;
+                this->channels = c;
+                this->format = ColorFormatFromChannels(c);
+                this->data = file->GetData() + offset;
+            }
+
             virtual ~Texture2D() {
-                if (this->data){
+                if (this->data && !mapping){
                     delete [] (T*) this->data;
                 }
             }
@@ -106,15 +136,29 @@ namespace OpenEngine {
             }
 
             /**
-             * Unloads the data array but leaves the property values.
+             * Unloads the data array, or releases the mapped file,
+             * but leaves the property values.
              */
             virtual void Unload(){
-                if (this->data) {
+                if (mapping) {
+                    mapping.reset();
+                    this->data = NULL;
+                }
+                else if (this->data) {
                     delete [] (T*) this->data;
                     this->data = NULL;
                 }
             }
 
+            /**
+             * Get the mapped file holding the pixels.
+             *
+             * @return The mapped file, empty if the pixels are not mapped.
+             */
+            inline MappedFilePtr GetMapping() const {
+                return mapping;
+            }
+
             /**
              * Get the size of each channel on the loaded texture.
              *
@@ -260,6 +304,41 @@ namespace OpenEngine {
                 }
             }
 
+            /**
+             * @throws ResourceException if the texture is unloaded.
+             */
+            void Serialize(IArchiveWriter& w) {
+                if (this->data == NULL && this->width * this->height * this->channels != 0)
+                    throw ResourceException("Can not serialize unloaded texture");
+                w.WriteInt("width", this->width);
+                w.WriteInt("height", this->height);
+                w.WriteInt("channels", this->channels);
+                w.WriteInt("format", this->format);
+                w.WriteInt("wrap", this->wrap);
+                w.WriteInt("filtering", this->filtering);
+                w.WriteInt("mipmapping", this->mipmapping);
+                w.WriteInt("compression", this->compression);
+                w.WriteRawArray("data", (const T*)this->data,
+                                this->width * this->height * this->channels);
+            }
+
+            void Deserialize(IArchiveReader& r) {
+                Unload();
+                this->width = r.ReadInt("width");
+                this->height = r.ReadInt("height");
+                this->channels = r.ReadInt("channels");
+                this->format = ColorFormat(r.ReadInt("format"));
+                this->wrap = Wrapping(r.ReadInt("wrap"));
+                this->filtering = Filtering(r.ReadInt("filtering"));
+                this->mipmapping = r.ReadInt("mipmapping") != 0;
+                this->compression = r.ReadInt("compression") != 0;
+                this->data = new T[this->width * this->height * this->channels];
+                r.ReadRawArray("data", (T*)this->data,
+                               this->width * this->height * this->channels);
+            }
+
+        private:
+            MappedFilePtr mapping;
         };
 
         /**
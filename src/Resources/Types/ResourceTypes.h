@@ -55,6 +55,24 @@ namespace OpenEngine {
                     return NOTYPE;
             }
 
+            /**
+             * Yields the size in bytes of a value of a type, 0 for
+             * NOTYPE.
+             */
+            inline unsigned int GetSize(Type t){
+                switch(t){
+                case UBYTE:
+                case SBYTE:  return 1;
+                case USHORT:
+                case SHORT:  return 2;
+                case UINT:
+                case INT:
+                case FLOAT:  return 4;
+                case DOUBLE: return 8;
+                default:     return 0;
+                }
+            }
+
             /*
             std::string ToString(Type t) {
                 switch(t){
@@ -0,0 +1,80 @@
+// Resource testing utilities
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#ifndef _OE_RESOURCE_TESTING_H_
+#define _OE_RESOURCE_TESTING_H_
+
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+// Helpers shared by the resource tests
+
+/**
+ * Temporary directory for the files written by a test. The directory
+ * and the files named through it are removed when it goes out of
+ * scope.
+ */
+class TempDir {
+    std::string path;
+    std::vector<std::string> files;
+
+    TempDir(const TempDir&);
+    TempDir& operator=(const TempDir&);
+
+public:
+    TempDir() {
+#if defined(_WIN32)
+        char dir[MAX_PATH], name[MAX_PATH];
+        if (GetTempPathA(MAX_PATH, dir) == 0 ||
+            GetTempFileNameA(dir, "oe", 0, name) == 0 ||
+            !DeleteFileA(name) || !CreateDirectoryA(name, NULL))
+            throw std::runtime_error("Could not create a temporary directory");
+        path = name;
+#else
+        const char* tmp = getenv("TMPDIR");
+        std::string name = std::string(tmp ? tmp : "/tmp") + "/oe_test_XXXXXX";
+        std::vector<char> buffer(name.begin(), name.end());
+        buffer.push_back('\0');
+        if (mkdtemp(&buffer[0]) == NULL)
+            throw std::runtime_error("Could not create a temporary directory");
+        path = &buffer[0];
+#endif
+    }
+
+    ~TempDir() {
+        for (unsigned int i = 0; i < files.size(); i++)
+            remove(files[i].c_str());
+#if defined(_WIN32)
+        RemoveDirectoryA(path.c_str());
+#else
+        rmdir(path.c_str());
+#endif
+    }
+
+    //! Path of the directory.
+    const std::string& GetPath() const { return path; }
+
+    //! Path of a file in the directory, removed with the directory.
+    std::string File(const std::string& name) {
+        std::string file = path + "/" + name;
+        files.push_back(file);
+        return file;
+    }
+};
+
+#endif // _OE_RESOURCE_TESTING_H_
@@ -0,0 +1,78 @@
+#include <Testing/Testing.h>
+
+#include <Core/CoalescingQueuedEvent.h>
+#include <Resources/Texture2D.h>
+#include <Resources/Texture3D.h>
+#include <Resources/DataBlock.h>
+
+#include <vector>
+
+using namespace OpenEngine::Resources;
+using OpenEngine::Core::IListener;
+using OpenEngine::Core::CoalescingQueuedEvent;
+
+template <class T>
+class Collector : public IListener<T> {
+public:
+    std::vector<T> args;
+    void Handle(T arg) { args.push_back(arg); }
+};
+
+int test_main(int argc, char* argv[]) {
+
+    // 2D texture changes merge to the bounding rectangle
+    {
+        UCharTexture2DPtr a(new UCharTexture2D(64, 64, 4));
+        UCharTexture2DPtr b(new UCharTexture2D(8, 8, 4));
+        CoalescingQueuedEvent<Texture2DChangedEventArg> q;
+        Collector<Texture2DChangedEventArg> c;
+        q.Attach(c);
+        VoidPtr rect(new int(0));
+        q.Notify(Texture2DChangedEventArg(a, 10, 20, 5, 5, rect));
+        q.Notify(Texture2DChangedEventArg(b));
+        q.Notify(Texture2DChangedEventArg(a, 2, 30, 4, 10));
+        q.Release();
+        OE_CHECK(c.args.size() == 2);
+        Texture2DChangedEventArg& m = c.args[0];
+        OE_CHECK(m.resource == a);
+        OE_CHECK(m.xOffset == 2 && m.yOffset == 20);
+        OE_CHECK(m.width == 13 && m.height == 20);
+        OE_CHECK(!m.dataRect);
+        OE_CHECK(c.args[1].resource == b && c.args[1].width == 8);
+    }
+
+    // 3D texture changes merge to the bounding box
+    {
+        UCharTexture3DPtr a(new UCharTexture3D(16, 16, 16, 1));
+        CoalescingQueuedEvent<Texture3DChangedEventArg> q;
+        Collector<Texture3DChangedEventArg> c;
+        q.Attach(c);
+        q.Notify(Texture3DChangedEventArg(a, 1, 2, 3, 2, 2, 2));
+        q.Notify(Texture3DChangedEventArg(a, 4, 0, 8, 1, 1, 1));
+        q.Release();
+        OE_CHECK(c.args.size() == 1);
+        Texture3DChangedEventArg& m = c.args[0];
+        OE_CHECK(m.xOffset == 1 && m.yOffset == 0 && m.zOffset == 3);
+        OE_CHECK(m.width == 4 && m.height == 4 && m.depth == 6);
+    }
+
+    // data block changes merge to the covering range
+    {
+        Float3DataBlockPtr a(new DataBlock<3, float>(100));
+        Float3DataBlockPtr b(new DataBlock<3, float>(10));
+        CoalescingQueuedEvent<IDataBlockChangedEventArg> q;
+        Collector<IDataBlockChangedEventArg> c;
+        q.Attach(c);
+        q.Notify(IDataBlockChangedEventArg(a, 50, 60));
+        q.Notify(IDataBlockChangedEventArg(b, 0, 1));
+        q.Notify(IDataBlockChangedEventArg(a, 10, 20));
+        q.Notify(IDataBlockChangedEventArg(b, 5, 6));
+        OE_CHECK(q.GetMergedCount() == 2);
+        q.Release();
+        OE_CHECK(c.args.size() == 2);
+        OE_CHECK(c.args[0].resource == a);
+        OE_CHECK(c.args[0].start == 10 && c.args[0].end == 60);
+        OE_CHECK(c.args[1].start == 0 && c.args[1].end == 6);
+    }
+    return 0;
+}
@@ -0,0 +1,200 @@
+#include <Testing/Testing.h>
+
+#include <Resources/ContainerArchive.h>
+#include <Resources/DataBlock.h>
+#include <Resources/Texture2D.h>
+#include <Scene/SceneNode.h>
+#include <Scene/TransformationNode.h>
+#include <Scene/RenderStateNode.h>
+#include <Scene/InstanceNode.h>
+
+#include <cstring>
+#include <fstream>
+#include <typeinfo>
+
+#include "ResourceTesting.h"
+
+using namespace std;
+using namespace OpenEngine::Resources;
+using namespace OpenEngine::Scene;
+using OpenEngine::Math::Vector;
+using OpenEngine::Math::Matrix;
+
+typedef Vector<3, float> Vec3;
+typedef DataBlock<3, float> Float3Block;
+
+static void Write(const string& filename) {
+    SceneNode* scene = new SceneNode();
+    TransformationNode* tn = new TransformationNode();
+    tn->SetPosition(Vec3(1, 2, 3));
+    scene->AddNode(new SceneNode());
+    scene->AddNode(tn);
+    RenderStateNode* rsn = new RenderStateNode();
+    rsn->EnableOption(RenderStateNode::LIGHTING);
+
+    Float3DataBlockPtr vertices(new Float3Block(1000));
+    for (unsigned int i = 0; i < 1000; i++)
+        vertices->SetElement(i, Vec3(i, i + 1, i + 2));
+    IndicesPtr indices(new Indices(3));
+    indices->GetData()[2] = 7;
+    UCharTexture2DPtr tex(new UCharTexture2D(8, 4, 4));
+    tex->GetData()[5] = 42;
+    tex->SetWrapping(REPEAT);
+
+    ofstream out(filename.c_str(), ios::binary);
+    ContainerArchiveWriter w(out);
+    w.WriteInt("int", -42);
+    w.WriteString("name", "grass");
+    w.WriteDouble("double", 0.25);
+    w.WriteString("again", "grass");
+    w.WriteMatrix<2,2,float>("matrix", Matrix<2,2,float>(1, 2, 3, 4));
+    w.WriteScene("scene", scene);
+    w.WriteScene("state", rsn);
+    w.WriteScene("none", NULL);
+    w.WriteDataBlock("vertices", vertices);
+    w.WriteDataBlock("indices", indices);
+    w.WriteDataBlock("vertices", vertices);
+    w.WriteTexture("grass", tex);
+    w.WriteFloat("float", 1.5f);
+    w.Close();
+    delete scene;
+    delete rsn;
+}
+
+int test_main(int argc, char* argv[]) {
+    TempDir dir;
+    const string test = dir.File("test.oec");
+    Write(test);
+
+    {
+        MappedFilePtr file = MappedFile::Open(test);
+        ContainerArchiveReader r(file);
+        // stream, 2 scenes, 2 blocks, a texture and the strings
+        OE_CHECK(r.GetNumberOfChunks() == 7);
+        for (unsigned int i = 0; i < r.GetNumberOfChunks(); i++)
+            OE_CHECK(r.GetChunk(i).offset % 16 == 0);
+
+        OE_CHECK(r.ReadInt("int") == -42);
+        OE_CHECK(r.ReadString("name") == "grass");
+        OE_CHECK(r.ReadDouble("double") == 0.25);
+        OE_CHECK(r.ReadString("again") == "grass");
+        OE_CHECK((r.ReadMatrix<2,2,float>("matrix") == Matrix<2,2,float>(1, 2, 3, 4)));
+
+        ISceneNode* scene = r.ReadScene("scene");
+        OE_CHECK(scene->GetNumberOfNodes() == 2);
+        TransformationNode* tn = dynamic_cast<TransformationNode*>(scene->GetNode(1));
+        OE_CHECK(tn != NULL && tn->GetPosition() == Vec3(1, 2, 3));
+        RenderStateNode* rsn = dynamic_cast<RenderStateNode*>(r.ReadScene("state"));
+        OE_CHECK(rsn != NULL && rsn->IsOptionEnabled(RenderStateNode::LIGHTING));
+        OE_CHECK(r.ReadScene("none") == NULL);
+
+        // payloads are used in place from the mapping
+        IDataBlockPtr vertices = r.ReadDataBlock("vertices");
+        IDataBlockPtr indices = r.ReadDataBlock("indices");
+        OE_CHECK(r.ReadDataBlock("vertices") == vertices);
+        OE_CHECK(typeid(*vertices) == typeid(Float3Block));
+        Float3Block* v = dynamic_cast<Float3Block*>(vertices.get());
+        OE_CHECK(v->GetSize() == 1000 && v->GetElement(500) == Vec3(500, 501, 502));
+        OE_CHECK(v->GetMapping() == file);
+        OE_CHECK((char*)v->GetVoidData() >= file->GetData());
+        OE_CHECK((unsigned long)v->GetVoidData() % 16 == 0);
+        OE_CHECK(indices->GetBlockType() == INDEX_ARRAY);
+        OE_CHECK(((unsigned int*)indices->GetVoidData())[2] == 7);
+
+        ITexture2DPtr tex = r.ReadTexture("grass");
+        OE_CHECK(tex->GetWidth() == 8 && tex->GetHeight() == 4);
+        OE_CHECK(tex->GetChannels() == 4 && tex->GetType() == Types::UBYTE);
+        OE_CHECK(tex->GetWrapping() == REPEAT);
+        OE_CHECK(((unsigned char*)tex->GetVoidDataPtr())[5] == 42);
+        OE_CHECK(r.ReadFloat("float") == 1.5f);
+
+        bool threw = false;
+        try { r.ReadInt("past the end"); }
+        catch (ResourceException&) { threw = true; }
+        OE_CHECK(threw);
+        delete scene;
+        delete rsn;
+    }
+
+    // chunks can be loaded on their own
+    {
+        ContainerArchiveReader r(MappedFile::Open(test));
+        int chunk = r.FindChunk("state", CHUNK_SCENE);
+        OE_CHECK(chunk > 0 && r.GetChunk(chunk).name == "state");
+        ISceneNode* rsn = r.LoadScene(chunk);
+        OE_CHECK(dynamic_cast<RenderStateNode*>(rsn) != NULL);
+        delete rsn;
+        OE_CHECK(r.FindChunk("state", CHUNK_TEXTURE) == -1);
+        ITexture2DPtr tex = r.LoadTexture(r.FindChunk("grass", CHUNK_TEXTURE));
+        OE_CHECK(tex->GetWidth() == 8);
+        bool threw = false;
+        try { r.LoadScene(r.FindChunk("grass", CHUNK_TEXTURE)); }
+        catch (ResourceException&) { threw = true; }
+        OE_CHECK(threw);
+    }
+
+    // corrupt payloads fail the checksum when they are used
+    {
+        MappedFilePtr file = MappedFile::Open(test, MappedFile::COPY_ON_WRITE);
+        size_t offset;
+        {
+            ContainerArchiveReader r(file);
+            offset = r.GetChunk(r.FindChunk("vertices", CHUNK_DATA_BLOCK)).offset;
+        }
+        file->GetData()[offset + 100]++;
+        ContainerArchiveReader r(file);
+        bool threw = false;
+        try { r.LoadDataBlock(r.FindChunk("vertices", CHUNK_DATA_BLOCK)); }
+        catch (ResourceException&) { threw = true; }
+        OE_CHECK(threw);
+        OE_CHECK(r.LoadDataBlock(r.FindChunk("indices", CHUNK_DATA_BLOCK)));
+        ContainerArchiveReader unverified(file, false);
+        OE_CHECK(unverified.LoadDataBlock(unverified.FindChunk("vertices", CHUNK_DATA_BLOCK)));
+
+        file->GetData()[0] = 'X';
+        threw = false;
+        try { ContainerArchiveReader bad(file); }
+        catch (ResourceException&) { threw = true; }
+        OE_CHECK(threw);
+    }
+
+    // data blocks the reader can not rebuild are not written
+    {
+        ofstream out(dir.File("unsupported.oec").c_str(), ios::binary);
+        ContainerArchiveWriter w(out);
+        IDataBlockPtr ints(new Float3Block(4));
+        ints->SetType(Types::INT);
+        bool threw = false;
+        try { w.WriteDataBlock("ints", ints); }
+        catch (ResourceException&) { threw = true; }
+        OE_CHECK(threw);
+    }
+
+    // a scene referring to itself is rejected
+    {
+        const string cycle = dir.File("cycle.oec");
+        {
+            ofstream out(cycle.c_str(), ios::binary);
+            ContainerArchiveWriter w(out);
+            InstanceNode* instance = new InstanceNode(ScenePrototype(new SceneNode()));
+            w.WriteScene("instance", instance);
+            delete instance;
+        }
+        MappedFilePtr file = MappedFile::Open(cycle, MappedFile::COPY_ON_WRITE);
+        unsigned int chunk;
+        size_t end;
+        {
+            ContainerArchiveReader r(file);
+            chunk = r.FindChunk("instance", CHUNK_SCENE);
+            end = r.GetChunk(chunk).offset + r.GetChunk(chunk).size;
+        }
+        // the prototype reference is the last field of the instance
+        memcpy(file->GetData() + end - 4, &chunk, 4);
+        ContainerArchiveReader r(file, false);
+        bool threw = false;
+        try { delete r.LoadScene(chunk); }
+        catch (ResourceException&) { threw = true; }
+        OE_CHECK(threw);
+    }
+    return 0;
+}
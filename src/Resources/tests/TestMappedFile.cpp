@@ -0,0 +1,83 @@
+#include <Testing/Testing.h>
+
+#include <Resources/MappedFile.h>
+#include <Resources/DataBlock.h>
+#include <Resources/Texture2D.h>
+
+#include <fstream>
+
+#include "ResourceTesting.h"
+
+using namespace std;
+using namespace OpenEngine::Resources;
+using OpenEngine::Math::Vector;
+
+typedef Vector<3, float> Vec3;
+
+int test_main(int argc, char* argv[]) {
+    TempDir dir;
+    const string path = dir.File("mapped.bin");
+    // a header followed by 100 vertices and a 4x4 rgb texture
+    {
+        ofstream out(path.c_str(), ios::binary);
+        unsigned int header[4] = {0xBEEF, 100, 4, 4};
+        out.write((char*)header, sizeof(header));
+        for (int i = 0; i < 300; i++) {
+            float f = i;
+            out.write((char*)&f, sizeof(float));
+        }
+        for (int i = 0; i < 48; i++) out.put((char)i);
+    }
+    unsigned long vertices = 16;
+    unsigned long pixels = vertices + 300 * sizeof(float);
+
+    MappedFilePtr file = MappedFile::Open(path);
+    OE_CHECK(file->GetSize() == pixels + 48);
+    OE_CHECK(file->Contains(pixels, 48) && !file->Contains(pixels, 49));
+
+    // blocks use the mapping in place and keep it alive
+    DataBlock<3, float>* block = new DataBlock<3, float>(100, file, vertices);
+    UCharTexture2D* tex = new UCharTexture2D(4, 4, 3, file, pixels);
+    OE_CHECK(block->GetVoidData() == file->GetData() + vertices);
+    OE_CHECK(block->GetMapping() == file);
+    file.reset();
+    OE_CHECK(block->GetElement(10) == Vec3(30, 31, 32));
+    OE_CHECK(tex->GetPixel(1, 1)[2] == 17);
+    OE_CHECK(tex->GetColorFormat() == RGB && tex->GetChannels() == 3);
+
+    // clones are copies on the heap
+    IDataBlockPtr clone = block->Clone();
+    *clone += Vec3(1, 1, 1);
+    Vec3 v;
+    clone->GetElement(10, v);
+    OE_CHECK(v == Vec3(31, 32, 33));
+    OE_CHECK(block->GetElement(10) == Vec3(30, 31, 32));
+
+    block->Unload();
+    OE_CHECK(block->GetVoidData() == NULL && !block->GetMapping());
+    delete block;
+    delete tex;
+
+    // copy on write mappings can be changed without changing the file
+    MappedFilePtr cow = MappedFile::Open(path, MappedFile::COPY_ON_WRITE);
+    DataBlock<3, float> writable(100, cow, vertices);
+    writable.SetElement(10, Vec3(0, 0, 0));
+    OE_CHECK(writable.GetElement(10) == Vec3(0, 0, 0));
+    DataBlock<3, float> readable(100, MappedFile::Open(path), vertices);
+    OE_CHECK(readable.GetElement(10) == Vec3(30, 31, 32));
+
+    // regions outside the file or unaligned are rejected
+    bool threw = false;
+    try { DataBlock<3, float> b(105, cow, vertices); }
+    catch (ResourceException&) { threw = true; }
+    OE_CHECK(threw);
+    threw = false;
+    try { DataBlock<3, float> b(10, cow, 2); }
+    catch (ResourceException&) { threw = true; }
+    OE_CHECK(threw);
+    threw = false;
+    try { MappedFile::Open(dir.GetPath() + "/missing.bin"); }
+    catch (ResourceException&) { threw = true; }
+    OE_CHECK(threw);
+    return 0;
+}
@@ -0,0 +1,190 @@
+#include <Testing/Testing.h>
+
+#include <Resources/StreamArchive.h>
+#include <Resources/BinaryStreamArchive.h>
+#include <Resources/ContainerArchive.h>
+#include <Resources/DataBlock.h>
+#include <Resources/Texture2D.h>
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "ResourceTesting.h"
+
+using namespace std;
+using namespace OpenEngine::Resources;
+using OpenEngine::Math::Vector;
+
+typedef Vector<3, float> Vec3;
+typedef DataBlock<3, float> Float3Block;
+
+static void Write(IArchiveWriter& w) {
+    Float3Block block(100, NULL, INDEX_ARRAY, DYNAMIC);
+    for (unsigned int i = 0; i < 100; i++)
+        block.SetElement(i, Vec3(i, -0.5f * i, i + 0.25f));
+    block.Serialize(w);
+
+    UCharTexture2D tex(4, 2, 3);
+    for (unsigned int i = 0; i < 4 * 2 * 3; i++)
+        tex.GetData()[i] = i * 10;
+    tex.SetWrapping(REPEAT);
+    tex.Serialize(w);
+
+    short shorts[3] = {-1, 300, -32000};
+    double doubles[2] = {0.125, -1e10};
+    w.WriteRawArray("shorts", shorts, 3);
+    w.WriteRawArray("doubles", doubles, 2);
+    w.WriteRawArray("empty", doubles, 0);
+    w.WriteInt("end", 42);
+}
+
+static void Read(IArchiveReader& r) {
+    Float3Block block;
+    block.Deserialize(r);
+    OE_CHECK(block.GetSize() == 100);
+    OE_CHECK(block.GetBlockType() == INDEX_ARRAY);
+    OE_CHECK(block.GetUpdateMode() == DYNAMIC);
+    bool equal = true;
+    for (unsigned int i = 0; i < 100; i++)
+        equal &= block.GetElement(i) == Vec3(i, -0.5f * i, i + 0.25f);
+    OE_CHECK(equal);
+
+    UCharTexture2D tex;
+    tex.Deserialize(r);
+    OE_CHECK(tex.GetWidth() == 4 && tex.GetHeight() == 2);
+    OE_CHECK(tex.GetChannels() == 3);
+    OE_CHECK(tex.GetWrapping() == REPEAT);
+    equal = true;
+    for (unsigned int i = 0; i < 4 * 2 * 3; i++)
+        equal &= tex.GetData()[i] == i * 10;
+    OE_CHECK(equal);
+
+    short shorts[3];
+    double doubles[2];
+    r.ReadRawArray("shorts", shorts, 3);
+    OE_CHECK(shorts[0] == -1 && shorts[1] == 300 && shorts[2] == -32000);
+    r.ReadRawArray("doubles", doubles, 2);
+    OE_CHECK(doubles[0] == 0.125 && doubles[1] == -1e10);
+    r.ReadRawArray("empty", doubles, 0);
+    OE_CHECK(r.ReadInt("end") == 42);
+}
+
+// read an array of three shorts with the wrong length or type
+static bool ThrowsOnMismatch(IArchiveReader& r, bool length) {
+    try {
+        if (length) {
+            short shorts[2];
+            r.ReadRawArray("shorts", shorts, 2);
+        }
+        else {
+            unsigned short shorts[3];
+            r.ReadRawArray("shorts", shorts, 3);
+        }
+    } catch (OpenEngine::Core::Exception&) {
+        return true;
+    }
+    return false;
+}
+
+int test_main(int argc, char* argv[]) {
+    short shorts[3] = {1, 2, 3};
+
+    // text archive
+    {
+        stringstream ss;
+        StreamArchiveWriter w(ss);
+        Write(w);
+        StreamArchiveReader r(ss);
+        Read(r);
+
+        stringstream bad;
+        StreamArchiveWriter bw(bad);
+        bw.WriteRawArray("shorts", shorts, 3);
+        StreamArchiveReader br(bad);
+        OE_CHECK(ThrowsOnMismatch(br, true));
+    }
+
+    // binary archive
+    {
+        stringstream ss;
+        BinaryStreamArchiveWriter w(ss);
+        Write(w);
+        BinaryStreamArchiveReader r(ss);
+        Read(r);
+
+        for (int i = 0; i < 2; i++) {
+            stringstream bad;
+            BinaryStreamArchiveWriter bw(bad);
+            bw.WriteRawArray("shorts", shorts, 3);
+            BinaryStreamArchiveReader br(bad);
+            OE_CHECK(ThrowsOnMismatch(br, i == 0));
+        }
+
+        // an array written with the opposite byte order
+        stringstream out;
+        BinaryStreamArchiveWriter bw(out);
+        bw.WriteRawArray("shorts", shorts, 3);
+        string data = out.str();
+        unsigned int pos = 0;
+        const unsigned int sizes[] = {sizeof(size_t), 4, 4, 2, 2, 2};
+        for (unsigned int i = 0; i < 6; pos += sizes[i++])
+            reverse(data.begin() + pos, data.begin() + pos + sizes[i]);
+        stringstream in(data);
+        BinaryStreamArchiveReader br(in);
+        short swapped[3];
+        br.ReadRawArray("shorts", swapped, 3);
+        OE_CHECK(swapped[0] == 1 && swapped[1] == 2 && swapped[2] == 3);
+
+        // a truncated array
+        stringstream truncated(out.str().substr(0, out.str().size() - 1));
+        BinaryStreamArchiveReader tr(truncated);
+        bool threw = false;
+        try { tr.ReadRawArray("shorts", swapped, 3); }
+        catch (OpenEngine::Core::Exception&) { threw = true; }
+        OE_CHECK(threw);
+    }
+
+    // unloaded data blocks and textures can not be serialized
+    {
+        stringstream ss;
+        BinaryStreamArchiveWriter w(ss);
+        Float3Block block(10);
+        block.Unload();
+        bool threw = false;
+        try { block.Serialize(w); }
+        catch (ResourceException&) { threw = true; }
+        OE_CHECK(threw);
+
+        UCharTexture2D tex(4, 2, 3);
+        tex.Unload();
+        threw = false;
+        try { tex.Serialize(w); }
+        catch (ResourceException&) { threw = true; }
+        OE_CHECK(threw);
+    }
+
+    // container archive
+    TempDir dir;
+    const string path = dir.File("rawarray.oec");
+    {
+        {
+            ofstream out(path.c_str(), ios::binary);
+            ContainerArchiveWriter w(out);
+            Write(w);
+            w.WriteRawArray("shorts", shorts, 3);
+            w.WriteRawArray("shorts", shorts, 3);
+        }
+        ContainerArchiveReader r(MappedFile::Open(path));
+        Read(r);
+        OE_CHECK(ThrowsOnMismatch(r, true));
+    }
+    {
+        ContainerArchiveReader r(MappedFile::Open(path));
+        Read(r);
+        r.ReadRawArray("shorts", shorts, 3);
+        OE_CHECK(ThrowsOnMismatch(r, false));
+    }
+    return 0;
+}
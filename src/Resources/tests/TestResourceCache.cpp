@@ -0,0 +1,110 @@
+#include <Testing/Testing.h>
+
+#include <Resources/ResourceManager.h>
+#include <Resources/IResource.h>
+
+#include "ResourceTesting.h"
+
+#include <fstream>
+#include <string>
+
+using namespace std;
+using namespace OpenEngine::Resources;
+
+struct FakeEventArg {};
+
+class FakeResource : public IResource<FakeEventArg> {
+public:
+    string file;
+    FakeResource(string file) : file(file) {}
+    void Load() {}
+    void Unload() {}
+};
+
+typedef boost::shared_ptr<FakeResource> FakeResourcePtr;
+typedef ResourceManager<FakeResource> Manager;
+
+class FakePlugin : public IResourcePlugin<FakeResource> {
+public:
+    FakePlugin() { AddExtension("cache"); }
+    FakeResourcePtr CreateResource(string file) {
+        return FakeResourcePtr(new FakeResource(file));
+    }
+};
+
+static unsigned long Size(FakeResourcePtr resource, const string& file) {
+    return 100;
+}
+
+int test_main(int argc, char* argv[]) {
+    TempDir dir;
+    const string aFile = dir.File("a.cache");
+    const string bFile = dir.File("b.cache");
+    const string cFile = dir.File("c.cache");
+    ofstream(aFile.c_str()) << "aaaa";
+    ofstream(bFile.c_str()) << "bb";
+    ofstream(cFile.c_str()) << "c";
+    FakePlugin plugin;
+    Manager::AddPlugin(&plugin);
+
+    // without a budget every request creates a new resource
+    FakeResourcePtr a = Manager::Create(aFile);
+    OE_CHECK(Manager::Create(aFile) != a);
+    ResourceCacheStats stats = Manager::GetStats();
+    OE_CHECK(stats.entries == 0 && stats.misses == 0);
+
+    // with a budget requests for the same file share the resource
+    Manager::SetBudget(1000);
+    a = Manager::Create(aFile);
+    OE_CHECK(Manager::Create(dir.GetPath() + "/./a.cache") == a);
+    Manager::Create(bFile);
+    stats = Manager::GetStats();
+    OE_CHECK(stats.hits == 1 && stats.misses == 2);
+    // the default size is the file size
+    OE_CHECK(stats.entries == 2 && stats.bytes == 6);
+    // the unused resource is evicted
+    Manager::Purge();
+    stats = Manager::GetStats();
+    OE_CHECK(stats.entries == 1 && stats.bytes == 4 && stats.evictions == 1);
+
+    // unused resources are kept within the budget, least recently used
+    // are evicted first
+    Manager::SetSizeFunction(Size);
+    Manager::Clear();
+    Manager::ResetStats();
+    Manager::SetBudget(250);
+    OE_CHECK(Manager::Create(aFile) != a);
+    Manager::Create(bFile);
+    Manager::Create(aFile);
+    OE_CHECK(Manager::GetStats().entries == 2);
+    FakeResourcePtr c = Manager::Create(cFile);
+    stats = Manager::GetStats();
+    OE_CHECK(stats.entries == 2 && stats.bytes == 200 && stats.evictions == 1);
+    OE_CHECK(Manager::GetStats().hits == 1);
+    Manager::Create(aFile);
+    OE_CHECK(Manager::GetStats().hits == 2);
+    Manager::Create(bFile);
+    OE_CHECK(Manager::GetStats().misses == 4);
+
+    // resources in use are never evicted
+    Manager::SetBudget(1);
+    stats = Manager::GetStats();
+    OE_CHECK(stats.entries == 1 && stats.bytes == 100);
+    OE_CHECK(Manager::Create(cFile) == c);
+    c.reset();
+    Manager::Purge();
+    OE_CHECK(Manager::GetStats().entries == 0);
+    OE_CHECK(Manager::GetStats().bytes == 0);
+
+    // a zero budget disables the cache again
+    c = Manager::Create(cFile);
+    Manager::SetBudget(0);
+    OE_CHECK(Manager::GetStats().entries == 0);
+    OE_CHECK(Manager::Create(cFile) != c);
+
+    bool threw = false;
+    try { Manager::Create(dir.GetPath() + "/missing.cache"); }
+    catch (ResourceException&) { threw = true; }
+    OE_CHECK(threw);
+    return 0;
+}
@@ -0,0 +1,163 @@
+#include <Testing/Testing.h>
+
+#include <Resources/ResourceLoader.h>
+#include <Resources/ResourceFuture.h>
+#include <Resources/ResourceManager.h>
+#include <Resources/IResource.h>
+#include <Core/Mutex.h>
+#include <Core/Thread.h>
+
+#include "ResourceTesting.h"
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace OpenEngine::Resources;
+using OpenEngine::Core::Mutex;
+using OpenEngine::Core::Thread;
+using OpenEngine::Core::IListener;
+
+struct FakeEventArg {};
+
+static Mutex mutex;
+static vector<string> loaded;
+
+class FakeResource : public IResource<FakeEventArg> {
+public:
+    string file;
+    bool isLoaded;
+    FakeResource(string file) : file(file), isLoaded(false) {}
+    void Load() {
+        if (file.find("bad") != string::npos)
+            throw ResourceException("bad file");
+        if (file.find("slow") != string::npos)
+            Thread::Sleep(100);
+        mutex.Lock();
+        loaded.push_back(file);
+        mutex.Unlock();
+        isLoaded = true;
+    }
+    void Unload() { isLoaded = false; }
+};
+
+typedef boost::shared_ptr<FakeResource> FakeResourcePtr;
+
+class FakePlugin : public IResourcePlugin<FakeResource> {
+public:
+    FakePlugin() { AddExtension("fake"); }
+    FakeResourcePtr CreateResource(string file) {
+        return FakeResourcePtr(new FakeResource(file));
+    }
+};
+
+template <class T>
+class Counter : public IListener<T> {
+public:
+    int count;
+    Counter() : count(0) {}
+    void Handle(T arg) { count++; }
+};
+
+typedef ResourceFuture<FakeResource> Future;
+
+int test_main(int argc, char* argv[]) {
+    FakePlugin plugin;
+
+    // an idle loader loads in priority order on the waiting thread
+    {
+        ResourceLoader loader(0);
+        Future::Ptr a(new Future(&plugin, "a", 0));
+        Future::Ptr b(new Future(&plugin, "b", 5));
+        Future::Ptr c(new Future(&plugin, "c", 0));
+        Future::Ptr d(new Future(&plugin, "bad", 0));
+        loader.Submit(a);
+        loader.Submit(b);
+        loader.Submit(c);
+        loader.Submit(d);
+        OE_CHECK(loader.GetQueued() == 4);
+        c->SetPriority(10);
+        OE_CHECK(a->Cancel());
+        OE_CHECK(loader.GetQueued() == 3);
+
+        loaded.clear();
+        c->Wait();
+        OE_CHECK(c->IsDone() && !c->IsDelivered());
+        OE_CHECK(c->Get() && c->Get()->isLoaded);
+        OE_CHECK(b->GetState() == ResourceLoad::QUEUED);
+        OE_CHECK(b->WaitFor()->file == "b");
+        d->Wait();
+        OE_CHECK(d->GetState() == ResourceLoad::FAILED);
+        OE_CHECK(d->GetError() == "bad file");
+        OE_CHECK(!d->Get());
+        bool threw = false;
+        try { d->WaitFor(); } catch (ResourceException&) { threw = true; }
+        OE_CHECK(threw);
+        OE_CHECK(loaded.size() == 2 && loaded[0] == "c" && loaded[1] == "b");
+        OE_CHECK(!a->Cancel());
+        OE_CHECK(a->GetState() == ResourceLoad::CANCELLED);
+
+        // results are delivered when the loader is dispatched
+        Counter<ResourceLoadEventArg> loads;
+        Counter<ResourceFutureEventArg<FakeResource> > cLoaded;
+        loader.LoadEvent().Attach(loads);
+        c->LoadedEvent().Attach(cLoaded);
+        OE_CHECK(loader.GetPending() == 4);
+        loader.Dispatch();
+        OE_CHECK(loads.count == 4 && cLoaded.count == 1);
+        OE_CHECK(c->IsDelivered() && a->IsDelivered());
+        OE_CHECK(loader.GetPending() == 0);
+        loader.Dispatch();
+        OE_CHECK(loads.count == 4);
+
+        threw = false;
+        try { loader.Submit(a); } catch (ResourceException&) { threw = true; }
+        OE_CHECK(threw);
+    }
+
+    // loader threads
+    {
+        ResourceLoader loader(3);
+        loader.Start();
+        OE_CHECK(loader.IsRunning());
+        vector<Future::Ptr> futures;
+        for (int i = 0; i < 20; i++) {
+            futures.push_back(Future::Ptr(new Future(&plugin, i % 5 ? "slow" : "x", i % 3)));
+            loader.Submit(futures.back());
+        }
+        for (unsigned int i = 0; i < futures.size(); i++)
+            OE_CHECK(futures[i]->WaitFor()->isLoaded);
+        loader.Dispatch();
+        OE_CHECK(loader.GetPending() == 0);
+
+        // a load cancelled while loading is delivered as cancelled
+        Future::Ptr slow(new Future(&plugin, "slow", 0));
+        loader.Submit(slow);
+        while (slow->GetState() == ResourceLoad::QUEUED) Thread::Sleep(1);
+        OE_CHECK(slow->Cancel());
+        slow->Wait();
+        OE_CHECK(slow->GetState() == ResourceLoad::CANCELLED);
+        loader.Dispatch();
+        OE_CHECK(slow->IsDelivered() && !slow->Get());
+        loader.Stop();
+        OE_CHECK(!loader.IsRunning());
+    }
+
+    // the resource manager finds the file and picks the plug-in
+    {
+        TempDir dir;
+        const string file = dir.File("loader.fake");
+        ofstream(file.c_str()).put('x');
+        ResourceManager<FakeResource>::AddPlugin(&plugin);
+        ResourceLoader loader(1);
+        loader.Start();
+        Future::Ptr f = ResourceManager<FakeResource>::Load(file, loader);
+        OE_CHECK(f->WaitFor()->file == file);
+        bool threw = false;
+        try { ResourceManager<FakeResource>::Load(dir.GetPath() + "/loader.none", loader); }
+        catch (ResourceException&) { threw = true; }
+        OE_CHECK(threw);
+    }
+    return 0;
+}
@@ -8,6 +8,7 @@
 //--------------------------------------------------------------------
 
 #include <Scene/BlendingNode.h>
+#include <Scene/SceneJournal.h>
 
 namespace OpenEngine {
 namespace Scene {
@@ -24,6 +25,7 @@ BlendingNode::BlendingFactor BlendingNode::GetSource() {
 
 void BlendingNode::SetSource(BlendingFactor source) {
     this->source = source;
+    SceneJournal::StateChanged(this);
 }
 
 BlendingNode::BlendingFactor BlendingNode::GetDestination() {
@@ -32,6 +34,7 @@ BlendingNode::BlendingFactor BlendingNode::GetDestination() {
 
 void BlendingNode::SetDestination(BlendingFactor destination) {
     this->destination = destination;
+    SceneJournal::StateChanged(this);
 }
 
 BlendingNode::BlendingEquation BlendingNode::GetEquation() {
@@ -40,6 +43,7 @@ BlendingNode::BlendingEquation BlendingNode::GetEquation() {
 
 void BlendingNode::SetEquation(BlendingEquation equation) {
     this->equation = equation;
+    SceneJournal::StateChanged(this);
 }
 
 } // NS Scene
@@ -8,6 +8,7 @@
 //--------------------------------------------------------------------
 
 #include <Scene/GeometryNode.h>
+#include <Scene/SceneJournal.h>
 #include <Math/Vector.h>
 #include <Math/Quaternion.h>
 #include <Utils/Convert.h>
@@ -85,6 +86,19 @@ FaceSet* GeometryNode::GetFaceSet() {
 void GeometryNode::SetFaceSet(FaceSet* faces){
     delete this->faces;
     this->faces = faces;
+    InvalidateBounds();
+    SceneJournal::StateChanged(this);
+}
+
+/**
+ * Add the vertices of the faces to the bounds of the sub nodes.
+ */
+void GeometryNode::ComputeBounds(Bounds& bounds) {
+    ISceneNode::ComputeBounds(bounds);
+    if (faces == NULL) return;
+    for (FaceList::iterator itr = faces->begin(); itr != faces->end(); itr++)
+        for (int i = 0; i < 3; i++)
+            bounds.Add((*itr)->vert[i]);
 }
 
 const std::string GeometryNode::ToString() const {
@@ -106,6 +120,7 @@ void GeometryNode::Deserialize(Resources::IArchiveReader& r) {
     size_t len = r.ReadInt("length");
     while (len--)
         faces->Add(r.ReadObjectPtr<Face>("face"));
+    InvalidateBounds();
 }
 
 } //NS Scene
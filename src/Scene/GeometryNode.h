@@ -22,7 +22,8 @@ namespace Scene {
 
 /**
  * Geometry node.
- * Acts as a simple node wrapping a face set.
+ * Acts as a simple node wrapping a face set. Call InvalidateBounds()
+ * after changing the faces of the set.
  *
  * @class GeometryNode GeometryNode.h Scene/GeometryNode.h
  */
@@ -43,6 +44,9 @@ public:
     void Serialize(Resources::IArchiveWriter& w);
     void Deserialize(Resources::IArchiveReader& r);
 
+protected:
+    void ComputeBounds(Geometry::Bounds& bounds);
+
 private:
     Geometry::FaceSet* faces;
 
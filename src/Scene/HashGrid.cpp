@@ -0,0 +1,358 @@
+// Uniform hash grid spatial index.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#include <Scene/HashGrid.h>
+#include <Scene/Exceptions.h>
+#include <Geometry/Sphere.h>
+#include <Geometry/Plane.h>
+#include <Geometry/Ray.h>
+
+#include <algorithm>
+#include <limits>
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+
+namespace OpenEngine {
+namespace Scene {
+
+using std::list;
+using std::map;
+using std::pair;
+using std::vector;
+using Geometry::Bounds;
+using Geometry::Sphere;
+using Geometry::Plane;
+using Geometry::Ray;
+
+// nodes covering more cells are large
+static const double MAX_CELLS = 64;
+// cell coordinates are clamped to keep the arithmetic in range
+static const float MAX_COORD = 1 << 30;
+
+/**
+ * Create a hash grid.
+ *
+ * @param cellSize Size of the cells.
+ * @param buckets Number of hash buckets.
+ * @throws InvalidSceneOperation if the cell size or the number of
+ * buckets is not positive.
+ */
+HashGrid::HashGrid(float cellSize, unsigned int buckets)
+    : cellSize(cellSize), buckets(buckets), mark(0) {
+    if (cellSize <= 0 || buckets == 0)
+        throw InvalidSceneOperation("A hash grid needs cells and buckets.");
+    Clear();
+}
+
+HashGrid::~HashGrid() {
+    Clear();
+}
+
+float HashGrid::GetCellSize() const {
+    return cellSize;
+}
+
+void HashGrid::Insert(ISceneNode* node, const Bounds& bounds) {
+    if (bounds.IsEmpty()) {
+        Remove(node);
+        return;
+    }
+    map<ISceneNode*, Entry*>::iterator itr = entries.find(node);
+    if (itr == entries.end()) {
+        Entry* e = new Entry();
+        e->node = node;
+        e->bounds = bounds;
+        e->mark = mark;
+        entries[node] = e;
+        Link(e);
+        return;
+    }
+    Entry* e = itr->second;
+    // moved within the same cells
+    int l[3], h[3];
+    Cell(bounds.GetMin(), l);
+    Cell(bounds.GetMax(), h);
+    if (!e->large && std::equal(l, l + 3, e->lo) && std::equal(h, h + 3, e->hi)) {
+        e->bounds = bounds;
+        return;
+    }
+    Unlink(e);
+    e->bounds = bounds;
+    Link(e);
+}
+
+void HashGrid::Remove(ISceneNode* node) {
+    map<ISceneNode*, Entry*>::iterator itr = entries.find(node);
+    if (itr == entries.end()) return;
+    Unlink(itr->second);
+    delete itr->second;
+    entries.erase(itr);
+}
+
+/**
+ * Remove all nodes.
+ * The cells covered by the grid only shrink when it is cleared.
+ */
+void HashGrid::Clear() {
+    map<ISceneNode*, Entry*>::iterator itr;
+    for (itr = entries.begin(); itr != entries.end(); itr++)
+        delete itr->second;
+    entries.clear();
+    large.clear();
+    for (unsigned int i = 0; i < buckets.size(); i++)
+        buckets[i].clear();
+    for (int i = 0; i < 3; i++) {
+        lo[i] = INT_MAX;
+        hi[i] = INT_MIN;
+    }
+}
+
+unsigned int HashGrid::GetSize() const {
+    return entries.size();
+}
+
+bool HashGrid::Contains(ISceneNode* node) const {
+    return entries.find(node) != entries.end();
+}
+
+void HashGrid::Query(const Bounds& bounds, list<ISceneNode*>& nodes) {
+    if (bounds.IsEmpty()) return;
+    vector<Entry*> found;
+    Collect(bounds, found);
+    for (unsigned int i = 0; i < found.size(); i++)
+        if (found[i]->bounds.Intersects(bounds))
+            nodes.push_back(found[i]->node);
+}
+
+void HashGrid::Query(const Sphere& sphere, list<ISceneNode*>& nodes) {
+    Vector<3,float> r(sphere.GetRadius());
+    vector<Entry*> found;
+    Collect(Bounds(sphere.GetCenter() - r, sphere.GetCenter() + r), found);
+    for (unsigned int i = 0; i < found.size(); i++)
+        if (found[i]->bounds.Intersects(sphere))
+            nodes.push_back(found[i]->node);
+}
+
+void HashGrid::Query(const vector<Plane>& planes, list<ISceneNode*>& nodes) {
+    map<ISceneNode*, Entry*>::iterator itr;
+    for (itr = entries.begin(); itr != entries.end(); itr++) {
+        unsigned int i = 0;
+        while (i < planes.size() && !itr->second->bounds.IsBehind(planes[i])) i++;
+        if (i == planes.size()) nodes.push_back(itr->first);
+    }
+}
+
+/**
+ * Find the nodes nearest to a point.
+ * Visits the cells in growing shells around the cell of the point
+ * until no unvisited cell can hold a nearer node.
+ */
+void HashGrid::Nearest(Vector<3,float> point, unsigned int k,
+                       list<ISceneNode*>& nodes) {
+    if (k == 0 || entries.empty()) return;
+    mark++;
+    // the nearest entries found so far, nearest first
+    vector<pair<float, Entry*> > best;
+    vector<Entry*> found(large);
+    int c[3];
+    Cell(point, c);
+    int first = 0, last = -1;
+    if (lo[0] <= hi[0]) {
+        for (int i = 0; i < 3; i++) {
+            first = std::max(first, std::max(lo[i] - c[i], c[i] - hi[i]));
+            last = std::max(last, std::max(abs(c[i] - lo[i]), abs(c[i] - hi[i])));
+        }
+    }
+    for (int r = first; ; r++) {
+        for (unsigned int i = 0; i < found.size(); i++) {
+            float d = found[i]->bounds.GetSquaredDistance(point);
+            if (best.size() == k && d >= best.back().first) continue;
+            pair<float, Entry*> p(d, found[i]);
+            best.insert(std::upper_bound(best.begin(), best.end(), p), p);
+            if (best.size() > k) best.pop_back();
+        }
+        found.clear();
+        // nodes in the shell of radius r are at least r - 1 cells away
+        float min = (r - 1) * cellSize;
+        if (r > last || (best.size() == k && r > 0 && best.back().first <= min * min))
+            break;
+        int xl = std::max(c[0] - r, lo[0]), xh = std::min(c[0] + r, hi[0]);
+        int yl = std::max(c[1] - r, lo[1]), yh = std::min(c[1] + r, hi[1]);
+        for (int x = xl; x <= xh; x++)
+            for (int y = yl; y <= yh; y++) {
+                if (abs(x - c[0]) == r || abs(y - c[1]) == r) {
+                    int zl = std::max(c[2] - r, lo[2]), zh = std::min(c[2] + r, hi[2]);
+                    for (int z = zl; z <= zh; z++)
+                        Visit(Bucket(x, y, z), found);
+                }
+                else {
+                    if (c[2] - r >= lo[2]) Visit(Bucket(x, y, c[2] - r), found);
+                    if (r > 0 && c[2] + r <= hi[2]) Visit(Bucket(x, y, c[2] + r), found);
+                }
+            }
+    }
+    for (unsigned int i = 0; i < best.size(); i++)
+        nodes.push_back(best[i].second->node);
+}
+
+/**
+ * Find the first node hit by a ray.
+ * Walks the cells along the ray until the nearest hit is closer than
+ * the next cell.
+ */
+ISceneNode* HashGrid::Cast(const Ray& ray, float* distance) {
+    mark++;
+    Entry* hit = NULL;
+    float best = std::numeric_limits<float>::max();
+    vector<Entry*> found(large);
+    if (lo[0] <= hi[0]) {
+        Bounds grid(Vector<3,float>(lo[0], lo[1], lo[2]) * cellSize,
+                    Vector<3,float>(hi[0] + 1, hi[1] + 1, hi[2] + 1) * cellSize);
+        Vector<3,float> p = ray.GetPoint(), dir = ray.GetDirection();
+        float t;
+        if (grid.Intersects(ray, &t)) {
+            int c[3], step[3];
+            float next[3], delta[3];
+            Cell(p + dir * t, c);
+            for (int i = 0; i < 3; i++) {
+                c[i] = std::max(lo[i], std::min(hi[i], c[i]));
+                step[i] = dir[i] > 0 ? 1 : (dir[i] < 0 ? -1 : 0);
+                if (step[i] == 0) {
+                    next[i] = delta[i] = std::numeric_limits<float>::max();
+                    continue;
+                }
+                float border = (c[i] + (step[i] > 0 ? 1 : 0)) * cellSize;
+                next[i] = (border - p[i]) / dir[i];
+                delta[i] = cellSize / fabs(dir[i]);
+            }
+            for (;;) {
+                Visit(Bucket(c[0], c[1], c[2]), found);
+                for (unsigned int i = 0; i < found.size(); i++)
+                    if (found[i]->bounds.Intersects(ray, &t) && t < best) {
+                        best = t;
+                        hit = found[i];
+                    }
+                found.clear();
+                // step to the neighbour cell the ray enters first
+                int a = next[0] < next[1] ? (next[0] < next[2] ? 0 : 2)
+                                          : (next[1] < next[2] ? 1 : 2);
+                if (best <= next[a] || step[a] == 0) break;
+                c[a] += step[a];
+                if (c[a] < lo[a] || c[a] > hi[a]) break;
+                next[a] += delta[a];
+            }
+        }
+    }
+    float t;
+    for (unsigned int i = 0; i < found.size(); i++)
+        if (found[i]->bounds.Intersects(ray, &t) && t < best) {
+            best = t;
+            hit = found[i];
+        }
+    if (hit == NULL) return NULL;
+    if (distance) *distance = best;
+    return hit->node;
+}
+
+// get the cell of a point
+void HashGrid::Cell(Vector<3,float> point, int cell[3]) const {
+    for (int i = 0; i < 3; i++) {
+        float c = floor(point[i] / cellSize);
+        cell[i] = int(std::max(-MAX_COORD, std::min(MAX_COORD, c)));
+    }
+}
+
+std::vector<HashGrid::Entry*>& HashGrid::Bucket(int x, int y, int z) {
+    unsigned int h = (unsigned int)x * 73856093u
+                   ^ (unsigned int)y * 19349663u
+                   ^ (unsigned int)z * 83492791u;
+    return buckets[h % buckets.size()];
+}
+
+// add an entry to the buckets of its cells
+void HashGrid::Link(Entry* entry) {
+    Cell(entry->bounds.GetMin(), entry->lo);
+    Cell(entry->bounds.GetMax(), entry->hi);
+    double n = 1;
+    for (int i = 0; i < 3; i++)
+        n *= double(entry->hi[i]) - entry->lo[i] + 1;
+    entry->large = n > MAX_CELLS;
+    if (entry->large) {
+        large.push_back(entry);
+        return;
+    }
+    for (int i = 0; i < 3; i++) {
+        lo[i] = std::min(lo[i], entry->lo[i]);
+        hi[i] = std::max(hi[i], entry->hi[i]);
+    }
+    for (int x = entry->lo[0]; x <= entry->hi[0]; x++)
+        for (int y = entry->lo[1]; y <= entry->hi[1]; y++)
+            for (int z = entry->lo[2]; z <= entry->hi[2]; z++) {
+                vector<Entry*>& b = Bucket(x, y, z);
+                // cells may share a bucket
+                if (std::find(b.begin(), b.end(), entry) == b.end())
+                    b.push_back(entry);
+            }
+}
+
+void HashGrid::Unlink(Entry* entry) {
+    if (entry->large) {
+        large.erase(std::find(large.begin(), large.end(), entry));
+        return;
+    }
+    for (int x = entry->lo[0]; x <= entry->hi[0]; x++)
+        for (int y = entry->lo[1]; y <= entry->hi[1]; y++)
+            for (int z = entry->lo[2]; z <= entry->hi[2]; z++) {
+                vector<Entry*>& b = Bucket(x, y, z);
+                vector<Entry*>::iterator itr = std::find(b.begin(), b.end(), entry);
+                if (itr == b.end()) continue;
+                *itr = b.back();
+                b.pop_back();
+            }
+}
+
+// get the entries in the cells overlapping the bounds, once each
+void HashGrid::Collect(const Bounds& bounds, vector<Entry*>& found) {
+    mark++;
+    found = large;
+    int l[3], h[3];
+    Cell(bounds.GetMin(), l);
+    Cell(bounds.GetMax(), h);
+    double n = 1;
+    for (int i = 0; i < 3; i++) {
+        l[i] = std::max(l[i], lo[i]);
+        h[i] = std::min(h[i], hi[i]);
+        if (l[i] > h[i]) return;
+        n *= double(h[i]) - l[i] + 1;
+    }
+    // more cells than buckets, visit every bucket once
+    if (n > buckets.size()) {
+        for (unsigned int i = 0; i < buckets.size(); i++)
+            Visit(buckets[i], found);
+        return;
+    }
+    for (int x = l[0]; x <= h[0]; x++)
+        for (int y = l[1]; y <= h[1]; y++)
+            for (int z = l[2]; z <= h[2]; z++)
+                Visit(Bucket(x, y, z), found);
+}
+
+// add the entries of a bucket not seen by the current query
+void HashGrid::Visit(vector<Entry*>& bucket, vector<Entry*>& found) {
+    for (unsigned int i = 0; i < bucket.size(); i++) {
+        Entry* e = bucket[i];
+        if (e->mark == mark) continue;
+        e->mark = mark;
+        found.push_back(e);
+    }
+}
+
+} // NS Scene
+} // NS OpenEngine
@@ -0,0 +1,92 @@
+// Uniform hash grid spatial index.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#ifndef _OE_HASH_GRID_H_
+#define _OE_HASH_GRID_H_
+
+#include <Scene/ISpatialIndex.h>
+#include <Geometry/Bounds.h>
+
+#include <map>
+
+namespace OpenEngine {
+namespace Scene {
+
+/**
+ * Uniform hash grid spatial index.
+ * Divides space into cubic cells of one size and hashes the cells
+ * into a fixed number of buckets, so the grid is unbounded and its
+ * memory only depends on the number of nodes. A node is kept in the
+ * bucket of every cell its bounds overlap. Nodes covering more than
+ * a few cells are kept in a separate list tested by every query.
+ *
+ * The grid suits many objects of similar size, such as characters
+ * and props, with cells about the size of the objects or the
+ * typical query radius. Box, sphere and nearest queries visit the
+ * cells around the query and ray casts walk the cells along the ray.
+ * Plane queries have no cells to visit and test every node, so use a
+ * LooseOctree for view culling.
+ *
+ * @class HashGrid HashGrid.h Scene/HashGrid.h
+ * @see LooseOctree
+ */
+class HashGrid : public ISpatialIndex {
+public:
+    HashGrid(float cellSize, unsigned int buckets = 4096);
+    virtual ~HashGrid();
+
+    float GetCellSize() const;
+
+    void Insert(ISceneNode* node, const Geometry::Bounds& bounds);
+    void Remove(ISceneNode* node);
+    void Clear();
+    unsigned int GetSize() const;
+    bool Contains(ISceneNode* node) const;
+
+    void Query(const Geometry::Bounds& bounds, std::list<ISceneNode*>& nodes);
+    void Query(const Geometry::Sphere& sphere, std::list<ISceneNode*>& nodes);
+    void Query(const std::vector<Geometry::Plane>& planes,
+               std::list<ISceneNode*>& nodes);
+    void Nearest(Vector<3,float> point, unsigned int k,
+                 std::list<ISceneNode*>& nodes);
+    ISceneNode* Cast(const Geometry::Ray& ray, float* distance = NULL);
+
+private:
+    //! indexed node
+    struct Entry {
+        ISceneNode* node;
+        Geometry::Bounds bounds;
+        int lo[3], hi[3];       //!< cells covered, or none if large
+        bool large;
+        unsigned int mark;      //!< last query that tested the entry
+    };
+
+    float cellSize;
+    std::vector<std::vector<Entry*> > buckets;
+    std::vector<Entry*> large;
+    std::map<ISceneNode*, Entry*> entries;
+    //! cells covered by the entries that are not large
+    int lo[3], hi[3];
+    unsigned int mark;
+
+    void Cell(Vector<3,float> point, int cell[3]) const;
+    std::vector<Entry*>& Bucket(int x, int y, int z);
+    void Link(Entry* entry);
+    void Unlink(Entry* entry);
+    void Collect(const Geometry::Bounds& bounds, std::vector<Entry*>& found);
+    void Visit(std::vector<Entry*>& bucket, std::vector<Entry*>& found);
+
+    HashGrid(const HashGrid&);
+    HashGrid& operator=(const HashGrid&);
+};
+
+} // NS Scene
+} // NS OpenEngine
+
+#endif // _OE_HASH_GRID_H_
@@ -9,31 +9,70 @@
 
 #include <Scene/ISceneNode.h>
 #include <Scene/Exceptions.h>
+#include <Scene/SceneIndex.h>
+#include <Scene/SceneJournal.h>
+#include <Scene/TransformationStore.h>
+#include <Core/Atomic.h>
+#include <Core/Mutex.h>
+#include <Core/Thread.h>
+
+#include <vector>
 
 
 namespace OpenEngine {
 namespace Scene {
 
 using std::list;
+using std::vector;
+using Core::AtomicAdd;
+using Core::AtomicCompareAndSwap;
+using Core::MemoryBarrier;
+using Core::Mutex;
+using Core::Thread;
+
+// accept stack value while queued operations are performed
+static const int PERFORMING = -1;
+
+// guards the operation queues of all nodes
+static Mutex operationLock;
+
+// serializes removals and deletions, which update the indices,
+// journals and transformation stores that are not thread safe, when
+// forks of a parallel traversal change the scene
+static Mutex structureLock;
 
 ISceneNode::ISceneNode()
-    : parent(NULL)
+    : boundsDirty(true)
+    , cachesDirty(true)
+    , parent(NULL)
+    , operationsPending(false)
     , acceptStack(0) {
 
 }
 
 ISceneNode::ISceneNode(const ISceneNode& node)
-    : parent(NULL)
+    : boundsDirty(true)
+    , cachesDirty(true)
+    , parent(NULL)
+    , operationsPending(false)
     , acceptStack(0)
 {
 
 }
 
 ISceneNode::~ISceneNode() {
-    list<ISceneNode*>::iterator itr;
-    for (itr = subNodes.begin(); itr != subNodes.end(); itr++)
-        delete *itr;
+    // delete the sub tree without recursing, so deep scenes do not
+    // exhaust the stack
+    vector<ISceneNode*> nodes(subNodes.begin(), subNodes.end());
     subNodes.clear();
+    while (!nodes.empty()) {
+        ISceneNode* node = nodes.back();
+        nodes.pop_back();
+        nodes.insert(nodes.end(), node->subNodes.begin(), node->subNodes.end());
+        node->subNodes.clear();
+        node->parent = NULL;
+        delete node;
+    }
 }
 
 ISceneNode* ISceneNode::GetParent() {
@@ -65,6 +104,61 @@ int ISceneNode::IndexOfNode(ISceneNode* node) {
     return -1;
 }
 
+void ISceneNode::InvalidateTransformations() {
+    int parent = -1;
+    TransformationStore* store = TransformationStore::Find(this, parent);
+    InvalidateTransformations(store, parent);
+}
+
+void ISceneNode::InvalidateTransformations(TransformationStore* store,
+                                           int parent) {
+    list<ISceneNode*>::iterator itr;
+    for (itr = subNodes.begin(); itr != subNodes.end(); itr++) {
+        // the root of another store may sit below the node
+        int p = parent;
+        TransformationStore* s = TransformationStore::FindRoot(*itr, store, p);
+        (*itr)->InvalidateTransformations(s, p);
+    }
+}
+
+Geometry::Bounds ISceneNode::GetBounds() {
+    if (boundsDirty) {
+        bounds = Geometry::Bounds();
+        ComputeBounds(bounds);
+        boundsDirty = false;
+    }
+    return bounds;
+}
+
+Geometry::Bounds ISceneNode::GetWorldBounds() {
+    Geometry::Bounds b = GetBounds();
+    for (ISceneNode* p = parent; p != NULL; p = p->parent)
+        p->TransformBounds(b);
+    return b;
+}
+
+void ISceneNode::InvalidateBounds() {
+    // a dirty node has dirty nodes above it, so stop at the first one
+    for (ISceneNode* n = this;
+         n != NULL && !(n->boundsDirty && n->cachesDirty);
+         n = n->parent)
+        n->boundsDirty = n->cachesDirty = true;
+}
+
+void ISceneNode::ComputeBounds(Geometry::Bounds& bounds) {
+    list<ISceneNode*>::iterator itr;
+    for (itr = subNodes.begin(); itr != subNodes.end(); itr++)
+        bounds.Add((*itr)->GetBounds());
+}
+
+void ISceneNode::TransformBounds(Geometry::Bounds& bounds) {}
+
+void ISceneNode::SetInfo(const std::string info) {
+    this->info = info;
+    SceneIndex::NodeChanged(this);
+    SceneJournal::StateChanged(this);
+}
+
 const string ISceneNode::ToString() const {
     return this->GetTypeName() + string(" ") + this->GetInfo();
 }
@@ -76,11 +170,18 @@ const string ISceneNode::ToString() const {
  * classes that overwrite the VisitSubNodes method are responsible for
  * invoking this.
  *
+ * The stack is atomic so several threads may traverse the node at
+ * once. Waits if queued operations are being performed.
+ *
  * @see VisitSubNodes
  */
 void ISceneNode::IncAcceptStack() {
-    // increment the accept stack
-    ++acceptStack;
+    for (;;) {
+        int n = acceptStack;
+        if (n != PERFORMING && AtomicCompareAndSwap(acceptStack, n, n + 1))
+            return;
+        if (n == PERFORMING) Thread::Yield();
+    }
 }
 
 /**
@@ -96,15 +197,45 @@ void ISceneNode::IncAcceptStack() {
 void ISceneNode::DecAcceptStack() {
     // if the accept stack is exhausted perform actions on all nodes
     // that were queued
-    if (--acceptStack == 0) {
+    if (AtomicAdd(acceptStack, -1) == 0)
+        PerformQueuedOperations();
+}
+
+//! queue an operation until no traversal is in progress
+void ISceneNode::QueueOperation(QueueType type, ISceneNode* sub) {
+    operationLock.Lock();
+    operationQueue.push_back(QueuedNode(type, sub));
+    operationsPending = true;
+    operationLock.Unlock();
+    // the traversal may have ended before the operation was queued
+    PerformQueuedOperations();
+}
+
+/**
+ * Perform the queued operations if no traversal is in progress.
+ * Traversals starting meanwhile wait for the operations to complete.
+ * Operations of different nodes are performed one at a time, also
+ * when the traversals of several threads end at once.
+ */
+void ISceneNode::PerformQueuedOperations() {
+    while (operationsPending &&
+           AtomicCompareAndSwap(acceptStack, 0, PERFORMING)) {
+        list<QueuedNode> queue;
+        operationLock.Lock();
+        queue.swap(operationQueue);
+        operationsPending = false;
+        operationLock.Unlock();
+        structureLock.Lock();
         list<QueuedNode>::iterator q;
-        for (q = operationQueue.begin(); q != operationQueue.end(); q++) {
+        for (q = queue.begin(); q != queue.end(); q++) {
             ISceneNode* node = (*q).node;
             QueueType type = (*q).type;
             if      (type == DELETE_OP) _DeleteNode(node);
             else if (type == REMOVE_OP) _RemoveNode(node);
         }
-        operationQueue.clear();
+        structureLock.Unlock();
+        MemoryBarrier();
+        acceptStack = 0;
     }
 }
 
@@ -132,34 +263,63 @@ void ISceneNode::AddNode(ISceneNode* sub) {
         throw InvalidSceneOperation("A scene node may not have multiple parents.");
     subNodes.push_back(sub);
     sub->parent = this;
+    sub->InvalidateTransformations();
+    InvalidateBounds();
+    SceneIndex::NodeAdded(sub);
+    SceneJournal::NodeAdded(sub);
 }
 
 void ISceneNode::RemoveNode(ISceneNode* sub) {
     // if there is a accept in progress queue the operation
-    if (acceptStack)
-        operationQueue.push_back(QueuedNode(REMOVE_OP, sub));
+    if (!AtomicCompareAndSwap(acceptStack, 0, PERFORMING))
+        QueueOperation(REMOVE_OP, sub);
     // else we can safely remove it right away
-    else _RemoveNode(sub);
+    else {
+        structureLock.Lock();
+        _RemoveNode(sub);
+        structureLock.Unlock();
+        MemoryBarrier();
+        acceptStack = 0;
+        PerformQueuedOperations();
+    }
 }
 
 //! non-delayed removal of a node
 void ISceneNode::_RemoveNode(ISceneNode* sub) {
+    if (sub->parent == this) {
+        SceneIndex::NodeRemoved(sub);
+        SceneJournal::NodeRemoved(sub);
+    }
     subNodes.remove(sub);
     sub->parent = NULL;
+    sub->InvalidateTransformations();
+    InvalidateBounds();
 }
 
 void ISceneNode::DeleteNode(ISceneNode* sub) {
     // if there is a accept in progress queue the operation
-    if (acceptStack)
-        operationQueue.push_back(QueuedNode(DELETE_OP, sub));
+    if (!AtomicCompareAndSwap(acceptStack, 0, PERFORMING))
+        QueueOperation(DELETE_OP, sub);
     // else we can safely delete it right away
-    else _DeleteNode(sub);
+    else {
+        structureLock.Lock();
+        _DeleteNode(sub);
+        structureLock.Unlock();
+        MemoryBarrier();
+        acceptStack = 0;
+        PerformQueuedOperations();
+    }
 }
 
 //! non-delayed deletion of a node
 void ISceneNode::_DeleteNode(ISceneNode* sub) {
+    if (sub->parent == this) {
+        SceneIndex::NodeRemoved(sub);
+        SceneJournal::NodeDeleted(sub);
+    }
     subNodes.remove(sub);
     delete sub;
+    InvalidateBounds();
 }
 
 void ISceneNode::ReplaceNode(ISceneNode* oldNode, ISceneNode* newNode) {
@@ -170,11 +330,18 @@ void ISceneNode::ReplaceNode(ISceneNode* oldNode, ISceneNode* newNode) {
     list<ISceneNode*>::iterator itr;
     for (itr = subNodes.begin(); itr != subNodes.end(); itr++) {
         if (*itr == oldNode) {
+            SceneIndex::NodeRemoved(oldNode);
+            SceneJournal::NodeDeleted(oldNode);
+            oldNode->parent = NULL;
             newNode->parent = this;
+            newNode->InvalidateTransformations();
             *itr = newNode;
-            if (acceptStack)
-                operationQueue.push_back(QueuedNode(DELETE_OP, oldNode));
-            else _DeleteNode(oldNode);
+            InvalidateBounds();
+            SceneIndex::NodeAdded(newNode);
+            SceneJournal::NodeAdded(newNode);
+            // the old node is no longer a sub node, so this only
+            // deletes it
+            DeleteNode(oldNode);
             return;
         }
     }
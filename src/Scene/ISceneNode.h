@@ -10,14 +10,19 @@
 #ifndef _OE_INTERFACE_SCENE_NODE_H_
 #define _OE_INTERFACE_SCENE_NODE_H_
 
+#include <Geometry/Bounds.h>
+
 #include <string>
 #include <list>
+#include <cstddef>
 
 #define OE_SCENE_NODE(klass, syper)                     \
 public:                                                 \
 virtual void Accept(ISceneNodeVisitor& v);              \
 virtual ISceneNode* Clone() const;                      \
 virtual const std::string GetTypeName() const;          \
+static void* operator new(size_t size);                 \
+static void operator delete(void* node);                \
 private:
 
 namespace OpenEngine {
@@ -30,6 +35,7 @@ namespace Scene {
 
 // forward declaration
 class ISceneNodeVisitor;
+class TransformationStore;
 
 /**
  * Scene node interface.
@@ -153,6 +159,44 @@ public:
 
     virtual int IndexOfNode(ISceneNode* node);
 
+    /**
+     * Invalidate cached world transformations.
+     * Called when the node is added to or removed from a parent, as
+     * that changes the world transformation of the whole sub tree.
+     * The transformation store of the node is looked up once and
+     * handed down the sub tree.
+     *
+     * @see TransformationNode
+     */
+    void InvalidateTransformations();
+
+    /**
+     * Get the bounds of the node and its sub tree.
+     * The bounds are in the coordinate space of the nearest
+     * transformation node above the node, and are cached until the
+     * contents, the structure or a transformation of the sub tree
+     * change.
+     *
+     * @return Bounds, empty if the sub tree has no geometry.
+     */
+    Geometry::Bounds GetBounds();
+
+    /**
+     * Get the world space bounds of the node and its sub tree.
+     * Applies the transformation nodes above the node to the bounds.
+     * Visitors that keep track of transformations themselves should
+     * transform GetBounds() instead.
+     *
+     * @return World bounds, empty if the sub tree has no geometry.
+     */
+    Geometry::Bounds GetWorldBounds();
+
+    /**
+     * Invalidate the cached bounds of the node and all nodes above
+     * it. Must be called by nodes when their contents change.
+     */
+    void InvalidateBounds();
+
     /**
      * Get a string representation of the node.
      * There is no restriction on the representation. It should
@@ -198,7 +242,7 @@ public:
      *
      * @param info Node info string
      */
-    virtual void SetInfo(const std::string info) { this->info = info; };
+    virtual void SetInfo(const std::string info);
 
     /**
      * Accept a visitor.
@@ -217,7 +261,49 @@ public:
     virtual void Serialize(Resources::IArchiveWriter& w);
     virtual void Deserialize(Resources::IArchiveReader& r);
 
+protected:
+
+    /**
+     * Compute the bounds of the node and its sub tree.
+     * The default is the union of the bounds of the sub nodes. Nodes
+     * with contents add the bounds of their contents.
+     *
+     * @param bounds Bounds in the space of the node [out]
+     */
+    virtual void ComputeBounds(Geometry::Bounds& bounds);
+
+    /**
+     * Transform bounds from the space below the node to the space
+     * of the node. Does nothing unless the node is a transformation.
+     *
+     * @param bounds Bounds to transform [in/out]
+     */
+    virtual void TransformBounds(Geometry::Bounds& bounds);
+
+    /**
+     * Invalidate cached world transformations of the sub tree.
+     * The default propagates the call to all sub nodes.
+     *
+     * @param store Store of the node, NULL if none.
+     * @param parent Index of the nearest transformation node above
+     *               the node in the store, -1 if there is none.
+     */
+    virtual void InvalidateTransformations(TransformationStore* store,
+                                           int parent);
+
 private:
+    //! Fills the caches of sub trees before fanning out
+    friend class ParallelVisitor;
+
+    //! Cached bounds of the sub tree
+    Geometry::Bounds bounds;
+
+    //! True if the cached bounds are out of date
+    bool boundsDirty;
+
+    //! True if a cache in the sub tree may be out of date, until a
+    //! parallel traversal fills them
+    bool cachesDirty;
 
     //! The parent node
     ISceneNode* parent;
@@ -239,11 +325,17 @@ private:
     //! Queued node operations.
     std::list<QueuedNode> operationQueue;
 
-    //! Height of the accept/visit stack.
-    int acceptStack;
+    //! True if operations are queued.
+    volatile bool operationsPending;
+
+    //! Height of the accept/visit stack, negative while performing
+    //! queued operations.
+    volatile int acceptStack;
 
     void _RemoveNode(ISceneNode* sub);
     void _DeleteNode(ISceneNode* sub);
+    void QueueOperation(QueueType type, ISceneNode* sub);
+    void PerformQueuedOperations();
 
     // We currently need to have access to these methods in the definition of
     // accept in all sub type. Clients should however not use them!
@@ -32,11 +32,25 @@ namespace Scene {
      */
 #define SCENE_NODE(type)                              \
     void ISceneNodeVisitor::Visit##type(type* node) { \
-        DefaultVisitNode(node);                       \
+        DefaultVisit(node);                           \
     }
 #include "SceneNodes.def"
 #undef SCENE_NODE
 
+    void ISceneNodeVisitor::DefaultVisit(ISceneNode* node) {
+        DefaultVisitNode(node);
+    }
+
+    /**
+     * Instance nodes are visited as transformation nodes by visitors
+     * that do not handle them.
+     *
+     * @see InstanceNode
+     */
+    void ISceneNodeVisitor::DefaultVisit(InstanceNode* node) {
+        VisitTransformationNode(node);
+    }
+
     /**
      * Default visiting behavior.
      * Changing this will change the tree traversal.
@@ -48,6 +48,10 @@ protected:
     // Default visiting behavior.
     virtual void DefaultVisitNode(ISceneNode* node);
 
+private:
+    void DefaultVisit(ISceneNode* node);
+    void DefaultVisit(InstanceNode* node);
+
 };
 
 } // NS Scene
@@ -0,0 +1,137 @@
+// Spatial index interface.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#ifndef _OE_INTERFACE_SPATIAL_INDEX_H_
+#define _OE_INTERFACE_SPATIAL_INDEX_H_
+
+#include <Math/Vector.h>
+
+#include <list>
+#include <vector>
+#include <cstddef>
+
+namespace OpenEngine {
+    namespace Geometry {
+        class Bounds;
+        class Sphere;
+        class Plane;
+        class Ray;
+    }
+namespace Scene {
+
+class ISceneNode;
+
+using Math::Vector;
+
+/**
+ * Spatial index interface.
+ * Indexes scene nodes by axis aligned world bounds, so overlap,
+ * proximity and ray queries only test the nodes near the query
+ * instead of every node. All tests are on the indexed bounds, so
+ * exact tests against the geometry are left to the caller.
+ *
+ * @code
+ * LooseOctree octree(worldBounds);
+ * octree.Insert(node, node->GetWorldBounds());
+ * list<ISceneNode*> near;
+ * octree.Query(Sphere(position, 20), near);
+ * float t;
+ * ISceneNode* picked = octree.Cast(ray, &t);
+ * @endcode
+ *
+ * Indices do not own the nodes and are not thread safe, not even
+ * for concurrent queries.
+ *
+ * @class ISpatialIndex ISpatialIndex.h Scene/ISpatialIndex.h
+ * @see SpatialIndexer
+ */
+class ISpatialIndex {
+public:
+    virtual ~ISpatialIndex() {}
+
+    /**
+     * Insert a node or update the bounds of an indexed node.
+     * Nodes with empty bounds are removed.
+     *
+     * @param node Node to index.
+     * @param bounds World bounds of the node.
+     */
+    virtual void Insert(ISceneNode* node, const Geometry::Bounds& bounds) = 0;
+
+    /**
+     * Remove a node, if it is indexed. The node is only used as a
+     * key, so it may have been deleted.
+     */
+    virtual void Remove(ISceneNode* node) = 0;
+
+    /**
+     * Remove all nodes.
+     */
+    virtual void Clear() = 0;
+
+    /**
+     * Number of indexed nodes.
+     */
+    virtual unsigned int GetSize() const = 0;
+
+    /**
+     * Check if a node is indexed.
+     */
+    virtual bool Contains(ISceneNode* node) const = 0;
+
+    /**
+     * Find the nodes whose bounds overlap the bounds.
+     *
+     * @param bounds Bounds to test.
+     * @param nodes List the nodes are added to, in no particular order.
+     */
+    virtual void Query(const Geometry::Bounds& bounds,
+                       std::list<ISceneNode*>& nodes) = 0;
+
+    /**
+     * Find the nodes whose bounds overlap the sphere.
+     */
+    virtual void Query(const Geometry::Sphere& sphere,
+                       std::list<ISceneNode*>& nodes) = 0;
+
+    /**
+     * Find the nodes whose bounds are not entirely behind any of the
+     * planes, such as the clipping planes of a frustum.
+     *
+     * @see Geometry::Bounds::IsBehind
+     */
+    virtual void Query(const std::vector<Geometry::Plane>& planes,
+                       std::list<ISceneNode*>& nodes) = 0;
+
+    /**
+     * Find the nodes nearest to a point, measured to their bounds.
+     *
+     * @param point Point to measure from.
+     * @param k Maximum number of nodes to find.
+     * @param nodes List the nodes are added to, nearest first.
+     */
+    virtual void Nearest(Vector<3,float> point, unsigned int k,
+                         std::list<ISceneNode*>& nodes) = 0;
+
+    /**
+     * Find the first node whose bounds a ray hits.
+     *
+     * @param ray Ray to cast.
+     * @param distance Set to the distance along the ray to the hit,
+     * in lengths of the ray direction.
+     * @return The node or NULL if the ray hits nothing.
+     */
+    virtual ISceneNode* Cast(const Geometry::Ray& ray,
+                             float* distance = NULL) = 0;
+};
+
+} // NS Scene
+} // NS OpenEngine
+
+#endif // _OE_INTERFACE_SPATIAL_INDEX_H_
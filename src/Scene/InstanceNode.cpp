@@ -0,0 +1,141 @@
+// Instance of a shared scene sub tree.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#include <Scene/InstanceNode.h>
+#include <Scene/Exceptions.h>
+#include <Scene/SceneJournal.h>
+#include <Resources/IArchiveWriter.h>
+#include <Resources/IArchiveReader.h>
+
+#include <list>
+
+namespace OpenEngine {
+namespace Scene {
+
+InstanceNode::InstanceNode() {}
+
+/**
+ * Copy constructor.
+ * The copy shares the prototype of the node.
+ */
+InstanceNode::InstanceNode(const InstanceNode& node)
+    : TransformationNode(node)
+    , prototype(node.prototype) {}
+
+/**
+ * Create an instance of a prototype.
+ *
+ * @param prototype Root of the prototype sub tree.
+ * @throws InvalidSceneOperation if the prototype is in a scene.
+ */
+InstanceNode::InstanceNode(ScenePrototype prototype) {
+    SetPrototype(prototype);
+}
+
+InstanceNode::~InstanceNode() {}
+
+ScenePrototype InstanceNode::GetPrototype() const {
+    return prototype;
+}
+
+/**
+ * Set the prototype of the instance.
+ *
+ * @param prototype Root of the prototype sub tree, may be empty.
+ * @throws InvalidSceneOperation if the prototype is in a scene.
+ */
+void InstanceNode::SetPrototype(ScenePrototype prototype) {
+    if (prototype && prototype->GetParent() != NULL)
+        throw InvalidSceneOperation("A prototype may not have a parent.");
+    this->prototype = prototype;
+    InvalidateBounds();
+    SceneJournal::StateChanged(this);
+}
+
+/**
+ * Check if the prototype is shared with other instances.
+ */
+bool InstanceNode::IsShared() const {
+    return prototype && !prototype.unique();
+}
+
+/**
+ * Get a writable node of the prototype.
+ * If the prototype is shared it is copied for the instance first, so
+ * changes only affect this instance, and nodes of the shared
+ * prototype no longer belong to the instance. Call InvalidateBounds()
+ * on the instance after changing the bounds of the prototype.
+ *
+ * The first write copies the whole prototype, not only the path down
+ * to the node, since a node can not have a parent in both the shared
+ * and the private copy. Instance nodes inside the prototype keep
+ * sharing their own prototypes when copied, so large prototypes
+ * built from nested instances only copy the enclosing level.
+ *
+ * @param node Node in the prototype of the instance.
+ * @return The node in the private prototype of the instance.
+ * @throws InvalidSceneOperation if the node is not in the prototype.
+ */
+ISceneNode* InstanceNode::Write(ISceneNode* node) {
+    std::list<int> path;
+    ISceneNode* n = node;
+    for (; n != NULL && n != prototype.get(); n = n->GetParent())
+        if (n->GetParent() != NULL)
+            path.push_front(n->GetParent()->IndexOfNode(n));
+    if (n == NULL)
+        throw InvalidSceneOperation("The node is not in the prototype of the instance.");
+
+    if (!prototype.unique())
+        prototype.reset(prototype->Clone());
+    InvalidateBounds();
+    SceneJournal::StateChanged(this);
+
+    n = prototype.get();
+    std::list<int>::iterator itr;
+    for (itr = path.begin(); itr != path.end(); itr++)
+        n = n->GetNode(*itr);
+    return n;
+}
+
+/**
+ * Visit the sub nodes of the instance followed by the prototype.
+ */
+void InstanceNode::VisitSubNodes(ISceneNodeVisitor& visitor) {
+    ISceneNode::VisitSubNodes(visitor);
+    if (prototype) prototype->Accept(visitor);
+}
+
+/**
+ * Compute the bounds of the sub nodes and the prototype in the space
+ * of the parent.
+ */
+void InstanceNode::ComputeBounds(Geometry::Bounds& bounds) {
+    ISceneNode::ComputeBounds(bounds);
+    if (prototype) bounds.Add(prototype->GetBounds());
+    TransformBounds(bounds);
+}
+
+/**
+ * Serialize an instance node.
+ * A prototype shared by several instances is written once and
+ * referenced by the others, so they share it again when read back.
+ */
+void InstanceNode::Serialize(Resources::IArchiveWriter& w) {
+    TransformationNode::Serialize(w);
+    w.WriteScenePtr("prototype", prototype);
+}
+
+void InstanceNode::Deserialize(Resources::IArchiveReader& r) {
+    TransformationNode::Deserialize(r);
+    prototype = r.ReadScenePtr("prototype");
+    InvalidateBounds();
+}
+
+} // NS Scene
+} // NS OpenEngine
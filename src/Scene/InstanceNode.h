@@ -0,0 +1,92 @@
+// Instance of a shared scene sub tree.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#ifndef _OE_INSTANCE_NODE_H_
+#define _OE_INSTANCE_NODE_H_
+
+#include <Scene/TransformationNode.h>
+
+#include <boost/shared_ptr.hpp>
+
+namespace OpenEngine {
+namespace Scene {
+
+//! Shared prototype sub tree.
+typedef boost::shared_ptr<ISceneNode> ScenePrototype;
+
+/**
+ * Instance of a shared scene sub tree.
+ * Places a prototype sub tree, such as a tree, a rock or a character,
+ * in the scene without copying it. Any number of instance nodes may
+ * reference the same prototype, each with its own transformation.
+ * Sub nodes added to the instance itself are visited before the
+ * prototype, so an instance can carry its own attachments.
+ *
+ * @code
+ * ScenePrototype rock(ModelLoader::Load("rock.obj"));
+ * for (unsigned int i = 0; i < 1000; i++) {
+ *     InstanceNode* instance = new InstanceNode(rock);
+ *     instance->SetPosition(RandomPosition());
+ *     scene->AddNode(instance);
+ * }
+ * @endcode
+ *
+ * The prototype is not part of the scene graph, so its nodes have no
+ * parent and their world transformations and bounds are relative to
+ * the instance. Prototypes must not be changed through the nodes a
+ * visitor reaches. Write() instead gives the instance a private copy
+ * of the prototype on the first write, after which the instance no
+ * longer shares it. The copy is of the whole prototype, see Write().
+ *
+ * Visitors that do not handle instance nodes visit them as
+ * transformation nodes, so an instance looks like a transformation
+ * node with the prototype as its last sub node.
+ *
+ * @class InstanceNode InstanceNode.h Scene/InstanceNode.h
+ */
+class InstanceNode : public TransformationNode {
+    OE_SCENE_NODE(InstanceNode, TransformationNode)
+public:
+    InstanceNode();
+    InstanceNode(const InstanceNode& node);
+    explicit InstanceNode(ScenePrototype prototype);
+    virtual ~InstanceNode();
+
+    ScenePrototype GetPrototype() const;
+    void SetPrototype(ScenePrototype prototype);
+    bool IsShared() const;
+
+    ISceneNode* Write(ISceneNode* node);
+
+    /**
+     * Get a writable node of the prototype.
+     *
+     * @see Write(ISceneNode*)
+     */
+    template <class T>
+    T* Write(T* node) {
+        return static_cast<T*>(Write(static_cast<ISceneNode*>(node)));
+    }
+
+    void VisitSubNodes(ISceneNodeVisitor& visitor);
+
+    void Serialize(Resources::IArchiveWriter& w);
+    void Deserialize(Resources::IArchiveReader& r);
+
+protected:
+    void ComputeBounds(Geometry::Bounds& bounds);
+
+private:
+    ScenePrototype prototype;
+};
+
+} // NS Scene
+} // NS OpenEngine
+
+#endif // _OE_INSTANCE_NODE_H_
@@ -0,0 +1,315 @@
+// Loose octree spatial index.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#include <Scene/LooseOctree.h>
+#include <Scene/Exceptions.h>
+#include <Geometry/Sphere.h>
+#include <Geometry/Plane.h>
+#include <Geometry/Ray.h>
+
+#include <queue>
+#include <cmath>
+
+namespace OpenEngine {
+namespace Scene {
+
+using std::list;
+using std::map;
+using std::vector;
+using Geometry::Bounds;
+using Geometry::Sphere;
+using Geometry::Plane;
+using Geometry::Ray;
+
+// overlap tests of the queries
+struct BoundsTest {
+    const Bounds& bounds;
+    BoundsTest(const Bounds& bounds) : bounds(bounds) {}
+    bool operator()(const Bounds& b) const { return b.Intersects(bounds); }
+};
+
+struct SphereTest {
+    const Sphere& sphere;
+    SphereTest(const Sphere& sphere) : sphere(sphere) {}
+    bool operator()(const Bounds& b) const { return b.Intersects(sphere); }
+};
+
+struct PlanesTest {
+    const vector<Plane>& planes;
+    PlanesTest(const vector<Plane>& planes) : planes(planes) {}
+    bool operator()(const Bounds& b) const {
+        for (unsigned int i = 0; i < planes.size(); i++)
+            if (b.IsBehind(planes[i])) return false;
+        return !b.IsEmpty();
+    }
+};
+
+// distances of the closest first searches
+struct NearestMetric {
+    Vector<3,float> point;
+    NearestMetric(Vector<3,float> point) : point(point) {}
+    bool operator()(const Bounds& b, float& key) const {
+        key = b.GetSquaredDistance(point);
+        return true;
+    }
+};
+
+struct RayMetric {
+    const Ray& ray;
+    RayMetric(const Ray& ray) : ray(ray) {}
+    bool operator()(const Bounds& b, float& key) const {
+        return b.Intersects(ray, &key);
+    }
+};
+
+// cell or entry in the queue of a closest first search
+struct SearchItem {
+    float key;
+    void* cell;
+    void* entry;
+    SearchItem(float key, void* cell, void* entry)
+        : key(key), cell(cell), entry(entry) {}
+    // order the priority queue closest first
+    bool operator<(const SearchItem& item) const { return key > item.key; }
+};
+
+LooseOctree::Cell::Cell(Cell* parent, unsigned int index,
+                        Vector<3,float> center, float half)
+    : center(center), half(half)
+    , loose(center - Vector<3,float>(2 * half), center + Vector<3,float>(2 * half))
+    , parent(parent), index(index), count(0) {
+    for (unsigned int i = 0; i < 8; i++) children[i] = NULL;
+}
+
+LooseOctree::Cell::~Cell() {
+    for (unsigned int i = 0; i < 8; i++) delete children[i];
+}
+
+/**
+ * Create an octree.
+ *
+ * @param world Bounds of the world, the octree covers the cube around
+ * their center with the largest of their sizes.
+ * @param depth Levels of cells below the root cell.
+ * @throws InvalidSceneOperation if the world bounds are empty.
+ */
+LooseOctree::LooseOctree(const Bounds& world, unsigned int depth)
+    : depth(depth), cells(1) {
+    if (world.IsEmpty())
+        throw InvalidSceneOperation("The world of an octree may not be empty.");
+    Vector<3,float> extent = world.GetExtent();
+    float half = extent.Max();
+    if (half <= 0) half = 1;
+    root = new Cell(NULL, 0, world.GetCenter(), half);
+}
+
+LooseOctree::~LooseOctree() {
+    Clear();
+    delete root;
+}
+
+unsigned int LooseOctree::GetDepth() const {
+    return depth;
+}
+
+/**
+ * Number of cells, including the root cell.
+ */
+unsigned int LooseOctree::GetNumberOfCells() const {
+    return cells;
+}
+
+void LooseOctree::Insert(ISceneNode* node, const Bounds& bounds) {
+    if (bounds.IsEmpty()) {
+        Remove(node);
+        return;
+    }
+    Entry* e;
+    map<ISceneNode*, Entry*>::iterator itr = entries.find(node);
+    if (itr != entries.end()) {
+        e = itr->second;
+        // moved within its cell
+        if (Locate(bounds, false) == e->cell) {
+            e->bounds = bounds;
+            return;
+        }
+        Detach(e);
+    }
+    else {
+        e = new Entry();
+        e->node = node;
+        entries[node] = e;
+    }
+    e->bounds = bounds;
+    Attach(e, Locate(bounds, true));
+}
+
+void LooseOctree::Remove(ISceneNode* node) {
+    map<ISceneNode*, Entry*>::iterator itr = entries.find(node);
+    if (itr == entries.end()) return;
+    Detach(itr->second);
+    delete itr->second;
+    entries.erase(itr);
+}
+
+void LooseOctree::Clear() {
+    map<ISceneNode*, Entry*>::iterator itr;
+    for (itr = entries.begin(); itr != entries.end(); itr++)
+        delete itr->second;
+    entries.clear();
+    Cell* cell = new Cell(NULL, 0, root->center, root->half);
+    delete root;
+    root = cell;
+    cells = 1;
+}
+
+unsigned int LooseOctree::GetSize() const {
+    return entries.size();
+}
+
+bool LooseOctree::Contains(ISceneNode* node) const {
+    return entries.find(node) != entries.end();
+}
+
+void LooseOctree::Query(const Bounds& bounds, list<ISceneNode*>& nodes) {
+    if (bounds.IsEmpty()) return;
+    Collect(root, BoundsTest(bounds), nodes);
+}
+
+void LooseOctree::Query(const Sphere& sphere, list<ISceneNode*>& nodes) {
+    Collect(root, SphereTest(sphere), nodes);
+}
+
+void LooseOctree::Query(const vector<Plane>& planes, list<ISceneNode*>& nodes) {
+    Collect(root, PlanesTest(planes), nodes);
+}
+
+void LooseOctree::Nearest(Vector<3,float> point, unsigned int k,
+                          list<ISceneNode*>& nodes) {
+    Search(NearestMetric(point), k, &nodes, NULL);
+}
+
+ISceneNode* LooseOctree::Cast(const Ray& ray, float* distance) {
+    Entry* e = Search(RayMetric(ray), 1, NULL, distance);
+    return e ? e->node : NULL;
+}
+
+/**
+ * Find the cell for bounds: the smallest cell containing the center
+ * whose loose bounds contain the bounds.
+ *
+ * @param bounds Bounds to place.
+ * @param create Create missing cells, else return NULL if the cell
+ * does not exist.
+ */
+LooseOctree::Cell* LooseOctree::Locate(const Bounds& bounds, bool create) {
+    Vector<3,float> center = bounds.GetCenter();
+    float size = bounds.GetExtent().Max();
+    Cell* cell = root;
+    for (int i = 0; i < 3; i++)
+        if (fabs(center[i] - root->center[i]) > root->half) return root;
+    for (unsigned int d = 0; d < depth; d++) {
+        float half = cell->half * 0.5f;
+        if (size > half) break;
+        unsigned int index = (center[0] > cell->center[0] ? 1 : 0)
+                           | (center[1] > cell->center[1] ? 2 : 0)
+                           | (center[2] > cell->center[2] ? 4 : 0);
+        if (cell->children[index] == NULL) {
+            if (!create) return NULL;
+            Vector<3,float> offset(index & 1 ? half : -half,
+                                   index & 2 ? half : -half,
+                                   index & 4 ? half : -half);
+            cell->children[index] =
+                new Cell(cell, index, cell->center + offset, half);
+            cells++;
+        }
+        cell = cell->children[index];
+    }
+    return cell;
+}
+
+void LooseOctree::Attach(Entry* entry, Cell* cell) {
+    entry->cell = cell;
+    entry->slot = cell->entries.size();
+    cell->entries.push_back(entry);
+    for (; cell != NULL; cell = cell->parent)
+        cell->count++;
+}
+
+// detach an entry from its cell, deleting the cells left empty
+void LooseOctree::Detach(Entry* entry) {
+    Cell* cell = entry->cell;
+    Entry* last = cell->entries.back();
+    cell->entries[entry->slot] = last;
+    last->slot = entry->slot;
+    cell->entries.pop_back();
+    entry->cell = NULL;
+    for (Cell* c = cell; c != NULL; c = c->parent)
+        c->count--;
+    while (cell != root && cell->count == 0) {
+        Cell* parent = cell->parent;
+        parent->children[cell->index] = NULL;
+        delete cell;
+        cells--;
+        cell = parent;
+    }
+}
+
+// add the nodes passing the test in the cells whose loose bounds pass
+template <class Test>
+void LooseOctree::Collect(Cell* cell, const Test& test, list<ISceneNode*>& nodes) {
+    if (cell->count == 0) return;
+    // the root also holds the nodes outside the world
+    if (cell != root && !test(cell->loose)) return;
+    for (unsigned int i = 0; i < cell->entries.size(); i++)
+        if (test(cell->entries[i]->bounds))
+            nodes.push_back(cell->entries[i]->node);
+    for (unsigned int i = 0; i < 8; i++)
+        if (cell->children[i]) Collect(cell->children[i], test, nodes);
+}
+
+// visit cells and entries closest first, as measured by the metric,
+// until k entries are found. The distance to the loose bounds of a
+// cell is a lower bound of the distances to its entries.
+template <class Metric>
+LooseOctree::Entry* LooseOctree::Search(const Metric& metric, unsigned int k,
+                                        list<ISceneNode*>* nodes, float* key) {
+    Entry* first = NULL;
+    unsigned int found = 0;
+    std::priority_queue<SearchItem> queue;
+    if (root->count > 0) queue.push(SearchItem(0, root, NULL));
+    while (!queue.empty() && found < k) {
+        SearchItem item = queue.top();
+        queue.pop();
+        if (item.entry) {
+            Entry* e = static_cast<Entry*>(item.entry);
+            if (first == NULL) {
+                first = e;
+                if (key) *key = item.key;
+            }
+            if (nodes) nodes->push_back(e->node);
+            found++;
+            continue;
+        }
+        Cell* cell = static_cast<Cell*>(item.cell);
+        float d;
+        for (unsigned int i = 0; i < cell->entries.size(); i++)
+            if (metric(cell->entries[i]->bounds, d))
+                queue.push(SearchItem(d, NULL, cell->entries[i]));
+        for (unsigned int i = 0; i < 8; i++) {
+            Cell* child = cell->children[i];
+            if (child && metric(child->loose, d))
+                queue.push(SearchItem(d, child, NULL));
+        }
+    }
+    return first;
+}
+
+} // NS Scene
+} // NS OpenEngine
@@ -0,0 +1,109 @@
+// Loose octree spatial index.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#ifndef _OE_LOOSE_OCTREE_H_
+#define _OE_LOOSE_OCTREE_H_
+
+#include <Scene/ISpatialIndex.h>
+#include <Geometry/Bounds.h>
+
+#include <map>
+
+namespace OpenEngine {
+namespace Scene {
+
+/**
+ * Loose octree spatial index.
+ * Each cell of a loose octree accepts nodes whose center lies in the
+ * cell and whose bounds fit twice the size of the cell, so a node
+ * sits in exactly one cell, chosen from its center and size alone.
+ * Inserting, moving and removing a node is logarithmic in the size
+ * of the world, and moving a node within its cell only updates its
+ * bounds. Queries descend into the cells whose loose bounds
+ * overlap the query, and nearest and ray queries visit the cells
+ * closest first.
+ *
+ * The octree covers a fixed world cube. Nodes outside it are kept in
+ * the root cell, which is tested by every query.
+ *
+ * @class LooseOctree LooseOctree.h Scene/LooseOctree.h
+ * @see HashGrid
+ */
+class LooseOctree : public ISpatialIndex {
+public:
+    LooseOctree(const Geometry::Bounds& world, unsigned int depth = 8);
+    virtual ~LooseOctree();
+
+    unsigned int GetDepth() const;
+    unsigned int GetNumberOfCells() const;
+
+    void Insert(ISceneNode* node, const Geometry::Bounds& bounds);
+    void Remove(ISceneNode* node);
+    void Clear();
+    unsigned int GetSize() const;
+    bool Contains(ISceneNode* node) const;
+
+    void Query(const Geometry::Bounds& bounds, std::list<ISceneNode*>& nodes);
+    void Query(const Geometry::Sphere& sphere, std::list<ISceneNode*>& nodes);
+    void Query(const std::vector<Geometry::Plane>& planes,
+               std::list<ISceneNode*>& nodes);
+    void Nearest(Vector<3,float> point, unsigned int k,
+                 std::list<ISceneNode*>& nodes);
+    ISceneNode* Cast(const Geometry::Ray& ray, float* distance = NULL);
+
+private:
+    struct Cell;
+
+    //! indexed node
+    struct Entry {
+        ISceneNode* node;
+        Geometry::Bounds bounds;
+        Cell* cell;
+        unsigned int slot;      //!< position in the entries of the cell
+    };
+
+    //! octree cell
+    struct Cell {
+        Vector<3,float> center;
+        float half;             //!< half the size of the cell
+        Geometry::Bounds loose; //!< bounds of the nodes the cell accepts
+        Cell* parent;
+        Cell* children[8];
+        unsigned int index;     //!< index in the children of the parent
+        std::vector<Entry*> entries;
+        unsigned int count;     //!< entries in the sub tree
+
+        Cell(Cell* parent, unsigned int index,
+             Vector<3,float> center, float half);
+        ~Cell();
+    };
+
+    unsigned int depth;
+    unsigned int cells;
+    Cell* root;
+    std::map<ISceneNode*, Entry*> entries;
+
+    Cell* Locate(const Geometry::Bounds& bounds, bool create);
+    void Attach(Entry* entry, Cell* cell);
+    void Detach(Entry* entry);
+
+    template <class Test>
+    void Collect(Cell* cell, const Test& test, std::list<ISceneNode*>& nodes);
+    template <class Metric>
+    Entry* Search(const Metric& metric, unsigned int k,
+                  std::list<ISceneNode*>* nodes, float* key);
+
+    LooseOctree(const LooseOctree&);
+    LooseOctree& operator=(const LooseOctree&);
+};
+
+} // NS Scene
+} // NS OpenEngine
+
+#endif // _OE_LOOSE_OCTREE_H_
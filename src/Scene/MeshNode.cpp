@@ -8,7 +8,10 @@
 //--------------------------------------------------------------------
 
 #include <Scene/MeshNode.h>
+#include <Scene/SceneJournal.h>
 #include <Geometry/Mesh.h>
+#include <Geometry/GeometrySet.h>
+#include <Resources/IDataBlock.h>
 
 using namespace OpenEngine::Geometry;
 
@@ -20,7 +23,8 @@ namespace OpenEngine {
         }
 
         MeshNode::MeshNode(const MeshNode& node) 
-            : ISceneNode(node) {
+            : ISceneNode(node)
+            , vertexBounds(node.vertexBounds) {
             mesh = node.GetMesh();
         }
 
@@ -34,6 +38,30 @@ namespace OpenEngine {
 
         void MeshNode::SetMesh(MeshPtr mesh){
             this->mesh = mesh;
+            vertexBounds = Bounds();
+            InvalidateBounds();
+            SceneJournal::StateChanged(this);
+        }
+
+        /**
+         * Add the vertices of the mesh to the bounds of the sub
+         * nodes. Unloaded vertices keep their size but not their
+         * data, so the bounds from when they were loaded are used.
+         */
+        void MeshNode::ComputeBounds(Bounds& bounds) {
+            ISceneNode::ComputeBounds(bounds);
+            if (!mesh || !mesh->GetGeometrySet()) return;
+            Resources::IDataBlockPtr vertices = mesh->GetGeometrySet()->GetVertices();
+            if (!vertices) return;
+            if (vertices->GetVoidData() != NULL) {
+                vertexBounds = Bounds();
+                for (unsigned int i = 0; i < vertices->GetSize(); i++) {
+                    Vector<3,float> v;
+                    vertices->GetElement(i, v);
+                    vertexBounds.Add(v);
+                }
+            }
+            bounds.Add(vertexBounds);
         }
     }
 }
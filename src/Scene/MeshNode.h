@@ -25,7 +25,11 @@ namespace OpenEngine {
 
         /**
          * Mesh node.
-         * Acts as a simple node wrapping a mesh.
+         * Acts as a simple node wrapping a mesh. Call
+         * InvalidateBounds() after changing the vertices of the mesh.
+         * While the vertex data is unloaded, e.g. after upload to the
+         * graphics card, the bounds computed from the loaded data are
+         * kept.
          *
          * @class MeshNode MeshNode.h Scene/MeshNode.h
          */
@@ -41,6 +45,12 @@ namespace OpenEngine {
 
         protected:
             MeshPtr mesh;
+
+            void ComputeBounds(Geometry::Bounds& bounds);
+
+        private:
+            //! bounds of the vertices when last loaded
+            Geometry::Bounds vertexBounds;
             
         };
     }
@@ -0,0 +1,292 @@
+// Pooled allocation of scene nodes.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#include <Scene/NodeAllocator.h>
+#include <Scene/Exceptions.h>
+#include <Core/ThreadStorage.h>
+#include <Core/Atomic.h>
+
+#include <algorithm>
+#include <new>
+
+namespace OpenEngine {
+namespace Scene {
+
+using std::list;
+using std::string;
+using Core::AtomicAdd;
+using Core::Mutex;
+using Core::ThreadStorage;
+
+// alignment of node allocations
+static const size_t ALIGN = 16;
+// size of the allocation header, keeping the node aligned
+static const size_t HEADER = (sizeof(void*) * 2 + ALIGN - 1) & ~(ALIGN - 1);
+// bytes per slab
+static const size_t SLAB = 64 * 1024;
+
+// guards the list of pools
+static Mutex poolsLock;
+
+static size_t Align(size_t size) {
+    return (size + ALIGN - 1) & ~(ALIGN - 1);
+}
+
+// arenas activated on a thread, the active one last
+typedef std::vector<NodeArena*> ArenaStack;
+
+static void ReleaseArenas(void* arenas) {
+    delete static_cast<ArenaStack*>(arenas);
+}
+
+static unsigned int ArenaSlot() {
+    static const unsigned int slot = ThreadStorage::AllocateSlot(ReleaseArenas);
+    return slot;
+}
+
+static ArenaStack* Arenas(bool create) {
+    ThreadStorage& ts = ThreadStorage::Current();
+    ArenaStack* arenas = static_cast<ArenaStack*>(ts.Get(ArenaSlot()));
+    if (arenas == NULL && create) ts.Set(ArenaSlot(), arenas = new ArenaStack());
+    return arenas;
+}
+
+/**
+ * Create a pool.
+ *
+ * @param name Name of the node type.
+ * @param size Size of the node type.
+ */
+NodePool::NodePool(const string& name, size_t size)
+    : name(name), size(size), allocated(0), free(NULL) {
+    size_t slot = Align(size + HEADER);
+    slabSlots = SLAB / slot > 0 ? SLAB / slot : 1;
+    poolsLock.Lock();
+    Pools().push_back(this);
+    poolsLock.Unlock();
+}
+
+NodePool::~NodePool() {
+    poolsLock.Lock();
+    Pools().remove(this);
+    poolsLock.Unlock();
+    for (unsigned int i = 0; i < slabs.size(); i++)
+        ::operator delete(slabs[i]);
+}
+
+list<NodePool*>& NodePool::Pools() {
+    static list<NodePool*> pools;
+    return pools;
+}
+
+/**
+ * Get all node pools, for statistics.
+ */
+list<NodePool*> NodePool::GetPools() {
+    poolsLock.Lock();
+    list<NodePool*> pools = Pools();
+    poolsLock.Unlock();
+    return pools;
+}
+
+const string& NodePool::GetName() const {
+    return name;
+}
+
+size_t NodePool::GetSlotSize() const {
+    return size;
+}
+
+/**
+ * Number of nodes allocated from the pool.
+ */
+unsigned int NodePool::GetAllocated() const {
+    return allocated;
+}
+
+/**
+ * Number of slots in the pool.
+ */
+unsigned int NodePool::GetCapacity() const {
+    return slabs.size() * slabSlots;
+}
+
+// take a slot from the free list, adding a slab if it is empty
+void* NodePool::Take() {
+    lock.Lock();
+    if (free == NULL) {
+        size_t slot = Align(size + HEADER);
+        char* slab = static_cast<char*>(::operator new(slot * slabSlots));
+        slabs.push_back(slab);
+        for (unsigned int i = slabSlots; i > 0; i--) {
+            void* s = slab + (i - 1) * slot;
+            *static_cast<void**>(s) = free;
+            free = s;
+        }
+    }
+    void* s = free;
+    free = *static_cast<void**>(s);
+    allocated++;
+    lock.Unlock();
+    return s;
+}
+
+void NodePool::Give(void* slot) {
+    lock.Lock();
+    *static_cast<void**>(slot) = free;
+    free = slot;
+    allocated--;
+    lock.Unlock();
+}
+
+/**
+ * Allocate a node.
+ * Allocates from the arena active on the calling thread, if any,
+ * else from the pool, or from the heap for nodes larger than the
+ * slots of the pool.
+ *
+ * @param pool Pool of the node type.
+ * @param size Size of the node.
+ * @return Memory for the node.
+ */
+void* NodePool::Allocate(NodePool& pool, size_t size) {
+    Header* h;
+    NodeArena* arena = NodeArena::GetActive();
+    if (arena != NULL) {
+        h = static_cast<Header*>(arena->Allocate(size + HEADER));
+        h->pool = NULL;
+        h->arena = arena;
+    }
+    else if (size <= pool.size) {
+        h = static_cast<Header*>(pool.Take());
+        h->pool = &pool;
+        h->arena = NULL;
+    }
+    else {
+        h = static_cast<Header*>(::operator new(size + HEADER));
+        h->pool = NULL;
+        h->arena = NULL;
+    }
+    return reinterpret_cast<char*>(h) + HEADER;
+}
+
+/**
+ * Free a node allocated by Allocate().
+ * Arena memory is kept until the arena is deleted.
+ */
+void NodePool::Free(void* node) {
+    if (node == NULL) return;
+    Header* h = reinterpret_cast<Header*>(static_cast<char*>(node) - HEADER);
+    if (h->arena != NULL)  h->arena->Free();
+    else if (h->pool != NULL) h->pool->Give(h);
+    else ::operator delete(h);
+}
+
+/**
+ * Create an arena.
+ *
+ * @param chunkSize Size of the chunks the arena allocates.
+ */
+NodeArena::NodeArena(size_t chunkSize)
+    : chunkSize(chunkSize), offset(0), used(0), allocated(0) {}
+
+/**
+ * Delete the arena, freeing the memory of all its nodes at once.
+ * The nodes must have been deleted.
+ */
+NodeArena::~NodeArena() {
+    // forget the arena on the calling thread, even below other arenas
+    ArenaStack* arenas = Arenas(false);
+    if (arenas != NULL)
+        arenas->erase(std::remove(arenas->begin(), arenas->end(), this),
+                      arenas->end());
+    for (unsigned int i = 0; i < chunks.size(); i++)
+        ::operator delete(chunks[i]);
+}
+
+/**
+ * Make the arena the allocator of scene nodes created by the calling
+ * thread, until it is deactivated. Each thread keeps its own stack of
+ * activated arenas, so an arena may be active on several threads and
+ * activated again above other arenas.
+ *
+ * @throws InvalidSceneOperation if the arena is active already.
+ */
+void NodeArena::Activate() {
+    ArenaStack* arenas = Arenas(true);
+    if (!arenas->empty() && arenas->back() == this)
+        throw InvalidSceneOperation("The node arena is already active.");
+    arenas->push_back(this);
+}
+
+/**
+ * Stop allocating from the arena on the calling thread. The arena
+ * that was active before it is active again.
+ */
+void NodeArena::Deactivate() {
+    ArenaStack* arenas = Arenas(false);
+    if (arenas == NULL || arenas->empty() || arenas->back() != this) return;
+    arenas->pop_back();
+}
+
+/**
+ * Get the arena active on the calling thread.
+ *
+ * @return Arena or NULL if nodes are allocated from the pools.
+ */
+NodeArena* NodeArena::GetActive() {
+    ArenaStack* arenas = Arenas(false);
+    return arenas == NULL || arenas->empty() ? NULL : arenas->back();
+}
+
+/**
+ * Number of live nodes in the arena.
+ */
+unsigned int NodeArena::GetAllocated() const {
+    return allocated;
+}
+
+/**
+ * Bytes allocated from the arena.
+ */
+size_t NodeArena::GetUsed() const {
+    return used;
+}
+
+/**
+ * Bytes reserved by the arena.
+ */
+size_t NodeArena::GetCapacity() const {
+    size_t n = 0;
+    for (unsigned int i = 0; i < sizes.size(); i++)
+        n += sizes[i];
+    return n;
+}
+
+void* NodeArena::Allocate(size_t size) {
+    size = Align(size);
+    if (chunks.empty() || offset + size > sizes.back()) {
+        size_t s = size > chunkSize ? size : chunkSize;
+        chunks.push_back(static_cast<char*>(::operator new(s)));
+        sizes.push_back(s);
+        offset = 0;
+    }
+    void* p = chunks.back() + offset;
+    offset += size;
+    used += size;
+    AtomicAdd(allocated, 1);
+    return p;
+}
+
+void NodeArena::Free() {
+    AtomicAdd(allocated, -1);
+}
+
+} // NS Scene
+} // NS OpenEngine
@@ -0,0 +1,137 @@
+// Pooled allocation of scene nodes.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#ifndef _OE_NODE_ALLOCATOR_H_
+#define _OE_NODE_ALLOCATOR_H_
+
+#include <Core/Mutex.h>
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <list>
+
+namespace OpenEngine {
+namespace Scene {
+
+/**
+ * Slab pool for scene nodes of one type.
+ * Every scene node type declared in SceneNodes.def allocates its
+ * nodes from its own pool, through the operator new declared by
+ * OE_SCENE_NODE. The pool carves fixed size slots out of slabs and
+ * recycles freed slots, so creating, cloning and loading nodes does
+ * not fragment the heap.
+ *
+ * Sub classes of node types that are larger than the node type fall
+ * back to the heap. Pools are never shrunk.
+ *
+ * @class NodePool NodeAllocator.h Scene/NodeAllocator.h
+ * @see NodeArena
+ */
+class NodePool {
+public:
+    NodePool(const std::string& name, size_t size);
+    virtual ~NodePool();
+
+    const std::string& GetName() const;
+    size_t GetSlotSize() const;
+    unsigned int GetAllocated() const;
+    unsigned int GetCapacity() const;
+
+    static void* Allocate(NodePool& pool, size_t size);
+    static void Free(void* node);
+
+    static std::list<NodePool*> GetPools();
+
+private:
+    friend class NodeArena;
+
+    //! allocation header in front of every node
+    struct Header {
+        NodePool* pool;         //!< pool of a slot
+        class NodeArena* arena; //!< arena of an arena allocation
+    };
+
+    std::string name;
+    size_t size;
+    unsigned int slabSlots;
+    unsigned int allocated;
+    std::vector<char*> slabs;
+    void* free;
+    Core::Mutex lock;
+
+    static std::list<NodePool*>& Pools();
+
+    void* Take();
+    void Give(void* slot);
+
+    NodePool(const NodePool&);
+    NodePool& operator=(const NodePool&);
+};
+
+/**
+ * Arena for loading or cloning a whole scene.
+ * While an arena is active on a thread all scene nodes created by the
+ * thread are bump allocated from the contiguous chunks of the arena,
+ * regardless of type. Deleting such a node runs its destructor but
+ * keeps the memory, which is freed all at once when the arena is
+ * deleted.
+ *
+ * @code
+ * NodeArena* arena = new NodeArena();
+ * arena->Activate();
+ * ISceneNode* level = reader.ReadScene("level");
+ * arena->Deactivate();
+ * ...
+ * delete level;
+ * delete arena;
+ * @endcode
+ *
+ * All nodes in the arena must be deleted before the arena. Arenas
+ * may be activated on several threads, each thread restoring its own
+ * previous arena on deactivation, but allocation from one arena is
+ * not thread safe.
+ *
+ * @class NodeArena NodeAllocator.h Scene/NodeAllocator.h
+ * @see NodePool
+ */
+class NodeArena {
+public:
+    NodeArena(size_t chunkSize = 1024 * 1024);
+    virtual ~NodeArena();
+
+    void Activate();
+    void Deactivate();
+    static NodeArena* GetActive();
+
+    unsigned int GetAllocated() const;
+    size_t GetUsed() const;
+    size_t GetCapacity() const;
+
+private:
+    friend class NodePool;
+
+    size_t chunkSize;
+    std::vector<char*> chunks;
+    std::vector<size_t> sizes;
+    size_t offset;
+    size_t used;
+    volatile int allocated;
+
+    void* Allocate(size_t size);
+    void Free();
+
+    NodeArena(const NodeArena&);
+    NodeArena& operator=(const NodeArena&);
+};
+
+} // NS Scene
+} // NS OpenEngine
+
+#endif // _OE_NODE_ALLOCATOR_H_
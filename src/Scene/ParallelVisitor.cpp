@@ -0,0 +1,220 @@
+// Parallel scene traversal visitor.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS) 
+// 
+// This program is free software; It is covered by the GNU General 
+// Public License version 2 or any later version. 
+// See the GNU General Public License for more details (see LICENSE). 
+//--------------------------------------------------------------------
+
+#include <Scene/ParallelVisitor.h>
+#include <Scene/ISceneNode.h>
+#include <Core/TaskScheduler.h>
+#include <Core/Exceptions.h>
+#include <Scene/InstanceNode.h>
+#include <Scene/TransformationNode.h>
+#include <Scene/Exceptions.h>
+#include <Resources/Exceptions.h>
+
+#include <typeinfo>
+#include <vector>
+
+namespace OpenEngine {
+namespace Scene {
+
+using Core::ITask;
+using Core::TaskGroup;
+using Core::TaskScheduler;
+using Core::Exception;
+using Math::Quaternion;
+using Math::Vector;
+using Resources::ResourceException;
+using std::string;
+using std::vector;
+
+// ranges per worker when fanning out, to balance uneven sub trees
+static const unsigned int rangesPerWorker = 2;
+
+// Holds an exception of a worker to rethrow it with its type on the
+// forking thread.
+class Error {
+public:
+    virtual ~Error() {}
+    virtual void Throw() = 0;
+};
+
+template <class E>
+class TypedError : public Error {
+    E e;
+public:
+    TypedError(const E& e) : e(e) {}
+    void Throw() { throw e; }
+};
+
+// Visits a range of sub nodes with a fork.
+class ParallelVisitor::RangeTask : public ITask {
+public:
+    ParallelVisitor* visitor;
+    ISceneNode** begin;
+    ISceneNode** end;
+    Error* error;
+    RangeTask() : visitor(NULL), begin(NULL), end(NULL), error(NULL) {}
+    ~RangeTask() { delete error; }
+    void Run() {
+        // exceptions must not escape onto the worker thread, the
+        // engine exceptions are kept with their type
+        try {
+            for (ISceneNode** n = begin; n != end; n++)
+                (*n)->Accept(*visitor);
+        } catch (InvalidSceneOperation& e) {
+            error = new TypedError<InvalidSceneOperation>(e);
+        } catch (ResourceException& e) {
+            error = new TypedError<ResourceException>(e);
+        } catch (Core::InvalidArgument& e) {
+            error = new TypedError<Core::InvalidArgument>(e);
+        } catch (Core::NotImplemented& e) {
+            error = new TypedError<Core::NotImplemented>(e);
+        } catch (Exception& e) {
+            error = new TypedError<Exception>(e);
+        } catch (std::exception& e) {
+            error = new TypedError<Exception>
+                (Exception(string(typeid(e).name()) + ": " + e.what()));
+        } catch (...) {
+            error = new TypedError<Exception>
+                (Exception("Unknown exception in parallel scene traversal."));
+        }
+    }
+};
+
+/**
+ * Fill the lazy world transformation and bounds caches of a sub tree
+ * and of the prototypes of its instances, so forks visiting the same
+ * prototype only read them. Changes invalidate the bounds up to the
+ * root, which marks the path to them, so only the changed parts of
+ * the sub tree are visited.
+ */
+void ParallelVisitor::UpdateCaches(ISceneNode* root) {
+    if (!root->cachesDirty) return;
+    root->GetBounds();
+    vector<ISceneNode*> nodes(1, root);
+    while (!nodes.empty()) {
+        ISceneNode* node = nodes.back();
+        nodes.pop_back();
+        if (!node->cachesDirty) continue;
+        node->cachesDirty = false;
+        TransformationNode* t = dynamic_cast<TransformationNode*>(node);
+        if (t != NULL && t->IsWorldTransformationDirty()) {
+            Vector<3,float> position;
+            Quaternion<float> rotation;
+            t->GetAccumulatedTransformations(&position, &rotation);
+        }
+        InstanceNode* instance = dynamic_cast<InstanceNode*>(node);
+        if (instance != NULL && instance->GetPrototype()) {
+            ISceneNode* prototype = instance->GetPrototype().get();
+            prototype->GetBounds();
+            nodes.push_back(prototype);
+        }
+        nodes.insert(nodes.end(), node->subNodes.begin(), node->subNodes.end());
+    }
+}
+
+/**
+ * Create a parallel visitor.
+ *
+ * @param scheduler Scheduler to fan out on, NULL for serial traversal.
+ */
+ParallelVisitor::ParallelVisitor(TaskScheduler* scheduler)
+    : scheduler(scheduler), forkDepth(4), depth(0) {
+}
+
+ParallelVisitor::~ParallelVisitor() {}
+
+/**
+ * Traverse a scene.
+ *
+ * @param root Root of the scene.
+ */
+void ParallelVisitor::Traverse(ISceneNode& root) {
+    root.Accept(*this);
+}
+
+void ParallelVisitor::SetScheduler(TaskScheduler* scheduler) {
+    this->scheduler = scheduler;
+}
+
+TaskScheduler* ParallelVisitor::GetScheduler() const {
+    return scheduler;
+}
+
+/**
+ * Set the number of nested levels at which the traversal fans out.
+ * Below that sub trees are visited serially by the fork that reached
+ * them. Defaults to 4.
+ */
+void ParallelVisitor::SetForkDepth(unsigned int depth) {
+    forkDepth = depth;
+}
+
+unsigned int ParallelVisitor::GetForkDepth() const {
+    return forkDepth;
+}
+
+/**
+ * Visit the sub nodes of a node, in parallel if possible.
+ *
+ * @param node Node whose sub nodes to visit.
+ * @throws Exception if visiting a sub tree on a worker failed, as
+ *         thrown if it is an engine exception.
+ */
+void ParallelVisitor::VisitSubNodes(ISceneNode* node) {
+    unsigned int size = node->subNodes.size();
+    if (scheduler == NULL || scheduler->GetWorkerCount() == 0 ||
+        depth >= forkDepth || size < 2) {
+        node->VisitSubNodes(*this);
+        return;
+    }
+
+    // the forks share the caches of the sub tree, so fill them first
+    if (depth == 0) UpdateCaches(node);
+
+    vector<ISceneNode*> subs(node->subNodes.begin(), node->subNodes.end());
+    unsigned int count = (scheduler->GetWorkerCount() + 1) * rangesPerWorker;
+    if (count > size) count = size;
+
+    vector<RangeTask> tasks(count);
+    TaskGroup group;
+    for (unsigned int i = 0; i < count; i++) {
+        RangeTask& t = tasks[i];
+        t.visitor = Fork();
+        t.visitor->scheduler = scheduler;
+        t.visitor->forkDepth = forkDepth;
+        t.visitor->depth = depth + 1;
+        t.begin = &subs[0] + i * size / count;
+        t.end = &subs[0] + (i + 1) * size / count;
+        scheduler->Spawn(t, group);
+    }
+    scheduler->Wait(group);
+
+    Error* error = NULL;
+    for (unsigned int i = 0; i < count; i++) {
+        if (error == NULL) error = tasks[i].error;
+        Join(*tasks[i].visitor);
+        delete tasks[i].visitor;
+    }
+    if (error != NULL) error->Throw();
+
+    // the prototype of an instance is not among its sub nodes
+    InstanceNode* instance = dynamic_cast<InstanceNode*>(node);
+    if (instance != NULL && instance->GetPrototype())
+        instance->GetPrototype()->Accept(*this);
+}
+
+/**
+ * Default visit, visits the sub nodes.
+ */
+void ParallelVisitor::DefaultVisitNode(ISceneNode* node) {
+    VisitSubNodes(node);
+}
+
+} // NS Scene
+} // NS OpenEngine
@@ -0,0 +1,115 @@
+// Parallel scene traversal visitor.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS) 
+// 
+// This program is free software; It is covered by the GNU General 
+// Public License version 2 or any later version. 
+// See the GNU General Public License for more details (see LICENSE). 
+//--------------------------------------------------------------------
+
+#ifndef _OE_PARALLEL_VISITOR_H_
+#define _OE_PARALLEL_VISITOR_H_
+
+#include <Scene/ISceneNodeVisitor.h>
+
+#include <cstddef>
+
+namespace OpenEngine {
+    namespace Core {
+        class TaskScheduler;
+    }
+namespace Scene {
+
+/**
+ * Parallel scene traversal visitor.
+ * Visits independent sub trees on the workers of a TaskScheduler.
+ * Where the traversal fans out the sub nodes are split into ranges,
+ * each visited by a fork of the visitor created with Fork(). When
+ * all ranges are done the forks are merged back with Join(), in the
+ * order of the sub nodes, so the result of a pass is the same as for
+ * a serial traversal.
+ *
+ * @code
+ * class CountVisitor : public ParallelVisitor {
+ * public:
+ *     unsigned int count;
+ *     CountVisitor(TaskScheduler* s) : ParallelVisitor(s), count(0) {}
+ *     void VisitGeometryNode(GeometryNode* node) {
+ *         count++;
+ *         VisitSubNodes(node);
+ *     }
+ * protected:
+ *     ParallelVisitor* Fork() { return new CountVisitor(NULL); }
+ *     void Join(ParallelVisitor& fork) {
+ *         count += ((CountVisitor&)fork).count;
+ *     }
+ * };
+ * @endcode
+ *
+ * Visit methods must call VisitSubNodes() (or rely on the default
+ * visit) instead of node->VisitSubNodes() for the traversal to fan
+ * out. Forks only fan out further up to the fork depth. Passes must
+ * not change the scene structure, except for removing and deleting
+ * nodes, which are delayed until the traversal has left the parent
+ * and then performed one at a time.
+ * Before the first fan out the cached world transformations and
+ * bounds of the sub tree, and of the prototypes of its instances,
+ * are brought up to date, so forks can query them concurrently. Only
+ * the parts changed since the last parallel traversal are visited
+ * for this; a change to a shared prototype must invalidate the bounds
+ * of its instances, as required by InstanceNode. An engine exception
+ * thrown by a fork is rethrown with its type after the join.
+ * Without a scheduler, or one without workers, the traversal is
+ * serial.
+ *
+ * @class ParallelVisitor ParallelVisitor.h Scene/ParallelVisitor.h
+ * @see TaskScheduler
+ */
+class ParallelVisitor : public ISceneNodeVisitor {
+public:
+    ParallelVisitor(Core::TaskScheduler* scheduler = NULL);
+    virtual ~ParallelVisitor();
+
+    void Traverse(ISceneNode& root);
+
+    void SetScheduler(Core::TaskScheduler* scheduler);
+    Core::TaskScheduler* GetScheduler() const;
+    void SetForkDepth(unsigned int depth);
+    unsigned int GetForkDepth() const;
+
+protected:
+    /**
+     * Create a visitor for a range of sub trees.
+     * The fork should carry the configuration of the pass but start
+     * with an empty result.
+     *
+     * @return New visitor, deleted by the traversal after joining.
+     */
+    virtual ParallelVisitor* Fork() = 0;
+
+    /**
+     * Merge the result of a fork into this visitor.
+     * Forks are joined in sub node order on the thread that forked
+     * them.
+     *
+     * @param fork Visitor returned by Fork().
+     */
+    virtual void Join(ParallelVisitor& fork) = 0;
+
+    void VisitSubNodes(ISceneNode* node);
+    virtual void DefaultVisitNode(ISceneNode* node);
+
+private:
+    class RangeTask;
+
+    static void UpdateCaches(ISceneNode* root);
+
+    Core::TaskScheduler* scheduler;
+    unsigned int forkDepth;
+    unsigned int depth;
+};
+
+} // NS Scene
+} // NS OpenEngine
+
+#endif // _OE_PARALLEL_VISITOR_H_
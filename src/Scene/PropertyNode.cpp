@@ -8,6 +8,8 @@
 //--------------------------------------------------------------------
 
 #include <Scene/PropertyNode.h>
+#include <Scene/SceneIndex.h>
+#include <Scene/SceneJournal.h>
 #include <Core/Exceptions.h>
 #include <Utils/Convert.h>
 
@@ -122,14 +124,20 @@ std::string PropertyNode::Property::AsString() {
  * Set property \a key to the integer \a value.
  */
 void PropertyNode::SetProperty(std::string key, int value) {
-    props[key] = Property(value);
+    props.erase(key);
+    props.insert(make_pair(key, Property(value)));
+    SceneIndex::NodeChanged(this);
+    SceneJournal::StateChanged(this);
 }
 
 /**
  * Set property \a key to the float \a value.
  */
 void PropertyNode::SetProperty(std::string key, float value) {
-    props[key] = Property(value);
+    props.erase(key);
+    props.insert(make_pair(key, Property(value)));
+    SceneIndex::NodeChanged(this);
+    SceneJournal::StateChanged(this);
 }
 
 /**
@@ -144,7 +152,10 @@ void PropertyNode::SetProperty(std::string key, double value) {
  * Set property \a key to the string \a value.
  */
 void PropertyNode::SetProperty(std::string key, std::string value) {
-    props[key] = Property(value);
+    props.erase(key);
+    props.insert(make_pair(key, Property(value)));
+    SceneIndex::NodeChanged(this);
+    SceneJournal::StateChanged(this);
 }
 
 /**
@@ -65,6 +65,7 @@ public:
         std::string AsString();
     private:
         friend class PropertyNode;
+        friend class SceneIndex;
         // needed for creating default entries in stl-maps
         friend class std::map<std::string,Property>;
         // type enum and field (for run-time types)
@@ -88,6 +89,7 @@ public:
     Property GetProperty(std::string key);
 
 private:
+    friend class SceneIndex;
     std::map<std::string, Property> props;
 
 };
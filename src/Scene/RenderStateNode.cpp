@@ -8,6 +8,7 @@
 //--------------------------------------------------------------------
 
 #include <Scene/RenderStateNode.h>
+#include <Scene/SceneJournal.h>
 #include <Resources/IArchiveWriter.h>
 #include <Resources/IArchiveReader.h>
 #include <string>
@@ -96,6 +97,7 @@ void RenderStateNode::EnableOption(RenderStateOption options) {
     // add to enabled
     unsigned int optEn = enabled | (unsigned int)options;
     enabled = (RenderStateOption)optEn;
+    SceneJournal::StateChanged(this);
 }
 
 /**
@@ -113,12 +115,14 @@ void RenderStateNode::DisableOption(RenderStateOption options) {
     // add to disabled
     unsigned int optDis = disabled | (unsigned int)options;
     disabled = (RenderStateOption)optDis;
+    SceneJournal::StateChanged(this);
 }
 
 void RenderStateNode::InheritOption(RenderStateOption options) {
     // remove from enabled and disabled
     enabled  = (RenderStateOption) (enabled  & ~((unsigned int)options));
     disabled = (RenderStateOption) (disabled & ~((unsigned int)options));
+    SceneJournal::StateChanged(this);
 }
 
 /**
@@ -161,6 +165,7 @@ void RenderStateNode::Invert() {
     RenderStateOption tmp = this->enabled;
     this->enabled  = this->disabled;
     this->disabled = tmp;
+    SceneJournal::StateChanged(this);
 }
 
 /**
@@ -0,0 +1,200 @@
+// Incremental scene node index.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#include <Scene/SceneIndex.h>
+#include <Scene/ISceneNode.h>
+#include <Scene/PropertyNode.h>
+#include <Scene/Exceptions.h>
+
+namespace OpenEngine {
+namespace Scene {
+
+using std::list;
+using std::map;
+using std::string;
+
+map<ISceneNode*, SceneIndex*> SceneIndex::indices;
+const SceneIndex::NodeSet SceneIndex::none;
+
+/**
+ * Create an index for a scene.
+ *
+ * @param root Root of the scene.
+ * @throws InvalidSceneOperation if the scene is already indexed.
+ */
+SceneIndex::SceneIndex(ISceneNode* root) : root(root) {
+    if (root == NULL)
+        throw InvalidSceneOperation("A scene index needs a root.");
+    if (Find(root) != NULL)
+        throw InvalidSceneOperation("The scene is already indexed.");
+    indices[root] = this;
+    Insert(root);
+}
+
+SceneIndex::~SceneIndex() {
+    indices.erase(root);
+}
+
+ISceneNode* SceneIndex::GetRoot() const {
+    return root;
+}
+
+/**
+ * Number of indexed nodes, including the root.
+ */
+unsigned int SceneIndex::GetSize() const {
+    return entries.size();
+}
+
+bool SceneIndex::Contains(ISceneNode* node) const {
+    return entries.find(node) != entries.end();
+}
+
+/**
+ * Get all nodes of a type.
+ *
+ * @param type Type name, see ISceneNode::GetTypeName.
+ */
+SceneIndex::View<ISceneNode> SceneIndex::GetNodesOfType(const string& type) const {
+    return View<ISceneNode>(Lookup(types, type));
+}
+
+/**
+ * Get all nodes with an info string.
+ */
+SceneIndex::View<ISceneNode> SceneIndex::GetNodesWithInfo(const string& info) const {
+    return View<ISceneNode>(Lookup(infos, info));
+}
+
+/**
+ * Get all property nodes with a string property.
+ * Matches as PropertyNode::Property::Match, so properties of other
+ * types never match.
+ */
+SceneIndex::View<PropertyNode> SceneIndex::GetPropertyNodesWith(const string& key,
+                                                                const string& value) const {
+    return View<PropertyNode>(Lookup(properties, PropertyKey(key, value)));
+}
+
+/**
+ * Find the index of the scene a node belongs to.
+ *
+ * @return Index or NULL if the node is not in an indexed scene.
+ */
+SceneIndex* SceneIndex::Find(ISceneNode* node) {
+    if (indices.empty()) return NULL;
+    for (; node != NULL; node = node->GetParent()) {
+        map<ISceneNode*, SceneIndex*>::iterator i = indices.find(node);
+        if (i != indices.end()) return i->second;
+    }
+    return NULL;
+}
+
+/**
+ * Get the index of a scene root.
+ *
+ * @return Index or NULL if the root is not indexed.
+ */
+SceneIndex* SceneIndex::Get(ISceneNode* root) {
+    map<ISceneNode*, SceneIndex*>::iterator i = indices.find(root);
+    return i == indices.end() ? NULL : i->second;
+}
+
+/**
+ * Index a sub tree that was added to a scene.
+ * Called by the scene node after linking the node in.
+ */
+void SceneIndex::NodeAdded(ISceneNode* node) {
+    SceneIndex* index = Find(node->GetParent());
+    if (index) index->Insert(node);
+}
+
+/**
+ * Unindex a sub tree that is removed from a scene.
+ * Called by the scene node before unlinking or deleting the node.
+ */
+void SceneIndex::NodeRemoved(ISceneNode* node) {
+    SceneIndex* index = Find(node->GetParent());
+    if (index) index->Erase(node);
+}
+
+/**
+ * Reindex a node whose info or properties changed.
+ */
+void SceneIndex::NodeChanged(ISceneNode* node) {
+    SceneIndex* index = Find(node);
+    if (index == NULL) return;
+    index->Unindex(node);
+    index->Index(node);
+}
+
+void SceneIndex::Insert(ISceneNode* node) {
+    Index(node);
+    list<ISceneNode*>::iterator itr;
+    for (itr = node->subNodes.begin(); itr != node->subNodes.end(); itr++)
+        Insert(*itr);
+}
+
+void SceneIndex::Erase(ISceneNode* node) {
+    Unindex(node);
+    list<ISceneNode*>::iterator itr;
+    for (itr = node->subNodes.begin(); itr != node->subNodes.end(); itr++)
+        Erase(*itr);
+}
+
+void SceneIndex::Index(ISceneNode* node) {
+    Entry& e = entries[node];
+    e.type = node->GetTypeName();
+    e.info = node->GetInfo();
+    e.properties.clear();
+    types[e.type].insert(node);
+    infos[e.info].insert(node);
+    PropertyNode* p = dynamic_cast<PropertyNode*>(node);
+    if (p == NULL) return;
+    map<string, PropertyNode::Property>::iterator itr;
+    for (itr = p->props.begin(); itr != p->props.end(); itr++) {
+        if (itr->second.type != PropertyNode::Property::STRING) continue;
+        string key = PropertyKey(itr->first, itr->second.str);
+        e.properties.push_back(key);
+        properties[key].insert(node);
+    }
+}
+
+void SceneIndex::Unindex(ISceneNode* node) {
+    map<ISceneNode*, Entry>::iterator itr = entries.find(node);
+    if (itr == entries.end()) return;
+    Entry& e = itr->second;
+    Remove(types, e.type, node);
+    Remove(infos, e.info, node);
+    for (unsigned int i = 0; i < e.properties.size(); i++)
+        Remove(properties, e.properties[i], node);
+    entries.erase(itr);
+}
+
+const SceneIndex::NodeSet& SceneIndex::Lookup(const map<string, NodeSet>& m,
+                                              const string& key) {
+    map<string, NodeSet>::const_iterator itr = m.find(key);
+    return itr == m.end() ? none : itr->second;
+}
+
+// remove a node from a set, keeping the set when it becomes empty as
+// views may refer to it
+void SceneIndex::Remove(map<string, NodeSet>& m, const string& key,
+                        ISceneNode* node) {
+    map<string, NodeSet>::iterator itr = m.find(key);
+    if (itr == m.end()) return;
+    itr->second.erase(node);
+}
+
+string SceneIndex::PropertyKey(const string& key, const string& value) {
+    return key + '\0' + value;
+}
+
+} // NS Scene
+} // NS OpenEngine
@@ -0,0 +1,172 @@
+// Incremental scene node index.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#ifndef _OE_SCENE_INDEX_H_
+#define _OE_SCENE_INDEX_H_
+
+#include <set>
+#include <map>
+#include <list>
+#include <string>
+#include <vector>
+#include <iterator>
+#include <cstddef>
+
+namespace OpenEngine {
+namespace Scene {
+
+class ISceneNode;
+class PropertyNode;
+
+/**
+ * Incremental scene node index.
+ * Indexes the nodes of a scene by type name, by the string
+ * properties of property nodes and by info string. Nodes added to or
+ * removed from the scene are indexed and unindexed as the scene
+ * changes, so lookups are logarithmic in the size of the index
+ * instead of a traversal of the scene.
+ *
+ * @code
+ * SceneIndex* index = new SceneIndex(scene);
+ * // all property nodes with id=gun, without traversing the scene
+ * SceneIndex::View<PropertyNode> guns =
+ *     index->GetPropertyNodesWith("id", "gun");
+ * for (SceneIndex::View<PropertyNode>::iterator itr = guns.begin();
+ *      itr != guns.end(); itr++)
+ *     ...
+ * @endcode
+ *
+ * Queries return views of the index rather than copies. A view
+ * stays valid as long as the index and follows later changes of the
+ * scene, except that a query no node has matched yet returns a view
+ * that stays empty. Iterators of a view are invalidated when the
+ * scene changes. Results are ordered by node address, not by
+ * position in the scene. Like the type selectors of
+ * SearchTool the type index matches the exact node type.
+ *
+ * The index must be deleted before the scene. Updating the index is
+ * not thread safe, so the scene must only change from one thread at
+ * a time.
+ *
+ * @class SceneIndex SceneIndex.h Scene/SceneIndex.h
+ * @see SearchTool
+ */
+class SceneIndex {
+public:
+    //! Set of indexed nodes.
+    typedef std::set<ISceneNode*> NodeSet;
+
+    /**
+     * Read only view of a set of indexed nodes of type \a T.
+     *
+     * @class View SceneIndex.h Scene/SceneIndex.h
+     */
+    template <class T>
+    class View {
+    public:
+        class iterator {
+        public:
+            typedef std::forward_iterator_tag iterator_category;
+            typedef T* value_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef T* const* pointer;
+            typedef T* reference;
+
+            iterator() {}
+            iterator(NodeSet::const_iterator itr) : itr(itr) {}
+            T* operator*() const { return static_cast<T*>(*itr); }
+            iterator& operator++() { ++itr; return *this; }
+            iterator operator++(int) { iterator i = *this; ++itr; return i; }
+            bool operator==(const iterator& i) const { return itr == i.itr; }
+            bool operator!=(const iterator& i) const { return itr != i.itr; }
+        private:
+            NodeSet::const_iterator itr;
+        };
+
+        View(const NodeSet& nodes) : nodes(&nodes) {}
+
+        iterator begin() const { return iterator(nodes->begin()); }
+        iterator end() const { return iterator(nodes->end()); }
+        unsigned int size() const { return nodes->size(); }
+        bool empty() const { return nodes->empty(); }
+        bool Contains(ISceneNode* node) const {
+            return nodes->find(node) != nodes->end();
+        }
+        //! Any node in the view, NULL if the view is empty.
+        T* Any() const {
+            return nodes->empty() ? NULL : static_cast<T*>(*nodes->begin());
+        }
+        //! The nodes of the view.
+        const NodeSet& GetNodeSet() const { return *nodes; }
+        //! Copy the view into a list.
+        std::list<T*> ToList() const {
+            return std::list<T*>(begin(), end());
+        }
+
+    private:
+        const NodeSet* nodes;
+    };
+
+    SceneIndex(ISceneNode* root);
+    virtual ~SceneIndex();
+
+    ISceneNode* GetRoot() const;
+    unsigned int GetSize() const;
+    bool Contains(ISceneNode* node) const;
+
+    View<ISceneNode> GetNodesOfType(const std::string& type) const;
+    View<ISceneNode> GetNodesWithInfo(const std::string& info) const;
+    View<PropertyNode> GetPropertyNodesWith(const std::string& key,
+                                            const std::string& value) const;
+
+    static SceneIndex* Find(ISceneNode* node);
+    static SceneIndex* Get(ISceneNode* root);
+
+    static void NodeAdded(ISceneNode* node);
+    static void NodeRemoved(ISceneNode* node);
+    static void NodeChanged(ISceneNode* node);
+
+private:
+    //! index keys of a node, for unindexing
+    struct Entry {
+        std::string type;
+        std::string info;
+        std::vector<std::string> properties;
+    };
+
+    ISceneNode* root;
+    std::map<std::string, NodeSet> types;
+    std::map<std::string, NodeSet> infos;
+    std::map<std::string, NodeSet> properties;
+    std::map<ISceneNode*, Entry> entries;
+
+    //! indices by root node
+    static std::map<ISceneNode*, SceneIndex*> indices;
+    static const NodeSet none;
+
+    void Insert(ISceneNode* node);
+    void Erase(ISceneNode* node);
+    void Index(ISceneNode* node);
+    void Unindex(ISceneNode* node);
+
+    static const NodeSet& Lookup(const std::map<std::string, NodeSet>& m,
+                                 const std::string& key);
+    static void Remove(std::map<std::string, NodeSet>& m,
+                       const std::string& key, ISceneNode* node);
+    static std::string PropertyKey(const std::string& key,
+                                   const std::string& value);
+
+    SceneIndex(const SceneIndex&);
+    SceneIndex& operator=(const SceneIndex&);
+};
+
+} // NS Scene
+} // NS OpenEngine
+
+#endif // _OE_SCENE_INDEX_H_
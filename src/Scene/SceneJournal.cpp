@@ -0,0 +1,256 @@
+// Journal of scene changes.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#include <Scene/SceneJournal.h>
+#include <Scene/ISceneNode.h>
+#include <Scene/Exceptions.h>
+
+#include <list>
+
+namespace OpenEngine {
+namespace Scene {
+
+using std::list;
+using std::map;
+using std::set;
+using std::vector;
+
+map<ISceneNode*, SceneJournal*> SceneJournal::journals;
+
+/**
+ * Start recording the changes of a scene.
+ *
+ * @param root Root of the scene.
+ * @throws InvalidSceneOperation if the scene already has a journal.
+ */
+SceneJournal::SceneJournal(ISceneNode* root)
+    : root(root), frame(0), dropped(0) {
+    if (root == NULL)
+        throw InvalidSceneOperation("A scene journal needs a root.");
+    if (Find(root) != NULL)
+        throw InvalidSceneOperation("The scene already has a journal.");
+    journals[root] = this;
+}
+
+SceneJournal::~SceneJournal() {
+    journals.erase(root);
+}
+
+ISceneNode* SceneJournal::GetRoot() const {
+    return root;
+}
+
+/**
+ * Get the changes of the current frame in the order they were made.
+ * Deleting nodes only marks their records, which are removed here,
+ * so get the changes again after changing the scene.
+ */
+const vector<SceneJournal::Change>& SceneJournal::GetChanges() const {
+    if (dropped > 0) Compact();
+    return changes;
+}
+
+bool SceneJournal::IsEmpty() const {
+    return changes.size() == dropped;
+}
+
+/**
+ * Number of frames ended by NextFrame.
+ */
+unsigned int SceneJournal::GetFrame() const {
+    return frame;
+}
+
+/**
+ * End the frame, discarding its changes.
+ * Call once a frame after every consumer has read the changes.
+ */
+void SceneJournal::NextFrame() {
+    changes.clear();
+    dropped = 0;
+    records.clear();
+    removed.clear();
+    transformed.clear();
+    changed.clear();
+    frame++;
+}
+
+/**
+ * Find the journal of the scene a node belongs to.
+ *
+ * @return Journal or NULL if the node is not in a journaled scene.
+ */
+SceneJournal* SceneJournal::Find(ISceneNode* node) {
+    if (journals.empty()) return NULL;
+    for (; node != NULL; node = node->GetParent()) {
+        map<ISceneNode*, SceneJournal*>::iterator i = journals.find(node);
+        if (i != journals.end()) return i->second;
+    }
+    return NULL;
+}
+
+/**
+ * Get the journal of a scene root.
+ *
+ * @return Journal or NULL if the root has no journal.
+ */
+SceneJournal* SceneJournal::Get(ISceneNode* root) {
+    map<ISceneNode*, SceneJournal*>::iterator i = journals.find(root);
+    return i == journals.end() ? NULL : i->second;
+}
+
+/**
+ * Record a sub tree added to a scene.
+ * Called by the scene node after linking the node in.
+ */
+void SceneJournal::NodeAdded(ISceneNode* node) {
+    SceneJournal* journal = Find(node->GetParent());
+    if (journal) journal->Add(node);
+}
+
+/**
+ * Record a sub tree removed from a scene.
+ * Called by the scene node before unlinking the node.
+ */
+void SceneJournal::NodeRemoved(ISceneNode* node) {
+    SceneJournal* journal = Find(node->GetParent());
+    if (journal) journal->Remove(node);
+}
+
+/**
+ * Record the deletion of a sub tree in a scene.
+ * Called by the scene node before unlinking and deleting the node.
+ */
+void SceneJournal::NodeDeleted(ISceneNode* node) {
+    SceneJournal* journal = Find(node->GetParent());
+    if (journal) journal->Delete(node);
+}
+
+/**
+ * Record a change of the local transformation of a node.
+ */
+void SceneJournal::TransformChanged(ISceneNode* node) {
+    SceneJournal* journal = Find(node);
+    if (journal && journal->transformed.insert(node).second)
+        journal->Record(Change(TRANSFORM_CHANGED, node));
+}
+
+/**
+ * Record a change of the render state, properties or contents of a
+ * node.
+ */
+void SceneJournal::StateChanged(ISceneNode* node) {
+    SceneJournal* journal = Find(node);
+    if (journal && journal->changed.insert(node).second)
+        journal->Record(Change(STATE_CHANGED, node));
+}
+
+void SceneJournal::Add(ISceneNode* node) {
+    map<ISceneNode*, unsigned int>::iterator r = removed.find(node);
+    if (r == removed.end()) {
+        Record(Change(NODE_ADDED, node, node->GetParent()));
+        return;
+    }
+    // removed earlier in the frame, so it moved
+    Change& c = changes[r->second];
+    c.type = NODE_REPARENTED;
+    c.parent = node->GetParent();
+    Index(c.parent, r->second);
+    removed.erase(r);
+}
+
+void SceneJournal::Remove(ISceneNode* node) {
+    removed[node] = changes.size();
+    Record(Change(NODE_REMOVED, node, NULL, node->GetParent()));
+}
+
+void SceneJournal::Delete(ISceneNode* node) {
+    set<ISceneNode*> nodes;
+    Collect(node, nodes);
+
+    // drop the records of the deleted nodes and forget their pointers,
+    // visiting only the records that refer to them
+    set<ISceneNode*>::iterator itr;
+    for (itr = nodes.begin(); itr != nodes.end(); itr++) {
+        map<ISceneNode*, vector<unsigned int> >::iterator r = records.find(*itr);
+        if (r != records.end()) {
+            vector<unsigned int>& refs = r->second;
+            for (unsigned int i = 0; i < refs.size(); i++) {
+                Change& c = changes[refs[i]];
+                if (c.node == NULL) continue;
+                if (nodes.find(c.node) != nodes.end()) {
+                    c.node = NULL;
+                    dropped++;
+                    continue;
+                }
+                if (nodes.find(c.parent) != nodes.end()) c.parent = NULL;
+                if (nodes.find(c.previous) != nodes.end()) c.previous = NULL;
+            }
+            records.erase(r);
+        }
+        removed.erase(*itr);
+        transformed.erase(*itr);
+        changed.erase(*itr);
+    }
+
+    // record every deleted node, parents first. The deleted nodes are
+    // only keys, so just the parent of the root is indexed.
+    changes.push_back(Change(NODE_DELETED, node, NULL, node->GetParent()));
+    Index(node->GetParent(), changes.size() - 1);
+    list<ISceneNode*> queue(node->subNodes.begin(), node->subNodes.end());
+    while (!queue.empty()) {
+        ISceneNode* sub = queue.front();
+        queue.pop_front();
+        changes.push_back(Change(NODE_DELETED, sub));
+        queue.insert(queue.end(), sub->subNodes.begin(), sub->subNodes.end());
+    }
+}
+
+// append a record and index it by the nodes it refers to
+void SceneJournal::Record(const Change& change) {
+    changes.push_back(change);
+    unsigned int i = changes.size() - 1;
+    Index(change.node, i);
+    Index(change.parent, i);
+    Index(change.previous, i);
+}
+
+void SceneJournal::Index(ISceneNode* node, unsigned int record) const {
+    if (node != NULL) records[node].push_back(record);
+}
+
+// remove the dropped records, keeping the order, and renumber the
+// indices
+void SceneJournal::Compact() const {
+    unsigned int n = 0;
+    records.clear();
+    removed.clear();
+    for (unsigned int i = 0; i < changes.size(); i++) {
+        const Change& c = changes[i];
+        if (c.node == NULL) continue;
+        changes[n] = c;
+        if (c.type != NODE_DELETED) Index(c.node, n);
+        Index(c.parent, n);
+        Index(c.previous, n);
+        if (c.type == NODE_REMOVED) removed[c.node] = n;
+        n++;
+    }
+    changes.resize(n, Change(NODE_DELETED, NULL));
+    dropped = 0;
+}
+
+void SceneJournal::Collect(ISceneNode* node, set<ISceneNode*>& nodes) {
+    nodes.insert(node);
+    list<ISceneNode*>::iterator itr;
+    for (itr = node->subNodes.begin(); itr != node->subNodes.end(); itr++)
+        Collect(*itr, nodes);
+}
+
+} // NS Scene
+} // NS OpenEngine
@@ -0,0 +1,141 @@
+// Journal of scene changes.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#ifndef _OE_SCENE_JOURNAL_H_
+#define _OE_SCENE_JOURNAL_H_
+
+#include <map>
+#include <set>
+#include <vector>
+#include <cstddef>
+
+namespace OpenEngine {
+namespace Scene {
+
+class ISceneNode;
+
+/**
+ * Journal of scene changes.
+ * Records the structural and state changes of a scene as compact
+ * change records, so systems mirroring the scene, such as renderers,
+ * spatial indices and physics, can update in time proportional to
+ * what changed during a frame instead of traversing the whole scene.
+ *
+ * @code
+ * SceneJournal* journal = new SceneJournal(scene);
+ * ...
+ * // once a frame, after the scene has been updated
+ * const vector<SceneJournal::Change>& changes = journal->GetChanges();
+ * for (unsigned int i = 0; i < changes.size(); i++)
+ *     switch (changes[i].type) {
+ *     case SceneJournal::NODE_ADDED: ...
+ *     }
+ * journal->NextFrame();
+ * @endcode
+ *
+ * Records are kept in the order of the changes and coalesced per
+ * frame: a node removed and added again becomes one reparent record
+ * and a node changing its transformation or state several times is
+ * recorded once. Adding or removing a sub tree is recorded for its
+ * root only, while deleting a sub tree records every deleted node,
+ * so mirrors can drop their copies without knowing the tree. Records
+ * of nodes deleted later in the frame are dropped, parents deleted
+ * later in the frame are NULL, and the node of a deletion record may
+ * only be used as a key.
+ *
+ * The journal only sees changes made through the scene node
+ * methods. Nodes removed from the scene must not be deleted until
+ * the frame has been read, use DeleteNode to delete nodes in the
+ * scene. The journal must be deleted before the scene, and recording
+ * is not thread safe, so the scene must only change from one thread
+ * at a time.
+ *
+ * @class SceneJournal SceneJournal.h Scene/SceneJournal.h
+ * @see SceneIndex
+ */
+class SceneJournal {
+public:
+    //! Kinds of changes.
+    enum ChangeType {
+        NODE_ADDED,        //!< sub tree added to the scene
+        NODE_REMOVED,      //!< sub tree removed from the scene
+        NODE_DELETED,      //!< node deleted
+        NODE_REPARENTED,   //!< sub tree moved within the scene
+        TRANSFORM_CHANGED, //!< local transformation changed
+        STATE_CHANGED      //!< render state, properties or contents changed
+    };
+
+    //! Change record.
+    struct Change {
+        ChangeType type;
+        ISceneNode* node;
+        //! parent after a structural change, else NULL
+        ISceneNode* parent;
+        //! parent before a structural change, else NULL
+        ISceneNode* previous;
+
+        Change(ChangeType type, ISceneNode* node,
+               ISceneNode* parent = NULL, ISceneNode* previous = NULL)
+            : type(type), node(node), parent(parent), previous(previous) {}
+    };
+
+    SceneJournal(ISceneNode* root);
+    virtual ~SceneJournal();
+
+    ISceneNode* GetRoot() const;
+    const std::vector<Change>& GetChanges() const;
+    bool IsEmpty() const;
+    unsigned int GetFrame() const;
+    void NextFrame();
+
+    static SceneJournal* Find(ISceneNode* node);
+    static SceneJournal* Get(ISceneNode* root);
+
+    static void NodeAdded(ISceneNode* node);
+    static void NodeRemoved(ISceneNode* node);
+    static void NodeDeleted(ISceneNode* node);
+    static void TransformChanged(ISceneNode* node);
+    static void StateChanged(ISceneNode* node);
+
+private:
+    ISceneNode* root;
+    unsigned int frame;
+
+    // records of deleted nodes are dropped by clearing their node and
+    // compacted away when the changes are read
+    mutable std::vector<Change> changes;
+    mutable unsigned int dropped;
+
+    //! records by the nodes they refer to, as node, parent or previous
+    mutable std::map<ISceneNode*, std::vector<unsigned int> > records;
+
+    //! record of the last removal of a node in this frame
+    mutable std::map<ISceneNode*, unsigned int> removed;
+    //! nodes with a transformation or state record in this frame
+    std::set<ISceneNode*> transformed, changed;
+
+    //! journals by root node
+    static std::map<ISceneNode*, SceneJournal*> journals;
+
+    void Add(ISceneNode* node);
+    void Remove(ISceneNode* node);
+    void Delete(ISceneNode* node);
+    void Record(const Change& change);
+    void Index(ISceneNode* node, unsigned int record) const;
+    void Compact() const;
+    void Collect(ISceneNode* node, std::set<ISceneNode*>& nodes);
+
+    SceneJournal(const SceneJournal&);
+    SceneJournal& operator=(const SceneJournal&);
+};
+
+} // NS Scene
+} // NS OpenEngine
+
+#endif // _OE_SCENE_JOURNAL_H_
@@ -1,6 +1,7 @@
 
 #include <Scene/SceneNodes.h>
 #include <Scene/ISceneNodeVisitor.h>
+#include <Scene/NodeAllocator.h>
 
 namespace OpenEngine {
 namespace Scene {
@@ -27,6 +28,19 @@ ISceneNode* type::Clone() const {                               \
 #include "SceneNodes.def"
 #undef SCENE_NODE
         
+// Allocation from a pool per node type. The pools are never deleted
+// so nodes may outlive static destruction.
+#define SCENE_NODE(type)                                        \
+void* type::operator new(size_t size) {                         \
+    static NodePool* pool = new NodePool(#type, sizeof(type));  \
+    return NodePool::Allocate(*pool, size);                     \
+}                                                               \
+void type::operator delete(void* node) {                        \
+    NodePool::Free(node);                                       \
+}
+#include "SceneNodes.def"
+#undef SCENE_NODE
+
 // Type string
 #define SCENE_NODE(type)                                        \
 const std::string type::GetTypeName() const {                   \
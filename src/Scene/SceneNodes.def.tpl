@@ -12,4 +12,5 @@ SCENE_NODE(TransformationNode)
 SCENE_NODE(VertexArrayNode)
 SCENE_NODE(MeshNode)
 SCENE_NODE(PostProcessNode)
+SCENE_NODE(InstanceNode)
 @OE_SCENE_NODE_XMACRO_EXPANSION@
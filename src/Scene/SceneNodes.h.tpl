@@ -12,4 +12,5 @@
 #include <Scene/VertexArrayNode.h>
 #include <Scene/MeshNode.h>
 #include <Scene/PostProcessNode.h>
+#include <Scene/InstanceNode.h>
 @OE_SCENE_NODE_INCLUDE_EXPANSION@
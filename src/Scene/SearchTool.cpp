@@ -9,6 +9,7 @@
 
 #include <Scene/SearchTool.h>
 #include <Scene/SceneNodes.h>
+#include <Scene/Exceptions.h>
 
 namespace OpenEngine {
 namespace Scene {
@@ -16,6 +17,14 @@ namespace Scene {
 using std::list;
 using std::string;
 
+// get the index of an indexed scene root
+static SceneIndex& _index(ISceneNode* r) {
+    SceneIndex* index = SceneIndex::Get(r);
+    if (index == NULL)
+        throw InvalidSceneOperation("Indexed search in a scene without an index.");
+    return *index;
+}
+
 #define SCENE_NODE(type)                                                \
     type* SearchTool::Child##type(ISceneNode* r, bool incl) {           \
         if (r == NULL) return NULL;                                     \
@@ -166,6 +175,14 @@ using std::string;
             for (itr = rs.begin(); itr != rs.end(); itr++)              \
                 finder.DefaultVisitNode(*itr);                          \
         return finder.found;                                            \
+    }                                                                   \
+    type* SearchTool::Indexed##type(ISceneNode* r) {                    \
+        if (r == NULL) return NULL;                                     \
+        return Indexed##type##s(r).Any();                               \
+    }                                                                   \
+    SceneIndex::View<type> SearchTool::Indexed##type##s(ISceneNode* r) { \
+        SceneIndex::View<ISceneNode> v = _index(r).GetNodesOfType(#type); \
+        return SceneIndex::View<type>(v.GetNodeSet());                  \
     }
 #include "SceneNodes.def"
 #undef SCENE_NODE
@@ -333,5 +350,22 @@ list<PropertyNode*> SearchTool::AncestorPropertyNodesWith(string k, string v, li
     return finder.found;
 }
 
+// ====================================================
+// Indexed with-selectors.
+// ====================================================
+
+PropertyNode* SearchTool::IndexedPropertyNodeWith(string k, string v, ISceneNode* r) {
+    if (r == NULL) return NULL;
+    return IndexedPropertyNodesWith(k, v, r).Any();
+}
+
+SceneIndex::View<PropertyNode> SearchTool::IndexedPropertyNodesWith(string k, string v, ISceneNode* r) {
+    return _index(r).GetPropertyNodesWith(k, v);
+}
+
+SceneIndex::View<ISceneNode> SearchTool::IndexedNodesWithInfo(string info, ISceneNode* r) {
+    return _index(r).GetNodesWithInfo(info);
+}
+
 } // NS Scene
 } // NS OpenEngine
@@ -11,6 +11,7 @@
 #define _OE_SCENE_SEARCH_TOOL_H_
 
 #include <Scene/ISceneNode.h>
+#include <Scene/SceneIndex.h>
 #include <list>
 #include <string>
 
@@ -40,6 +41,16 @@ namespace Scene {
  * @endcode
  * Please refer to tests/SearchTool.cpp for further usage.
  *
+ * The selectors above traverse the scene on every call. For scenes
+ * searched often, such as once a frame, create a SceneIndex for the
+ * scene and use the indexed selectors. They look up the whole indexed
+ * scene, including the root, and return views of the index instead
+ * of copied lists.
+ * @code
+ * SceneIndex index(scene);
+ * PropertyNode* gun = tool.IndexedPropertyNodeWith("id", "gun", scene);
+ * @endcode
+ *
  * @class SearchTool SearchTool.h Scene/SearchTool.h
  * @see tests/SearchTool.cpp
  *
@@ -79,11 +90,17 @@ public:
     static std::list<type*> axis##type##sWith(std::string, std::string, ISceneNode*); \
     static std::list<type*> axis##type##sWith(std::string, std::string, std::list<ISceneNode*>);
 
+// Macro for defining indexed lookups of the nodes of an indexed scene
+#define INDEXED(type)                                                   \
+    static type* Indexed##type(ISceneNode*);                            \
+    static SceneIndex::View<type> Indexed##type##s(ISceneNode*);
+
 // Create an implementation pr. scene node
 #define SCENE_NODE(type)   \
     AXIS(type, Descendant) \
     AXIS(type, Ancestor)   \
-    AXIS(type, Child)
+    AXIS(type, Child)      \
+    INDEXED(type)
 #include "SceneNodes.def"
 #undef SCENE_NODE
 
@@ -92,8 +109,13 @@ public:
     AXIS_WITH(PropertyNode, Ancestor)
     AXIS_WITH(PropertyNode, Child)
 
+    static PropertyNode* IndexedPropertyNodeWith(std::string, std::string, ISceneNode*);
+    static SceneIndex::View<PropertyNode> IndexedPropertyNodesWith(std::string, std::string, ISceneNode*);
+    static SceneIndex::View<ISceneNode> IndexedNodesWithInfo(std::string, ISceneNode*);
+
 #undef AXIS
 #undef AXIS_WITH
+#undef INDEXED
 
 };
 
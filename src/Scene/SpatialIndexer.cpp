@@ -0,0 +1,120 @@
+// Spatial index update module.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#include <Scene/SpatialIndexer.h>
+#include <Scene/ISpatialIndex.h>
+#include <Scene/SceneJournal.h>
+#include <Scene/MeshNode.h>
+#include <Scene/GeometryNode.h>
+#include <Scene/InstanceNode.h>
+#include <Geometry/Bounds.h>
+
+#include <vector>
+
+namespace OpenEngine {
+namespace Scene {
+
+using std::list;
+using std::vector;
+
+/**
+ * Create an update module.
+ *
+ * @param index Index to keep up to date.
+ * @param journal Journal of the scene to index.
+ */
+SpatialIndexer::SpatialIndexer(ISpatialIndex& index, SceneJournal& journal)
+    : index(index), journal(journal) {}
+
+SpatialIndexer::~SpatialIndexer() {}
+
+ISpatialIndex& SpatialIndexer::GetIndex() const {
+    return index;
+}
+
+SceneJournal& SpatialIndexer::GetJournal() const {
+    return journal;
+}
+
+/**
+ * Index the whole scene, replacing the contents of the index.
+ */
+void SpatialIndexer::Build() {
+    index.Clear();
+    Insert(journal.GetRoot());
+}
+
+/**
+ * Apply the changes recorded by the journal in the current frame.
+ * Changes are applied in order, so a sub tree indexed by an early
+ * change and removed by a later one ends up removed.
+ */
+void SpatialIndexer::Update() {
+    const vector<SceneJournal::Change>& changes = journal.GetChanges();
+    for (unsigned int i = 0; i < changes.size(); i++) {
+        const SceneJournal::Change& c = changes[i];
+        switch (c.type) {
+        case SceneJournal::NODE_ADDED:
+        case SceneJournal::NODE_REPARENTED:
+        case SceneJournal::TRANSFORM_CHANGED:
+            Insert(c.node);
+            break;
+        case SceneJournal::NODE_REMOVED:
+            Remove(c.node);
+            break;
+        case SceneJournal::NODE_DELETED:
+            // deleted nodes are only keys
+            index.Remove(c.node);
+            break;
+        case SceneJournal::STATE_CHANGED:
+            if (IsIndexed(c.node))
+                index.Insert(c.node, c.node->GetWorldBounds());
+            break;
+        }
+    }
+}
+
+void SpatialIndexer::Handle(ProcessEventArg arg) {
+    Update();
+}
+
+/**
+ * Check if a node should be indexed.
+ *
+ * @return True for mesh, geometry and instance nodes.
+ */
+bool SpatialIndexer::IsIndexed(ISceneNode* node) {
+    return dynamic_cast<MeshNode*>(node) != NULL
+        || dynamic_cast<GeometryNode*>(node) != NULL
+        || dynamic_cast<InstanceNode*>(node) != NULL;
+}
+
+// index the selected nodes of a sub tree by their current bounds
+void SpatialIndexer::Insert(ISceneNode* node) {
+    vector<ISceneNode*> stack(1, node);
+    while (!stack.empty()) {
+        ISceneNode* n = stack.back();
+        stack.pop_back();
+        if (IsIndexed(n)) index.Insert(n, n->GetWorldBounds());
+        stack.insert(stack.end(), n->subNodes.begin(), n->subNodes.end());
+    }
+}
+
+void SpatialIndexer::Remove(ISceneNode* node) {
+    vector<ISceneNode*> stack(1, node);
+    while (!stack.empty()) {
+        ISceneNode* n = stack.back();
+        stack.pop_back();
+        index.Remove(n);
+        stack.insert(stack.end(), n->subNodes.begin(), n->subNodes.end());
+    }
+}
+
+} // NS Scene
+} // NS OpenEngine
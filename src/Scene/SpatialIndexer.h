@@ -0,0 +1,81 @@
+// Spatial index update module.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#ifndef _OE_SPATIAL_INDEXER_H_
+#define _OE_SPATIAL_INDEXER_H_
+
+#include <Core/IListener.h>
+#include <Core/EngineEvents.h>
+
+namespace OpenEngine {
+namespace Scene {
+
+class ISceneNode;
+class ISpatialIndex;
+class SceneJournal;
+
+using Core::IListener;
+using Core::ProcessEventArg;
+
+/**
+ * Spatial index update module.
+ * Keeps a spatial index of the world bounds of the nodes in a scene.
+ * Build() indexes the whole scene, after which every process event
+ * applies the changes recorded by the journal of the scene, so only
+ * the moved, added and removed sub trees are reindexed.
+ *
+ * @code
+ * SceneJournal* journal = new SceneJournal(scene);
+ * LooseOctree* octree = new LooseOctree(worldBounds);
+ * SpatialIndexer* indexer = new SpatialIndexer(*octree, *journal);
+ * indexer->Build();
+ * engine.ProcessEvent().Attach(*indexer);
+ * @endcode
+ *
+ * Attach the indexer after the modules changing the scene, and end
+ * the frame of the journal after every consumer of the journal has
+ * handled the process event.
+ *
+ * By default mesh, geometry and instance nodes are indexed, override
+ * IsIndexed to select other nodes. Indexed nodes are indexed by the
+ * bounds of their whole sub tree.
+ *
+ * @class SpatialIndexer SpatialIndexer.h Scene/SpatialIndexer.h
+ * @see ISpatialIndex
+ * @see SceneJournal
+ */
+class SpatialIndexer : public IListener<ProcessEventArg> {
+public:
+    SpatialIndexer(ISpatialIndex& index, SceneJournal& journal);
+    virtual ~SpatialIndexer();
+
+    ISpatialIndex& GetIndex() const;
+    SceneJournal& GetJournal() const;
+
+    void Build();
+    void Update();
+    void Handle(ProcessEventArg arg);
+
+    virtual bool IsIndexed(ISceneNode* node);
+
+private:
+    ISpatialIndex& index;
+    SceneJournal& journal;
+
+    void Insert(ISceneNode* node);
+    void Remove(ISceneNode* node);
+
+    SpatialIndexer(const SpatialIndexer&);
+    SpatialIndexer& operator=(const SpatialIndexer&);
+};
+
+} // NS Scene
+} // NS OpenEngine
+
+#endif // _OE_SPATIAL_INDEXER_H_
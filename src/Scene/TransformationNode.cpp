@@ -8,6 +8,8 @@
 //--------------------------------------------------------------------
 
 #include <Scene/TransformationNode.h>
+#include <Scene/TransformationStore.h>
+#include <Scene/SceneJournal.h>
 #include <Resources/IArchiveWriter.h>
 #include <Resources/IArchiveReader.h>
 
@@ -17,7 +19,11 @@ namespace OpenEngine {
 namespace Scene {
 
     //! Empty constructor.
-    TransformationNode::TransformationNode() : scale(Vector<3,float>(1.0f)) {
+    TransformationNode::TransformationNode()
+        : scale(Vector<3,float>(1.0f))
+        , dirty(true)
+        , store(NULL)
+        , index(0) {
     }
 
     /**
@@ -28,16 +34,62 @@ namespace Scene {
      */
     TransformationNode::TransformationNode(const TransformationNode& node)
         : ISceneNode(node)
-        , ISceneNodeVisitor()
         , IReflectable()
+        , dirty(true)
+        , store(NULL)
+        , index(0)
     {
-        rotation = node.rotation;
-        position = node.position;
-        scale = node.scale;
+        rotation = node.LocalRotation();
+        position = node.LocalPosition();
+        scale = node.LocalScale();
     }
 
-    //! Empty destructor.
-    TransformationNode::~TransformationNode() {}
+    /**
+     * Destructor.
+     * Releases the entry in the store holding the transformation.
+     */
+    TransformationNode::~TransformationNode() {
+        if (store) store->Release(index);
+    }
+
+    // the local transformation, held by the store if bound to one
+    Vector<3,float>& TransformationNode::LocalPosition() {
+        return store ? store->position[index] : position;
+    }
+
+    Quaternion<float>& TransformationNode::LocalRotation() {
+        return store ? store->rotation[index] : rotation;
+    }
+
+    Vector<3,float>& TransformationNode::LocalScale() {
+        return store ? store->scale[index] : scale;
+    }
+
+    const Vector<3,float>& TransformationNode::LocalPosition() const {
+        return store ? store->position[index] : position;
+    }
+
+    const Quaternion<float>& TransformationNode::LocalRotation() const {
+        return store ? store->rotation[index] : rotation;
+    }
+
+    const Vector<3,float>& TransformationNode::LocalScale() const {
+        return store ? store->scale[index] : scale;
+    }
+
+    /**
+     * Mark the world transformation dirty after a change of the
+     * local transformation.
+     */
+    void TransformationNode::LocalChanged() {
+        SceneJournal::TransformChanged(this);
+        InvalidateBounds();
+        if (store) store->MarkDirty(index);
+        else if (!dirty) {
+            dirty = true;
+            ISceneNode::InvalidateTransformations(NULL, -1);
+        }
+    }
 
     /**
      * Move transformation.
@@ -50,7 +102,8 @@ namespace Scene {
      */
     void TransformationNode::Move(float x, float y, float z) {
         // add the rotation of v around the current quaternion to the position
-        position += rotation.RotateVector(Vector<3,float>(x,y,z)); 
+        LocalPosition() += LocalRotation().RotateVector(Vector<3,float>(x,y,z));
+        LocalChanged();
     }
 
     /**
@@ -67,7 +120,9 @@ namespace Scene {
         Quaternion<float> q(x, y, z);
         q.Normalize();
         // apply the accumulated rotation
+        Quaternion<float>& rotation = LocalRotation();
         rotation = rotation * q;
+        LocalChanged();
     }
 
     /**
@@ -80,9 +135,11 @@ namespace Scene {
      * @param z scale along local z-axis
      */
     void TransformationNode::Scale(float x, float y, float z) {
+        Vector<3,float>& scale = LocalScale();
         scale[0] *= x;
         scale[1] *= y;
         scale[2] *= z;
+        LocalChanged();
     }
 
 
@@ -92,6 +149,26 @@ namespace Scene {
      * @return Transformation matrix
      */
     Matrix<4,4,float> TransformationNode::GetTransformationMatrix() {
+        return ToMatrix(LocalPosition(), LocalRotation(), LocalScale());
+    }
+
+    /**
+     * Get matrix representation of the world transformation.
+     *
+     * @return World transformation matrix
+     */
+    Matrix<4,4,float> TransformationNode::GetWorldTransformationMatrix() {
+        UpdateWorldTransformation();
+        if (store) return store->world[index];
+        return ToMatrix(worldPosition, worldRotation, worldScale);
+    }
+
+    /**
+     * Build a transformation matrix.
+     */
+    Matrix<4,4,float> TransformationNode::ToMatrix(Vector<3,float> position,
+                                                   Quaternion<float> rotation,
+                                                   Vector<3,float> scale) {
         // get the rotation from the quaternion
         Matrix<4,4,float> m = rotation.GetMatrix().GetExpanded();
         m.Transpose();
@@ -99,7 +176,10 @@ namespace Scene {
         m(3,0) = position[0];
         m(3,1) = position[1];
         m(3,2) = position[2];
-        return GetScaleMatrix() * m;
+        return Matrix<4,4,float>(scale[0], 0.0f, 0.0f, 0.0f,
+                                 0.0f, scale[1], 0.0f, 0.0f,
+                                 0.0f, 0.0f, scale[2], 0.0f,
+                                 0.0f, 0.0f, 0.0f, 1.0f) * m;
     }
 
     /**
@@ -108,7 +188,7 @@ namespace Scene {
      * @return Vector<3,float> position.
      */
     Vector<3,float> TransformationNode::GetPosition() {
-        return position;
+        return LocalPosition();
     }
 
     /**
@@ -117,7 +197,8 @@ namespace Scene {
      * @param position new position.
      */
     void TransformationNode::SetPosition(Vector<3,float> position) {
-        this->position = position;
+        LocalPosition() = position;
+        LocalChanged();
     }
 
     /**
@@ -126,7 +207,7 @@ namespace Scene {
      * @return Quaternion<float> describing the rotation.
      */
     Quaternion<float> TransformationNode::GetRotation() {
-        return rotation;
+        return LocalRotation();
     }
 
     /**
@@ -135,7 +216,7 @@ namespace Scene {
      * @return Scaling vector.
      */
     Vector<3,float> TransformationNode::GetScale() {
-        return scale;
+        return LocalScale();
     }
 
     /**
@@ -144,6 +225,7 @@ namespace Scene {
      * @return Scaling matrix.
      */
     Matrix<4,4,float> TransformationNode::GetScaleMatrix() {
+        Vector<3,float>& scale = LocalScale();
         return Matrix<4,4,float>(scale[0], 0.0f, 0.0f, 0.0f,
                                  0.0f, scale[1], 0.0f, 0.0f,
                                  0.0f, 0.0f, scale[2], 0.0f,
@@ -156,7 +238,8 @@ namespace Scene {
      * @param rotation new rotation.
      */
     void TransformationNode::SetRotation(Quaternion<float> rotation) {
-        this->rotation = rotation;
+        LocalRotation() = rotation;
+        LocalChanged();
     }
 
     /**
@@ -165,7 +248,8 @@ namespace Scene {
      * @param scale new scaling.
      */
     void TransformationNode::SetScale(Vector<3,float> scale) {
-        this->scale = scale;
+        LocalScale() = scale;
+        LocalChanged();
     }
 
     /**
@@ -174,86 +258,223 @@ namespace Scene {
      * @param scale new scaling.
      */
     void TransformationNode::SetScale(Matrix<4,4,float> scale) {
-        this->scale[0] = scale(0,0);
-        this->scale[1] = scale(1,1);
-        this->scale[2] = scale(2,2);
+        Vector<3,float>& s = LocalScale();
+        s[0] = scale(0,0);
+        s[1] = scale(1,1);
+        s[2] = scale(2,2);
+        LocalChanged();
+    }
+
+    /**
+     * Mark the world transformation of this node and all
+     * transformation nodes below it dirty.
+     * A dirty node only has dirty transformation nodes below it, so
+     * the propagation stops at nodes that are already dirty.
+     *
+     * If the node has been moved in or out of a scene kept in a
+     * TransformationStore the sub tree is bound to or released from
+     * the store.
+     */
+    void TransformationNode::InvalidateTransformations(TransformationStore* s,
+                                                       int parent) {
+        if (store != NULL) {
+            if (s == store && parent == store->parents[index]) {
+                store->MarkDirty(index);
+                return;
+            }
+            store->Unbind(this);
+        }
+        if (s != NULL) {
+            s->Bind(this, parent);
+            return;
+        }
+        InvalidateBounds();
+        if (!dirty) {
+            dirty = true;
+            ISceneNode::InvalidateTransformations(NULL, -1);
+        }
+    }
+
+    /**
+     * Check if the cached world transformation is out of date.
+     *
+     * @return True if the next query will update the cache.
+     */
+    bool TransformationNode::IsWorldTransformationDirty() const {
+        if (store) return store->IsDirty();
+        return dirty;
     }
 
     /**
-     * Custom visit sub node method.
-     * We overwrite the sub node selector to select the parenting node
-     * instead. This results in a left-to-root traversal of the tree.
+     * Get the store holding the transformation.
      *
-     * @param node Currently visited node.
+     * @return Store or NULL if the node holds the transformation.
+     */
+    TransformationStore* TransformationNode::GetStore() const {
+        return store;
+    }
+
+    // read the world transformation, which must be up to date
+    void TransformationNode::GetWorld(Vector<3,float>& position,
+                                      Quaternion<float>& rotation,
+                                      Vector<3,float>& scale) {
+        if (store) {
+            position = store->worldPosition[index];
+            rotation = store->worldRotation[index];
+            scale    = store->worldScale[index];
+        } else {
+            position = worldPosition;
+            rotation = worldRotation;
+            scale    = worldScale;
+        }
+    }
+
+    /**
+     * Update a dirty world transformation, updating dirty
+     * transformation nodes above it first.
      */
-    void TransformationNode::DefaultVisitNode(ISceneNode* node) {
-        ISceneNode* p = node->GetParent();
-        if (p != NULL)
-            p->Accept(*this);
+    void TransformationNode::UpdateWorldTransformation() {
+        if (store) {
+            store->Update();
+            return;
+        }
+        if (!dirty) return;
+        TransformationNode* parent = NULL;
+        for (ISceneNode* p = GetParent(); p != NULL && parent == NULL;
+             p = p->GetParent())
+            parent = dynamic_cast<TransformationNode*>(p);
+        if (parent != NULL)
+            parent->UpdateWorldTransformation();
+        UpdateWorldTransformation(parent);
     }
 
     /**
-     * Visit transformations to collect position and rotation
-     * information.
+     * Compute the world transformation from the clean world
+     * transformation of the nearest transformation node above.
      *
-     * @param node Self or parenting transformation node.
+     * @param parent Nearest transformation node above, NULL if none.
      */
-    void TransformationNode::VisitTransformationNode(TransformationNode* node) {
-        DefaultVisitNode(node);
+    void TransformationNode::UpdateWorldTransformation(TransformationNode* parent) {
+        if (parent == NULL) {
+            worldPosition = position;
+            worldRotation = rotation;
+            worldScale    = scale;
+        } else {
+            Vector<3,float> p, s;
+            Quaternion<float> r;
+            parent->GetWorld(p, r, s);
+            Accumulate(p, r, s, position, rotation, scale,
+                       worldPosition, worldRotation, worldScale);
+        }
+        dirty = false;
+    }
 
-        // write the result added to this nodes values to the parameters
-        accPosition = accRotation.RotateVector(node->position) + accPosition;
+    /**
+     * Accumulate a local transformation onto the world transformation
+     * of its parent.
+     */
+    void TransformationNode::Accumulate(Vector<3,float> parentPosition,
+                                        Quaternion<float> parentRotation,
+                                        Vector<3,float> parentScale,
+                                        Vector<3,float> position,
+                                        Quaternion<float> rotation,
+                                        Vector<3,float> scale,
+                                        Vector<3,float>& worldPosition,
+                                        Quaternion<float>& worldRotation,
+                                        Vector<3,float>& worldScale) {
+        worldPosition = parentRotation.RotateVector(position) + parentPosition;
+
+        Vector<3,float> rotated = parentRotation.RotateVector(scale);
+        worldScale = parentScale;
+        worldScale[0] *= rotated[0];
+        worldScale[1] *= rotated[1];
+        worldScale[2] *= rotated[2];
+
+        worldRotation = parentRotation * rotation;
+    }
 
-        Vector<3,float> rotated = accRotation.RotateVector(node->scale);
-        accScale[0] *= rotated[0];
-        accScale[1] *= rotated[1];
-        accScale[2] *= rotated[2];
+    /**
+     * Update all dirty world transformations in a scene.
+     * The scene is traversed top down, so every transformation is
+     * computed once from its already updated parent.
+     *
+     * @param root Root of the scene to update.
+     */
+    void TransformationNode::UpdateWorldTransformations(ISceneNode* root) {
+        TransformationNode* parent = NULL;
+        for (ISceneNode* p = root->GetParent(); p != NULL && parent == NULL;
+             p = p->GetParent())
+            parent = dynamic_cast<TransformationNode*>(p);
+        if (parent != NULL)
+            parent->UpdateWorldTransformation();
+        UpdateWorldTransformations(root, parent);
+    }
 
-        accRotation = accRotation * node->rotation;
+    void TransformationNode::UpdateWorldTransformations(ISceneNode* node,
+                                                        TransformationNode* parent) {
+        TransformationNode* t = dynamic_cast<TransformationNode*>(node);
+        if (t != NULL) {
+            if (t->store) t->store->Update();
+            else if (t->dirty) t->UpdateWorldTransformation(parent);
+            parent = t;
+        }
+        std::list<ISceneNode*>::iterator itr;
+        for (itr = node->subNodes.begin(); itr != node->subNodes.end(); itr++)
+            UpdateWorldTransformations(*itr, parent);
     }
 
     /**
-     * Get the accumulated position.
-     * Get the position by traversing upwards in the scene tree
-     * accumulating the position of all the nodes in the chain.
+     * Get the accumulated transformations.
+     * Get the world position, rotation and scale accumulated from all
+     * the transformation nodes in the parenting chain. The result is
+     * cached until the node or one of its ancestors change.
      *
-     * @return Accumulated position vector.
+     * @param position World position [out]
+     * @param rotation World rotation [out]
+     * @param scale World scale [out, optional]
      */
     void TransformationNode::GetAccumulatedTransformations(Vector<3,float>* position, Quaternion<float>* rotation, Vector<3,float>* scale) {
-        // reset the accumulators
-        accPosition = Vector<3,float>();
-        accRotation = Quaternion<float>();
-        accScale    = Vector<3,float>(1.0f);
-        
-        // get the accumulators from the parenting chain
-        VisitTransformationNode(this);
-        
-        // write in results
-        *position = accPosition;
-        *rotation = accRotation;
-        if (scale) *scale = accScale;
+        UpdateWorldTransformation();
+        Vector<3,float> s;
+        GetWorld(*position, *rotation, s);
+        if (scale) *scale = s;
+    }
+
+    /**
+     * Compute the bounds of the sub tree in the space of the parent.
+     */
+    void TransformationNode::ComputeBounds(Geometry::Bounds& bounds) {
+        ISceneNode::ComputeBounds(bounds);
+        TransformBounds(bounds);
+    }
+
+    /**
+     * Transform bounds by the local transformation.
+     */
+    void TransformationNode::TransformBounds(Geometry::Bounds& bounds) {
+        bounds = bounds.Transform(LocalPosition(), LocalRotation(), LocalScale());
     }
 
     /**
      * Serialize a transformation node.
      */    
     void TransformationNode::Serialize(Resources::IArchiveWriter& w) {
-        w.WriteQuaternion<float>("rotation",rotation);
-        w.WriteVector<3,float>("position",position);
-        w.WriteVector<3,float>("scale",scale);
+        w.WriteQuaternion<float>("rotation",LocalRotation());
+        w.WriteVector<3,float>("position",LocalPosition());
+        w.WriteVector<3,float>("scale",LocalScale());
     }
     /**
      * Deserialize a transformation node.
      */    
     void TransformationNode::Deserialize(Resources::IArchiveReader& r) {
-        rotation = r.ReadQuaternion<float>("rotation");
-        position = r.ReadVector<3,float>("position");
-        scale = r.ReadVector<3,float>("scale");
+        LocalRotation() = r.ReadQuaternion<float>("rotation");
+        LocalPosition() = r.ReadVector<3,float>("position");
+        LocalScale() = r.ReadVector<3,float>("scale");
+        LocalChanged();
     }
 
 
     const std::string TransformationNode::ToString() const {
-        TransformationNode t(*this);
         char str[256];
         /*
         Matrix<4,4,float> m = t.GetTransformationMatrix();
@@ -267,12 +488,12 @@ namespace Scene {
 
               
         // Print each transformation matrix
-        Matrix<4,4,float> m = rotation.GetMatrix().GetExpanded();
-        Vector<3,float> pos = position;
+        Matrix<4,4,float> m = LocalRotation().GetMatrix().GetExpanded();
+        const Vector<3,float>& pos = LocalPosition();
         sprintf(str, "%.3f %.3f %.3f %.3f\n%.3f %.3f %.3f %.3f\n%.3f %.3f %.3f %.3f\n%.3f %.3f %.3f %.3f\n", 
-                m[0][0], m[0][1], m[0][2], pos[0],
-                m[1][0], m[1][1], m[1][2], pos[1],
-                m[2][0], m[2][1], m[2][2], pos[2],
+                m[0][0], m[0][1], m[0][2], pos.Get(0),
+                m[1][0], m[1][1], m[1][2], pos.Get(1),
+                m[2][0], m[2][1], m[2][2], pos.Get(2),
                 m[3][0], m[3][1], m[3][2], 1.0); 
 
 
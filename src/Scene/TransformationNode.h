@@ -29,6 +29,8 @@ using OpenEngine::Math::Vector;
 using OpenEngine::Math::Matrix;
 using OpenEngine::Math::Quaternion;
 
+class TransformationStore;
+
 /**
  * Transformation node.
  * When inserted in the scene graph, all successive nodes
@@ -37,10 +39,27 @@ using OpenEngine::Math::Quaternion;
  * scene graph, who is responsible for applying the
  * rotation and positioning.
  *
+ * The world transformation, accumulated from all transformation
+ * nodes above and including the node, is cached. Changing a node, or
+ * moving it in the graph, marks the cache of the node and all
+ * transformation nodes below it dirty. A dirty cache is updated on
+ * the next query, which then walks up to the nearest clean ancestor,
+ * or all at once by UpdateWorldTransformations(). The latter should
+ * run once a frame, see TransformationUpdater, so that queries made
+ * during the frame are constant time.
+ *
+ * Optionally the transformations of a scene can be kept in a
+ * TransformationStore. The node is then a handle to an entry in the
+ * flat arrays of the store, which updates all world transformations
+ * in a single linear sweep.
+ *
+ * Updating the cache is not thread safe, so queries from other
+ * threads must happen after the update pass. ParallelVisitor runs
+ * the update pass itself before it fans out.
+ *
  * @class TransformationNode TransformationNode.h Scene/TransformationNode.h
  */
     class TransformationNode : public ISceneNode
-                             , public ISceneNodeVisitor
                              , public Core::IReflectable {
 #ifndef SWIG
     OE_SCENE_NODE(TransformationNode, ISceneNode)
@@ -52,9 +71,6 @@ public:
     TransformationNode(const TransformationNode& node);
     virtual ~TransformationNode();
 
-    // ISceneNodeVisitor methods
-    void VisitTransformationNode(TransformationNode* node);
-
     // New transformation methods
     void Move(float x, float y, float z);
     void Rotate(float x, float y, float z);
@@ -70,16 +86,28 @@ public:
     Vector<3,float>   GetScale();
     Matrix<4,4,float> GetScaleMatrix();
     Matrix<4,4,float> GetTransformationMatrix();
+    Matrix<4,4,float> GetWorldTransformationMatrix();
     void GetAccumulatedTransformations(Vector<3,float>* position, 
                                        Quaternion<float>* rotation, 
                                        Vector<3,float>* scale = NULL);
 
+    bool IsWorldTransformationDirty() const;
+    static void UpdateWorldTransformations(ISceneNode* root);
+
+    TransformationStore* GetStore() const;
+
     void Serialize(Resources::IArchiveWriter& w);
     void Deserialize(Resources::IArchiveReader& r);
 
     const std::string ToString() const;
-    
+
+protected:
+    void ComputeBounds(Geometry::Bounds& bounds);
+    void TransformBounds(Geometry::Bounds& bounds);
+    void InvalidateTransformations(TransformationStore* store, int parent);
+
 private:
+    friend class TransformationStore;
 
     //! current rotation quaternion
     Quaternion<float> rotation;
@@ -87,24 +115,55 @@ private:
     //! current absolute position vector
     Vector<3,float> position;
     
-    //! accumulated rotation from collection traversal
-    Quaternion<float> accRotation;
-
-    //! accumulated position from collection traversal
-    Vector<3,float> accPosition;
-
-    //! accumulated scale from collection traversal
-    Vector<3,float> accScale;
-
     //! current scaling factor
     //! @todo - represent the scale as x,y,z. Using a 4x4 matrix is plain wast.
     Vector<3,float> scale;
-	
-
-protected:
 
-    //! overwritten visiting method
-    virtual void DefaultVisitNode(ISceneNode* node);
+    //! cached world rotation
+    Quaternion<float> worldRotation;
+
+    //! cached world position
+    Vector<3,float> worldPosition;
+
+    //! cached world scale
+    Vector<3,float> worldScale;
+
+    //! true if the cached world transformation is out of date
+    bool dirty;
+
+    //! store holding the transformation, NULL if held by the node
+    TransformationStore* store;
+
+    //! index of the entry in the store
+    unsigned int index;
+
+    Vector<3,float>&   LocalPosition();
+    Quaternion<float>& LocalRotation();
+    Vector<3,float>&   LocalScale();
+    const Vector<3,float>&   LocalPosition() const;
+    const Quaternion<float>& LocalRotation() const;
+    const Vector<3,float>&   LocalScale() const;
+    void LocalChanged();
+
+    void GetWorld(Vector<3,float>& position, Quaternion<float>& rotation,
+                  Vector<3,float>& scale);
+    void UpdateWorldTransformation();
+    void UpdateWorldTransformation(TransformationNode* parent);
+    static void UpdateWorldTransformations(ISceneNode* node,
+                                           TransformationNode* parent);
+
+    static void Accumulate(Vector<3,float> parentPosition,
+                           Quaternion<float> parentRotation,
+                           Vector<3,float> parentScale,
+                           Vector<3,float> position,
+                           Quaternion<float> rotation,
+                           Vector<3,float> scale,
+                           Vector<3,float>& worldPosition,
+                           Quaternion<float>& worldRotation,
+                           Vector<3,float>& worldScale);
+    static Matrix<4,4,float> ToMatrix(Vector<3,float> position,
+                                      Quaternion<float> rotation,
+                                      Vector<3,float> scale);
 
 };
 
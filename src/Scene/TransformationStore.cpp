@@ -0,0 +1,302 @@
+// Flat transformation hierarchy storage.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#include <Scene/TransformationStore.h>
+#include <Scene/TransformationNode.h>
+#include <Scene/Exceptions.h>
+
+#include <algorithm>
+
+namespace OpenEngine {
+namespace Scene {
+
+using std::list;
+using std::map;
+using std::vector;
+
+map<ISceneNode*, TransformationStore*> TransformationStore::stores;
+
+/**
+ * Create a store for a scene.
+ * All transformation nodes in the scene are bound to the store,
+ * except those of stores created earlier for sub trees of the scene,
+ * which keep them.
+ *
+ * @param root Root of the scene.
+ * @throws InvalidSceneOperation if the scene is already in a store.
+ */
+TransformationStore::TransformationStore(ISceneNode* root)
+    : root(root), holes(0), dirtyAny(false) {
+    int parent;
+    if (root == NULL)
+        throw InvalidSceneOperation("A transformation store needs a root.");
+    if (Find(root, parent) != NULL)
+        throw InvalidSceneOperation("The scene is already in a transformation store.");
+    stores[root] = this;
+    Bind(root, -1);
+}
+
+/**
+ * Destroy the store.
+ * The transformation nodes hold their transformations again.
+ */
+TransformationStore::~TransformationStore() {
+    for (unsigned int i = 0; i < nodes.size(); i++) {
+        TransformationNode* t = nodes[i];
+        if (t == NULL) continue;
+        t->position = position[i];
+        t->rotation = rotation[i];
+        t->scale = scale[i];
+        t->store = NULL;
+        t->dirty = true;
+    }
+    stores.erase(root);
+}
+
+/**
+ * Find the store a node belongs to.
+ *
+ * @param node Scene node.
+ * @param parent Index of the nearest transformation node above the
+ *               node in the store, -1 if there is none [out]
+ * @return Store or NULL if the node is not in a stored scene.
+ */
+TransformationStore* TransformationStore::Find(ISceneNode* node, int& parent) {
+    if (stores.empty()) return NULL;
+    parent = -1;
+    map<ISceneNode*, TransformationStore*>::iterator s = stores.find(node);
+    if (s != stores.end()) return s->second;
+    for (ISceneNode* p = node->GetParent(); p != NULL; p = p->GetParent()) {
+        TransformationNode* t = dynamic_cast<TransformationNode*>(p);
+        if (t != NULL) {
+            if (t->store == NULL) return NULL;
+            parent = t->index;
+            return t->store;
+        }
+        s = stores.find(p);
+        if (s != stores.end()) return s->second;
+    }
+    return NULL;
+}
+
+/**
+ * Find the store of a node from the store of its parent.
+ *
+ * @param node Scene node.
+ * @param store Store of the parent of the node.
+ * @param parent Index of the nearest transformation node above the
+ *               node in the store [in/out]
+ * @return The store rooted at the node, else the given store.
+ */
+TransformationStore* TransformationStore::FindRoot(ISceneNode* node,
+                                                   TransformationStore* store,
+                                                   int& parent) {
+    if (stores.empty()) return store;
+    map<ISceneNode*, TransformationStore*>::iterator s = stores.find(node);
+    if (s == stores.end()) return store;
+    parent = -1;
+    return s->second;
+}
+
+/**
+ * Append the transformation nodes of a sub tree.
+ * Appending in pre-order keeps parents before children. The sub
+ * trees of other stores are left to them.
+ */
+void TransformationStore::Bind(ISceneNode* node, int parent) {
+    if (node != root && stores.find(node) != stores.end()) return;
+    TransformationNode* t = dynamic_cast<TransformationNode*>(node);
+    if (t != NULL) {
+        if (t->store != NULL) t->store->Unbind(t);
+        unsigned int i = nodes.size();
+        nodes.push_back(t);
+        parents.push_back(parent);
+        position.push_back(t->position);
+        rotation.push_back(t->rotation);
+        scale.push_back(t->scale);
+        worldPosition.push_back(Vector<3,float>());
+        worldRotation.push_back(Quaternion<float>());
+        worldScale.push_back(Vector<3,float>(1.0f));
+        world.push_back(Matrix<4,4,float>());
+        dirty.push_back(1);
+        dirtyAny = true;
+        t->store = this;
+        t->index = i;
+        parent = i;
+    }
+    list<ISceneNode*>::iterator itr;
+    for (itr = node->subNodes.begin(); itr != node->subNodes.end(); itr++)
+        Bind(*itr, parent);
+}
+
+/**
+ * Release the transformation nodes of a sub tree, handing their
+ * transformations back to the nodes.
+ */
+void TransformationStore::Unbind(ISceneNode* node) {
+    TransformationNode* t = dynamic_cast<TransformationNode*>(node);
+    if (t != NULL && t->store == this) {
+        unsigned int i = t->index;
+        t->position = position[i];
+        t->rotation = rotation[i];
+        t->scale = scale[i];
+        t->store = NULL;
+        t->dirty = true;
+        Release(i);
+    }
+    list<ISceneNode*>::iterator itr;
+    for (itr = node->subNodes.begin(); itr != node->subNodes.end(); itr++)
+        Unbind(*itr);
+}
+
+// leave a hole for a released entry
+void TransformationStore::Release(unsigned int index) {
+    nodes[index] = NULL;
+    holes++;
+}
+
+void TransformationStore::MarkDirty(unsigned int index) {
+    dirty[index] = 1;
+    dirtyAny = true;
+}
+
+/**
+ * Remove the holes left by released entries, keeping the order.
+ */
+void TransformationStore::Compact() {
+    vector<int> remap(nodes.size(), -1);
+    unsigned int j = 0;
+    for (unsigned int i = 0; i < nodes.size(); i++) {
+        if (nodes[i] == NULL) continue;
+        remap[i] = j;
+        nodes[j] = nodes[i];
+        parents[j] = parents[i] < 0 ? -1 : remap[parents[i]];
+        position[j] = position[i];
+        rotation[j] = rotation[i];
+        scale[j] = scale[i];
+        worldPosition[j] = worldPosition[i];
+        worldRotation[j] = worldRotation[i];
+        worldScale[j] = worldScale[i];
+        world[j] = world[i];
+        dirty[j] = dirty[i];
+        nodes[j]->index = j;
+        j++;
+    }
+    nodes.resize(j);
+    parents.resize(j);
+    position.resize(j);
+    rotation.resize(j);
+    scale.resize(j);
+    worldPosition.resize(j);
+    worldRotation.resize(j);
+    worldScale.resize(j);
+    world.resize(j);
+    dirty.resize(j);
+    holes = 0;
+}
+
+/**
+ * Update all dirty world transformations.
+ * As parents precede their children a single sweep propagates the
+ * dirty flags and computes the world transformations.
+ */
+void TransformationStore::Update() {
+    if (!dirtyAny) return;
+    if (holes * 2 > nodes.size()) Compact();
+
+    // transformation above the root of the scene
+    TransformationNode* base = NULL;
+    for (ISceneNode* p = root->GetParent(); p != NULL && base == NULL;
+         p = p->GetParent())
+        base = dynamic_cast<TransformationNode*>(p);
+    Vector<3,float> basePosition, baseScale;
+    Quaternion<float> baseRotation;
+    if (base != NULL)
+        base->GetAccumulatedTransformations(&basePosition, &baseRotation,
+                                            &baseScale);
+
+    const unsigned int size = nodes.size();
+    for (unsigned int i = 0; i < size; i++) {
+        int p = parents[i];
+        if (p >= 0) dirty[i] |= dirty[p];
+        if (!dirty[i] || nodes[i] == NULL) continue;
+        if (p >= 0)
+            TransformationNode::Accumulate(worldPosition[p], worldRotation[p],
+                                           worldScale[p],
+                                           position[i], rotation[i], scale[i],
+                                           worldPosition[i], worldRotation[i],
+                                           worldScale[i]);
+        else if (base != NULL)
+            TransformationNode::Accumulate(basePosition, baseRotation, baseScale,
+                                           position[i], rotation[i], scale[i],
+                                           worldPosition[i], worldRotation[i],
+                                           worldScale[i]);
+        else {
+            worldPosition[i] = position[i];
+            worldRotation[i] = rotation[i];
+            worldScale[i] = scale[i];
+        }
+        world[i] = TransformationNode::ToMatrix(worldPosition[i],
+                                                worldRotation[i],
+                                                worldScale[i]);
+    }
+    std::fill(dirty.begin(), dirty.end(), 0);
+    dirtyAny = false;
+}
+
+/**
+ * Check if any world transformation is out of date.
+ */
+bool TransformationStore::IsDirty() const {
+    return dirtyAny;
+}
+
+ISceneNode* TransformationStore::GetRoot() const {
+    return root;
+}
+
+/**
+ * Number of entries, including holes left by released nodes.
+ */
+unsigned int TransformationStore::GetSize() const {
+    return nodes.size();
+}
+
+/**
+ * Number of bound transformation nodes.
+ */
+unsigned int TransformationStore::GetCount() const {
+    return nodes.size() - holes;
+}
+
+/**
+ * Get the node of an entry.
+ *
+ * @return Transformation node, NULL for a hole.
+ */
+TransformationNode* TransformationStore::GetNode(unsigned int index) const {
+    return nodes[index];
+}
+
+/**
+ * Parent entry index of all entries, -1 for top level entries.
+ */
+const vector<int>& TransformationStore::GetParents() const {
+    return parents;
+}
+
+/**
+ * World matrices of all entries, valid after Update().
+ */
+const vector<Matrix<4,4,float> >& TransformationStore::GetWorldMatrices() const {
+    return world;
+}
+
+} // NS Scene
+} // NS OpenEngine
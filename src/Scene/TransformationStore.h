@@ -0,0 +1,115 @@
+// Flat transformation hierarchy storage.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#ifndef _OE_TRANSFORMATION_STORE_H_
+#define _OE_TRANSFORMATION_STORE_H_
+
+#include <Math/Vector.h>
+#include <Math/Matrix.h>
+#include <Math/Quaternion.h>
+
+#include <vector>
+#include <map>
+
+namespace OpenEngine {
+namespace Scene {
+
+class ISceneNode;
+class TransformationNode;
+
+using OpenEngine::Math::Vector;
+using OpenEngine::Math::Matrix;
+using OpenEngine::Math::Quaternion;
+
+/**
+ * Flat transformation hierarchy storage.
+ * Keeps the transformations of all transformation nodes in a scene
+ * in structure of arrays form: parent index, local position, rotation
+ * and scale, and the world transformation and matrix. Entries are
+ * ordered parent before child, so Update() computes all dirty world
+ * transformations in one linear sweep over contiguous memory instead
+ * of chasing pointers through the scene graph.
+ *
+ * While a store exists the transformation nodes of its scene are
+ * handles to their entries. Nodes added to the scene are bound to
+ * the store and nodes removed from it are released, so the store
+ * follows the scene without being rebuilt. Released entries leave
+ * holes that are compacted when they make up half the store.
+ *
+ * @code
+ * TransformationStore* store = new TransformationStore(scene);
+ * engine.ProcessEvent().Attach(*(new TransformationUpdater(store)));
+ * @endcode
+ *
+ * The store must be deleted before the scene, which then holds its
+ * transformations itself again. The world transformation of
+ * transformation nodes above the root is applied to the store. A
+ * store may be created for a scene containing the root of another
+ * store, whose sub tree stays in the other store.
+ *
+ * @class TransformationStore TransformationStore.h Scene/TransformationStore.h
+ * @see TransformationNode
+ */
+class TransformationStore {
+public:
+    TransformationStore(ISceneNode* root);
+    virtual ~TransformationStore();
+
+    void Update();
+    bool IsDirty() const;
+
+    ISceneNode* GetRoot() const;
+    unsigned int GetSize() const;
+    unsigned int GetCount() const;
+
+    TransformationNode* GetNode(unsigned int index) const;
+    const std::vector<int>& GetParents() const;
+    const std::vector<Matrix<4,4,float> >& GetWorldMatrices() const;
+
+private:
+    friend class ISceneNode;
+    friend class TransformationNode;
+
+    ISceneNode* root;
+    unsigned int holes;
+    bool dirtyAny;
+
+    std::vector<TransformationNode*> nodes;
+    std::vector<int> parents;
+    std::vector<Vector<3,float> > position;
+    std::vector<Quaternion<float> > rotation;
+    std::vector<Vector<3,float> > scale;
+    std::vector<Vector<3,float> > worldPosition;
+    std::vector<Quaternion<float> > worldRotation;
+    std::vector<Vector<3,float> > worldScale;
+    std::vector<Matrix<4,4,float> > world;
+    std::vector<unsigned char> dirty;
+
+    //! stores by root node
+    static std::map<ISceneNode*, TransformationStore*> stores;
+
+    static TransformationStore* Find(ISceneNode* node, int& parent);
+    static TransformationStore* FindRoot(ISceneNode* node,
+                                         TransformationStore* store,
+                                         int& parent);
+
+    void Bind(ISceneNode* node, int parent);
+    void Unbind(ISceneNode* node);
+    void Release(unsigned int index);
+    void MarkDirty(unsigned int index);
+    void Compact();
+
+    TransformationStore(const TransformationStore&);
+    TransformationStore& operator=(const TransformationStore&);
+};
+
+} // NS Scene
+} // NS OpenEngine
+
+#endif // _OE_TRANSFORMATION_STORE_H_
@@ -0,0 +1,74 @@
+// World transformation update module.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS) 
+// 
+// This program is free software; It is covered by the GNU General 
+// Public License version 2 or any later version. 
+// See the GNU General Public License for more details (see LICENSE). 
+//--------------------------------------------------------------------
+
+#include <Scene/TransformationUpdater.h>
+#include <Scene/TransformationNode.h>
+#include <Scene/TransformationStore.h>
+#include <Utils/Profiler.h>
+
+namespace OpenEngine {
+namespace Scene {
+
+using Utils::Profiler;
+
+/**
+ * Create an update module.
+ *
+ * @param root Root of the scene to update, may be set later.
+ */
+TransformationUpdater::TransformationUpdater(ISceneNode* root)
+    : root(root), store(NULL) {
+}
+
+/**
+ * Create an update module for a stored scene.
+ *
+ * @param store Store to update.
+ */
+TransformationUpdater::TransformationUpdater(TransformationStore* store)
+    : root(NULL), store(store) {
+}
+
+TransformationUpdater::~TransformationUpdater() {}
+
+/**
+ * Set the root of the scene to update.
+ *
+ * @param root Scene root, NULL to stop updating.
+ */
+void TransformationUpdater::SetRoot(ISceneNode* root) {
+    this->root = root;
+}
+
+ISceneNode* TransformationUpdater::GetRoot() {
+    return root;
+}
+
+/**
+ * Set the store to update instead of traversing a scene.
+ *
+ * @param store Transformation store, NULL to traverse the root.
+ */
+void TransformationUpdater::SetStore(TransformationStore* store) {
+    this->store = store;
+}
+
+TransformationStore* TransformationUpdater::GetStore() {
+    return store;
+}
+
+void TransformationUpdater::Handle(ProcessEventArg arg) {
+    Profiler::Zone zone("TransformationUpdater::Process");
+    if (store != NULL) store->Update();
+    else if (root != NULL)
+        TransformationNode::UpdateWorldTransformations(root);
+}
+
+} // NS Scene
+} // NS OpenEngine
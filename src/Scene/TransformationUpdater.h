@@ -0,0 +1,61 @@
+// World transformation update module.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS) 
+// 
+// This program is free software; It is covered by the GNU General 
+// Public License version 2 or any later version. 
+// See the GNU General Public License for more details (see LICENSE). 
+//--------------------------------------------------------------------
+
+#ifndef _OE_TRANSFORMATION_UPDATER_H_
+#define _OE_TRANSFORMATION_UPDATER_H_
+
+#include <Core/IListener.h>
+#include <Core/EngineEvents.h>
+
+namespace OpenEngine {
+namespace Scene {
+
+class ISceneNode;
+class TransformationStore;
+
+using Core::IListener;
+using Core::ProcessEventArg;
+
+/**
+ * World transformation update module.
+ * Updates the dirty world transformations of a scene once every
+ * process event. Attach it to the process event before the modules
+ * that query transformations, such as cameras, physics and sound.
+ * For a scene kept in a TransformationStore the store is updated
+ * instead of traversing the scene.
+ *
+ * @code
+ * TransformationUpdater* updater = new TransformationUpdater(scene);
+ * engine.ProcessEvent().Attach(*updater);
+ * @endcode
+ *
+ * @class TransformationUpdater TransformationUpdater.h Scene/TransformationUpdater.h
+ * @see TransformationNode::UpdateWorldTransformations
+ */
+class TransformationUpdater : public IListener<ProcessEventArg> {
+private:
+    ISceneNode* root;
+    TransformationStore* store;
+public:
+    TransformationUpdater(ISceneNode* root = NULL);
+    TransformationUpdater(TransformationStore* store);
+    virtual ~TransformationUpdater();
+
+    void SetRoot(ISceneNode* root);
+    ISceneNode* GetRoot();
+    void SetStore(TransformationStore* store);
+    TransformationStore* GetStore();
+
+    void Handle(ProcessEventArg arg);
+};
+
+} // NS Scene
+} // NS OpenEngine
+
+#endif // _OE_TRANSFORMATION_UPDATER_H_
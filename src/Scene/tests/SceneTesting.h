@@ -0,0 +1,30 @@
+// Scene testing utilities
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS) 
+// 
+// This program is free software; It is covered by the GNU General 
+// Public License version 2 or any later version. 
+// See the GNU General Public License for more details (see LICENSE). 
+//--------------------------------------------------------------------
+
+#ifndef _OE_SCENE_TESTING_H_
+#define _OE_SCENE_TESTING_H_
+
+#include <Scene/TransformationNode.h>
+
+// Helpers shared by the scene tests
+
+inline bool Near(OpenEngine::Math::Vector<3,float> a,
+                 OpenEngine::Math::Vector<3,float> b) {
+    return (a - b).GetLength() < 1e-4;
+}
+
+inline OpenEngine::Math::Vector<3,float>
+WorldPosition(OpenEngine::Scene::TransformationNode* node) {
+    OpenEngine::Math::Vector<3,float> p;
+    OpenEngine::Math::Quaternion<float> q;
+    node->GetAccumulatedTransformations(&p, &q);
+    return p;
+}
+
+#endif // _OE_SCENE_TESTING_H_
@@ -0,0 +1,98 @@
+#include <Testing/Testing.h>
+#include "SceneTesting.h"
+
+#include <Scene/SceneNode.h>
+#include <Scene/GeometryNode.h>
+#include <Scene/TransformationNode.h>
+#include <Scene/MeshNode.h>
+#include <Geometry/Mesh.h>
+#include <Geometry/GeometrySet.h>
+#include <Resources/DataBlock.h>
+#include <Geometry/Face.h>
+#include <Geometry/FaceSet.h>
+#include <Math/Math.h>
+
+using namespace OpenEngine::Scene;
+using namespace OpenEngine::Geometry;
+using namespace OpenEngine::Resources;
+using OpenEngine::Math::PI;
+
+static GeometryNode* Triangle(Vector<3,float> p) {
+    FaceSet* faces = new FaceSet();
+    faces->Add(FacePtr(new Face(p,
+                                p + Vector<3,float>(1,0,0),
+                                p + Vector<3,float>(0,1,0))));
+    return new GeometryNode(faces);
+}
+
+int test_main(int argc, char* argv[]) {
+    Bounds empty;
+    OE_CHECK(empty.IsEmpty());
+    Bounds unit(Vector<3,float>(-1,-1,-1), Vector<3,float>(1,1,1));
+    OE_CHECK(unit.Intersects(Bounds(Vector<3,float>(0.5,0.5,0.5),
+                                    Vector<3,float>(2,2,2))));
+    OE_CHECK(!unit.Intersects(Bounds(Vector<3,float>(2,2,2),
+                                     Vector<3,float>(3,3,3))));
+    Bounds turned = unit.Transform(Vector<3,float>(10,0,0),
+                                   Quaternion<float>(0, PI / 4, 0),
+                                   Vector<3,float>(1,1,1));
+    OE_CHECK(Near(turned.GetCenter(), Vector<3,float>(10,0,0)));
+    OE_CHECK(turned.GetExtent()[0] > 1.4f);
+
+    SceneNode* root = new SceneNode();
+    TransformationNode* t = new TransformationNode();
+    GeometryNode* a = Triangle(Vector<3,float>(0,0,0));
+    GeometryNode* b = Triangle(Vector<3,float>(5,0,0));
+    root->AddNode(t);
+    t->AddNode(a);
+    root->AddNode(b);
+
+    // bounds are the union of the sub tree
+    Bounds r = root->GetBounds();
+    OE_CHECK(Near(r.GetMin(), Vector<3,float>(0,0,0)));
+    OE_CHECK(Near(r.GetMax(), Vector<3,float>(6,1,0)));
+    OE_CHECK(a->GetBounds() == Bounds(Vector<3,float>(0,0,0),
+                                      Vector<3,float>(1,1,0)));
+
+    // transformations refit the nodes above them
+    t->SetPosition(Vector<3,float>(0,0,-10));
+    r = root->GetBounds();
+    OE_CHECK(Near(r.GetMin(), Vector<3,float>(0,0,-10)));
+    OE_CHECK(Near(a->GetWorldBounds().GetMax(), Vector<3,float>(1,1,-10)));
+    // bounds below the transformation are unchanged
+    OE_CHECK(Near(a->GetBounds().GetMax(), Vector<3,float>(1,1,0)));
+
+    t->SetScale(Vector<3,float>(2,2,2));
+    OE_CHECK(Near(a->GetWorldBounds().GetMax(), Vector<3,float>(2,2,-10)));
+
+    // structural changes refit
+    root->RemoveNode(b);
+    r = root->GetBounds();
+    OE_CHECK(Near(r.GetMax(), Vector<3,float>(2,2,-10)));
+    t->AddNode(b);
+    r = root->GetBounds();
+    OE_CHECK(Near(r.GetMax(), Vector<3,float>(12,2,-10)));
+
+    // nodes without geometry have empty bounds
+    SceneNode* group = new SceneNode();
+    OE_CHECK(group->GetBounds().IsEmpty());
+    delete group;
+
+    // unloading the vertices of a mesh keeps its bounds
+    DataBlock<3,float>* vertices = new DataBlock<3,float>(2);
+    vertices->SetElement(0, Vector<3,float>(-1,0,0));
+    vertices->SetElement(1, Vector<3,float>(1,2,3));
+    IndicesPtr indices(new Indices(2));
+    GeometrySetPtr geom(new GeometrySet(IDataBlockPtr(vertices)));
+    MeshNode* mesh = new MeshNode(MeshPtr(new Mesh(indices, LINES, geom,
+                                                   MaterialPtr())));
+    Bounds m = mesh->GetBounds();
+    OE_CHECK(m == Bounds(Vector<3,float>(-1,0,0), Vector<3,float>(1,2,3)));
+    vertices->Unload();
+    mesh->InvalidateBounds();
+    OE_CHECK(mesh->GetBounds() == m);
+    delete mesh;
+
+    delete root;
+    return 0;
+}
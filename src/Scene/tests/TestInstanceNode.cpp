@@ -0,0 +1,153 @@
+#include <Testing/Testing.h>
+#include "SceneTesting.h"
+
+#include <Scene/InstanceNode.h>
+#include <Scene/SceneNode.h>
+#include <Scene/GeometryNode.h>
+#include <Scene/PropertyNode.h>
+#include <Scene/ISceneNodeVisitor.h>
+#include <Scene/Exceptions.h>
+#include <Geometry/Face.h>
+#include <Geometry/FaceSet.h>
+#include <Resources/StreamArchive.h>
+#include <Resources/BinaryStreamArchive.h>
+
+#include <sstream>
+
+using namespace OpenEngine::Scene;
+using namespace OpenEngine::Geometry;
+using namespace OpenEngine::Resources;
+
+// counts nodes, knowing nothing about instances
+class CountVisitor : public ISceneNodeVisitor {
+public:
+    unsigned int transformations, properties;
+    CountVisitor() : transformations(0), properties(0) {}
+    void VisitTransformationNode(TransformationNode* node) {
+        transformations++;
+        node->VisitSubNodes(*this);
+    }
+    void VisitPropertyNode(PropertyNode* node) {
+        properties++;
+        node->VisitSubNodes(*this);
+    }
+};
+
+int test_main(int argc, char* argv[]) {
+    // prototype: a triangle at (0,1,0) and a property node
+    SceneNode* root = new SceneNode();
+    TransformationNode* t = new TransformationNode();
+    t->SetPosition(Vector<3,float>(0,1,0));
+    FaceSet* faces = new FaceSet();
+    faces->Add(FacePtr(new Face(Vector<3,float>(0,0,0),
+                                Vector<3,float>(1,0,0),
+                                Vector<3,float>(0,1,0))));
+    t->AddNode(new GeometryNode(faces));
+    PropertyNode* prop = new PropertyNode();
+    prop->SetProperty("kind", "rock");
+    root->AddNode(t);
+    root->AddNode(prop);
+    ScenePrototype rock(root);
+
+    SceneNode* scene = new SceneNode();
+    InstanceNode* a = new InstanceNode(rock);
+    InstanceNode* b = new InstanceNode(rock);
+    a->SetPosition(Vector<3,float>(10,0,0));
+    b->SetPosition(Vector<3,float>(-10,0,0));
+    scene->AddNode(a);
+    scene->AddNode(b);
+    OE_CHECK(a->IsShared() && b->IsShared());
+    OE_CHECK(a->GetNumberOfNodes() == 0);
+
+    // visitors see the instances as transformation nodes
+    CountVisitor count;
+    scene->Accept(count);
+    OE_CHECK(count.transformations == 4);
+    OE_CHECK(count.properties == 2);
+
+    // bounds include the transformed prototype
+    OE_CHECK(Near(a->GetBounds().GetMin(), Vector<3,float>(10,1,0)));
+    OE_CHECK(Near(scene->GetBounds().GetMin(), Vector<3,float>(-10,1,0)));
+    OE_CHECK(Near(scene->GetBounds().GetMax(), Vector<3,float>(11,2,0)));
+
+    // clones share the prototype
+    ISceneNode* copy = scene->Clone();
+    OE_CHECK(rock.use_count() == 5);
+    delete copy;
+    OE_CHECK(rock.use_count() == 3);
+
+    // the first write copies the prototype for the instance
+    PropertyNode* mine = a->Write(prop);
+    OE_CHECK(mine != prop);
+    OE_CHECK(mine->GetProperty("kind").Match(std::string("rock")));
+    OE_CHECK(!a->IsShared());
+    OE_CHECK(b->GetPrototype() == rock);
+    mine->SetProperty("kind", "moss");
+    OE_CHECK(prop->GetProperty("kind").Match(std::string("rock")));
+    // later writes change the private copy in place
+    OE_CHECK(a->Write(mine) == mine);
+    ISceneNode* mt = a->Write(a->GetPrototype()->GetNode(0));
+    OE_CHECK(mt->GetParent() == a->GetPrototype().get());
+    static_cast<TransformationNode*>(mt)->SetPosition(Vector<3,float>(0,5,0));
+    a->InvalidateBounds();
+    OE_CHECK(Near(a->GetBounds().GetMin(), Vector<3,float>(10,5,0)));
+    OE_CHECK(Near(b->GetBounds().GetMin(), Vector<3,float>(-10,1,0)));
+
+    // only nodes of the prototype are writable
+    bool thrown = false;
+    try { a->Write(prop); }
+    catch (InvalidSceneOperation&) { thrown = true; }
+    OE_CHECK(thrown);
+
+    // prototypes may not be in a scene
+    ScenePrototype held(new SceneNode());
+    SceneNode* holder = new SceneNode();
+    holder->AddNode(held.get());
+    InstanceNode c;
+    thrown = false;
+    try { c.SetPrototype(held); }
+    catch (InvalidSceneOperation&) { thrown = true; }
+    OE_CHECK(thrown);
+    holder->RemoveNode(held.get());
+    delete holder;
+    c.SetPrototype(held);
+    OE_CHECK(c.IsShared());
+
+    delete scene;
+    OE_CHECK(rock.unique());
+
+    // shared prototypes are written once and shared when read back
+    SceneNode* saved = new SceneNode();
+    ScenePrototype tree(new SceneNode());
+    tree->AddNode(new TransformationNode());
+    saved->AddNode(new InstanceNode(tree));
+    saved->AddNode(new InstanceNode(tree));
+    saved->AddNode(new InstanceNode(ScenePrototype(new SceneNode())));
+    for (int binary = 0; binary < 2; binary++) {
+        std::stringstream ss;
+        ISceneNode* loaded;
+        if (binary) {
+            BinaryStreamArchiveWriter w(ss);
+            w.WriteScene("scene", saved);
+            BinaryStreamArchiveReader r(ss);
+            loaded = r.ReadScene("scene");
+        } else {
+            StreamArchiveWriter w(ss);
+            w.WriteScene("scene", saved);
+            StreamArchiveReader r(ss);
+            loaded = r.ReadScene("scene");
+        }
+        OE_REQUIRE(loaded->GetNumberOfNodes() == 3);
+        InstanceNode* i0 = dynamic_cast<InstanceNode*>(loaded->GetNode(0));
+        InstanceNode* i1 = dynamic_cast<InstanceNode*>(loaded->GetNode(1));
+        InstanceNode* i2 = dynamic_cast<InstanceNode*>(loaded->GetNode(2));
+        OE_REQUIRE(i0 && i1 && i2);
+        OE_CHECK(i0->GetPrototype() == i1->GetPrototype());
+        OE_CHECK(i0->GetPrototype()->GetNumberOfNodes() == 1);
+        OE_CHECK(i2->GetPrototype() != i0->GetPrototype());
+        OE_CHECK(i2->GetPrototype()->GetNumberOfNodes() == 0);
+        delete loaded;
+    }
+    delete saved;
+    return 0;
+}
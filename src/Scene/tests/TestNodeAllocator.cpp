@@ -0,0 +1,129 @@
+#include <Testing/Testing.h>
+
+#include <Scene/NodeAllocator.h>
+#include <Scene/SceneNode.h>
+#include <Scene/TransformationNode.h>
+#include <Scene/PropertyNode.h>
+#include <Core/Thread.h>
+
+using namespace std;
+using namespace OpenEngine::Scene;
+
+// a node type without its own pool
+class BigNode : public SceneNode {
+public:
+    char data[512];
+};
+
+// activates an arena on its own thread
+class ArenaThread : public OpenEngine::Core::Thread {
+public:
+    NodeArena* arena;
+    bool active, restored;
+    ArenaThread(NodeArena* arena)
+        : arena(arena), active(false), restored(false) {}
+    void Run() {
+        arena->Activate();
+        active = NodeArena::GetActive() == arena;
+        arena->Deactivate();
+        restored = NodeArena::GetActive() == NULL;
+    }
+};
+
+static NodePool* FindPool(string name) {
+    list<NodePool*> pools = NodePool::GetPools();
+    for (list<NodePool*>::iterator itr = pools.begin(); itr != pools.end(); itr++)
+        if ((*itr)->GetName() == name) return *itr;
+    return NULL;
+}
+
+int test_main(int argc, char* argv[]) {
+    // nodes come from the pool of their type
+    SceneNode* first = new SceneNode();
+    NodePool* pool = FindPool("SceneNode");
+    OE_CHECK(pool != NULL);
+    OE_CHECK(pool->GetSlotSize() == sizeof(SceneNode));
+    unsigned int base = pool->GetAllocated();
+    SceneNode* root = new SceneNode();
+    for (unsigned int i = 0; i < 1000; i++)
+        root->AddNode(new SceneNode());
+    OE_CHECK(pool->GetAllocated() == base + 1001);
+    OE_CHECK(pool->GetCapacity() >= pool->GetAllocated());
+
+    // clones are pooled too
+    ISceneNode* clone = root->Clone();
+    OE_CHECK(pool->GetAllocated() == base + 2002);
+    delete clone;
+    delete root;
+    OE_CHECK(pool->GetAllocated() == base);
+
+    // freed slots are reused
+    delete first;
+    SceneNode* again = new SceneNode();
+    OE_CHECK(again == first);
+    delete again;
+
+    // larger sub classes fall back to the heap
+    BigNode* big = new BigNode();
+    OE_CHECK(pool->GetAllocated() == base - 1);
+    root = new SceneNode();
+    root->AddNode(big);
+    delete root;
+
+    // a whole scene in an arena
+    NodeArena* arena = new NodeArena(16 * 1024);
+    arena->Activate();
+    OE_CHECK(NodeArena::GetActive() == arena);
+    root = new SceneNode();
+    for (unsigned int i = 0; i < 100; i++) {
+        TransformationNode* t = new TransformationNode();
+        t->AddNode(new PropertyNode());
+        root->AddNode(t);
+    }
+    arena->Deactivate();
+    OE_CHECK(NodeArena::GetActive() == NULL);
+    OE_CHECK(arena->GetAllocated() == 201);
+    OE_CHECK(arena->GetUsed() <= arena->GetCapacity());
+    OE_CHECK(pool->GetAllocated() == base - 1);
+    // nodes created after deactivation use the pools
+    SceneNode* pooled = new SceneNode();
+    root->AddNode(pooled);
+    OE_CHECK(pool->GetAllocated() == base);
+    delete root;
+    OE_CHECK(arena->GetAllocated() == 0);
+    OE_CHECK(pool->GetAllocated() == base - 1);
+    delete arena;
+
+    // each thread restores its own previous arena, also when an arena
+    // is activated again above another one
+    NodeArena* outer = new NodeArena();
+    NodeArena* inner = new NodeArena();
+    outer->Activate();
+    inner->Activate();
+    outer->Activate();
+    ArenaThread thread(outer);
+    thread.Start();
+    thread.Wait();
+    OE_CHECK(thread.active && thread.restored);
+    OE_CHECK(NodeArena::GetActive() == outer);
+    outer->Deactivate();
+    OE_CHECK(NodeArena::GetActive() == inner);
+    inner->Deactivate();
+    OE_CHECK(NodeArena::GetActive() == outer);
+    outer->Deactivate();
+    OE_CHECK(NodeArena::GetActive() == NULL);
+    delete inner;
+    delete outer;
+
+    // deep scenes are deleted without recursion
+    root = new SceneNode();
+    ISceneNode* node = root;
+    for (unsigned int i = 0; i < 100000; i++) {
+        ISceneNode* sub = new SceneNode();
+        node->AddNode(sub);
+        node = sub;
+    }
+    delete root;
+    OE_CHECK(pool->GetAllocated() == base - 1);
+    return 0;
+}
@@ -0,0 +1,147 @@
+#include <Testing/Testing.h>
+
+#include <Scene/ParallelVisitor.h>
+#include <Scene/SceneNode.h>
+#include <Scene/PropertyNode.h>
+#include <Scene/InstanceNode.h>
+#include <Scene/TransformationNode.h>
+#include <Scene/SceneIndex.h>
+#include <Scene/Exceptions.h>
+#include <Core/TaskScheduler.h>
+#include <Utils/Convert.h>
+
+#include <vector>
+#include <string>
+
+using namespace OpenEngine::Scene;
+using OpenEngine::Core::TaskScheduler;
+using OpenEngine::Utils::Convert;
+
+// Collects node info in traversal order and deletes marked nodes.
+class CollectVisitor : public ParallelVisitor {
+public:
+    std::vector<std::string> infos;
+    bool prune;
+    CollectVisitor(TaskScheduler* s, bool prune = false)
+        : ParallelVisitor(s), prune(prune) {}
+    void VisitSceneNode(SceneNode* node) {
+        infos.push_back(node->GetInfo());
+        if (prune && node->GetInfo() == "prune" && node->GetParent())
+            node->GetParent()->DeleteNode(node);
+        VisitSubNodes(node);
+    }
+protected:
+    ParallelVisitor* Fork() { return new CollectVisitor(NULL, prune); }
+    void Join(ParallelVisitor& fork) {
+        CollectVisitor& f = (CollectVisitor&)fork;
+        infos.insert(infos.end(), f.infos.begin(), f.infos.end());
+    }
+};
+
+// Throws on the node with info "throw".
+class ThrowVisitor : public ParallelVisitor {
+public:
+    ThrowVisitor(TaskScheduler* s) : ParallelVisitor(s) {}
+    void VisitSceneNode(SceneNode* node) {
+        if (node->GetInfo() == "throw")
+            throw InvalidSceneOperation("thrown by a fork");
+        VisitSubNodes(node);
+    }
+protected:
+    ParallelVisitor* Fork() { return new ThrowVisitor(NULL); }
+    void Join(ParallelVisitor& fork) {}
+};
+
+static void Build(ISceneNode* node, int depth, int& next) {
+    if (depth == 0) return;
+    for (int i = 0; i < 4; i++) {
+        SceneNode* sub = new SceneNode();
+        sub->SetInfo(Convert::ToString(next++));
+        node->AddNode(sub);
+        Build(sub, depth - 1, next);
+    }
+}
+
+int test_main(int argc, char* argv[]) {
+    SceneNode* root = new SceneNode();
+    int next = 0;
+    Build(root, 6, next);
+
+    CollectVisitor serial(NULL);
+    serial.Traverse(*root);
+    OE_CHECK(serial.infos.size() == (unsigned int)next + 1);
+
+    TaskScheduler scheduler(3);
+    scheduler.Start();
+    for (int i = 0; i < 10; i++) {
+        CollectVisitor parallel(&scheduler);
+        parallel.Traverse(*root);
+        // joined in sub node order
+        OE_CHECK(parallel.infos == serial.infos);
+    }
+
+    // deletions during the traversal are delayed and all performed
+    std::list<ISceneNode*>::iterator itr;
+    for (itr = root->subNodes.begin(); itr != root->subNodes.end(); itr++) {
+        ISceneNode* sub = (*itr)->GetNode(1);
+        sub->SetInfo("prune");
+    }
+    // the index is updated by the deletions of all forks
+    SceneIndex* index = new SceneIndex(root);
+    CollectVisitor pruner(&scheduler, true);
+    pruner.Traverse(*root);
+    CollectVisitor after(&scheduler);
+    after.Traverse(*root);
+    OE_CHECK(after.infos.size() == serial.infos.size() - 4 * 341);
+    OE_CHECK(index->GetSize() == after.infos.size());
+    OE_CHECK(index->GetNodesWithInfo("prune").empty());
+    delete index;
+    for (itr = root->subNodes.begin(); itr != root->subNodes.end(); itr++)
+        OE_CHECK((*itr)->GetNumberOfNodes() == 3);
+
+    // the caches of a prototype shared by instances visited on
+    // different forks are filled before fanning out
+    TransformationNode* shared = new TransformationNode();
+    ScenePrototype prototype(shared);
+    SceneNode* scene = new SceneNode();
+    for (int i = 0; i < 8; i++)
+        scene->AddNode(new InstanceNode(prototype));
+    TransformationNode* moved = new TransformationNode();
+    scene->AddNode(moved);
+    shared->Move(1, 0, 0);
+    moved->Move(0, 1, 0);
+    OE_CHECK(shared->IsWorldTransformationDirty());
+    OE_CHECK(moved->IsWorldTransformationDirty());
+    CollectVisitor instances(&scheduler);
+    instances.Traverse(*scene);
+    OE_CHECK(!shared->IsWorldTransformationDirty());
+    OE_CHECK(!moved->IsWorldTransformationDirty());
+    // changes after a pass are found through the dirty flags
+    moved->Move(0, 1, 0);
+    shared->Move(1, 0, 0);
+    std::list<ISceneNode*>::iterator inst;
+    for (inst = scene->subNodes.begin(); inst != scene->subNodes.end(); inst++)
+        (*inst)->InvalidateBounds();
+    OE_CHECK(moved->IsWorldTransformationDirty());
+    OE_CHECK(shared->IsWorldTransformationDirty());
+    CollectVisitor again(&scheduler);
+    again.Traverse(*scene);
+    OE_CHECK(!shared->IsWorldTransformationDirty());
+    OE_CHECK(!moved->IsWorldTransformationDirty());
+    delete scene;
+
+    // an exception of a fork is rethrown with its type
+    root->GetNode(2)->GetNode(1)->SetInfo("throw");
+    bool thrown = false;
+    try {
+        ThrowVisitor thrower(&scheduler);
+        thrower.Traverse(*root);
+    } catch (InvalidSceneOperation& e) {
+        thrown = true;
+    }
+    OE_CHECK(thrown);
+
+    scheduler.Stop();
+    delete root;
+    return 0;
+}
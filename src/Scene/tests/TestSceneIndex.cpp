@@ -0,0 +1,115 @@
+#include <Testing/Testing.h>
+
+#include <Scene/SceneIndex.h>
+#include <Scene/SearchTool.h>
+#include <Scene/SceneNode.h>
+#include <Scene/PropertyNode.h>
+#include <Scene/TransformationNode.h>
+#include <Scene/Exceptions.h>
+
+using namespace std;
+using namespace OpenEngine::Scene;
+
+int test_main(int argc, char* argv[]) {
+    //           s1
+    //         /  |  \.
+    //       p1  r1   t1
+    //            |
+    //           p2
+    //            |
+    //           r2
+    SceneNode*    s1 = new SceneNode();
+    PropertyNode* p1 = new PropertyNode();
+    PropertyNode* p2 = new PropertyNode();
+    SceneNode*    r1 = new SceneNode();
+    SceneNode*    r2 = new SceneNode();
+    TransformationNode* t1 = new TransformationNode();
+    p1->SetProperty("id", "gun");
+    p2->SetProperty("id", "hat");
+    p2->SetProperty("count", 2);
+    s1->AddNode(p1); s1->AddNode(r1); s1->AddNode(t1);
+    r1->AddNode(p2);
+    p2->AddNode(r2);
+
+    // searching without an index fails
+    bool thrown = false;
+    try { SearchTool::IndexedSceneNodes(s1); }
+    catch (InvalidSceneOperation&) { thrown = true; }
+    OE_CHECK(thrown);
+
+    SceneIndex* index = new SceneIndex(s1);
+    OE_CHECK(index->GetSize() == 6);
+    OE_CHECK(SceneIndex::Find(r2) == index);
+    OE_CHECK(SceneIndex::Get(s1) == index);
+    OE_CHECK(SceneIndex::Get(r1) == NULL);
+
+    // by type, including the root
+    SceneIndex::View<SceneNode> scenes = SearchTool::IndexedSceneNodes(s1);
+    OE_CHECK(scenes.size() == 3);
+    OE_CHECK(scenes.Contains(s1) && scenes.Contains(r1) && scenes.Contains(r2));
+    OE_CHECK(SearchTool::IndexedTransformationNode(s1) == t1);
+    OE_CHECK(SearchTool::IndexedRenderStateNode(s1) == NULL);
+    OE_CHECK(SearchTool::IndexedRenderStateNodes(s1).empty());
+    list<PropertyNode*> props = SearchTool::IndexedPropertyNodes(s1).ToList();
+    OE_CHECK(props.size() == 2);
+
+    // by property, only string properties match
+    OE_CHECK(SearchTool::IndexedPropertyNodeWith("id", "gun", s1) == p1);
+    OE_CHECK(SearchTool::IndexedPropertyNodesWith("id", "hat", s1).size() == 1);
+    OE_CHECK(SearchTool::IndexedPropertyNodeWith("count", "2", s1) == NULL);
+    OE_CHECK(SearchTool::IndexedPropertyNodeWith("id", "cat", s1) == NULL);
+
+    // property changes are reindexed
+    p1->SetProperty("id", "sword");
+    OE_CHECK(SearchTool::IndexedPropertyNodeWith("id", "gun", s1) == NULL);
+    OE_CHECK(SearchTool::IndexedPropertyNodeWith("id", "sword", s1) == p1);
+
+    // by info string
+    r2->SetInfo("player");
+    OE_CHECK(SearchTool::IndexedNodesWithInfo("player", s1).Any() == r2);
+    // a view held across changes follows them
+    SceneIndex::View<ISceneNode> players =
+        SearchTool::IndexedNodesWithInfo("player", s1);
+
+    // removed sub trees are unindexed
+    r1->RemoveNode(p2);
+    OE_CHECK(index->GetSize() == 4);
+    OE_CHECK(!index->Contains(r2));
+    OE_CHECK(SearchTool::IndexedPropertyNodeWith("id", "hat", s1) == NULL);
+    OE_CHECK(SearchTool::IndexedNodesWithInfo("player", s1).empty());
+    OE_CHECK(players.empty());
+    // changes outside the scene do not touch the index
+    p2->SetProperty("id", "gun");
+    OE_CHECK(SearchTool::IndexedPropertyNodeWith("id", "gun", s1) == NULL);
+
+    // added sub trees are indexed
+    t1->AddNode(p2);
+    OE_CHECK(index->GetSize() == 6);
+    OE_CHECK(SearchTool::IndexedPropertyNodeWith("id", "gun", s1) == p2);
+    OE_CHECK(SearchTool::IndexedNodesWithInfo("player", s1).Any() == r2);
+    OE_CHECK(players.Contains(r2));
+
+    // replaced and deleted nodes are unindexed
+    SceneNode* r3 = new SceneNode();
+    p2->ReplaceNode(r2, r3);
+    OE_CHECK(index->Contains(r3));
+    OE_CHECK(SearchTool::IndexedNodesWithInfo("player", s1).empty());
+    t1->DeleteNode(p2);
+    OE_CHECK(index->GetSize() == 4);
+    OE_CHECK(SearchTool::IndexedPropertyNodes(s1).size() == 1);
+
+    // the index agrees with the traversing selectors
+    OE_CHECK(SearchTool::DescendantSceneNodes(s1, true).size() ==
+             SearchTool::IndexedSceneNodes(s1).size());
+
+    // a scene may only have one index
+    thrown = false;
+    try { SceneIndex again(r1); }
+    catch (InvalidSceneOperation&) { thrown = true; }
+    OE_CHECK(thrown);
+
+    delete index;
+    OE_CHECK(SceneIndex::Find(r1) == NULL);
+    delete s1;
+    return 0;
+}
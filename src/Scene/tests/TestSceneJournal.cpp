@@ -0,0 +1,136 @@
+#include <Testing/Testing.h>
+
+#include <Scene/SceneJournal.h>
+#include <Scene/SceneNode.h>
+#include <Scene/RenderStateNode.h>
+#include <Scene/TransformationNode.h>
+#include <Scene/Exceptions.h>
+
+using namespace std;
+using namespace OpenEngine::Scene;
+
+typedef SceneJournal::Change Change;
+
+static bool Is(const Change& c, SceneJournal::ChangeType type,
+               ISceneNode* node, ISceneNode* parent = NULL,
+               ISceneNode* previous = NULL) {
+    return c.type == type && c.node == node
+        && c.parent == parent && c.previous == previous;
+}
+
+int test_main(int argc, char* argv[]) {
+    //       s1
+    //      /  \.
+    //    t1    r1
+    //    |
+    //    t2
+    SceneNode* s1 = new SceneNode();
+    TransformationNode* t1 = new TransformationNode();
+    TransformationNode* t2 = new TransformationNode();
+    RenderStateNode* r1 = new RenderStateNode();
+    s1->AddNode(t1);
+    t1->AddNode(t2);
+    s1->AddNode(r1);
+
+    // changes are only recorded with a journal
+    SceneJournal* journal = new SceneJournal(s1);
+    OE_CHECK(journal->IsEmpty());
+    OE_CHECK(SceneJournal::Find(t2) == journal);
+    OE_CHECK(SceneJournal::Get(s1) == journal);
+    OE_CHECK(SceneJournal::Get(t1) == NULL);
+    bool thrown = false;
+    try { new SceneJournal(t1); }
+    catch (InvalidSceneOperation&) { thrown = true; }
+    OE_CHECK(thrown);
+
+    // transformation and state changes are recorded once a frame
+    t2->Move(1, 0, 0);
+    t2->SetPosition(t2->GetPosition());
+    r1->EnableOption(RenderStateNode::LIGHTING);
+    r1->ToggleOption(RenderStateNode::LIGHTING);
+    s1->SetInfo("root");
+    const vector<Change>& changes = journal->GetChanges();
+    OE_CHECK(changes.size() == 3);
+    OE_CHECK(Is(changes[0], SceneJournal::TRANSFORM_CHANGED, t2));
+    OE_CHECK(Is(changes[1], SceneJournal::STATE_CHANGED, r1));
+    OE_CHECK(Is(changes[2], SceneJournal::STATE_CHANGED, s1));
+
+    // moving a transformation does not change its local transformation
+    journal->NextFrame();
+    OE_CHECK(journal->IsEmpty());
+    OE_CHECK(journal->GetFrame() == 1);
+    t1->RemoveNode(t2);
+    r1->AddNode(t2);
+    OE_CHECK(changes.size() == 1);
+    OE_CHECK(Is(changes[0], SceneJournal::NODE_REPARENTED, t2, r1, t1));
+
+    // adding and removing
+    journal->NextFrame();
+    TransformationNode* t3 = new TransformationNode();
+    t3->AddNode(new SceneNode());
+    s1->AddNode(t3);
+    s1->RemoveNode(r1);
+    OE_CHECK(changes.size() == 2);
+    OE_CHECK(Is(changes[0], SceneJournal::NODE_ADDED, t3, s1));
+    OE_CHECK(Is(changes[1], SceneJournal::NODE_REMOVED, r1, NULL, s1));
+
+    // detached nodes are not recorded
+    journal->NextFrame();
+    r1->DisableOption(RenderStateNode::TEXTURE);
+    t2->Move(0, 1, 0);
+    OE_CHECK(journal->IsEmpty());
+    s1->AddNode(r1);
+    journal->NextFrame();
+
+    // deleting a sub tree records every node and drops their records
+    t2->Move(0, 1, 0);
+    t3->Move(0, 1, 0);
+    s1->RemoveNode(t3);
+    t2->AddNode(t3);
+    ISceneNode* s2 = t3->GetNode(0);
+    s1->DeleteNode(r1);
+    OE_CHECK(!journal->IsEmpty());
+    const vector<Change>& deleted = journal->GetChanges();
+    OE_CHECK(deleted.size() == 4);
+    OE_CHECK(Is(deleted[0], SceneJournal::NODE_DELETED, r1, NULL, s1));
+    OE_CHECK(Is(deleted[1], SceneJournal::NODE_DELETED, t2));
+    OE_CHECK(Is(deleted[2], SceneJournal::NODE_DELETED, t3));
+    OE_CHECK(Is(deleted[3], SceneJournal::NODE_DELETED, s2));
+
+    // deleting many nodes in a frame keeps the records of the others
+    journal->NextFrame();
+    vector<TransformationNode*> many;
+    for (unsigned int i = 0; i < 100; i++) {
+        many.push_back(new TransformationNode());
+        s1->AddNode(many.back());
+        many.back()->Move(1, 0, 0);
+    }
+    for (unsigned int i = 0; i < 100; i += 2)
+        s1->DeleteNode(many[i]);
+    const vector<Change>& mixed = journal->GetChanges();
+    OE_CHECK(mixed.size() == 50 * 2 + 50);
+    bool ordered = true;
+    for (unsigned int i = 0; i < 50; i++) {
+        ordered &= Is(mixed[2 * i], SceneJournal::NODE_ADDED, many[2 * i + 1], s1);
+        ordered &= Is(mixed[2 * i + 1], SceneJournal::TRANSFORM_CHANGED, many[2 * i + 1]);
+        ordered &= Is(mixed[100 + i], SceneJournal::NODE_DELETED, many[2 * i], NULL, s1);
+    }
+    OE_CHECK(ordered);
+    for (unsigned int i = 1; i < 100; i += 2)
+        s1->DeleteNode(many[i]);
+    journal->NextFrame();
+
+    // replacing deletes the old node
+    journal->NextFrame();
+    SceneNode* s3 = new SceneNode();
+    s1->ReplaceNode(t1, s3);
+    OE_CHECK(changes.size() == 2);
+    OE_CHECK(Is(changes[0], SceneJournal::NODE_DELETED, t1, NULL, s1));
+    OE_CHECK(Is(changes[1], SceneJournal::NODE_ADDED, s3, s1));
+
+    delete journal;
+    OE_CHECK(SceneJournal::Find(s3) == NULL);
+    s3->SetInfo("no journal");
+    delete s1;
+    return 0;
+}
@@ -0,0 +1,190 @@
+#include <Testing/Testing.h>
+
+#include <Scene/LooseOctree.h>
+#include <Scene/HashGrid.h>
+#include <Scene/SpatialIndexer.h>
+#include <Scene/SceneJournal.h>
+#include <Scene/SceneNode.h>
+#include <Scene/GeometryNode.h>
+#include <Scene/TransformationNode.h>
+#include <Geometry/FaceSet.h>
+#include <Geometry/Face.h>
+#include <Geometry/Sphere.h>
+#include <Geometry/Plane.h>
+#include <Geometry/Ray.h>
+
+#include <cstdlib>
+#include <cmath>
+#include <map>
+#include <set>
+
+using namespace std;
+using namespace OpenEngine::Scene;
+using namespace OpenEngine::Geometry;
+using OpenEngine::Math::Vector;
+
+typedef map<ISceneNode*, Bounds> Objects;
+
+static float Random(float lo, float hi) {
+    return lo + (hi - lo) * (rand() / float(RAND_MAX));
+}
+
+static Bounds RandomBounds(float world, float size) {
+    Vector<3,float> c(Random(-world, world), Random(-world, world), Random(-world, world));
+    Vector<3,float> e(Random(0, size), Random(0, size), Random(0, size));
+    return Bounds(c - e, c + e);
+}
+
+static set<ISceneNode*> Set(const list<ISceneNode*>& nodes) {
+    return set<ISceneNode*>(nodes.begin(), nodes.end());
+}
+
+// compare the queries of an index with testing every object
+static bool Check(ISpatialIndex& index, Objects& objects) {
+    if (index.GetSize() != objects.size()) return false;
+    for (int q = 0; q < 50; q++) {
+        Bounds box = RandomBounds(120, 30);
+        Sphere sphere(Vector<3,float>(Random(-120, 120), 0, Random(-120, 120)),
+                      Random(0, 60));
+        vector<Plane> planes;
+        planes.push_back(Plane(Vector<3,float>(1, 0, 0), Random(-50, 50)));
+        planes.push_back(Plane(Vector<3,float>(0, -1, 0), Random(-50, 50)));
+        set<ISceneNode*> inBox, inSphere, inPlanes;
+        Vector<3,float> p(Random(-150, 150), Random(-150, 150), Random(-150, 150));
+        Ray ray(p, Vector<3,float>(Random(-1, 1), Random(-1, 1), Random(-1, 1)));
+        float first = -1;
+        multiset<float> distances;
+        for (Objects::iterator itr = objects.begin(); itr != objects.end(); itr++) {
+            const Bounds& b = itr->second;
+            if (b.Intersects(box)) inBox.insert(itr->first);
+            if (b.Intersects(sphere)) inSphere.insert(itr->first);
+            if (!b.IsBehind(planes[0]) && !b.IsBehind(planes[1]))
+                inPlanes.insert(itr->first);
+            float t;
+            if (b.Intersects(ray, &t) && (first < 0 || t < first)) first = t;
+            distances.insert(b.GetSquaredDistance(p));
+        }
+
+        list<ISceneNode*> nodes;
+        index.Query(box, nodes);
+        if (nodes.size() != inBox.size() || Set(nodes) != inBox) return false;
+        nodes.clear();
+        index.Query(sphere, nodes);
+        if (nodes.size() != inSphere.size() || Set(nodes) != inSphere) return false;
+        nodes.clear();
+        index.Query(planes, nodes);
+        if (nodes.size() != inPlanes.size() || Set(nodes) != inPlanes) return false;
+
+        // nearest first, at the same distances as the nearest objects
+        nodes.clear();
+        index.Nearest(p, 5, nodes);
+        if (nodes.size() != min(size_t(5), objects.size())) return false;
+        multiset<float>::iterator d = distances.begin();
+        for (list<ISceneNode*>::iterator n = nodes.begin(); n != nodes.end(); n++, d++)
+            if (objects[*n].GetSquaredDistance(p) != *d) return false;
+
+        float t = -1;
+        ISceneNode* hit = index.Cast(ray, &t);
+        if ((hit == NULL) != (first < 0)) return false;
+        if (hit && (t != first || objects[hit].Intersects(ray) == false)) return false;
+    }
+    return true;
+}
+
+static void TestIndex(ISpatialIndex& index) {
+    srand(42);
+    vector<ISceneNode*> nodes;
+    Objects objects;
+    for (int i = 0; i < 400; i++) {
+        ISceneNode* node = new SceneNode();
+        nodes.push_back(node);
+        // mostly small objects, some large and some outside the world
+        Bounds b = RandomBounds(i % 50 == 0 ? 150 : 100, i % 20 == 0 ? 60 : 3);
+        objects[node] = b;
+        index.Insert(node, b);
+    }
+    OE_CHECK(index.Contains(nodes[0]));
+    OE_CHECK(Check(index, objects));
+
+    // move, remove and reinsert
+    for (int i = 0; i < 400; i += 2) {
+        Bounds b = objects[nodes[i]];
+        if (i % 3 == 0) b = RandomBounds(100, 3);
+        else b = Bounds(b.GetMin() + Vector<3,float>(0.1f), b.GetMax() + Vector<3,float>(0.1f));
+        objects[nodes[i]] = b;
+        index.Insert(nodes[i], b);
+    }
+    for (int i = 1; i < 400; i += 4) {
+        objects.erase(nodes[i]);
+        index.Remove(nodes[i]);
+    }
+    OE_CHECK(!index.Contains(nodes[1]));
+    OE_CHECK(Check(index, objects));
+
+    index.Insert(nodes[1], Bounds());
+    OE_CHECK(!index.Contains(nodes[1]));
+
+    index.Clear();
+    objects.clear();
+    OE_CHECK(index.GetSize() == 0);
+    OE_CHECK(index.Cast(Ray(Vector<3,float>(0.0f), Vector<3,float>(1, 0, 0))) == NULL);
+    OE_CHECK(Check(index, objects));
+    for (unsigned int i = 0; i < nodes.size(); i++)
+        delete nodes[i];
+}
+
+static GeometryNode* Triangle(float x) {
+    FaceSet* faces = new FaceSet();
+    faces->Add(FacePtr(new Face(Vector<3,float>(x, 0, 0),
+                                Vector<3,float>(x + 1, 0, 0),
+                                Vector<3,float>(x, 1, 0))));
+    return new GeometryNode(faces);
+}
+
+int test_main(int argc, char* argv[]) {
+    LooseOctree octree(Bounds(Vector<3,float>(-100), Vector<3,float>(100)), 6);
+    TestIndex(octree);
+    OE_CHECK(octree.GetNumberOfCells() == 1);
+    HashGrid grid(8, 1024);
+    TestIndex(grid);
+
+    // the indexer follows the journal of the scene
+    SceneNode* scene = new SceneNode();
+    TransformationNode* t = new TransformationNode();
+    GeometryNode* g1 = Triangle(0);
+    GeometryNode* g2 = Triangle(10);
+    scene->AddNode(t);
+    t->AddNode(g1);
+    scene->AddNode(g2);
+    SceneJournal* journal = new SceneJournal(scene);
+    SpatialIndexer indexer(octree, *journal);
+    indexer.Build();
+    OE_CHECK(octree.GetSize() == 2);
+    Ray down(Vector<3,float>(0.25f, 0.25f, 10), Vector<3,float>(0, 0, -1));
+    OE_CHECK(octree.Cast(down) == g1);
+
+    t->Move(50, 0, 0);
+    scene->RemoveNode(g2);
+    GeometryNode* g3 = Triangle(0);
+    scene->AddNode(g3);
+    indexer.Update();
+    journal->NextFrame();
+    OE_CHECK(octree.GetSize() == 2);
+    OE_CHECK(!octree.Contains(g2));
+    OE_CHECK(octree.Cast(down) == g3);
+    list<ISceneNode*> nodes;
+    octree.Query(Bounds(Vector<3,float>(49), Vector<3,float>(51)), nodes);
+    OE_CHECK(nodes.size() == 0);
+    octree.Query(Bounds(Vector<3,float>(49, 0, 0), Vector<3,float>(51, 1, 0)), nodes);
+    OE_CHECK(nodes.size() == 1 && nodes.front() == g1);
+
+    scene->DeleteNode(t);
+    indexer.Update();
+    journal->NextFrame();
+    OE_CHECK(octree.GetSize() == 1);
+
+    delete journal;
+    delete scene;
+    delete g2;
+    return 0;
+}
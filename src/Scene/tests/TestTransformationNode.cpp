@@ -0,0 +1,63 @@
+#include <Testing/Testing.h>
+#include "SceneTesting.h"
+
+#include <Scene/TransformationNode.h>
+#include <Scene/SceneNode.h>
+#include <Math/Math.h>
+
+using namespace OpenEngine::Scene;
+using OpenEngine::Math::PI;
+
+int test_main(int argc, char* argv[]) {
+    SceneNode* root = new SceneNode();
+    TransformationNode* a = new TransformationNode();
+    SceneNode* group = new SceneNode();
+    TransformationNode* b = new TransformationNode();
+    root->AddNode(a);
+    a->AddNode(group);
+    group->AddNode(b);
+
+    a->SetPosition(Vector<3,float>(1,0,0));
+    b->SetPosition(Vector<3,float>(0,1,0));
+    OE_CHECK(a->IsWorldTransformationDirty());
+    OE_CHECK(b->IsWorldTransformationDirty());
+
+    // lazy update of the chain
+    OE_CHECK(Near(WorldPosition(b), Vector<3,float>(1,1,0)));
+    OE_CHECK(!a->IsWorldTransformationDirty());
+    OE_CHECK(!b->IsWorldTransformationDirty());
+
+    // changes propagate down the sub tree
+    a->Move(0,0,2);
+    OE_CHECK(a->IsWorldTransformationDirty());
+    OE_CHECK(b->IsWorldTransformationDirty());
+
+    // batch update
+    TransformationNode::UpdateWorldTransformations(root);
+    OE_CHECK(!b->IsWorldTransformationDirty());
+    OE_CHECK(Near(WorldPosition(b), Vector<3,float>(1,1,2)));
+
+    // rotation and scale of the parent apply to the child
+    a->SetScale(Vector<3,float>(2,2,2));
+    Vector<3,float> p, s;
+    Quaternion<float> q;
+    b->GetAccumulatedTransformations(&p, &q, &s);
+    OE_CHECK(Near(s, Vector<3,float>(2,2,2)));
+    a->SetRotation(Quaternion<float>(0, PI / 2, 0));
+    b->GetAccumulatedTransformations(&p, &q, &s);
+    OE_CHECK(Near(p, a->GetRotation().RotateVector(Vector<3,float>(0,1,0))
+                  + Vector<3,float>(1,0,2)));
+
+    // moving a sub tree invalidates it
+    TransformationNode* c = new TransformationNode();
+    c->SetPosition(Vector<3,float>(5,5,5));
+    root->AddNode(c);
+    TransformationNode::UpdateWorldTransformations(root);
+    a->RemoveNode(group);
+    OE_CHECK(b->IsWorldTransformationDirty());
+    c->AddNode(group);
+    OE_CHECK(Near(WorldPosition(b), Vector<3,float>(5,6,5)));
+
+    delete root;
+    return 0;
+}
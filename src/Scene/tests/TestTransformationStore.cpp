@@ -0,0 +1,104 @@
+#include <Testing/Testing.h>
+#include "SceneTesting.h"
+
+#include <Scene/TransformationStore.h>
+#include <Scene/TransformationNode.h>
+#include <Scene/SceneNode.h>
+
+using namespace OpenEngine::Scene;
+
+int test_main(int argc, char* argv[]) {
+    TransformationNode* base = new TransformationNode();
+    SceneNode* root = new SceneNode();
+    TransformationNode* a = new TransformationNode();
+    SceneNode* group = new SceneNode();
+    TransformationNode* b = new TransformationNode();
+    base->AddNode(root);
+    root->AddNode(a);
+    a->AddNode(group);
+    group->AddNode(b);
+    base->SetPosition(Vector<3,float>(0,0,10));
+    a->SetPosition(Vector<3,float>(1,0,0));
+    b->SetPosition(Vector<3,float>(0,1,0));
+
+    TransformationStore* store = new TransformationStore(root);
+    OE_CHECK(a->GetStore() == store);
+    OE_CHECK(b->GetStore() == store);
+    OE_CHECK(base->GetStore() == NULL);
+    OE_CHECK(store->GetCount() == 2);
+    OE_CHECK(store->GetParents()[0] == -1);
+    OE_CHECK(store->GetParents()[1] == 0);
+
+    // the store holds the transformations
+    OE_CHECK(Near(b->GetPosition(), Vector<3,float>(0,1,0)));
+    store->Update();
+    OE_CHECK(!store->IsDirty());
+    OE_CHECK(Near(WorldPosition(b), Vector<3,float>(1,1,10)));
+    Matrix<4,4,float> m = store->GetWorldMatrices()[1];
+    OE_CHECK(Near(Vector<3,float>(m(3,0), m(3,1), m(3,2)),
+                  Vector<3,float>(1,1,10)));
+
+    // changes are swept
+    a->Move(1,0,0);
+    OE_CHECK(store->IsDirty());
+    store->Update();
+    OE_CHECK(Near(WorldPosition(b), Vector<3,float>(2,1,10)));
+    base->Move(0,0,-10);
+    OE_CHECK(Near(WorldPosition(b), Vector<3,float>(2,1,0)));
+
+    // added nodes are bound after their parents
+    TransformationNode* c = new TransformationNode();
+    TransformationNode* d = new TransformationNode();
+    c->SetPosition(Vector<3,float>(5,0,0));
+    d->SetPosition(Vector<3,float>(0,5,0));
+    c->AddNode(d);
+    root->AddNode(c);
+    OE_CHECK(store->GetCount() == 4);
+    OE_CHECK(Near(WorldPosition(d), Vector<3,float>(5,5,0)));
+
+    // moving a sub tree rebinds it, removing releases it
+    a->RemoveNode(group);
+    OE_CHECK(b->GetStore() == NULL);
+    OE_CHECK(Near(WorldPosition(b), Vector<3,float>(0,1,0)));
+    d->AddNode(group);
+    OE_CHECK(b->GetStore() == store);
+    OE_CHECK(Near(WorldPosition(b), Vector<3,float>(5,6,0)));
+    for (unsigned int i = 0; i < store->GetSize(); i++)
+        if (store->GetNode(i) == b)
+            OE_CHECK(store->GetNode(store->GetParents()[i]) == d);
+
+    // deleted nodes leave holes that are compacted
+    root->DeleteNode(c);
+    OE_CHECK(store->GetCount() == 1);
+    a->Move(0,1,0);
+    store->Update();
+    OE_CHECK(store->GetSize() == 1);
+    OE_CHECK(store->GetNode(0) == a);
+
+    // the nodes hold their transformations again
+    delete store;
+    OE_CHECK(a->GetStore() == NULL);
+    OE_CHECK(Near(a->GetPosition(), Vector<3,float>(2,1,0)));
+    OE_CHECK(Near(WorldPosition(a), Vector<3,float>(2,1,0)));
+
+    // a store around another one leaves its nodes to it
+    TransformationNode* e = new TransformationNode();
+    e->SetPosition(Vector<3,float>(0,0,1));
+    a->AddNode(e);
+    TransformationStore* inner = new TransformationStore(a);
+    TransformationStore* outer = new TransformationStore(base);
+    OE_CHECK(base->GetStore() == outer && outer->GetCount() == 1);
+    OE_CHECK(a->GetStore() == inner && e->GetStore() == inner);
+    OE_CHECK(inner->GetCount() == 2);
+    base->Move(0,0,3);
+    OE_CHECK(Near(WorldPosition(e), Vector<3,float>(2,1,4)));
+    // the string form reads the transformation held by the store
+    TransformationNode copy(*e);
+    OE_CHECK(copy.GetStore() == NULL);
+    OE_CHECK(e->ToString() == copy.ToString());
+    delete outer;
+    delete inner;
+
+    delete base;
+    return 0;
+}
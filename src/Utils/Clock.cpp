@@ -0,0 +1,74 @@
+// Monotonic high resolution clock.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#include <Utils/Clock.h>
+#include <Meta/Time.h>
+
+namespace OpenEngine {
+namespace Utils {
+
+const uint64_t Ticks::MAX;
+
+static const uint64_t second = 1000000000;
+
+// cycles per second, zero until calibrated
+static volatile uint64_t frequency = 0;
+
+/**
+ * Read the monotonic clock.
+ *
+ * @return Ticks since an unspecified starting point.
+ */
+Ticks Clock::Now() {
+#if defined(__APPLE__)
+    static mach_timebase_info_data_t timebase;
+    if (timebase.denom == 0) mach_timebase_info(&timebase);
+    return Ticks(mach_absolute_time() * timebase.numer / timebase.denom);
+#else
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return Ticks((uint64_t)t.tv_sec * second + t.tv_nsec);
+#endif
+}
+
+/**
+ * Get the frequency of the cycle counter.
+ * The first call calibrates the counter against the clock, which
+ * takes about 20 milliseconds.
+ *
+ * @return Cycles per second.
+ */
+uint64_t Clock::GetCycleFrequency() {
+    if (frequency != 0) return frequency;
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+    Ticks t0 = Now();
+    uint64_t c0 = ReadCycleCounter();
+    struct timespec pause = { 0, 20000000 };
+    nanosleep(&pause, NULL);
+    Ticks t1 = Now();
+    uint64_t c1 = ReadCycleCounter();
+    uint64_t ns = (t1 - t0).AsNanoseconds();
+    uint64_t f = ns > 0 ? (uint64_t)((c1 - c0) * (double(second) / ns)) : second;
+    frequency = f > 0 ? f : second;
+#else
+    frequency = second;
+#endif
+    return frequency;
+}
+
+/**
+ * Convert a number of cycles to ticks.
+ */
+Ticks Clock::CyclesToTicks(uint64_t cycles) {
+    uint64_t f = GetCycleFrequency();
+    return Ticks((cycles / f) * second + (cycles % f) * second / f);
+}
+
+} // NS Utils
+} // NS OpenEngine
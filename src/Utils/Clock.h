@@ -0,0 +1,114 @@
+// Monotonic high resolution clock.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#ifndef _OE_CLOCK_H_
+#define _OE_CLOCK_H_
+
+#include <Meta/Types.h>
+#include <Utils/Timer.h>
+
+namespace OpenEngine {
+namespace Utils {
+
+/**
+ * Clock ticks.
+ * A 64 bit count of nanoseconds. Arithmetic saturates instead of
+ * wrapping, so subtracting a later time from an earlier one gives
+ * zero and never a huge (or negative) duration.
+ *
+ * @class Ticks Clock.h Utils/Clock.h
+ * @see Clock
+ */
+class Ticks {
+private:
+    uint64_t ns;
+
+public:
+    static const uint64_t MAX = ~(uint64_t)0;
+
+    Ticks() : ns(0) {}
+    explicit Ticks(uint64_t ns) : ns(ns) {}
+
+    static Ticks FromMicroseconds(uint64_t usec) {
+        return Ticks(usec > MAX / 1000 ? MAX : usec * 1000);
+    }
+    static Ticks FromTime(const Time t) {
+        return FromMicroseconds(t.AsInt64());
+    }
+
+    uint64_t AsNanoseconds() const { return ns; }
+    uint64_t AsMicroseconds() const { return ns / 1000; }
+    double AsSeconds() const { return ns * 1e-9; }
+    Time AsTime() const {
+        return Time(ns / 1000000000, (uint32_t)((ns % 1000000000) / 1000));
+    }
+
+    Ticks& operator+=(const Ticks t) {
+        ns = ns > MAX - t.ns ? MAX : ns + t.ns;
+        return *this;
+    }
+    Ticks& operator-=(const Ticks t) {
+        ns = ns < t.ns ? 0 : ns - t.ns;
+        return *this;
+    }
+    Ticks operator+(const Ticks t) const { Ticks s(*this); return s += t; }
+    Ticks operator-(const Ticks t) const { Ticks s(*this); return s -= t; }
+
+    bool operator< (const Ticks t) const { return ns <  t.ns; }
+    bool operator> (const Ticks t) const { return ns >  t.ns; }
+    bool operator<=(const Ticks t) const { return ns <= t.ns; }
+    bool operator>=(const Ticks t) const { return ns >= t.ns; }
+    bool operator==(const Ticks t) const { return ns == t.ns; }
+    bool operator!=(const Ticks t) const { return ns != t.ns; }
+    bool IsZero() const { return ns == 0; }
+};
+
+/**
+ * Monotonic high resolution clock.
+ * The engine time source. Unlike the wall clock it never jumps when
+ * the system time is adjusted, and it has nanosecond resolution
+ * where the platform provides it. The epoch is unspecified, so only
+ * differences between readings are meaningful.
+ *
+ * For micro profiling the processor cycle counter can be read
+ * directly, which costs a few cycles instead of a system call.
+ * Cycles are converted to ticks with a frequency calibrated against
+ * the clock on first use. The counter is only meaningful for short
+ * intervals on one thread, as it may differ between processors and
+ * with frequency scaling on older hardware.
+ *
+ * @class Clock Clock.h Utils/Clock.h
+ */
+class Clock {
+public:
+    static Ticks Now();
+
+    /**
+     * Read the processor cycle counter.
+     * Falls back to the clock in nanoseconds on platforms without a
+     * readable counter.
+     */
+    static inline uint64_t ReadCycleCounter() {
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+        uint32_t lo, hi;
+        __asm__ __volatile__ ("rdtsc" : "=a" (lo), "=d" (hi));
+        return ((uint64_t)hi << 32) | lo;
+#else
+        return Now().AsNanoseconds();
+#endif
+    }
+
+    static uint64_t GetCycleFrequency();
+    static Ticks CyclesToTicks(uint64_t cycles);
+};
+
+} // NS Utils
+} // NS OpenEngine
+
+#endif // _OE_CLOCK_H_
@@ -40,8 +40,9 @@ class DateTime {
     }
 
     DateTime(time_t t) {
-        struct tm* tminfo = localtime ( &t );
-        this->fill(*tminfo);
+        struct tm tminfo;
+        localtime_r(&t, &tminfo);
+        this->fill(tminfo);
     }
  public:
     DateTime() {
@@ -55,6 +56,13 @@ class DateTime {
         return DateTime(t);
     }
 
+    /**
+     * Local date and time of a time in seconds since the epoch.
+     */
+    static DateTime FromTime(time_t t) {
+        return DateTime(t);
+    }
+
     unsigned int GetYear() const {
         return year;
     }
@@ -13,6 +13,7 @@
 #include <Core/IEvent.h>
 #include <Core/IListener.h>
 #include <Utils/Timer.h>
+#include <Utils/Profiler.h>
 
 #include <string>
 #include <list>
@@ -40,6 +41,10 @@ namespace Utils {
  * prof.Profile<EventArg>("Listener 1", event, list1);
  * prof.Profile<EventArg>("Listener 2", event, list2);
  * @endcode
+ * Each intercepted call is also recorded as a Profiler zone named
+ * after the listener, nested in the zone of the notifying code.
+ *
+ * @see Profiler
  */
 class EventProfiler {
 private:
@@ -49,7 +54,7 @@ private:
         Timer timer; 
         std::string name;
         unsigned int count;
-        unsigned int time;
+        unsigned int time;      //!< accumulated time in microseconds
         Intercepter(std::string name) : name(name), count(0), time(0) {}
     };
     
@@ -62,8 +67,12 @@ private:
         virtual void Handle(E arg) {
             count++;
             timer.Start();
-            peer.Handle(arg);
+            {
+                Profiler::Zone zone(name.c_str());
+                peer.Handle(arg);
+            }
             timer.Stop();
+            time = timer.GetElapsedTime().AsInt();
         }
     };
 
@@ -0,0 +1,522 @@
+// Hierarchical frame profiler.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#include <Utils/Profiler.h>
+#include <Utils/Clock.h>
+#include <Core/Atomic.h>
+#include <Core/Mutex.h>
+#include <Core/ThreadStorage.h>
+#include <Logging/Logger.h>
+
+#include <cstring>
+#include <sstream>
+#include <algorithm>
+#include <map>
+
+namespace OpenEngine {
+namespace Utils {
+
+using Core::Mutex;
+using Core::MemoryBarrier;
+using Core::ThreadStorage;
+
+// records in each thread ring buffer, must be a power of two
+static const unsigned long bufferSize = 1 << 14;
+
+/**
+ * Per thread profiling state.
+ * The zone tree and the producer end of the ring buffer are only
+ * touched by the owning thread. The consumer end is only touched by
+ * Collect() while holding the profiler lock.
+ */
+class Profiler::ThreadBuffer {
+public:
+    // Zone in the call tree of the thread. Immutable once created
+    // except for the list of children, which only the owner reads.
+    class Node {
+    public:
+        const char* name;
+        Node* parent;
+        unsigned int depth;
+        std::string path;
+        std::vector<Node*> children;
+        Node(const char* name, Node* parent)
+            : name(name), parent(parent), depth(0) {
+            if (parent == NULL) return;
+            if (parent->parent == NULL) path = name;
+            else {
+                depth = parent->depth + 1;
+                path = parent->path + "/" + name;
+            }
+        }
+        ~Node() {
+            for (unsigned int i = 0; i < children.size(); i++)
+                delete children[i];
+        }
+    };
+
+    class Record {
+    public:
+        Node* node;
+        uint64_t start, end;
+    };
+
+    unsigned int id;
+    std::string name;
+    Node root;
+    Node* current;
+    std::vector<uint64_t> starts;   //!< open Begin() zones
+    Record* records;
+    volatile unsigned long head;
+    volatile unsigned long tail;
+    volatile unsigned int lost;
+    bool exited;                    //!< owner has exited, guarded by the lock
+
+    ThreadBuffer(unsigned int id)
+        : id(id), root("", NULL), current(&root)
+        , records(new Record[bufferSize]), head(0), tail(0), lost(0)
+        , exited(false) {}
+
+    ~ThreadBuffer() {
+        delete[] records;
+    }
+
+    void Enter(const char* name) {
+        std::vector<Node*>& cs = current->children;
+        for (unsigned int i = 0; i < cs.size(); i++)
+            if (cs[i]->name == name || strcmp(cs[i]->name, name) == 0) {
+                current = cs[i];
+                return;
+            }
+        Node* n = new Node(name, current);
+        cs.push_back(n);
+        current = n;
+    }
+
+    void Leave(uint64_t start, uint64_t end) {
+        Node* n = current;
+        if (n == &root) return;
+        current = n->parent;
+        unsigned long h = head;
+        if (h - tail >= bufferSize) {
+            lost++;
+            return;
+        }
+        Record& r = records[h & (bufferSize - 1)];
+        r.node = n;
+        r.start = start;
+        r.end = end;
+        MemoryBarrier();
+        head = h + 1;
+    }
+};
+
+// Sliding window of zone durations.
+class Window {
+public:
+    unsigned int depth;
+    unsigned int total;
+    unsigned int pos;
+    std::vector<uint64_t> samples;
+    Window() : depth(0), total(0), pos(0) {}
+    void Add(uint64_t sample, unsigned int size) {
+        if (samples.size() < size) samples.push_back(sample);
+        else samples[pos] = sample;
+        pos = (pos + 1) % size;
+        total++;
+    }
+};
+
+class CaptureRecord {
+public:
+    const char* name;
+    unsigned int thread;
+    uint64_t start, end;
+};
+
+volatile bool Profiler::enabled = false;
+
+static void ReleaseBuffer(void* buffer);
+
+static Mutex lock;
+static const unsigned int slot = ThreadStorage::AllocateSlot(ReleaseBuffer);
+static std::vector<Profiler::ThreadBuffer*> buffers;
+static unsigned int nextId = 0;
+static unsigned int retiredLost = 0;
+static std::map<unsigned int, std::string> retiredNames;
+static std::map<std::string, Window> windows;
+static unsigned int windowSize = 240;
+static bool capturing = false;
+static unsigned int captureLimit = 0;
+static uint64_t captureStart = 0;
+static std::vector<CaptureRecord> capture;
+
+static inline uint64_t Now() {
+    return Clock::Now().AsNanoseconds();
+}
+
+// Deletes the buffers of exited threads once their records are
+// collected. Must be called with the lock held.
+static void Retire() {
+    unsigned int n = 0;
+    for (unsigned int i = 0; i < buffers.size(); i++) {
+        Profiler::ThreadBuffer* b = buffers[i];
+        if (b->exited && b->tail == b->head) {
+            retiredLost += b->lost;
+            // the capture may still refer to the thread
+            if (capturing || !capture.empty()) retiredNames[b->id] = b->name;
+            delete b;
+        }
+        else buffers[n++] = b;
+    }
+    buffers.resize(n);
+}
+
+// Thread storage cleanup of the buffer of an exiting thread. The
+// buffer is kept until its remaining records are collected.
+static void ReleaseBuffer(void* buffer) {
+    lock.Lock();
+    static_cast<Profiler::ThreadBuffer*>(buffer)->exited = true;
+    Retire();
+    lock.Unlock();
+}
+
+// Buffer of the calling thread, registered on first use and named
+// after the thread.
+static Profiler::ThreadBuffer* Local() {
+    ThreadStorage& ts = ThreadStorage::Current();
+    Profiler::ThreadBuffer* b = static_cast<Profiler::ThreadBuffer*>(ts.Get(slot));
+    if (b != NULL) return b;
+    lock.Lock();
+    b = new Profiler::ThreadBuffer(nextId++);
+    b->name = ts.GetThreadName();
+    buffers.push_back(b);
+    lock.Unlock();
+    ts.Set(slot, b);
+    return b;
+}
+
+/**
+ * Open a zone on the calling thread.
+ *
+ * @param name Zone name, must outlive the profiler.
+ */
+Profiler::Zone::Zone(const char* name) : buffer(NULL) {
+    if (!enabled) return;
+    buffer = Local();
+    buffer->Enter(name);
+    start = Now();
+}
+
+/**
+ * Close the zone and record its duration.
+ */
+Profiler::Zone::~Zone() {
+    if (buffer != NULL) buffer->Leave(start, Now());
+}
+
+/**
+ * Enable or disable profiling.
+ * Zones opened while disabled are not recorded.
+ */
+void Profiler::SetEnabled(bool enabled) {
+    Profiler::enabled = enabled;
+}
+
+bool Profiler::IsEnabled() {
+    return enabled;
+}
+
+/**
+ * Open a zone without a scope, for instance when the zone starts and
+ * ends in different callbacks. Must be paired with End() on the same
+ * thread.
+ *
+ * @param name Zone name, must outlive the profiler.
+ */
+void Profiler::Begin(const char* name) {
+    if (!enabled) return;
+    ThreadBuffer* b = Local();
+    b->Enter(name);
+    b->starts.push_back(Now());
+}
+
+/**
+ * Close the zone opened by the last Begin() on the calling thread.
+ */
+void Profiler::End() {
+    // only a thread that opened a zone has a buffer, so a disabled
+    // profiler never allocates here
+    ThreadBuffer* b = static_cast<ThreadBuffer*>
+        (ThreadStorage::Current().Get(slot));
+    if (b == NULL || b->starts.empty()) return;
+    uint64_t start = b->starts.back();
+    b->starts.pop_back();
+    b->Leave(start, Now());
+}
+
+/**
+ * Name the calling thread in captured traces. Threads named with
+ * Core::Thread are named automatically.
+ */
+void Profiler::SetThreadName(const char* name) {
+    ThreadBuffer* b = Local();
+    lock.Lock();
+    b->name = name;
+    lock.Unlock();
+}
+
+/**
+ * Collect the zones recorded by all threads since the last call.
+ * Zones still open are collected once they close.
+ */
+void Profiler::Collect() {
+    if (!enabled && !capturing) return;
+    lock.Lock();
+    for (unsigned int i = 0; i < buffers.size(); i++) {
+        ThreadBuffer* b = buffers[i];
+        unsigned long h = b->head;
+        MemoryBarrier();
+        for (unsigned long t = b->tail; t != h; t++) {
+            ThreadBuffer::Record& r = b->records[t & (bufferSize - 1)];
+            Window& w = windows[r.node->path];
+            w.depth = r.node->depth;
+            w.Add(r.end - r.start, windowSize);
+            if (capturing && capture.size() < captureLimit) {
+                CaptureRecord c;
+                c.name = r.node->name;
+                c.thread = b->id;
+                c.start = r.start;
+                c.end = r.end;
+                capture.push_back(c);
+            }
+        }
+        MemoryBarrier();
+        b->tail = h;
+    }
+    Retire();
+    lock.Unlock();
+}
+
+/**
+ * Discard all statistics and captured zones.
+ */
+void Profiler::Reset() {
+    lock.Lock();
+    for (unsigned int i = 0; i < buffers.size(); i++) {
+        buffers[i]->tail = buffers[i]->head;
+        buffers[i]->lost = 0;
+    }
+    Retire();
+    retiredLost = 0;
+    windows.clear();
+    capture.clear();
+    lock.Unlock();
+}
+
+/**
+ * Set the number of samples in the statistics window.
+ * Discards the current statistics.
+ */
+void Profiler::SetWindow(unsigned int samples) {
+    lock.Lock();
+    windowSize = samples > 0 ? samples : 1;
+    windows.clear();
+    lock.Unlock();
+}
+
+unsigned int Profiler::GetWindow() {
+    return windowSize;
+}
+
+static Profiler::ZoneStatistics Summarize(const std::string& path,
+                                          const Window& w) {
+    Profiler::ZoneStatistics s;
+    s.path = path;
+    s.depth = w.depth;
+    s.total = w.total;
+    s.count = w.samples.size();
+    if (s.count == 0) return s;
+    std::vector<uint64_t> sorted(w.samples);
+    std::sort(sorted.begin(), sorted.end());
+    uint64_t sum = 0;
+    for (unsigned int i = 0; i < sorted.size(); i++)
+        sum += sorted[i];
+    s.min = sorted.front();
+    s.max = sorted.back();
+    s.avg = double(sum) / s.count;
+    s.p95 = sorted[(s.count - 1) * 95 / 100];
+    s.p99 = sorted[(s.count - 1) * 99 / 100];
+    return s;
+}
+
+/**
+ * Get the statistics of all zones ordered by path, so each zone is
+ * followed by the zones nested in it.
+ */
+std::vector<Profiler::ZoneStatistics> Profiler::GetStatistics() {
+    std::vector<ZoneStatistics> stats;
+    lock.Lock();
+    std::map<std::string, Window>::iterator i;
+    for (i = windows.begin(); i != windows.end(); i++)
+        stats.push_back(Summarize(i->first, i->second));
+    lock.Unlock();
+    return stats;
+}
+
+/**
+ * Get the statistics of a zone.
+ *
+ * @param path Zone path.
+ * @param stats Assigned the statistics if the zone is known.
+ * @return False if no samples have been collected for the zone.
+ */
+bool Profiler::GetStatistics(const std::string& path, ZoneStatistics& stats) {
+    lock.Lock();
+    std::map<std::string, Window>::iterator i = windows.find(path);
+    bool found = i != windows.end();
+    if (found) stats = Summarize(i->first, i->second);
+    lock.Unlock();
+    return found;
+}
+
+/**
+ * Number of zones dropped because a thread buffer was full. Collect
+ * more often if this is non zero.
+ */
+unsigned int Profiler::GetLost() {
+    lock.Lock();
+    unsigned int n = retiredLost;
+    for (unsigned int i = 0; i < buffers.size(); i++)
+        n += buffers[i]->lost;
+    lock.Unlock();
+    return n;
+}
+
+/**
+ * Start capturing collected zones for trace export.
+ * Discards any previous capture.
+ *
+ * @param maxRecords Maximal number of zones in the capture.
+ */
+void Profiler::StartCapture(unsigned int maxRecords) {
+    lock.Lock();
+    capture.clear();
+    retiredNames.clear();
+    captureLimit = maxRecords;
+    captureStart = Now();
+    capturing = true;
+    lock.Unlock();
+}
+
+/**
+ * Stop capturing. Zones recorded until now are collected first.
+ */
+void Profiler::StopCapture() {
+    Collect();
+    lock.Lock();
+    capturing = false;
+    lock.Unlock();
+}
+
+bool Profiler::IsCapturing() {
+    return capturing;
+}
+
+static void WriteJSONString(std::ostream& out, const std::string& s) {
+    out << '"';
+    for (unsigned int i = 0; i < s.size(); i++) {
+        char c = s[i];
+        if (c == '"' || c == '\\') out << '\\' << c;
+        else if ((unsigned char)c < 0x20) out << ' ';
+        else out << c;
+    }
+    out << '"';
+}
+
+// Write nanoseconds as fractional microseconds.
+static void WriteMicroseconds(std::ostream& out, uint64_t ns) {
+    out << ns / 1000 << '.'
+        << (char)('0' + ns / 100 % 10)
+        << (char)('0' + ns / 10 % 10)
+        << (char)('0' + ns % 10);
+}
+
+/**
+ * Write the captured zones in the Chrome trace event format.
+ * Timestamps are in microseconds relative to the capture start.
+ */
+void Profiler::WriteChromeTrace(std::ostream& out) {
+    lock.Lock();
+    std::map<unsigned int, std::string> names(retiredNames);
+    for (unsigned int i = 0; i < buffers.size(); i++)
+        names[buffers[i]->id] = buffers[i]->name;
+    out << "{\"traceEvents\":[";
+    bool first = true;
+    std::map<unsigned int, std::string>::iterator t;
+    for (t = names.begin(); t != names.end(); t++) {
+        if (!first) out << ",";
+        first = false;
+        out << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+            << t->first << ",\"args\":{\"name\":";
+        if (t->second.empty()) {
+            std::ostringstream n;
+            n << "Thread " << t->first;
+            WriteJSONString(out, n.str());
+        }
+        else WriteJSONString(out, t->second);
+        out << "}}";
+    }
+    for (unsigned int i = 0; i < capture.size(); i++) {
+        const CaptureRecord& r = capture[i];
+        if (!first) out << ",";
+        first = false;
+        out << "\n{\"name\":";
+        WriteJSONString(out, r.name);
+        out << ",\"cat\":\"OpenEngine\",\"ph\":\"X\",\"ts\":";
+        WriteMicroseconds(out, r.start > captureStart ? r.start - captureStart : 0);
+        out << ",\"dur\":";
+        WriteMicroseconds(out, r.end - r.start);
+        out << ",\"pid\":1,\"tid\":" << r.thread << "}";
+    }
+    out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+    lock.Unlock();
+}
+
+/**
+ * Print the zone statistics to the info log.
+ */
+void Profiler::DumpInfo() {
+    std::vector<ZoneStatistics> stats = GetStatistics();
+    logger.info << "Profiling info (microseconds over "
+                << windowSize << " samples):" << logger.end;
+    logger.info << "\t     min      avg      p95      p99      max  Zone"
+                << logger.end;
+    for (unsigned int i = 0; i < stats.size(); i++) {
+        const ZoneStatistics& s = stats[i];
+        std::ostringstream line;
+        line.setf(std::ios::fixed);
+        line.precision(1);
+        line.width(8); line << s.min / 1000.0 << " ";
+        line.width(8); line << s.avg / 1000.0 << " ";
+        line.width(8); line << s.p95 / 1000.0 << " ";
+        line.width(8); line << s.p99 / 1000.0 << " ";
+        line.width(8); line << s.max / 1000.0 << "  ";
+        for (unsigned int d = 0; d < s.depth; d++) line << "  ";
+        std::string::size_type slash = s.path.rfind('/');
+        line << (slash == std::string::npos ? s.path : s.path.substr(slash + 1));
+        logger.info << "\t" << line.str() << logger.end;
+    }
+    unsigned int lost = GetLost();
+    if (lost > 0)
+        logger.warning << "Profiler lost " << lost << " zones." << logger.end;
+}
+
+} // NS Utils
+} // NS OpenEngine
@@ -0,0 +1,119 @@
+// Hierarchical frame profiler.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#ifndef _OE_PROFILER_H_
+#define _OE_PROFILER_H_
+
+#include <Meta/Types.h>
+#include <string>
+#include <vector>
+#include <ostream>
+
+namespace OpenEngine {
+namespace Utils {
+
+/**
+ * Hierarchical frame profiler.
+ * Code is instrumented with scoped zones. Zones opened while another
+ * zone is open on the same thread are nested in it, so the zones form
+ * a call tree identified by paths such as
+ * "Engine::Process/Renderer::Process/TextureLoader::Load".
+ *
+ * @code
+ * void Module::Handle(Core::ProcessEventArg arg) {
+ *     Profiler::Zone zone("Module::Process");
+ *     ...
+ * }
+ * @endcode
+ *
+ * Each thread records completed zones in its own fixed size ring
+ * buffer without locking or allocating. Collect() drains the buffers
+ * into per zone statistics over a sliding window of samples and, when
+ * capturing, into a trace that can be written in the Chrome trace
+ * event format (chrome://tracing or Perfetto). The engine collects at
+ * the end of every frame. The buffer of a thread is freed once the
+ * thread has exited and its remaining zones are collected.
+ *
+ * Zones are timed with the monotonic Clock. Zone names must be
+ * string literals or otherwise outlive the profiler, as only the
+ * pointer is stored. Profiling is disabled by default, in which case
+ * a zone costs a single branch.
+ *
+ * @class Profiler Profiler.h Utils/Profiler.h
+ * @see EventProfiler
+ */
+class Profiler {
+public:
+    class ThreadBuffer;
+
+    /**
+     * Scoped profiling zone.
+     * Measures the time from construction to destruction.
+     */
+    class Zone {
+    private:
+        ThreadBuffer* buffer;
+        uint64_t start;
+        Zone(const Zone&);
+        Zone& operator=(const Zone&);
+    public:
+        Zone(const char* name);
+        ~Zone();
+    };
+
+    /**
+     * Statistics of a zone over the sliding window.
+     * Times are in nanoseconds.
+     */
+    class ZoneStatistics {
+    public:
+        std::string path;       //!< zone path, names separated by '/'
+        unsigned int depth;     //!< nesting depth, zero for root zones
+        unsigned int count;     //!< samples in the window
+        unsigned int total;     //!< samples since the profiler was reset
+        uint64_t min, max;
+        double avg;
+        uint64_t p95, p99;
+        ZoneStatistics()
+            : depth(0), count(0), total(0), min(0), max(0)
+            , avg(0), p95(0), p99(0) {}
+    };
+
+    static void SetEnabled(bool enabled);
+    static bool IsEnabled();
+
+    static void Begin(const char* name);
+    static void End();
+
+    static void SetThreadName(const char* name);
+
+    static void Collect();
+    static void Reset();
+
+    static void SetWindow(unsigned int samples);
+    static unsigned int GetWindow();
+    static std::vector<ZoneStatistics> GetStatistics();
+    static bool GetStatistics(const std::string& path, ZoneStatistics& stats);
+    static unsigned int GetLost();
+
+    static void StartCapture(unsigned int maxRecords = 1 << 20);
+    static void StopCapture();
+    static bool IsCapturing();
+    static void WriteChromeTrace(std::ostream& out);
+
+    static void DumpInfo();
+
+private:
+    static volatile bool enabled;
+};
+
+} // NS Utils
+} // NS OpenEngine
+
+#endif // _OE_PROFILER_H_
@@ -8,8 +8,8 @@
 //--------------------------------------------------------------------
 
 #include <Utils/Timer.h>
+#include <Utils/Clock.h>
 
-#include <Meta/Time.h>
 #include <Core/Exceptions.h>
 #include <Utils/Convert.h>
 
@@ -287,46 +287,16 @@ bool Timer::IsRunning() const {
 }
 
 /**
- * Get the system time.
- * The definition of what the "current time" is depends on the running
- * system. On most systems it is the time since the UNIX epoch.
- *
- * @todo We need to check that these timing methods are stable wrt.
- * to cpu scaling and system clocks. For unix type systems we may
- * wish to use times() together with sysconf to get the ticks per
- * second. On windows we might want to look at timeGetTime,
- * timeBeginPeriod and timeEndPeriod.
- *
- * Windows implementation from:
- * http://www.openasthra.com/c-tidbits/gettimeofday-function-for-windows/
+ * Get the current time.
+ * The time is read from the monotonic engine clock, so it never jumps
+ * with adjustments of the system time. The starting point is
+ * unspecified, only differences between times are meaningful.
  *
+ * @see Clock
  * @return Current time.
  */
 Time Timer::GetTime() {
-    /*
-#if defined(_WIN32)
-    #if defined(_MSC_VER) || defined(_MSC_EXTENSIONS)
-        #define DELTA_EPOCH_IN_MICROSECS  11644473600000000Ui64
-    #else
-        #define DELTA_EPOCH_IN_MICROSECS  11644473600000000ULL
-    #endif
-    Time tv;
-    FILETIME ft;
-    unsigned __int64 res = 0;
-    GetSystemTimeAsFileTime(&ft);
-    res |= ft.dwHighDateTime;
-    res <<= 32;
-    res |= ft.dwLowDateTime;
-    // converting file time to unix epoch
-    res /= 10;
-    res -= DELTA_EPOCH_IN_MICROSECS; 
-    return Time(res / 1000000UL, res % 1000000UL);
-#else
-*/
-    struct timeval t;
-    gettimeofday( &t, NULL );
-    return Time(t.tv_sec, t.tv_usec);
-//#endif
+    return Clock::Now().AsTime();
 }
 
 } //NS Utils
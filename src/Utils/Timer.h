@@ -18,8 +18,8 @@ namespace Utils {
 
 /**
  * Time data type.
- * Provides an interface to a time structure similar to that obtained
- * by \a gettimeofday.
+ * A time of microsecond resolution as seconds and microseconds. Use
+ * Ticks from the engine Clock for finer resolution.
  *
  * @todo We should look at how we can abstract Time and Timer to allow
  * alternative representation of ``time'', such as vector clocks.
@@ -0,0 +1,40 @@
+#include <Testing/Testing.h>
+
+#include <Utils/Clock.h>
+
+using namespace OpenEngine::Utils;
+
+int test_main(int argc, char* argv[]) {
+
+    // saturating arithmetic
+    Ticks a(10), b(25);
+    OE_CHECK((a - b).IsZero());
+    OE_CHECK((b - a).AsNanoseconds() == 15);
+    OE_CHECK((Ticks(Ticks::MAX) + a).AsNanoseconds() == Ticks::MAX);
+    OE_CHECK(Ticks::FromMicroseconds(Ticks::MAX).AsNanoseconds() == Ticks::MAX);
+
+    // conversion to and from the microsecond time type
+    Ticks t(3000001999ull);
+    OE_CHECK(t.AsTime() == Time(3, 1));
+    OE_CHECK(Ticks::FromTime(Time(3, 1)).AsNanoseconds() == 3000001000ull);
+
+    // the clock never runs backwards
+    Ticks last = Clock::Now();
+    for (int i = 0; i < 100000; i++) {
+        Ticks now = Clock::Now();
+        OE_CHECK(now >= last);
+        last = now;
+    }
+
+    // cycle counter advances and converts to a plausible duration
+    uint64_t c0 = Clock::ReadCycleCounter();
+    Ticks t0 = Clock::Now();
+    while ((Clock::Now() - t0).AsNanoseconds() < 5000000);
+    uint64_t c1 = Clock::ReadCycleCounter();
+    OE_CHECK(c1 > c0);
+    OE_CHECK(Clock::GetCycleFrequency() > 0);
+    Ticks d = Clock::CyclesToTicks(c1 - c0);
+    OE_CHECK(d.AsNanoseconds() > 1000000 && d.AsNanoseconds() < 1000000000);
+
+    return 0;
+}
@@ -0,0 +1,79 @@
+#include <Testing/Testing.h>
+
+#include <Utils/Profiler.h>
+#include <Core/Thread.h>
+
+#include <sstream>
+
+using namespace OpenEngine::Utils;
+using OpenEngine::Core::Thread;
+
+static void Work() {
+    Profiler::Zone zone("Work");
+}
+
+class Worker : public Thread {
+public:
+    void Run() {
+        Profiler::SetThreadName("worker");
+        for (int i = 0; i < 100; i++) {
+            Profiler::Zone zone("Job");
+            Work();
+        }
+    }
+};
+
+int test_main(int argc, char* argv[]) {
+
+    // zones are not recorded while disabled
+    {
+        Profiler::Zone zone("Disabled");
+    }
+    Profiler::End();
+    Profiler::SetEnabled(true);
+    Profiler::Collect();
+    Profiler::ZoneStatistics s;
+    OE_CHECK(!Profiler::GetStatistics("Disabled", s));
+
+    // nested zones are identified by their path
+    Profiler::SetWindow(10);
+    Profiler::StartCapture();
+    for (int i = 0; i < 20; i++) {
+        Profiler::Zone frame("Frame");
+        Work();
+        Profiler::Begin("Split");
+        Work();
+        Profiler::End();
+    }
+    Profiler::Collect();
+    OE_CHECK(Profiler::GetStatistics("Frame", s));
+    OE_CHECK(s.total == 20 && s.count == 10 && s.depth == 0);
+    OE_CHECK(s.min <= s.avg && s.avg <= s.max);
+    OE_CHECK(s.min <= s.p95 && s.p95 <= s.p99 && s.p99 <= s.max);
+    OE_CHECK(Profiler::GetStatistics("Frame/Work", s));
+    OE_CHECK(s.total == 20 && s.depth == 1);
+    OE_CHECK(Profiler::GetStatistics("Frame/Split/Work", s));
+    OE_CHECK(s.total == 20 && s.depth == 2);
+    OE_CHECK(!Profiler::GetStatistics("Work", s));
+
+    // zones of other threads are collected separately, also after
+    // the threads have exited
+    Worker w;
+    w.Start();
+    w.Wait();
+    Profiler::StopCapture();
+    OE_CHECK(Profiler::GetStatistics("Job/Work", s));
+    OE_CHECK(s.total == 100);
+    OE_CHECK(Profiler::GetLost() == 0);
+
+    std::ostringstream trace;
+    Profiler::WriteChromeTrace(trace);
+    OE_CHECK(trace.str().find("\"traceEvents\"") != std::string::npos);
+    OE_CHECK(trace.str().find("\"name\":\"Split\"") != std::string::npos);
+    OE_CHECK(trace.str().find("\"name\":\"worker\"") != std::string::npos);
+
+    Profiler::Reset();
+    OE_CHECK(!Profiler::GetStatistics("Frame", s));
+    Profiler::SetEnabled(false);
+    return 0;
+}